@@ -162,6 +162,15 @@ gp_distribution_policy_heap_table_check(PG_FUNCTION_ARGS)
 	/* Open relation in segment */
 	Relation rel = heap_open(relOid, AccessShareLock);
 
+	/*
+	 * Reduce the hash values to segments the way the executor placed the
+	 * rows: with the table's own reduction, e.g. jump consistent hashing.
+	 */
+	GpPolicyHashReduce hashreduce = POLICY_HASHREDUCE_MODULO;
+
+	if (rel->rd_cdbpolicy)
+		hashreduce = rel->rd_cdbpolicy->hashreduce;
+
 	/* Validate that the relation is a heap table */
 	if (!RelationIsHeap(rel))
 	{
@@ -178,7 +187,7 @@ gp_distribution_policy_heap_table_check(PG_FUNCTION_ARGS)
 		CHECK_FOR_INTERRUPTS();
 
 		/* Initialize hash function and structure */
-		CdbHash *hash = makeCdbHash(GpIdentity.numsegments);
+		CdbHash *hash = makeCdbHash(GpIdentity.numsegments, hashreduce);
 		cdbhashinit(hash);
 		
 		for(int i = 0; i < policy->nattrs; i++)
@@ -281,7 +281,8 @@ AOCSMoveTuple(TupleTableSlot *slot,
 static bool
 AOCSSegmentFileFullCompaction(Relation aorel,
 							  AOCSInsertDesc insertDesc,
-							  AOCSFileSegInfo *fsinfo)
+							  AOCSFileSegInfo *fsinfo,
+							  int elevel)
 {
 	const char *relname;
 	AppendOnlyVisimap visiMap;
@@ -298,6 +299,8 @@ AOCSSegmentFileFullCompaction(Relation aorel,
 	AOTupleId  *aoTupleId;
 	int64		tupleCount = 0;
 	int64		tuplePerPage = INT_MAX;
+	int64		eof = 0;
+	AppendOnlyCompactionProgress progress;
 
 	Assert(Gp_role == GP_ROLE_EXECUTE || Gp_role == GP_ROLE_UTILITY);
 	Assert(RelationIsAoCols(aorel));
@@ -347,13 +350,24 @@ AOCSSegmentFileFullCompaction(Relation aorel,
 	estate->es_num_result_relations = 1;
 	estate->es_result_relation_info = resultRelInfo;
 
+	/* All the columns are read */
+	for (i = 0; i < fsinfo->vpinfo.nEntry; i++)
+		eof += fsinfo->vpinfo.entry[i].eof;
+	AppendOnlyCompaction_BeginProgress(&progress, aorel, compact_segno,
+									   insertDesc->cur_segno,
+									   fsinfo->total_tupcount, eof,
+									   elevel);
+
 	aocs_getnext(scanDesc, ForwardScanDirection, slot);
 	while (!TupIsNull(slot))
 	{
+		bool		visible;
+
 		CHECK_FOR_INTERRUPTS();
 
 		aoTupleId = (AOTupleId *) slot_get_ctid(slot);
-		if (AppendOnlyVisimap_IsVisible(&scanDesc->visibilityMap, aoTupleId))
+		visible = AppendOnlyVisimap_IsVisible(&scanDesc->visibilityMap, aoTupleId);
+		if (visible)
 		{
 			AOCSMoveTuple(
 						  slot,
@@ -372,6 +386,7 @@ AOCSSegmentFileFullCompaction(Relation aorel,
 									 slot,
 									 mt_bind);
 		}
+		AppendOnlyCompaction_CountTuple(&progress, visible);
 
 		/*
 		 * Check for vacuum delay point after approximatly a var block
@@ -405,6 +420,7 @@ AOCSSegmentFileFullCompaction(Relation aorel,
 		   "Finished compaction: "
 		   "AO segfile %d, relation %s, moved tuple count " INT64_FORMAT,
 		   compact_segno, relname, movedTupleCount);
+	AppendOnlyCompaction_EndProgress(&progress);
 
 	AppendOnlyVisimap_Finish(&visiMap, NoLock);
 
@@ -508,6 +524,8 @@ AOCSDrop(Relation aorel,
   * When the insert segno is negative, only truncate to eof operations
  * can be executed.
  *
+ * The rows moved out of each compacted segment file are reported at elevel.
+ *
  * The caller is required to hold either an AccessExclusiveLock (vacuum full)
  * or a ShareLock on the relation.
  */
@@ -515,7 +533,8 @@ void
 AOCSCompact(Relation aorel,
 			List *compaction_segno,
 			int insert_segno,
-			bool isFull)
+			bool isFull,
+			int elevel)
 {
 	const char *relname;
 	int			total_segfiles;
@@ -594,7 +613,7 @@ AOCSCompact(Relation aorel,
 		if (AppendOnlyCompaction_ShouldCompact(aorel,
 											   fsinfo->segno, fsinfo->total_tupcount, isFull))
 		{
-			AOCSSegmentFileFullCompaction(aorel, insertDesc, fsinfo);
+			AOCSSegmentFileFullCompaction(aorel, insertDesc, fsinfo, elevel);
 		}
 
 		pfree(fsinfo);
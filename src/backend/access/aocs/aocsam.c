@@ -159,6 +159,7 @@ open_ds_write(Relation rel, DatumStreamWrite **ds, TupleDesc relationTupleDesc,
 
 		ds[i] = create_datumstreamwrite(ct,
 										clvl,
+										opts[i]->dictionary,
 										checksum,
 										 /* safeFSWriteSize */ 0,	/* UNDONE: Need to wire
 																	 * down pg_appendonly
@@ -274,6 +275,202 @@ aocs_initscan(AOCSScanDesc scan)
 	pgstat_count_heap_scan(scan->aos_rel);
 }
 
+static int
+compare_skip_ranges(const void *a, const void *b)
+{
+	const AppendOnlyBlockSkipRange *range1 = (const AppendOnlyBlockSkipRange *) a;
+	const AppendOnlyBlockSkipRange *range2 = (const AppendOnlyBlockSkipRange *) b;
+
+	if (range1->firstRowNum < range2->firstRowNum)
+		return -1;
+	if (range1->firstRowNum > range2->firstRowNum)
+		return 1;
+	return 0;
+}
+
+/*
+ * Find the row ranges of a segment file that the zone map rules out. Each
+ * key column has block directory entries of its own, so the ranges found
+ * for the different columns are merged by row number; the file offsets of
+ * the merged ranges are meaningless.
+ */
+static void
+load_zonemap_skip_ranges(AOCSScanDesc scan, AOCSFileSegInfo *segInfo)
+{
+	int			keyNo;
+	int			rangeNo;
+	int			nranges = 0;
+
+	if (scan->skip_ranges != NULL)
+	{
+		pfree(scan->skip_ranges);
+		scan->skip_ranges = NULL;
+	}
+	scan->nskip_ranges = 0;
+	scan->next_skip_range = 0;
+	scan->last_row_num = 0;
+
+	for (keyNo = 0; keyNo < scan->zonemap_nkeys; keyNo++)
+	{
+		AttrNumber	attno = scan->zonemap_keys[keyNo].sk_attno;
+		AppendOnlyBlockSkipRange *ranges;
+		int			ncolranges;
+		int			i;
+
+		/* Only look at each key column once. */
+		for (i = 0; i < keyNo; i++)
+		{
+			if (scan->zonemap_keys[i].sk_attno == attno)
+				break;
+		}
+		if (i < keyNo)
+			continue;
+
+		ranges = AppendOnlyBlockDirectory_GetSkipRanges(scan->aos_rel,
+														scan->appendOnlyMetaDataSnapshot,
+														segInfo->segno,
+														attno - 1,
+														getAOCSVPEntry(segInfo, attno - 1)->eof,
+														scan->zonemap_nkeys,
+														scan->zonemap_keys,
+														&ncolranges);
+		if (ncolranges == 0)
+			continue;
+
+		if (scan->skip_ranges == NULL)
+		{
+			scan->skip_ranges = ranges;
+			nranges = ncolranges;
+		}
+		else
+		{
+			scan->skip_ranges = repalloc(scan->skip_ranges,
+										 sizeof(AppendOnlyBlockSkipRange) *
+										 (nranges + ncolranges));
+			memcpy(&scan->skip_ranges[nranges], ranges,
+				   sizeof(AppendOnlyBlockSkipRange) * ncolranges);
+			nranges += ncolranges;
+			pfree(ranges);
+		}
+	}
+
+	if (nranges == 0)
+		return;
+
+	/* A row is ruled out if any key column rules it out. */
+	qsort(scan->skip_ranges, nranges, sizeof(AppendOnlyBlockSkipRange),
+		  compare_skip_ranges);
+	scan->nskip_ranges = 1;
+	for (rangeNo = 1; rangeNo < nranges; rangeNo++)
+	{
+		AppendOnlyBlockSkipRange *last = &scan->skip_ranges[scan->nskip_ranges - 1];
+		AppendOnlyBlockSkipRange *range = &scan->skip_ranges[rangeNo];
+
+		if (range->firstRowNum <= last->afterRowNum)
+			last->afterRowNum = Max(last->afterRowNum, range->afterRowNum);
+		else
+			scan->skip_ranges[scan->nskip_ranges++] = *range;
+	}
+}
+
+/*
+ * Returns the zone map skip range that covers the next row of the current
+ * segment file, or NULL if the zone map doesn't rule it out.
+ */
+static AppendOnlyBlockSkipRange *
+next_zonemap_skip_range(AOCSScanDesc scan)
+{
+	int64		nextRowNum = scan->last_row_num + 1;
+	AppendOnlyBlockSkipRange *range;
+
+	while (scan->next_skip_range < scan->nskip_ranges &&
+		   scan->skip_ranges[scan->next_skip_range].afterRowNum <= nextRowNum)
+		scan->next_skip_range++;
+
+	if (scan->next_skip_range >= scan->nskip_ranges)
+		return NULL;
+
+	range = &scan->skip_ranges[scan->next_skip_range];
+	if (range->firstRowNum > nextRowNum)
+		return NULL;
+
+	return range;
+}
+
+/*
+ * The columns read with each row of the current segment file: all projected
+ * columns, or only the early ones if the late ones are read late.
+ */
+static inline int
+get_row_atts(AOCSScanDesc scan, int **atts)
+{
+	if (scan->late_seg)
+	{
+		*atts = scan->early_atts;
+		return scan->num_early_atts;
+	}
+
+	*atts = scan->proj_atts;
+	return scan->num_proj_atts;
+}
+
+/*
+ * If the zone map rules out the next row of the current segment file, skip
+ * the columns read with each row past the rows it rules out, without reading
+ * their blocks. Late columns skip them when they are read. Returns false if
+ * that reaches the end of the segment file.
+ */
+static bool
+skip_zonemap_rows(AOCSScanDesc scan)
+{
+	AppendOnlyBlockSkipRange *range;
+	int		   *atts;
+	int			natts;
+	int			i;
+
+	range = next_zonemap_skip_range(scan);
+	if (range == NULL)
+		return true;
+
+	scan->next_skip_range++;
+	scan->skipped_ranges++;
+#ifdef FAULT_INJECTOR
+	FaultInjector_InjectFaultIfSet(AppendOnlyZoneMapSkip,
+								   DDLNotSpecified,
+								   "" /* databaseName */ ,
+								   RelationGetRelationName(scan->aos_rel));
+#endif
+
+	natts = get_row_atts(scan, &atts);
+	for (i = 0; i < natts; i++)
+	{
+		if (datumstreamread_skip_to_row(scan->ds[atts[i]],
+										range->afterRowNum) < 0)
+			return false;
+	}
+	scan->last_row_num = range->afterRowNum - 1;
+
+	return true;
+}
+
+/*
+ * Do the blocks of the segment file just opened store their row numbers?
+ * The late columns find the rows of a batch by them, so a segment file
+ * without them has all its columns read with each row. Looks at the first
+ * block of an early column, which the scan goes on to read anyway.
+ */
+static bool
+scan_seg_has_row_nums(AOCSScanDesc scan)
+{
+	int			attno = scan->early_atts[0];
+	DatumStreamRead *ds = scan->ds[attno];
+
+	if (datumstreamread_block(ds, scan->blockDirectory, attno) < 0)
+		return true;
+
+	return ds->getBlockInfo.firstRow >= 0;
+}
+
 static int
 open_next_scan_seg(AOCSScanDesc scan)
 {
@@ -350,6 +547,17 @@ open_next_scan_seg(AOCSScanDesc scan)
 												  scan->num_proj_atts,
 												  scan->blockDirectory);
 
+				load_zonemap_skip_ranges(scan, curSegInfo);
+
+				/*
+				 * Reading columns late relies on the row numbers stored in
+				 * the blocks, which pre-4.0 blocks lack. Files of older
+				 * format versions are upgraded a row at a time anyway.
+				 */
+				scan->late_seg = (scan->num_late_atts > 0 &&
+								  curSegInfo->formatversion == AORelationVersion_GetLatest() &&
+								  scan_seg_has_row_nums(scan));
+
 				return scan->cur_seg;
 			}
 		}
@@ -513,6 +721,70 @@ aocs_rescan(AOCSScanDesc scan)
 	aocs_initscan(scan);
 }
 
+/*
+ * Set the projected columns to read late: only when the caller asks for
+ * them with aocs_batch_late_values(), for rows of the last batch read by
+ * aocs_getnext_batch(). The other columns are read with each row as usual.
+ * Must be called before the first row is read, and the scan must then be
+ * read with aocs_getnext_batch() only.
+ *
+ * This pays off when a qual on the early columns rejects most rows: the late
+ * columns are only decoded for the rows that pass it, and their blocks that
+ * hold no such row are skipped without being read.
+ */
+void
+aocs_setlatecolumns(AOCSScanDesc scan, bool *late)
+{
+	int			i;
+
+	Assert(scan->cur_seg < 0);
+
+	/* A scan that builds the block directory must see every block */
+	if (scan->blockDirectory != NULL)
+		return;
+
+	if (scan->early_atts == NULL)
+	{
+		scan->early_atts = palloc(sizeof(int) * scan->num_proj_atts);
+		scan->late_atts = palloc(sizeof(int) * scan->num_proj_atts);
+	}
+	scan->num_early_atts = 0;
+	scan->num_late_atts = 0;
+
+	for (i = 0; i < scan->num_proj_atts; i++)
+	{
+		int			attno = scan->proj_atts[i];
+
+		if (late[attno])
+			scan->late_atts[scan->num_late_atts++] = attno;
+		else
+			scan->early_atts[scan->num_early_atts++] = attno;
+	}
+
+	/* Something has to be read with each row */
+	Assert(scan->num_early_atts > 0);
+}
+
+/*
+ * Set the keys used to skip blocks with the zone map, see
+ * appendonly_setzonemapkeys().
+ */
+void
+aocs_setzonemapkeys(AOCSScanDesc scan, int nkeys, ScanKey keys)
+{
+	if (scan->zonemap_keys != NULL)
+		pfree(scan->zonemap_keys);
+	scan->zonemap_keys = NULL;
+	scan->zonemap_nkeys = 0;
+
+	if (nkeys > 0 && gp_appendonly_zonemap)
+	{
+		scan->zonemap_keys = (ScanKey) palloc(sizeof(ScanKeyData) * nkeys);
+		memcpy(scan->zonemap_keys, keys, sizeof(ScanKeyData) * nkeys);
+		scan->zonemap_nkeys = nkeys;
+	}
+}
+
 void
 aocs_endscan(AOCSScanDesc scan)
 {
@@ -523,6 +795,27 @@ aocs_endscan(AOCSScanDesc scan)
 	close_cur_scan_seg(scan);
 	close_ds_read(scan->ds, scan->relationTupleDesc->natts);
 
+	elogif(Debug_appendonly_print_scan && scan->zonemap_nkeys > 0, LOG,
+		   "Append-only column-oriented scan of table '%s' skipped " INT64_FORMAT " row ranges using the zone map",
+		   NameStr(scan->aos_rel->rd_rel->relname),
+		   scan->skipped_ranges);
+	elogif(Debug_appendonly_print_scan && scan->num_late_atts > 0, LOG,
+		   "Append-only column-oriented scan of table '%s' read %d late columns for " INT64_FORMAT " of " INT64_FORMAT " rows",
+		   NameStr(scan->aos_rel->rd_rel->relname),
+		   scan->num_late_atts, scan->late_rows_read, scan->rows_read);
+
+	if (scan->zonemap_keys)
+		pfree(scan->zonemap_keys);
+	if (scan->skip_ranges)
+		pfree(scan->skip_ranges);
+	if (scan->run_ids)
+		pfree(scan->run_ids);
+	if (scan->early_atts)
+	{
+		pfree(scan->early_atts);
+		pfree(scan->late_atts);
+	}
+
 	pfree(scan->proj_atts);
 	pfree(scan->ds);
 
@@ -546,8 +839,8 @@ aocs_endscan(AOCSScanDesc scan)
  * Upgrades a Datum value from a previous version of the AOCS page format. The
  * DatumStreamRead that is passed must correspond to the column being upgraded.
  */
-static void upgrade_datum_impl(DatumStreamRead *ds, int attno, Datum values[],
-							   bool isnull[], int formatversion)
+static void upgrade_datum_impl(DatumStreamRead *ds, Datum *value, bool isnull,
+							   int formatversion)
 {
 	bool 	convert_numeric = false;
 
@@ -565,7 +858,7 @@ static void upgrade_datum_impl(DatumStreamRead *ds, int attno, Datum values[],
 		}
 
 		/* If this Datum is a numeric, we need to convert it. */
-		convert_numeric = (ds->baseTypeOid == NUMERICOID) && !isnull[attno];
+		convert_numeric = (ds->baseTypeOid == NUMERICOID) && !isnull;
 	}
 
 	if (convert_numeric)
@@ -585,7 +878,7 @@ static void upgrade_datum_impl(DatumStreamRead *ds, int attno, Datum values[],
 		 * to it won't be affected. Store it in the upgrade space for this
 		 * DatumStream.
 		 */
-		datum = values[attno];
+		datum = *value;
 		datalen = VARSIZE_ANY(DatumGetPointer(datum));
 
 		upgradedata = datumstreamread_get_upgrade_space(ds, datalen);
@@ -599,66 +892,110 @@ static void upgrade_datum_impl(DatumStreamRead *ds, int attno, Datum values[],
 		memcpy(&numericdata[2], &tmp, 2);
 
 		/* Re-point the Datum to the upgraded numeric. */
-		values[attno] = PointerGetDatum(upgradedata);
+		*value = PointerGetDatum(upgradedata);
 	}
 }
 
-static void upgrade_datum_scan(AOCSScanDesc scan, int attno, Datum values[],
-							   bool isnull[], int formatversion)
+static void upgrade_datum_scan(AOCSScanDesc scan, int attno, Datum *value,
+							   bool isnull, int formatversion)
 {
-	upgrade_datum_impl(scan->ds[attno], attno, values, isnull, formatversion);
+	upgrade_datum_impl(scan->ds[attno], value, isnull, formatversion);
 }
 
 static void upgrade_datum_fetch(AOCSFetchDesc fetch, int attno, Datum values[],
 								bool isnull[], int formatversion)
 {
-	upgrade_datum_impl(fetch->datumStreamFetchDesc[attno]->datumStream, attno,
-					   values, isnull, formatversion);
+	upgrade_datum_impl(fetch->datumStreamFetchDesc[attno]->datumStream,
+					   &values[attno], isnull[attno], formatversion);
 }
 
-void
-aocs_getnext(AOCSScanDesc scan, ScanDirection direction, TupleTableSlot *slot)
+/*
+ * Read the next visible row of the scan. The value of column attno is stored
+ * in d[attno * stride] and null[attno * stride].
+ *
+ * If stopAtBlockEnd is true, return false instead of reading the row if that
+ * would move any column to another block. The by-reference datums of earlier
+ * rows point into the current blocks, so this keeps them valid.
+ *
+ * If runs is not NULL, the run id of each value is stored in
+ * runs[attno * stride] too, see aocs_getnext_batch().
+ *
+ * In a segment file whose late columns are read late, only the early
+ * columns are read here.
+ *
+ * Returns false at the end of the scan.
+ */
+static inline bool
+aocs_read_next_row(AOCSScanDesc scan, Datum *d, bool *null, uint32 *runs,
+				   int stride, bool stopAtBlockEnd)
 {
-	int			ncol;
-	Datum	   *d = slot_get_values(slot);
-	bool	   *null = slot_get_isnull(slot);
 	AOTupleId	aoTupleId;
 	int64		rowNum = INT64CONST(-1);
 	int			err = 0;
 	int			i;
 	bool		isSnapshotAny = (scan->snapshot == SnapshotAny);
 
-	Assert(ScanDirectionIsForward(direction));
-
-	ncol = slot->tts_tupleDescriptor->natts;
-	Assert(ncol <= scan->relationTupleDesc->natts);
-
 	while (1)
 	{
 		AOCSFileSegInfo *curseginfo;
+		int		   *atts;
+		int			natts;
 
 ReadNext:
 		/* If necessary, open next seg */
 		if (scan->cur_seg < 0 || err < 0)
 		{
+			Assert(!stopAtBlockEnd);
+
 			err = open_next_scan_seg(scan);
 			if (err < 0)
 			{
 				/* No more seg, we are at the end */
-				ExecClearTuple(slot);
 				scan->cur_seg = -1;
-				return;
+				return false;
 			}
 			scan->cur_seg_row = 0;
 		}
 
 		Assert(scan->cur_seg >= 0);
 		curseginfo = scan->seginfo[scan->cur_seg];
+		natts = get_row_atts(scan, &atts);
+
+		if (stopAtBlockEnd)
+		{
+			/* Upgraded datums share one buffer per column */
+			if (curseginfo->formatversion < AORelationVersion_GetLatest())
+				return false;
+
+			if (scan->nskip_ranges > 0 && next_zonemap_skip_range(scan) != NULL)
+				return false;
+
+			for (i = 0; i < natts; i++)
+			{
+				if (datumstreamread_block_remaining(scan->ds[atts[i]]) <= 0)
+					return false;
+			}
+		}
+
+		if (scan->nskip_ranges > 0 && !skip_zonemap_rows(scan))
+		{
+			close_cur_scan_seg(scan);
+			err = -1;
+			goto ReadNext;
+		}
 
 		/* Read from cur_seg */
-		for (i = 0; i < scan->num_proj_atts; i++)
+		for (i = 0; i < natts; i++)
 		{
-			int			attno = scan->proj_atts[i];
+			int			attno = atts[i];
+
+			/*
+			 * Only trust the RLE state within a batch, where nothing but
+			 * datumstreamread_advance() has moved the stream since the last
+			 * datum we read.
+			 */
+			bool		repeats = (runs != NULL && stopAtBlockEnd &&
+								   datumstreamread_next_repeats(scan->ds[attno]));
 
 			err = datumstreamread_advance(scan->ds[attno]);
 			Assert(err >= 0);
@@ -676,20 +1013,40 @@ ReadNext:
 
 				err = datumstreamread_advance(scan->ds[attno]);
 				Assert(err > 0);
+				repeats = false;
 			}
 
 			/*
 			 * Get the column's datum right here since the data structures
 			 * should still be hot in CPU data cache memory.
 			 */
-			datumstreamread_get(scan->ds[attno], &d[attno], &null[attno]);
+			datumstreamread_get(scan->ds[attno], &d[attno * stride],
+								&null[attno * stride]);
+
+			if (runs != NULL)
+			{
+				if (datumstreamread_has_dictionary(scan->ds[attno]))
+				{
+					/* The dictionary codes are run ids too */
+					runs[attno * stride] = null[attno * stride] ?
+						scan->ds[attno]->blockRead.dict_count :
+						datumstreamread_dict_code(scan->ds[attno]);
+				}
+				else
+				{
+					if (!repeats)
+						scan->run_ids[attno]++;
+					runs[attno * stride] = scan->run_ids[attno];
+				}
+			}
 
 			/*
 			 * Perform any required upgrades on the Datum we just fetched.
 			 */
 			if (curseginfo->formatversion < AORelationVersion_GetLatest())
 			{
-				upgrade_datum_scan(scan, attno, d, null,
+				upgrade_datum_scan(scan, attno, &d[attno * stride],
+								   null[attno * stride],
 								   curseginfo->formatversion);
 			}
 
@@ -702,6 +1059,19 @@ ReadNext:
 			}
 		}
 
+		/*
+		 * Zone map skipping needs the row numbers stored in the blocks, and
+		 * so does reading columns late, which open_next_scan_seg() only
+		 * does in segment files that have them.
+		 */
+		if (rowNum == INT64CONST(-1))
+		{
+			Assert(!scan->late_seg);
+			scan->nskip_ranges = 0;
+		}
+		else
+			scan->last_row_num = rowNum;
+
 		AOTupleIdInit_Init(&aoTupleId);
 		AOTupleIdInit_segmentFileNum(&aoTupleId, curseginfo->segno);
 
@@ -721,14 +1091,142 @@ ReadNext:
 			goto ReadNext;
 		}
 		scan->cdb_fake_ctid = *((ItemPointer) &aoTupleId);
+		return true;
+	}
+
+	Assert(!"Never here");
+	return false;
+}
+
+void
+aocs_getnext(AOCSScanDesc scan, ScanDirection direction, TupleTableSlot *slot)
+{
+	int			ncol;
+
+	Assert(ScanDirectionIsForward(direction));
+
+	ncol = slot->tts_tupleDescriptor->natts;
+	Assert(ncol <= scan->relationTupleDesc->natts);
 
-		TupSetVirtualTupleNValid(slot, ncol);
-		slot_set_ctid(slot, &(scan->cdb_fake_ctid));
+	if (!aocs_read_next_row(scan, slot_get_values(slot), slot_get_isnull(slot),
+							NULL, 1, false))
+	{
+		ExecClearTuple(slot);
 		return;
 	}
 
-	Assert(!"Never here");
-	return;
+	TupSetVirtualTupleNValid(slot, ncol);
+	slot_set_ctid(slot, &(scan->cdb_fake_ctid));
+}
+
+/*
+ * Read up to maxrows rows of the scan in column-major order: the value of
+ * column attno in the i'th row goes to values[attno * maxrows + i], its
+ * tuple id to ctids[i]. Only the projected columns are filled in.
+ *
+ * If runs is not NULL, runs[attno * maxrows + i] is set to a run id of the
+ * value: two consecutive rows of the batch with the same run id are known to
+ * have the same value, because the second one was stored as a repeat of the
+ * first by RLE_TYPE compression. The ids mean nothing else, except for the
+ * columns whose block is dictionary encoded, see aocs_batch_dictionary().
+ *
+ * A batch ends early where any column moves on to its next block, so that
+ * the by-reference datums in the batch stay valid until the next call.
+ *
+ * If some columns are read late, see aocs_setlatecolumns(), only the early
+ * columns are filled in, and only they end the batch early, unless the
+ * batch comes from a segment file where all columns are read with each row.
+ *
+ * Returns the number of rows read, 0 at the end of the scan.
+ */
+int
+aocs_getnext_batch(AOCSScanDesc scan, int maxrows, Datum *values,
+				   bool *isnull, uint32 *runs, ItemPointerData *ctids)
+{
+	int			nrows = 0;
+
+	if (runs != NULL && scan->run_ids == NULL)
+		scan->run_ids = (uint32 *) palloc0(sizeof(uint32) * scan->relationTupleDesc->natts);
+
+	while (nrows < maxrows &&
+		   aocs_read_next_row(scan, values + nrows, isnull + nrows,
+							  runs ? runs + nrows : NULL, maxrows,
+							  nrows > 0))
+	{
+		ctids[nrows++] = scan->cdb_fake_ctid;
+	}
+
+	if (scan->late_seg)
+		scan->rows_read += nrows;
+
+	return nrows;
+}
+
+/*
+ * Read the values of the late columns for a row of the last batch read by
+ * aocs_getnext_batch(), given its tuple id, into values[attno] and
+ * isnull[attno]. The rows of a batch must be asked for in order. The values
+ * stay valid until the next call.
+ *
+ * The late columns skip the rows before it, and their blocks that end before
+ * it are skipped without being read.
+ *
+ * Returns false, without reading anything, if the batch came from a segment
+ * file where the late columns were read with each row into the batch.
+ */
+bool
+aocs_batch_late_values(AOCSScanDesc scan, ItemPointer ctid, Datum *values,
+					   bool *isnull)
+{
+	int64		rowNum;
+	int			i;
+
+	if (!scan->late_seg)
+		return false;
+
+	rowNum = AOTupleIdGet_rowNum((AOTupleId *) ctid);
+
+	for (i = 0; i < scan->num_late_atts; i++)
+	{
+		int			attno = scan->late_atts[i];
+		DatumStreamRead *ds = scan->ds[attno];
+
+		if (datumstreamread_skip_to_row(ds, rowNum) < 0 ||
+			datumstreamread_advance(ds) == 0 ||
+			ds->blockFirstRowNum + datumstreamread_nth(ds) != rowNum)
+			elog(ERROR, "could not find row " INT64_FORMAT " in column %d of append-only column-oriented table '%s'",
+				 rowNum, attno + 1, NameStr(scan->aos_rel->rd_rel->relname));
+
+		datumstreamread_get(ds, &values[attno], &isnull[attno]);
+	}
+
+	scan->late_rows_read++;
+
+	return true;
+}
+
+/*
+ * If the current block of column attno, which must not be a late column, is
+ * dictionary encoded, return the number of its dictionary entries, and set
+ * *entries to their values and *generation to a number that changes
+ * whenever the dictionary does. Otherwise return 0.
+ *
+ * For such a column, the run ids of the last batch read by
+ * aocs_getnext_batch() are the dictionary codes of the values: the index of
+ * the value in *entries, or the number of entries for NULLs.
+ */
+int
+aocs_batch_dictionary(AOCSScanDesc scan, int attno, Datum **entries,
+					  uint32 *generation)
+{
+	DatumStreamRead *ds = scan->ds[attno];
+
+	if (ds == NULL || !datumstreamread_has_dictionary(ds))
+		return 0;
+
+	*entries = ds->blockRead.dict_entries;
+	*generation = ds->blockRead.dict_generation;
+	return ds->blockRead.dict_count;
 }
 
 
@@ -968,6 +1466,9 @@ aocs_insert_values(AOCSInsertDesc idesc, Datum *d, bool *null, AOTupleId *aoTupl
 			}
 		}
 
+		AppendOnlyBlockDirectory_AddZoneValue(&idesc->blockDirectory, i, 0,
+											  d[i], null[i]);
+
 		if (toFree1 != NULL)
 			pfree(toFree1);
 	}
@@ -1838,7 +2339,8 @@ aocs_addcol_init(Relation rel,
 		ct = opts[iattr]->compresstype;
 		clvl = opts[iattr]->compresslevel;
 		blksz = opts[iattr]->blocksize;
-		desc->dsw[i] = create_datumstreamwrite(ct, clvl, rel->rd_appendonly->checksum, 0, blksz /* safeFSWriteSize */ ,
+		desc->dsw[i] = create_datumstreamwrite(ct, clvl, opts[iattr]->dictionary,
+											   rel->rd_appendonly->checksum, 0, blksz /* safeFSWriteSize */ ,
 											   attr, RelationGetRelationName(rel),
 											   titleBuf.data, rel->rd_istemp);
 	}
@@ -73,10 +73,12 @@ test__aocs_addcol_init(void **state)
 	opts[3]->compresstype = "rle_type";
 	opts[3]->compresslevel = 2;
 	opts[3]->blocksize = 8192;
+	opts[3]->dictionary = true;
 	opts[4] = (StdRdOptions *) malloc(sizeof(StdRdOptions));
 	opts[4]->compresstype = "none";
 	opts[4]->compresslevel = 0;
 	opts[4]->blocksize = 8192 * 2;
+	opts[4]->dictionary = false;
 
 	/* One call to RelationGetAttributeOptions() */
 	expect_any(RelationGetAttributeOptions, rel);
@@ -87,6 +89,8 @@ test__aocs_addcol_init(void **state)
 	expect_string(create_datumstreamwrite, compName, "none");
 	expect_value(create_datumstreamwrite, compLevel, 2);
 	expect_value(create_datumstreamwrite, compLevel, 0);
+	expect_value(create_datumstreamwrite, dictionary, true);
+	expect_value(create_datumstreamwrite, dictionary, false);
 	expect_value_count(create_datumstreamwrite, checksum, true, 2);
 	expect_value_count(create_datumstreamwrite, safeFSWriteSize, 0, 2);
 	expect_value(create_datumstreamwrite, maxsz, 8192);
@@ -110,6 +114,49 @@ test__aocs_addcol_init(void **state)
 	assert_int_equal(desc->cur_segno, -1);
 }
 
+/*
+ * aocs_setlatecolumns()
+ *
+ * Verify that the projected columns are split into early and late ones, and
+ * that a scan building the block directory reads all columns with each row.
+ */
+void
+test__aocs_setlatecolumns(void **state)
+{
+	AOCSScanDescData scan;
+	int			proj_atts[] = {0, 2, 3, 5};
+	bool		late[] = {false, true, true, false, true, true};
+
+	memset(&scan, 0, sizeof(scan));
+	scan.cur_seg = -1;
+	scan.proj_atts = proj_atts;
+	scan.num_proj_atts = 4;
+
+	aocs_setlatecolumns(&scan, late);
+	assert_int_equal(scan.num_early_atts, 2);
+	assert_int_equal(scan.early_atts[0], 0);
+	assert_int_equal(scan.early_atts[1], 3);
+	assert_int_equal(scan.num_late_atts, 2);
+	assert_int_equal(scan.late_atts[0], 2);
+	assert_int_equal(scan.late_atts[1], 5);
+
+	/* the split can be changed before the scan starts */
+	late[3] = true;
+	aocs_setlatecolumns(&scan, late);
+	assert_int_equal(scan.num_early_atts, 1);
+	assert_int_equal(scan.num_late_atts, 3);
+
+	memset(&scan, 0, sizeof(scan));
+	scan.cur_seg = -1;
+	scan.proj_atts = proj_atts;
+	scan.num_proj_atts = 4;
+	scan.blockDirectory = (AppendOnlyBlockDirectory *) palloc0(sizeof(AppendOnlyBlockDirectory));
+
+	aocs_setlatecolumns(&scan, late);
+	assert_int_equal(scan.num_late_atts, 0);
+	assert_true(scan.early_atts == NULL);
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -117,7 +164,8 @@ main(int argc, char *argv[])
 
 	const		UnitTest tests[] = {
 		unit_test(test__aocs_begin_headerscan),
-		unit_test(test__aocs_addcol_init)
+		unit_test(test__aocs_addcol_init),
+		unit_test(test__aocs_setlatecolumns)
 	};
 
 	MemoryContextInit();
@@ -329,6 +329,123 @@ AppendOnlyThrowAwayTuple(Relation rel,
 		   AOTupleIdGet_segmentFileNum(oldAoTupleId), AOTupleIdGet_rowNum(oldAoTupleId));
 }
 
+/* Bytes read between two checks of the I/O rate limit */
+#define COMPACTION_CHECK_BYTES (64 * 1024)
+
+/*
+ * Starts tracking the compaction of segment file segno, which has
+ * total_tupcount tuples in eof bytes, into insert_segno.
+ */
+void
+AppendOnlyCompaction_BeginProgress(AppendOnlyCompactionProgress *progress,
+								   Relation aorel, int segno, int insert_segno,
+								   int64 total_tupcount, int64 eof, int elevel)
+{
+	MemSet(progress, 0, sizeof(AppendOnlyCompactionProgress));
+	progress->relname = RelationGetRelationName(aorel);
+	progress->segno = segno;
+	progress->insert_segno = insert_segno;
+	progress->elevel = elevel;
+	progress->total_tupcount = total_tupcount;
+	progress->eof = eof;
+
+	/*
+	 * Check about every COMPACTION_CHECK_BYTES, and at least every 1% of the
+	 * file for the progress messages.
+	 */
+	if (total_tupcount > 0 && eof > 0)
+	{
+		progress->checkInterval = Min((int64) ((double) total_tupcount * COMPACTION_CHECK_BYTES / eof),
+									  total_tupcount / 100);
+		progress->checkInterval = Max(progress->checkInterval, 1);
+	}
+	else
+		progress->checkInterval = INT64_MAX;
+	progress->nextCheck = progress->checkInterval;
+
+	INSTR_TIME_SET_CURRENT(progress->startTime);
+}
+
+static int64
+AppendOnlyCompaction_BytesRead(AppendOnlyCompactionProgress *progress)
+{
+	/* The tuple count is only as good as pg_aoseg, don't go past the end */
+	if (progress->total_tupcount <= 0 ||
+		progress->tupleCount >= progress->total_tupcount)
+		return progress->eof;
+
+	return (int64) ((double) progress->eof * progress->tupleCount /
+					progress->total_tupcount);
+}
+
+/*
+ * Sleeps as long as the compaction is ahead of gp_appendonly_compaction_io_limit,
+ * and reports every 10% of the segment file.
+ */
+void
+AppendOnlyCompaction_CheckProgress(AppendOnlyCompactionProgress *progress)
+{
+	int64		bytesRead = AppendOnlyCompaction_BytesRead(progress);
+	int			percent;
+
+	progress->nextCheck = progress->tupleCount + progress->checkInterval;
+
+	if (gp_appendonly_compaction_io_limit > 0)
+	{
+		instr_time	elapsed;
+		double		elapsed_us;
+		double		expected_us;
+
+		INSTR_TIME_SET_CURRENT(elapsed);
+		INSTR_TIME_SUBTRACT(elapsed, progress->startTime);
+		elapsed_us = (double) INSTR_TIME_GET_MICROSEC(elapsed);
+		expected_us = (double) bytesRead * 1000000.0 /
+			((double) gp_appendonly_compaction_io_limit * 1024.0);
+
+		/*
+		 * Sleep at most a second at a time, so that a lowered limit or a
+		 * cancel doesn't wait for the whole backlog.
+		 */
+		if (expected_us > elapsed_us)
+			pg_usleep((long) Min(expected_us - elapsed_us, 1000000.0));
+	}
+
+	percent = progress->eof > 0 ? (int) (bytesRead * 100 / progress->eof) : 100;
+	if (percent >= progress->reportedPercent + 10)
+	{
+		progress->reportedPercent = percent - percent % 10;
+
+		elog(Debug_appendonly_print_compaction ? LOG : DEBUG1,
+			 "compacting segment file %d of relation \"%s\" into segment file %d: "
+			 "%d%% done, " INT64_FORMAT " rows moved, " INT64_FORMAT " dead rows removed",
+			 progress->segno, progress->relname, progress->insert_segno,
+			 progress->reportedPercent,
+			 progress->movedTupleCount, progress->droppedTupleCount);
+	}
+}
+
+/*
+ * Reports the totals of a finished segment file compaction.
+ */
+void
+AppendOnlyCompaction_EndProgress(AppendOnlyCompactionProgress *progress)
+{
+	instr_time	elapsed;
+	double		elapsed_sec;
+
+	INSTR_TIME_SET_CURRENT(elapsed);
+	INSTR_TIME_SUBTRACT(elapsed, progress->startTime);
+	elapsed_sec = INSTR_TIME_GET_DOUBLE(elapsed);
+
+	ereport(progress->elevel,
+			(errmsg("compacted segment file %d of relation \"%s\" into segment file %d",
+					progress->segno, progress->relname, progress->insert_segno),
+			 errdetail(INT64_FORMAT " rows moved, " INT64_FORMAT " dead rows removed, "
+					   INT64_FORMAT " kB read in %.2f s.",
+					   progress->movedTupleCount, progress->droppedTupleCount,
+					   AppendOnlyCompaction_BytesRead(progress) / 1024, elapsed_sec)));
+}
+
 /*
  * Assumes that the segment file lock is already held.
  * Assumes that the segment file should be compacted.
@@ -337,7 +454,8 @@ AppendOnlyThrowAwayTuple(Relation rel,
 static void
 AppendOnlySegmentFileFullCompaction(Relation aorel,
 									AppendOnlyInsertDesc insertDesc,
-									FileSegInfo *fsinfo)
+									FileSegInfo *fsinfo,
+									int elevel)
 {
 	const char *relname;
 	AppendOnlyVisimap visiMap;
@@ -353,6 +471,7 @@ AppendOnlySegmentFileFullCompaction(Relation aorel,
 	AOTupleId  *aoTupleId;
 	int64		tupleCount = 0;
 	int64		tuplePerPage = INT_MAX;
+	AppendOnlyCompactionProgress progress;
 
 	Assert(Gp_role == GP_ROLE_EXECUTE || Gp_role == GP_ROLE_UTILITY);
 	Assert(RelationIsAoRows(aorel));
@@ -403,16 +522,24 @@ AppendOnlySegmentFileFullCompaction(Relation aorel,
 	estate->es_num_result_relations = 1;
 	estate->es_result_relation_info = resultRelInfo;
 
+	AppendOnlyCompaction_BeginProgress(&progress, aorel, compact_segno,
+									   insertDesc->storageWrite.segmentFileNum,
+									   fsinfo->total_tupcount, fsinfo->eof,
+									   elevel);
+
 	/*
 	 * Go through all visible tuples and move them to a new segfile.
 	 */
 	while ((tuple = appendonly_getnext(scanDesc, ForwardScanDirection, slot)) != NULL)
 	{
+		bool		visible;
+
 		/* Check interrupts as this may take time. */
 		CHECK_FOR_INTERRUPTS();
 
 		aoTupleId = (AOTupleId *) slot_get_ctid(slot);
-		if (AppendOnlyVisimap_IsVisible(&scanDesc->visibilityMap, aoTupleId))
+		visible = AppendOnlyVisimap_IsVisible(&scanDesc->visibilityMap, aoTupleId);
+		if (visible)
 		{
 			AppendOnlyMoveTuple(tuple,
 								slot,
@@ -430,6 +557,7 @@ AppendOnlySegmentFileFullCompaction(Relation aorel,
 									 slot,
 									 mt_bind);
 		}
+		AppendOnlyCompaction_CountTuple(&progress, visible);
 
 		/*
 		 * Check for vacuum delay point after approximately a var block
@@ -458,6 +586,7 @@ AppendOnlySegmentFileFullCompaction(Relation aorel,
 		   "Finished compaction: "
 		   "AO segfile %d, relation %s, moved tuple count " INT64_FORMAT,
 		   compact_segno, relname, movedTupleCount);
+	AppendOnlyCompaction_EndProgress(&progress);
 
 	AppendOnlyVisimap_Finish(&visiMap, NoLock);
 
@@ -658,6 +787,8 @@ AppendOnlyTruncateToEOF(Relation aorel)
   * When the insert segno is negative, only truncate to eof operations
  * can be executed.
  *
+ * The rows moved out of each compacted segment file are reported at elevel.
+ *
  * The caller is required to hold either an AccessExclusiveLock (vacuum full)
  * or a ShareLock on the relation.
  */
@@ -665,7 +796,8 @@ void
 AppendOnlyCompact(Relation aorel,
 				  List *compaction_segno,
 				  int insert_segno,
-				  bool isFull)
+				  bool isFull,
+				  int elevel)
 {
 	const char *relname;
 	int			total_segfiles;
@@ -735,7 +867,8 @@ AppendOnlyCompact(Relation aorel,
 		{
 			AppendOnlySegmentFileFullCompaction(aorel,
 												insertDesc,
-												fsinfo);
+												fsinfo,
+												elevel);
 		}
 		pfree(fsinfo);
 	}
@@ -336,6 +336,25 @@ SetNextFileSegForRead(AppendOnlyScanDesc scan)
 												 &scan->executorReadBlock,
 												  /* blockFirstRowNum */ 1);
 
+	/* Find the blocks that the zone map rules out. */
+	if (scan->aos_skip_ranges != NULL)
+	{
+		pfree(scan->aos_skip_ranges);
+		scan->aos_skip_ranges = NULL;
+	}
+	scan->aos_nskip_ranges = 0;
+	scan->aos_next_skip_range = 0;
+	if (scan->aos_zonemap_nkeys > 0)
+		scan->aos_skip_ranges =
+			AppendOnlyBlockDirectory_GetSkipRanges(reln,
+												   scan->appendOnlyMetaDataSnapshot,
+												   segno,
+												   0,	/* columnGroupNo */
+												   eof,
+												   scan->aos_zonemap_nkeys,
+												   scan->aos_zonemap_keys,
+												   &scan->aos_nskip_ranges);
+
 	/* ready to go! */
 	scan->aos_need_new_segfile = false;
 
@@ -1238,6 +1257,33 @@ AppendOnlyExecutorReadBlock_FetchTuple(AppendOnlyExecutorReadBlock *executorRead
 
 /* ------------------------------------------------------------------------------ */
 
+/*
+ * Return the zone map skip range that starts at the block just found by
+ * getNextBlock(), or NULL if the block has to be read.
+ */
+static AppendOnlyBlockSkipRange *
+getZoneMapSkipRange(AppendOnlyScanDesc scan)
+{
+	int64		headerOffsetInFile = scan->executorReadBlock.headerOffsetInFile;
+	AppendOnlyBlockSkipRange *skipRange;
+
+	while (scan->aos_next_skip_range < scan->aos_nskip_ranges &&
+		   scan->aos_skip_ranges[scan->aos_next_skip_range].afterFileOffset <=
+		   headerOffsetInFile)
+		scan->aos_next_skip_range++;
+
+	if (scan->aos_next_skip_range >= scan->aos_nskip_ranges)
+		return NULL;
+
+	skipRange = &scan->aos_skip_ranges[scan->aos_next_skip_range];
+	if (skipRange->fileOffset != headerOffsetInFile)
+		return NULL;
+
+	scan->aos_next_skip_range++;
+
+	return skipRange;
+}
+
 /*
  * You can think of this scan routine as get next "executor" AO block.
  */
@@ -1253,19 +1299,52 @@ getNextBlock(AppendOnlyScanDesc scan)
 			return false;
 	}
 
-	if (!AppendOnlyExecutorReadBlock_GetBlockInfo(
-												  &scan->storageRead,
-												  &scan->executorReadBlock))
+	while (true)
 	{
-		if (scan->blockDirectory)
+		AppendOnlyBlockSkipRange *skipRange;
+
+		if (!AppendOnlyExecutorReadBlock_GetBlockInfo(
+													  &scan->storageRead,
+													  &scan->executorReadBlock))
 		{
-			AppendOnlyBlockDirectory_End_forInsert(scan->blockDirectory);
+			if (scan->blockDirectory)
+			{
+				AppendOnlyBlockDirectory_End_forInsert(scan->blockDirectory);
+			}
+
+			/* done reading the file */
+			CloseScannedFileSeg(scan);
+
+			return false;
 		}
 
-		/* done reading the file */
-		CloseScannedFileSeg(scan);
+		skipRange = getZoneMapSkipRange(scan);
+		if (skipRange == NULL)
+			break;
+
+		/*
+		 * The zone map rules out this block and the rest of its block
+		 * directory range, seek past them without reading their contents.
+		 */
+		scan->aos_skipped_blocks++;
+#ifdef FAULT_INJECTOR
+		FaultInjector_InjectFaultIfSet(AppendOnlyZoneMapSkip,
+									   DDLNotSpecified,
+									   "" /* databaseName */ ,
+									   RelationGetRelationName(scan->aos_rd));
+#endif
+		if (skipRange->afterFileOffset >= scan->storageRead.logicalEof)
+		{
+			CloseScannedFileSeg(scan);
 
-		return false;
+			return false;
+		}
+
+		AppendOnlyExecutionReadBlock_SetPositionInfo(&scan->executorReadBlock,
+													 skipRange->afterRowNum);
+		AppendOnlyStorageRead_SetTemporaryRange(&scan->storageRead,
+												skipRange->afterFileOffset,
+												scan->storageRead.logicalEof);
 	}
 
 	if (scan->blockDirectory)
@@ -1364,6 +1443,33 @@ appendonlygettup(AppendOnlyScanDesc scan,
 
 }
 
+/*
+ * Add the zone map columns of a tuple that was placed in the current
+ * VarBlock to the block directory.
+ */
+static void
+addZoneValues(AppendOnlyInsertDesc aoInsertDesc, MemTuple tup)
+{
+	AppendOnlyBlockDirectory *blockDirectory = &aoInsertDesc->blockDirectory;
+	MinipagePerColumnGroup *minipageInfo;
+	int			zoneNo;
+
+	if (blockDirectory->blkdirRel == NULL)
+		return;
+
+	minipageInfo = &blockDirectory->minipages[0];
+	for (zoneNo = 0; zoneNo < minipageInfo->numZoneColumns; zoneNo++)
+	{
+		Datum		value;
+		bool		isnull;
+
+		value = memtuple_getattr(tup, aoInsertDesc->mt_bind,
+								 minipageInfo->zoneAttnums[zoneNo], &isnull);
+		AppendOnlyBlockDirectory_AddZoneValue(blockDirectory, 0, zoneNo,
+											  value, isnull);
+	}
+}
+
 static void
 cancelLastBuffer(AppendOnlyInsertDesc aoInsertDesc)
 {
@@ -1746,6 +1852,32 @@ appendonly_rescan(AppendOnlyScanDesc scan,
 	initscan(scan, key);
 }
 
+/* ----------------
+ *		appendonly_setzonemapkeys	- set the keys used to skip blocks
+ *
+ * The keys are checked against the zone map in the block directory, and
+ * blocks in which no row can satisfy all of them are not read at all. The
+ * keys are not checked against the rows that are read; sk_func of each key
+ * is the btree comparison function of the column's type. Has no effect for
+ * tables without a block directory.
+ * ----------------
+ */
+void
+appendonly_setzonemapkeys(AppendOnlyScanDesc scan, int nkeys, ScanKey keys)
+{
+	if (scan->aos_zonemap_keys != NULL)
+		pfree(scan->aos_zonemap_keys);
+	scan->aos_zonemap_keys = NULL;
+	scan->aos_zonemap_nkeys = 0;
+
+	if (nkeys > 0 && gp_appendonly_zonemap)
+	{
+		scan->aos_zonemap_keys = (ScanKey) palloc(sizeof(ScanKeyData) * nkeys);
+		memcpy(scan->aos_zonemap_keys, keys, sizeof(ScanKeyData) * nkeys);
+		scan->aos_zonemap_nkeys = nkeys;
+	}
+}
+
 /* ----------------
  *		appendonly_endscan	- end relation scan
  * ----------------
@@ -1758,6 +1890,16 @@ appendonly_endscan(AppendOnlyScanDesc scan)
 	if (scan->aos_key)
 		pfree(scan->aos_key);
 
+	elogif(Debug_appendonly_print_scan && scan->aos_zonemap_nkeys > 0, LOG,
+		   "Append-only scan of table '%s' skipped " INT64_FORMAT " block ranges using the zone map",
+		   NameStr(scan->aos_rd->rd_rel->relname),
+		   scan->aos_skipped_blocks);
+
+	if (scan->aos_zonemap_keys)
+		pfree(scan->aos_zonemap_keys);
+	if (scan->aos_skip_ranges)
+		pfree(scan->aos_skip_ranges);
+
 	if (scan->aos_segfile_arr)
 	{
 		for (int seginfo_no = 0; seginfo_no < scan->aos_total_segfiles; seginfo_no++)
@@ -2986,6 +3128,8 @@ appendonly_insert(AppendOnlyInsertDesc aoInsertDesc,
 
 		if (itemLen > 0)
 			memcpy(itemPtr, tup, itemLen);
+
+		addZoneValues(aoInsertDesc, tup);
 	}
 	else
 	{
@@ -3015,6 +3159,12 @@ appendonly_insert(AppendOnlyInsertDesc aoInsertDesc,
 		Assert(aoInsertDesc->nonCompressedData == NULL);
 		Assert(!AppendOnlyStorageWrite_IsBufferAllocated(&aoInsertDesc->storageWrite));
 
+		/*
+		 * Large content gets no block directory entry of its own, it falls
+		 * in the range of the latest one.
+		 */
+		AppendOnlyBlockDirectory_InvalidateZoneMap(&aoInsertDesc->blockDirectory, 0);
+
 		setupNextWriteBlock(aoInsertDesc);
 	}
 
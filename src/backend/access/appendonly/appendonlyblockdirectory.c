@@ -24,10 +24,12 @@
 #include "utils/memutils.h"
 #include "utils/guc.h"
 #include "utils/fmgroids.h"
+#include "utils/typcache.h"
 #include "cdb/cdbappendonlyam.h"
 
 int			gp_blockdirectory_entry_min_range = 0;
 int			gp_blockdirectory_minipage_size = NUM_MINIPAGE_ENTRIES;
+bool		gp_appendonly_zonemap = true;
 
 static inline uint32
 minipage_size(uint32 nEntry)
@@ -36,6 +38,21 @@ minipage_size(uint32 nEntry)
 		sizeof(MinipageEntry) * nEntry;
 }
 
+static inline uint32
+minipage_zonemap_size(uint32 nEntry, int numZoneColumns)
+{
+	return minipage_size(nEntry) + sizeof(MinipageZoneHeader) +
+		sizeof(MinipageZone) * nEntry * numZoneColumns;
+}
+
+static inline int
+zonemap_compare(FmgrInfo *cmpProc, int64 value1, int64 value2)
+{
+	return DatumGetInt32(FunctionCall2(cmpProc,
+									   (Datum) value1,
+									   (Datum) value2));
+}
+
 static void load_last_minipage(
 				   AppendOnlyBlockDirectory *blockDirectory,
 				   int64 lastSequence,
@@ -62,6 +79,15 @@ static bool insert_new_entry(AppendOnlyBlockDirectory *blockDirectory,
 				 int64 fileOffset,
 				 int64 rowCount,
 				 bool addColAction);
+static void init_zonemap(AppendOnlyBlockDirectory *blockDirectory);
+static void zonemap_take_pending(MinipagePerColumnGroup *minipageInfo,
+					 int entryNo,
+					 int64 rowCount,
+					 bool merge);
+static bool zonemap_excludes(MinipageZoneHeader *header,
+				 MinipageZone *zones,
+				 int nkeys,
+				 ScanKey keys);
 
 void
 AppendOnlyBlockDirectoryEntry_GetBeginRange(
@@ -270,6 +296,7 @@ AppendOnlyBlockDirectory_Init_forInsert(
 		index_open(aoRel->rd_appendonly->blkdiridxid, RowExclusiveLock);
 
 	init_internal(blockDirectory);
+	init_zonemap(blockDirectory);
 
 	ereportif(Debug_appendonly_print_blockdirectory, LOG,
 			  (errmsg("Append-only block directory init for insert: "
@@ -732,7 +759,11 @@ insert_new_entry(
 
 		if (gp_blockdirectory_entry_min_range > 0 &&
 			fileOffset - entry->fileOffset < gp_blockdirectory_entry_min_range)
+		{
+			/* The rows of the new block now belong to the latest entry. */
+			zonemap_take_pending(minipageInfo, lastEntryNo, rowCount, true);
 			return true;
+		}
 
 		/* Update the rowCount in the latest entry */
 		Assert(entry->rowCount <= firstRowNum - entry->firstRowNum);
@@ -773,6 +804,9 @@ insert_new_entry(
 	entry->fileOffset = fileOffset;
 	entry->rowCount = rowCount;
 
+	zonemap_take_pending(minipageInfo, minipageInfo->numMinipageEntries,
+						 rowCount, false);
+
 	minipageInfo->numMinipageEntries++;
 
 	ereportif(Debug_appendonly_print_blockdirectory, LOG,
@@ -785,6 +819,435 @@ insert_new_entry(
 	return true;
 }
 
+/*
+ * init_zonemap
+ *
+ * Choose the columns whose values are summarized in the zone map of each
+ * column group: the column itself for column-oriented tables, and the first
+ * MAX_ZONEMAP_COLUMNS eligible columns for row-oriented ones. Only
+ * pass-by-value types with a default btree opclass are eligible.
+ */
+static void
+init_zonemap(AppendOnlyBlockDirectory *blockDirectory)
+{
+	TupleDesc	tupleDesc = RelationGetDescr(blockDirectory->aoRel);
+	int			groupNo;
+
+	if (!gp_appendonly_zonemap)
+		return;
+
+	for (groupNo = 0; groupNo < blockDirectory->numColumnGroups; groupNo++)
+	{
+		MinipagePerColumnGroup *minipageInfo =
+		&blockDirectory->minipages[groupNo];
+		AttrNumber	firstAttno;
+		AttrNumber	lastAttno;
+		AttrNumber	attno;
+
+		if (blockDirectory->isAOCol)
+			firstAttno = lastAttno = groupNo + 1;
+		else
+		{
+			firstAttno = 1;
+			lastAttno = tupleDesc->natts;
+		}
+
+		for (attno = firstAttno;
+			 attno <= lastAttno &&
+			 minipageInfo->numZoneColumns < MAX_ZONEMAP_COLUMNS;
+			 attno++)
+		{
+			Form_pg_attribute attr = tupleDesc->attrs[attno - 1];
+			TypeCacheEntry *typentry;
+			int			zoneNo;
+
+			if (attr->attisdropped || !attr->attbyval || attr->attlen <= 0)
+				continue;
+
+			typentry = lookup_type_cache(attr->atttypid,
+										 TYPECACHE_CMP_PROC_FINFO);
+			if (!OidIsValid(typentry->cmp_proc_finfo.fn_oid))
+				continue;
+
+			zoneNo = minipageInfo->numZoneColumns++;
+			minipageInfo->zoneAttnums[zoneNo] = attno;
+			minipageInfo->zoneCmpProcs[zoneNo] = &typentry->cmp_proc_finfo;
+		}
+
+		if (minipageInfo->numZoneColumns > 0)
+			minipageInfo->zones = (MinipageZone *)
+				MemoryContextAllocZero(blockDirectory->memoryContext,
+									   sizeof(MinipageZone) *
+									   NUM_MINIPAGE_ENTRIES *
+									   minipageInfo->numZoneColumns);
+	}
+}
+
+/*
+ * zonemap_take_pending
+ *
+ * Move the summaries of the rows added since the last entry was inserted
+ * into the given entry. If merge is true, the entry already has rows of its
+ * own and the new block with rowCount rows is merged into it.
+ *
+ * The result is only usable if every row of the block was summarized.
+ */
+static void
+zonemap_take_pending(MinipagePerColumnGroup *minipageInfo,
+					 int entryNo,
+					 int64 rowCount,
+					 bool merge)
+{
+	int			numZoneColumns = minipageInfo->numZoneColumns;
+	int			zoneNo;
+
+	for (zoneNo = 0; zoneNo < numZoneColumns; zoneNo++)
+	{
+		MinipageZone *pending = &minipageInfo->pendingZones[zoneNo];
+		MinipageZone *zone = &minipageInfo->zones[entryNo * numZoneColumns + zoneNo];
+		FmgrInfo   *cmpProc = minipageInfo->zoneCmpProcs[zoneNo];
+
+		if (pending->nullCount + pending->valueCount != rowCount ||
+			(merge && zone->nullCount + zone->valueCount == 0))
+		{
+			MemSet(zone, 0, sizeof(MinipageZone));
+		}
+		else if (!merge || zone->valueCount == 0)
+		{
+			int32		nullCount = merge ? zone->nullCount : 0;
+
+			*zone = *pending;
+			zone->nullCount += nullCount;
+		}
+		else
+		{
+			if (pending->valueCount > 0)
+			{
+				if (zonemap_compare(cmpProc, pending->minValue, zone->minValue) < 0)
+					zone->minValue = pending->minValue;
+				if (zonemap_compare(cmpProc, pending->maxValue, zone->maxValue) > 0)
+					zone->maxValue = pending->maxValue;
+			}
+			zone->nullCount += pending->nullCount;
+			zone->valueCount += pending->valueCount;
+		}
+
+		MemSet(pending, 0, sizeof(MinipageZone));
+	}
+}
+
+/*
+ * AppendOnlyBlockDirectory_AddZoneValue
+ *
+ * Add the value of a zone map column of a newly inserted row to the summary
+ * of the block being written. The summary becomes part of the entry that
+ * the next AppendOnlyBlockDirectory_InsertEntry() call for the column group
+ * inserts, so a row must be added after the block it is written to has been
+ * started.
+ */
+void
+AppendOnlyBlockDirectory_AddZoneValue(AppendOnlyBlockDirectory *blockDirectory,
+									  int columnGroupNo,
+									  int zoneColumnNo,
+									  Datum value,
+									  bool isnull)
+{
+	MinipagePerColumnGroup *minipageInfo;
+	MinipageZone *zone;
+	FmgrInfo   *cmpProc;
+
+	if (blockDirectory->blkdirRel == NULL)
+		return;
+
+	minipageInfo = &blockDirectory->minipages[columnGroupNo];
+	if (zoneColumnNo >= minipageInfo->numZoneColumns)
+		return;
+
+	zone = &minipageInfo->pendingZones[zoneColumnNo];
+	if (isnull)
+	{
+		zone->nullCount++;
+		return;
+	}
+
+	cmpProc = minipageInfo->zoneCmpProcs[zoneColumnNo];
+	if (zone->valueCount == 0)
+	{
+		zone->minValue = (int64) value;
+		zone->maxValue = (int64) value;
+	}
+	else if (zonemap_compare(cmpProc, (int64) value, zone->minValue) < 0)
+		zone->minValue = (int64) value;
+	else if (zonemap_compare(cmpProc, (int64) value, zone->maxValue) > 0)
+		zone->maxValue = (int64) value;
+
+	zone->valueCount++;
+}
+
+/*
+ * AppendOnlyBlockDirectory_InvalidateZoneMap
+ *
+ * Mark the summaries of the latest entry of a column group as unusable.
+ * Used when rows are written into the file range of that entry without
+ * adding them to its summaries.
+ */
+void
+AppendOnlyBlockDirectory_InvalidateZoneMap(AppendOnlyBlockDirectory *blockDirectory,
+										   int columnGroupNo)
+{
+	MinipagePerColumnGroup *minipageInfo;
+
+	if (blockDirectory->blkdirRel == NULL)
+		return;
+
+	minipageInfo = &blockDirectory->minipages[columnGroupNo];
+	if (minipageInfo->numZoneColumns == 0 ||
+		minipageInfo->numMinipageEntries == 0)
+		return;
+
+	MemSet(&minipageInfo->zones[(minipageInfo->numMinipageEntries - 1) *
+								minipageInfo->numZoneColumns],
+		   0, sizeof(MinipageZone) * minipageInfo->numZoneColumns);
+}
+
+/*
+ * zonemap_excludes
+ *
+ * Return true if the zone map summaries of an entry show that none of its
+ * rows can satisfy all of the scan keys.
+ */
+static bool
+zonemap_excludes(MinipageZoneHeader *header,
+				 MinipageZone *zones,
+				 int nkeys,
+				 ScanKey keys)
+{
+	int			keyNo;
+
+	for (keyNo = 0; keyNo < nkeys; keyNo++)
+	{
+		ScanKey		key = &keys[keyNo];
+		MinipageZone zone;
+		int			columnNo;
+		int			cmpMin;
+		int			cmpMax;
+
+		for (columnNo = 0; columnNo < header->numColumns; columnNo++)
+		{
+			if (header->attnum[columnNo] == key->sk_attno)
+				break;
+		}
+		if (columnNo == header->numColumns)
+			continue;
+
+		memcpy(&zone, &zones[columnNo], sizeof(MinipageZone));
+		if (zone.nullCount + zone.valueCount == 0)
+			continue;
+
+		if (key->sk_flags & SK_SEARCHNULL)
+		{
+			if (zone.nullCount == 0)
+				return true;
+			continue;
+		}
+		if (key->sk_flags & SK_SEARCHNOTNULL)
+		{
+			if (zone.valueCount == 0)
+				return true;
+			continue;
+		}
+		if (key->sk_flags & SK_ISNULL)
+			continue;
+
+		/* Strict operators never match nulls. */
+		if (zone.valueCount == 0)
+			return true;
+
+		cmpMin = zonemap_compare(&key->sk_func, zone.minValue,
+								 (int64) key->sk_argument);
+		cmpMax = zonemap_compare(&key->sk_func, zone.maxValue,
+								 (int64) key->sk_argument);
+
+		switch (key->sk_strategy)
+		{
+			case BTLessStrategyNumber:
+				if (cmpMin >= 0)
+					return true;
+				break;
+			case BTLessEqualStrategyNumber:
+				if (cmpMin > 0)
+					return true;
+				break;
+			case BTEqualStrategyNumber:
+				if (cmpMin > 0 || cmpMax < 0)
+					return true;
+				break;
+			case BTGreaterEqualStrategyNumber:
+				if (cmpMax < 0)
+					return true;
+				break;
+			case BTGreaterStrategyNumber:
+				if (cmpMax <= 0)
+					return true;
+				break;
+			default:
+				break;
+		}
+	}
+
+	return false;
+}
+
+/*
+ * AppendOnlyBlockDirectory_GetSkipRanges
+ *
+ * Return the ranges of blocks of a segment file and column group, in file
+ * order, whose zone map summaries show that none of their rows can satisfy
+ * all of the given scan keys. The number of ranges is returned in *nranges.
+ *
+ * The keys are zone map keys: sk_func is the btree comparison function of
+ * the column's type, and sk_argument must be of that type. Keys on columns
+ * that are not summarized are ignored.
+ */
+AppendOnlyBlockSkipRange *
+AppendOnlyBlockDirectory_GetSkipRanges(Relation aoRel,
+									   Snapshot appendOnlyMetaDataSnapshot,
+									   int segno,
+									   int columnGroupNo,
+									   int64 eof,
+									   int nkeys,
+									   ScanKey keys,
+									   int *nranges)
+{
+	Relation	blkdirRel;
+	Relation	blkdirIdx;
+	TupleDesc	heapTupleDesc;
+	ScanKeyData scanKeys[2];
+	IndexScanDesc idxScanDesc;
+	HeapTuple	tuple;
+	AppendOnlyBlockSkipRange *ranges = NULL;
+	int			maxRanges = 0;
+	MinipageEntry lastEntry;
+	bool		haveLastEntry = false;
+	bool		lastExcluded = false;
+
+	*nranges = 0;
+	MemSet(&lastEntry, 0, sizeof(MinipageEntry));
+
+	if (nkeys == 0 || !OidIsValid(aoRel->rd_appendonly->blkdirrelid))
+		return NULL;
+
+	blkdirRel = heap_open(aoRel->rd_appendonly->blkdirrelid, AccessShareLock);
+	blkdirIdx = index_open(aoRel->rd_appendonly->blkdiridxid, AccessShareLock);
+	heapTupleDesc = RelationGetDescr(blkdirRel);
+
+	ScanKeyInit(&scanKeys[0],
+				Anum_pg_aoblkdir_segno,
+				BTEqualStrategyNumber, F_INT4EQ,
+				Int32GetDatum(segno));
+	ScanKeyInit(&scanKeys[1],
+				Anum_pg_aoblkdir_columngroupno,
+				BTEqualStrategyNumber, F_INT4EQ,
+				Int32GetDatum(columnGroupNo));
+
+	/* The index returns the minipages in firstrownum order. */
+	idxScanDesc = index_beginscan(blkdirRel, blkdirIdx,
+								  appendOnlyMetaDataSnapshot,
+								  2, scanKeys);
+
+	while ((tuple = index_getnext(idxScanDesc, ForwardScanDirection)) != NULL)
+	{
+		struct varlena *value;
+		Minipage   *minipage;
+		MinipageZoneHeader header;
+		MinipageZone *zones = NULL;
+		bool		isnull;
+		uint32		entryNo;
+
+		value = (struct varlena *)
+			DatumGetPointer(heap_getattr(tuple, Anum_pg_aoblkdir_minipage,
+										 heapTupleDesc, &isnull));
+		Assert(!isnull);
+		minipage = (Minipage *) pg_detoast_datum(value);
+
+		if (minipage->version == MINIPAGE_VERSION_ZONEMAP)
+		{
+			char	   *trailer = (char *) minipage + minipage_size(minipage->nEntry);
+
+			memcpy(&header, trailer, sizeof(MinipageZoneHeader));
+			zones = (MinipageZone *) (trailer + sizeof(MinipageZoneHeader));
+		}
+
+		for (entryNo = 0; entryNo < minipage->nEntry; entryNo++)
+		{
+			MinipageEntry *entry = &minipage->entry[entryNo];
+
+			/* Entries past the EOF are left over from aborted inserts. */
+			if (entry->fileOffset >= eof)
+				break;
+
+			if (haveLastEntry && lastExcluded)
+			{
+				if (*nranges == maxRanges)
+				{
+					maxRanges = (maxRanges == 0) ? 64 : maxRanges * 2;
+					ranges = (ranges == NULL) ?
+						palloc(sizeof(AppendOnlyBlockSkipRange) * maxRanges) :
+						repalloc(ranges, sizeof(AppendOnlyBlockSkipRange) * maxRanges);
+				}
+				ranges[*nranges].fileOffset = lastEntry.fileOffset;
+				ranges[*nranges].afterFileOffset = entry->fileOffset;
+				ranges[*nranges].firstRowNum = lastEntry.firstRowNum;
+				ranges[*nranges].afterRowNum = entry->firstRowNum;
+				(*nranges)++;
+			}
+
+			lastEntry = *entry;
+			haveLastEntry = true;
+			lastExcluded = false;
+			if (zones != NULL)
+			{
+				MinipageZone *entryZones = (MinipageZone *)
+				((char *) zones + entryNo * header.numColumns * sizeof(MinipageZone));
+
+				lastExcluded = zonemap_excludes(&header, entryZones, nkeys, keys);
+			}
+		}
+
+		if ((struct varlena *) minipage != value)
+			pfree(minipage);
+	}
+
+	index_endscan(idxScanDesc);
+
+	/* The last entry covers the rest of the file. */
+	if (haveLastEntry && lastExcluded)
+	{
+		if (*nranges == maxRanges)
+		{
+			maxRanges++;
+			ranges = (ranges == NULL) ?
+				palloc(sizeof(AppendOnlyBlockSkipRange) * maxRanges) :
+				repalloc(ranges, sizeof(AppendOnlyBlockSkipRange) * maxRanges);
+		}
+		ranges[*nranges].fileOffset = lastEntry.fileOffset;
+		ranges[*nranges].afterFileOffset = eof;
+		ranges[*nranges].firstRowNum = lastEntry.firstRowNum;
+		ranges[*nranges].afterRowNum = lastEntry.firstRowNum + lastEntry.rowCount;
+		(*nranges)++;
+	}
+
+	index_close(blkdirIdx, AccessShareLock);
+	heap_close(blkdirRel, AccessShareLock);
+
+	ereportif(Debug_appendonly_print_blockdirectory, LOG,
+			  (errmsg("Append-only block directory zone map: "
+					  "(segno, columnGroupNo, nkeys, nranges) = (%d, %d, %d, %d)",
+					  segno, columnGroupNo, nkeys, *nranges)));
+
+	return ranges;
+}
+
 /*
  * AppendOnlyBlockDirectory_DeleteSegmentFile
  *
@@ -896,6 +1359,50 @@ init_scankeys(TupleDesc tupleDesc,
 	}
 }
 
+/*
+ * copy_out_zonemap
+ *
+ * Copy out the zone map of a minipage, for the columns summarized by this
+ * writer. Columns that the minipage has no summaries for are left unusable.
+ */
+static void
+copy_out_zonemap(MinipagePerColumnGroup *minipageInfo, Minipage *minipage)
+{
+	MinipageZoneHeader header;
+	char	   *zones;
+	int			numZoneColumns = minipageInfo->numZoneColumns;
+	int			zoneNo;
+	int			columnNo;
+	uint32		entryNo;
+
+	MemSet(minipageInfo->zones, 0,
+		   sizeof(MinipageZone) * minipage->nEntry * numZoneColumns);
+
+	if (minipage->version != MINIPAGE_VERSION_ZONEMAP)
+		return;
+
+	memcpy(&header, (char *) minipage + minipage_size(minipage->nEntry),
+		   sizeof(MinipageZoneHeader));
+	zones = (char *) minipage + minipage_size(minipage->nEntry) +
+		sizeof(MinipageZoneHeader);
+
+	for (zoneNo = 0; zoneNo < numZoneColumns; zoneNo++)
+	{
+		for (columnNo = 0; columnNo < header.numColumns; columnNo++)
+		{
+			if (header.attnum[columnNo] == minipageInfo->zoneAttnums[zoneNo])
+				break;
+		}
+		if (columnNo == header.numColumns)
+			continue;
+
+		for (entryNo = 0; entryNo < minipage->nEntry; entryNo++)
+			memcpy(&minipageInfo->zones[entryNo * numZoneColumns + zoneNo],
+				   zones + (entryNo * header.numColumns + columnNo) * sizeof(MinipageZone),
+				   sizeof(MinipageZone));
+	}
+}
+
 /*
  * copy_out_minipage
  *
@@ -908,21 +1415,26 @@ copy_out_minipage(MinipagePerColumnGroup *minipageInfo,
 {
 	struct varlena *value;
 	struct varlena *detoast_value;
+	Minipage   *minipage;
 
 	Assert(!minipage_isnull);
 
 	value = (struct varlena *)
 		DatumGetPointer(minipage_value);
 	detoast_value = pg_detoast_datum(value);
-	Assert(VARSIZE(detoast_value) <= minipage_size(NUM_MINIPAGE_ENTRIES));
+	minipage = (Minipage *) detoast_value;
 
-	memcpy(minipageInfo->minipage, detoast_value, VARSIZE(detoast_value));
-	if (detoast_value != value)
-		pfree(detoast_value);
+	Assert(minipage->nEntry <= NUM_MINIPAGE_ENTRIES);
 
-	Assert(minipageInfo->minipage->nEntry <= NUM_MINIPAGE_ENTRIES);
+	/* Any zone map follows the entries, copy it out separately. */
+	memcpy(minipageInfo->minipage, minipage, minipage_size(minipage->nEntry));
+	minipageInfo->numMinipageEntries = minipage->nEntry;
 
-	minipageInfo->numMinipageEntries = minipageInfo->minipage->nEntry;
+	if (minipageInfo->numZoneColumns > 0)
+		copy_out_zonemap(minipageInfo, minipage);
+
+	if (detoast_value != value)
+		pfree(detoast_value);
 }
 
 
@@ -1123,6 +1635,38 @@ find_minipage_entry(Minipage *minipage,
 		return -1;
 }
 
+/*
+ * form_zonemap_minipage
+ *
+ * Form a copy of the in-memory minipage followed by its zone map.
+ */
+static Minipage *
+form_zonemap_minipage(MinipagePerColumnGroup *minipageInfo)
+{
+	uint32		nEntry = minipageInfo->numMinipageEntries;
+	int			numZoneColumns = minipageInfo->numZoneColumns;
+	MinipageZoneHeader header;
+	Minipage   *minipage;
+	char	   *zones;
+
+	minipage = palloc(minipage_zonemap_size(nEntry, numZoneColumns));
+	memcpy(minipage, minipageInfo->minipage, minipage_size(nEntry));
+	SET_VARSIZE(minipage, minipage_zonemap_size(nEntry, numZoneColumns));
+	minipage->version = MINIPAGE_VERSION_ZONEMAP;
+
+	MemSet(&header, 0, sizeof(MinipageZoneHeader));
+	header.numColumns = numZoneColumns;
+	memcpy(header.attnum, minipageInfo->zoneAttnums,
+		   sizeof(AttrNumber) * numZoneColumns);
+
+	zones = (char *) minipage + minipage_size(nEntry);
+	memcpy(zones, &header, sizeof(MinipageZoneHeader));
+	memcpy(zones + sizeof(MinipageZoneHeader), minipageInfo->zones,
+		   sizeof(MinipageZone) * nEntry * numZoneColumns);
+
+	return minipage;
+}
+
 /*
  * write_minipage
  *
@@ -1138,6 +1682,7 @@ write_minipage(AppendOnlyBlockDirectory *blockDirectory,
 	bool	   *nulls = blockDirectory->nulls;
 	Relation	blkdirRel = blockDirectory->blkdirRel;
 	TupleDesc	heapTupleDesc = RelationGetDescr(blkdirRel);
+	Minipage   *minipage = minipageInfo->minipage;
 
 	Assert(minipageInfo->numMinipageEntries > 0);
 
@@ -1157,11 +1702,17 @@ write_minipage(AppendOnlyBlockDirectory *blockDirectory,
 		Int64GetDatum(minipageInfo->minipage->entry[0].firstRowNum);
 	nulls[Anum_pg_aoblkdir_firstrownum - 1] = false;
 
-	SET_VARSIZE(minipageInfo->minipage,
-				minipage_size(minipageInfo->numMinipageEntries));
-	minipageInfo->minipage->nEntry = minipageInfo->numMinipageEntries;
+	minipage->nEntry = minipageInfo->numMinipageEntries;
+	if (minipageInfo->numZoneColumns > 0)
+		minipage = form_zonemap_minipage(minipageInfo);
+	else
+	{
+		SET_VARSIZE(minipage,
+					minipage_size(minipageInfo->numMinipageEntries));
+		minipage->version = MINIPAGE_VERSION_PLAIN;
+	}
 	values[Anum_pg_aoblkdir_minipage - 1] =
-		PointerGetDatum(minipageInfo->minipage);
+		PointerGetDatum(minipage);
 	nulls[Anum_pg_aoblkdir_minipage - 1] = false;
 
 	tuple = heaptuple_form_to(heapTupleDesc,
@@ -1170,6 +1721,9 @@ write_minipage(AppendOnlyBlockDirectory *blockDirectory,
 							  NULL,
 							  NULL);
 
+	if (minipage != minipageInfo->minipage)
+		pfree(minipage);
+
 	/*
 	 * Write out the minipage to the block directory relation. If this
 	 * minipage is already in the relation, we update the row. Otherwise, a
@@ -774,8 +774,10 @@ RegisterSegnoForCompactionDrop(Oid relid, List *compactedSegmentFileList)
  * compaction run.
  *
  * If a list with more than one entry is returned, all these segments should be
- * compacted. This is only returned in utility mode as the usual ways to
- * determine a segment for compaction are not available.
+ * compacted. In utility mode, all segments are returned as the usual ways to
+ * determine a segment for compaction are not available. Otherwise, up to
+ * max_segnos available segments are returned, but a segment awaiting a drop
+ * is always returned alone.
  * If NIL is returned, no segment should be compacted. This usually
  * means that all segments are clean or empty.
  *
@@ -785,16 +787,20 @@ List *
 SetSegnoForCompaction(Relation rel,
 					  List *compactedSegmentFileList,
 					  List *insertedSegmentFileList,
+					  int max_segnos,
 					  bool *is_drop)
 {
 	TransactionId CurrentXid = GetTopTransactionId();
 	int			usesegno;
+	List	   *usesegnos = NIL;
+	ListCell   *lc;
 	int			i;
 	AORelHashEntryData *aoentry;
 	int64		segzero_tupcount = 0;
 
 	Assert(Gp_role != GP_ROLE_EXECUTE);
 	Assert(is_drop);
+	Assert(max_segnos > 0);
 	*is_drop = false;
 	if (Gp_role == GP_ROLE_UTILITY)
 	{
@@ -869,11 +875,12 @@ SetSegnoForCompaction(Relation rel,
 
 			*is_drop = true;
 			usesegno = i;
+			usesegnos = list_make1_int(usesegno);
 			break;
 		}
 	}
 
-	if (usesegno <= 0)
+	if (!*is_drop)
 	{
 		for (i = 0; i < MAX_AOREL_CONCURRENCY; i++)
 		{
@@ -899,19 +906,36 @@ SetSegnoForCompaction(Relation rel,
 				!in_compaction_list &&
 				!in_inserted_list)
 			{
-				usesegno = i;
-				break;
+				usesegnos = lappend_int(usesegnos, i);
+				if (list_length(usesegnos) >= max_segnos)
+					break;
 			}
 		}
 	}
 
-	if (usesegno != APPENDONLY_COMPACTION_SEGNO_INVALID)
+	/*
+	 * Mark the segnos as in use. Our transaction counts once in
+	 * txns_using_rel, however many segnos it uses.
+	 */
+	if (usesegnos != NIL)
 	{
-		/* mark this segno as in use */
-		if (aoentry->relsegfiles[usesegno].xid != CurrentXid)
+		bool		already_using = false;
+
+		foreach(lc, usesegnos)
+		{
+			if (aoentry->relsegfiles[lfirst_int(lc)].xid == CurrentXid)
+				already_using = true;
+		}
+		if (!already_using)
 		{
 			aoentry->txns_using_rel++;
 		}
+	}
+
+	foreach(lc, usesegnos)
+	{
+		usesegno = lfirst_int(lc);
+
 		if (*is_drop)
 		{
 			aoentry->relsegfiles[usesegno].state = PSEUDO_COMPACTION_USE;
@@ -931,7 +955,8 @@ SetSegnoForCompaction(Relation rel,
 						  aoentry->relsegfiles[usesegno].total_tupcount,
 						  aoentry->txns_using_rel)));
 	}
-	else
+
+	if (usesegnos == NIL)
 	{
 		ereportif(Debug_appendonly_print_segfile_choice, LOG,
 				  (errmsg("No compaction segment chosen for append-only relation \"%s\" (%d)",
@@ -940,13 +965,7 @@ SetSegnoForCompaction(Relation rel,
 
 	LWLockRelease(AOSegFileLock);
 
-	Assert(usesegno >= 0 || usesegno == APPENDONLY_COMPACTION_SEGNO_INVALID);
-
-	if (usesegno == APPENDONLY_COMPACTION_SEGNO_INVALID)
-	{
-		return NIL;
-	}
-	return lappend_int(NIL, usesegno);
+	return usesegnos;
 }
 
 /*
@@ -960,13 +979,17 @@ SetSegnoForCompaction(Relation rel,
  * Note that this code does not manipulate aoentry->txns_using_rel
  * as it has before been set by SetSegnoForCompaction.
  *
+ * If no segment is available, an error is raised, unless missing_ok is
+ * set, in which case InvalidFileSegNumber is returned.
+ *
  * Should only be called in DISPATCH and UTILITY mode.
  */
 int
 SetSegnoForCompactionInsert(Relation rel,
 							List *compacted_segno,
 							List *compactedSegmentFileList,
-							List *insertedSegmentFileList)
+							List *insertedSegmentFileList,
+							bool missing_ok)
 {
 	int			i,
 				usesegno = -1;
@@ -1041,6 +1064,8 @@ SetSegnoForCompactionInsert(Relation rel,
 	if (!segno_chosen)
 	{
 		LWLockRelease(AOSegFileLock);
+		if (missing_ok)
+			return InvalidFileSegNumber;
 		ereport(ERROR, (errmsg("could not find segment file to use for "
 							   "inserting into relation %s (%d).",
 							   RelationGetRelationName(rel), RelationGetRelid(rel))));
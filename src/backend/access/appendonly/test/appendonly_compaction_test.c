@@ -0,0 +1,116 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include "cmockery.h"
+
+#include "../appendonly_compaction.c"
+
+static void
+setup_relation(RelationData *reldata, FormData_pg_class *relform)
+{
+	MemSet(reldata, 0, sizeof(RelationData));
+	MemSet(relform, 0, sizeof(FormData_pg_class));
+	strcpy(NameStr(relform->relname), "ao");
+	reldata->rd_rel = relform;
+}
+
+void
+test__AppendOnlyCompaction_BeginProgress__CheckInterval(void **state)
+{
+	RelationData reldata;
+	FormData_pg_class relform;
+	AppendOnlyCompactionProgress progress;
+
+	setup_relation(&reldata, &relform);
+
+	/* 100 bytes per tuple: check every 64 kB */
+	AppendOnlyCompaction_BeginProgress(&progress, &reldata, 1, 2,
+									   1000000, 100000000, DEBUG2);
+	assert_int_equal(progress.checkInterval, 655);
+	assert_int_equal(progress.nextCheck, 655);
+
+	/* large tuples: check every tuple */
+	AppendOnlyCompaction_BeginProgress(&progress, &reldata, 1, 2,
+									   1000, 100000000, DEBUG2);
+	assert_int_equal(progress.checkInterval, 1);
+
+	/* small file: check every 1% */
+	AppendOnlyCompaction_BeginProgress(&progress, &reldata, 1, 2,
+									   100000, 1000000, DEBUG2);
+	assert_int_equal(progress.checkInterval, 1000);
+
+	/* no estimate, no checks */
+	AppendOnlyCompaction_BeginProgress(&progress, &reldata, 1, 2,
+									   0, 0, DEBUG2);
+	assert_true(progress.checkInterval == INT64_MAX);
+}
+
+void
+test__AppendOnlyCompaction_CountTuple__Progress(void **state)
+{
+	RelationData reldata;
+	FormData_pg_class relform;
+	AppendOnlyCompactionProgress progress;
+	int			i;
+
+	setup_relation(&reldata, &relform);
+	gp_appendonly_compaction_io_limit = 0;
+
+	AppendOnlyCompaction_BeginProgress(&progress, &reldata, 1, 2,
+									   100000, 1000000, DEBUG2);
+	for (i = 0; i < 25000; i++)
+		AppendOnlyCompaction_CountTuple(&progress, i % 5 != 0);
+
+	assert_int_equal(progress.tupleCount, 25000);
+	assert_int_equal(progress.movedTupleCount, 20000);
+	assert_int_equal(progress.droppedTupleCount, 5000);
+	assert_int_equal(progress.reportedPercent, 20);
+	assert_int_equal(AppendOnlyCompaction_BytesRead(&progress), 250000);
+
+	/* more tuples than pg_aoseg knew of don't read past the end */
+	for (i = 0; i < 100000; i++)
+		AppendOnlyCompaction_CountTuple(&progress, true);
+	assert_int_equal(AppendOnlyCompaction_BytesRead(&progress), 1000000);
+	assert_int_equal(progress.reportedPercent, 100);
+}
+
+void
+test__AppendOnlyCompaction_CountTuple__IoLimit(void **state)
+{
+	RelationData reldata;
+	FormData_pg_class relform;
+	AppendOnlyCompactionProgress progress;
+	instr_time	elapsed;
+	int			i;
+
+	setup_relation(&reldata, &relform);
+
+	/* 256 kB at 1 MB/s take a quarter of a second */
+	gp_appendonly_compaction_io_limit = 1024;
+	AppendOnlyCompaction_BeginProgress(&progress, &reldata, 1, 2,
+									   1024, 256 * 1024, DEBUG2);
+	for (i = 0; i < 1024; i++)
+		AppendOnlyCompaction_CountTuple(&progress, true);
+
+	INSTR_TIME_SET_CURRENT(elapsed);
+	INSTR_TIME_SUBTRACT(elapsed, progress.startTime);
+	assert_true(INSTR_TIME_GET_DOUBLE(elapsed) >= 0.24);
+
+	gp_appendonly_compaction_io_limit = 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+	cmockery_parse_arguments(argc, argv);
+
+	const		UnitTest tests[] = {
+		unit_test(test__AppendOnlyCompaction_BeginProgress__CheckInterval),
+		unit_test(test__AppendOnlyCompaction_CountTuple__Progress),
+		unit_test(test__AppendOnlyCompaction_CountTuple__IoLimit)
+	};
+
+	MemoryContextInit();
+
+	return run_tests(tests);
+}
@@ -0,0 +1,135 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include "cmockery.h"
+
+#include "../appendonlyblockdirectory.c"
+
+static void
+setup_zone(MinipageZoneHeader *header, MinipageZone *zone,
+		   int64 minValue, int64 maxValue, int32 nullCount, int32 valueCount)
+{
+	header->numColumns = 1;
+	header->attnum[0] = 1;
+
+	zone->minValue = minValue;
+	zone->maxValue = maxValue;
+	zone->nullCount = nullCount;
+	zone->valueCount = valueCount;
+}
+
+static void
+setup_key(ScanKey key, int flags, AttrNumber attno,
+		  StrategyNumber strategy, int64 argument)
+{
+	MemSet(key, 0, sizeof(ScanKeyData));
+	key->sk_flags = flags;
+	key->sk_attno = attno;
+	key->sk_strategy = strategy;
+	key->sk_argument = (Datum) argument;
+}
+
+/*
+ * Expect one call of the comparison function, returning the given result.
+ */
+static void
+expect_compare(int32 result)
+{
+	expect_any(FunctionCall2, flinfo);
+	expect_any(FunctionCall2, arg1);
+	expect_any(FunctionCall2, arg2);
+	will_return(FunctionCall2, Int32GetDatum(result));
+}
+
+void
+test__zonemap_excludes_unsummarized(void **state)
+{
+	MinipageZoneHeader header;
+	MinipageZone zone;
+	ScanKeyData key;
+
+	/* a key on a column without a summary never excludes anything */
+	setup_zone(&header, &zone, 10, 20, 0, 100);
+	setup_key(&key, 0, 2, BTEqualStrategyNumber, 30);
+	assert_false(zonemap_excludes(&header, &zone, 1, &key));
+
+	/* neither does an entry whose summary is not valid */
+	setup_zone(&header, &zone, 0, 0, 0, 0);
+	setup_key(&key, 0, 1, BTEqualStrategyNumber, 30);
+	assert_false(zonemap_excludes(&header, &zone, 1, &key));
+}
+
+void
+test__zonemap_excludes_nulls(void **state)
+{
+	MinipageZoneHeader header;
+	MinipageZone zone;
+	ScanKeyData key;
+
+	/* IS NULL on an entry without nulls */
+	setup_zone(&header, &zone, 10, 20, 0, 100);
+	setup_key(&key, SK_ISNULL | SK_SEARCHNULL, 1, InvalidStrategy, 0);
+	assert_true(zonemap_excludes(&header, &zone, 1, &key));
+
+	/* IS NOT NULL on an entry with nothing but nulls */
+	setup_zone(&header, &zone, 0, 0, 100, 0);
+	setup_key(&key, SK_ISNULL | SK_SEARCHNOTNULL, 1, InvalidStrategy, 0);
+	assert_true(zonemap_excludes(&header, &zone, 1, &key));
+
+	/* a comparison never matches an entry with nothing but nulls */
+	setup_key(&key, 0, 1, BTEqualStrategyNumber, 30);
+	assert_true(zonemap_excludes(&header, &zone, 1, &key));
+
+	/* IS NULL on an entry with some nulls */
+	setup_zone(&header, &zone, 10, 20, 1, 99);
+	setup_key(&key, SK_ISNULL | SK_SEARCHNULL, 1, InvalidStrategy, 0);
+	assert_false(zonemap_excludes(&header, &zone, 1, &key));
+}
+
+void
+test__zonemap_excludes_compare(void **state)
+{
+	MinipageZoneHeader header;
+	MinipageZone zone;
+	ScanKeyData key;
+
+	setup_zone(&header, &zone, 10, 20, 0, 100);
+
+	/* = 30, with min and max both below the argument */
+	setup_key(&key, 0, 1, BTEqualStrategyNumber, 30);
+	expect_compare(-1);
+	expect_compare(-1);
+	assert_true(zonemap_excludes(&header, &zone, 1, &key));
+
+	/* = 15, between min and max */
+	setup_key(&key, 0, 1, BTEqualStrategyNumber, 15);
+	expect_compare(-1);
+	expect_compare(1);
+	assert_false(zonemap_excludes(&header, &zone, 1, &key));
+
+	/* > 20, with max equal to the argument */
+	setup_key(&key, 0, 1, BTGreaterStrategyNumber, 20);
+	expect_compare(-1);
+	expect_compare(0);
+	assert_true(zonemap_excludes(&header, &zone, 1, &key));
+
+	/* <= 10, with min equal to the argument */
+	setup_key(&key, 0, 1, BTLessEqualStrategyNumber, 10);
+	expect_compare(0);
+	expect_compare(1);
+	assert_false(zonemap_excludes(&header, &zone, 1, &key));
+}
+
+int
+main(int argc, char *argv[])
+{
+	cmockery_parse_arguments(argc, argv);
+
+	const		UnitTest tests[] = {
+		unit_test(test__zonemap_excludes_unsummarized),
+		unit_test(test__zonemap_excludes_nulls),
+		unit_test(test__zonemap_excludes_compare),
+	};
+
+	return run_tests(tests);
+}
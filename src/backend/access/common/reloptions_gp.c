@@ -60,6 +60,14 @@ static relopt_bool boolRelOpts_gp[] =
 		},
 		AO_DEFAULT_CHECKSUM
 	},
+	{
+		{
+			SOPT_DICTIONARY,
+			"AOCS column dictionary encoding",
+			RELOPT_KIND_HEAP
+		},
+		AO_DEFAULT_DICTIONARY
+	},
 	/* list terminator */
 	{{NULL}}
 };
@@ -318,6 +326,7 @@ resetAOStorageOpts(StdRdOptions *ao_opts)
 	ao_opts->compresslevel = AO_DEFAULT_COMPRESSLEVEL;
 	ao_opts->compresstype = NULL;
 	ao_opts->orientation = NULL;
+	ao_opts->dictionary = AO_DEFAULT_DICTIONARY;
 }
 
 /*
@@ -749,6 +758,19 @@ transformAOStdRdOptions(StdRdOptions *opts, Datum withOpts)
 				astate = accumArrayResult(astate, PointerGetDatum(t), false,
 										  TEXTOID, CurrentMemoryContext);
 			}
+			soptLen = strlen(SOPT_DICTIONARY);
+			if (withLen > soptLen &&
+				pg_strncasecmp(strval, SOPT_DICTIONARY, soptLen) == 0)
+			{
+				strval = opts->dictionary ? "true" : "false";
+				len = VARHDRSZ + strlen(SOPT_DICTIONARY) + 1 + strlen(strval);
+				/* +1 leaves room for sprintf's trailing null */
+				t = (text *) palloc(len + 1);
+				SET_VARSIZE(t, len);
+				sprintf(VARDATA(t), "%s=%s", SOPT_DICTIONARY, strval);
+				astate = accumArrayResult(astate, PointerGetDatum(t), false,
+										  TEXTOID, CurrentMemoryContext);
+			}
 
 			/*
 			 * Record fillfactor only if it's specified in WITH clause.
@@ -882,6 +904,7 @@ validate_and_adjust_options(StdRdOptions *result,
 	relopt_value *complevel_opt;
 	relopt_value *checksum_opt;
 	relopt_value *orientation_opt;
+	relopt_value *dictionary_opt;
 
 	/* fillfactor */
 	fillfactor_opt = get_option_set(options, num_options, SOPT_FILLFACTOR);
@@ -1029,6 +1052,20 @@ validate_and_adjust_options(StdRdOptions *result,
 			result->compresslevel = setDefaultCompressionLevel(result->compresstype);
 		}
 
+		if (result->compresstype &&
+			(pg_strcasecmp(result->compresstype, "lz4") == 0) &&
+			(result->compresslevel > 9))
+		{
+			if (validate)
+				ereport(ERROR,
+						(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+						 errmsg("compresslevel=%d is out of range for lz4 "
+								"(should be in the range 1 to 9)",
+								result->compresslevel)));
+
+			result->compresslevel = setDefaultCompressionLevel(result->compresstype);
+		}
+
 		if (result->compresstype &&
 			(pg_strcasecmp(result->compresstype, "quicklz") == 0) &&
 			(result->compresslevel != 1))
@@ -1045,17 +1082,29 @@ validate_and_adjust_options(StdRdOptions *result,
 
 		if (result->compresstype &&
 			(pg_strcasecmp(result->compresstype, "rle_type") == 0) &&
-			(result->compresslevel > 4))
+			(result->compresslevel > 7))
 		{
 			if (validate)
 				ereport(ERROR,
 						(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
 						 errmsg("compresslevel=%d is out of range for rle_type "
-								"(should be in the range 1 to 4)",
+								"(should be in the range 1 to 7)",
 								result->compresslevel)));
 
 			result->compresslevel = setDefaultCompressionLevel(result->compresstype);
 		}
+
+#ifndef HAVE_LIBZSTD
+		/* compresslevel 5 to 7 of rle_type compress the blocks with zstd */
+		if (result->compresstype &&
+			(pg_strcasecmp(result->compresstype, "rle_type") == 0) &&
+			(result->compresslevel > 4) && validate)
+			ereport(ERROR,
+					(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+					 errmsg("compresslevel=%d of rle_type requires Zstandard compression",
+							result->compresslevel),
+					 errhint("Compile with --with-zstd to use Zstandard compression.")));
+#endif
 	}
 
 	/* checksum */
@@ -1120,6 +1169,38 @@ validate_and_adjust_options(StdRdOptions *result,
 		}
 	}
 
+	/* dictionary */
+	dictionary_opt = get_option_set(options, num_options, SOPT_DICTIONARY);
+	if (dictionary_opt != NULL)
+	{
+		if (!KIND_IS_RELATION(kind) && validate)
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("usage of parameter \"dictionary\" in a non "
+							"relation object is not supported")));
+
+		if (!result->appendonly && validate)
+			ereport(ERROR,
+					(errcode(ERRCODE_GP_FEATURE_NOT_SUPPORTED),
+					 errmsg("invalid option \"dictionary\" for base relation. "
+							"Only valid for Append Only relations")));
+
+		result->dictionary = dictionary_opt->values.bool_val;
+
+		/*
+		 * Only the dense datum stream blocks of rle_type columns have room
+		 * for a dictionary.
+		 */
+		if (result->dictionary &&
+			(result->compresstype == NULL ||
+			 pg_strcasecmp(result->compresstype, "rle_type") != 0) &&
+			validate)
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("dictionary encoding can only be used with "
+							"compresstype rle_type")));
+	}
+
 	if (result->appendonly && result->compresstype != NULL)
 		if (result->compresslevel == AO_DEFAULT_COMPRESSLEVEL)
 			result->compresslevel = setDefaultCompressionLevel(result->compresstype);
@@ -1215,7 +1296,8 @@ validateAppendOnlyRelOptions(bool ao,
 		(pg_strcasecmp(comptype, "quicklz") == 0 ||
 		 pg_strcasecmp(comptype, "zlib") == 0 ||
 		 pg_strcasecmp(comptype, "rle_type") == 0 ||
-		 pg_strcasecmp(comptype, "zstd") == 0))
+		 pg_strcasecmp(comptype, "zstd") == 0 ||
+		 pg_strcasecmp(comptype, "lz4") == 0))
 	{
 		if (!co &&
 			pg_strcasecmp(comptype, "rle_type") == 0)
@@ -1249,6 +1331,15 @@ validateAppendOnlyRelOptions(bool ao,
 							"(should be in the range 1 to 19)", complevel)));
 		}
 
+		if (comptype && (pg_strcasecmp(comptype, "lz4") == 0) &&
+			(complevel < 0 || complevel > 9))
+		{
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("compresslevel=%d is out of range for lz4 "
+							"(should be in the range 1 to 9)", complevel)));
+		}
+
 		if (comptype && (pg_strcasecmp(comptype, "quicklz") == 0) &&
 			(complevel != 1))
 		{
@@ -1258,13 +1349,24 @@ validateAppendOnlyRelOptions(bool ao,
 							"(should be 1)", complevel)));
 		}
 		if (comptype && (pg_strcasecmp(comptype, "rle_type") == 0) &&
-			(complevel < 0 || complevel > 4))
+			(complevel < 0 || complevel > 7))
 		{
 			ereport(ERROR,
 					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
 					 errmsg("compresslevel=%d is out of range for rle_type "
-							"(should be in the range 1 to 4)", complevel)));
+							"(should be in the range 1 to 7)", complevel)));
+		}
+#ifndef HAVE_LIBZSTD
+		if (comptype && (pg_strcasecmp(comptype, "rle_type") == 0) &&
+			complevel > 4)
+		{
+			ereport(ERROR,
+					(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+					 errmsg("compresslevel=%d of rle_type requires Zstandard compression",
+							complevel),
+					 errhint("Compile with --with-zstd to use Zstandard compression.")));
 		}
+#endif
 	}
 
 	if (blocksize < MIN_APPENDONLY_BLOCK_SIZE ||
@@ -1292,7 +1394,7 @@ validateAppendOnlyRelOptions(bool ao,
 
 /*
  * if no compressor type was specified, we set to no compression (level 0)
- * otherwise default for both zlib, quicklz, zstd and RLE to level 1.
+ * otherwise default for zlib, quicklz, zstd, lz4 and RLE to level 1.
  */
 static int
 setDefaultCompressionLevel(char *compresstype)
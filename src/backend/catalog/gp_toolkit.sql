@@ -2009,7 +2009,9 @@ $$ LANGUAGE plpgsql;
 --        int - sessionid,
 --        int - command_cnt,
 --        timestamptz - time of query start,
---        int - number of files
+--        int - number of files,
+--        bigint - bytes written before compression,
+--        bigint - bytes written after compression
 --
 -- @doc:
 --        UDF to retrieve workfile sets currently present on disk on one segment
@@ -2055,7 +2057,9 @@ WITH all_entries AS (
             sessionid int,
             commandid int,
             query_start timestamptz,
-            numfiles int
+            numfiles int,
+            bytes_uncompressed bigint,
+            bytes_compressed bigint
           )
     UNION ALL
     SELECT C.*
@@ -2071,7 +2075,9 @@ WITH all_entries AS (
             sessionid int,
             commandid int,
             query_start timestamptz,
-            numfiles int
+            numfiles int,
+            bytes_uncompressed bigint,
+            bytes_compressed bigint
           ))
 SELECT S.datname,
        (CASE WHEN (C.state = 1) THEN S.procpid ELSE NULL END) AS procpid,
@@ -2085,6 +2091,8 @@ SELECT S.datname,
        C.workmem,
        C.size,
        C.numfiles,
+       C.bytes_uncompressed,
+       C.bytes_compressed,
        C.path as directory,
        (CASE WHEN (C.state = 1) THEN 'RUNNING' WHEN (C.state = 2) THEN 'CACHED' WHEN (C.state = 3) THEN 'DELETING' ELSE 'UNKNOWN' END) as state
 FROM all_entries C LEFT OUTER JOIN
@@ -2126,7 +2134,9 @@ GRANT SELECT ON gp_toolkit.gp_workfile_usage_per_segment TO public;
 
 CREATE VIEW gp_toolkit.gp_workfile_usage_per_query AS
 SELECT datname, procpid, sess_id, command_cnt, usename, current_query, segid, state,
-    SUM(size) AS size, SUM(numfiles) AS numfiles
+    SUM(size) AS size, SUM(numfiles) AS numfiles,
+    SUM(bytes_uncompressed) AS bytes_uncompressed,
+    SUM(bytes_compressed) AS bytes_compressed
 FROM gp_toolkit.gp_workfile_entries
 GROUP BY (datname, procpid, sess_id, command_cnt, usename, current_query, segid, state);
 
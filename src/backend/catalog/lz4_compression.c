@@ -0,0 +1,201 @@
+/*---------------------------------------------------------------------
+ *
+ * lz4_compression.c
+ *
+ * LZ4 compresses several times faster than zlib, and decompresses
+ * several times faster than both zlib and zstd, for a lower ratio. It
+ * is meant for append-optimized tables that are scanned often.
+ *
+ * compresslevel 1 uses the fast LZ4 compressor. Levels 2 to 9 use the
+ * LZ4 HC compressor, at HC levels 5 to 12, which trades compression
+ * time for ratio. The blocks are decompressed the same way, and just as
+ * fast, whatever the level.
+ *
+ * IDENTIFICATION
+ *	    src/backend/catalog/lz4_compression.c
+ *
+ *---------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include "access/genam.h"
+#include "catalog/pg_compression.h"
+#include "fmgr.h"
+#include "utils/builtins.h"
+
+#ifdef HAVE_LIBLZ4
+/* LZ4 library is provided */
+
+#include <lz4.h>
+#include <lz4hc.h>
+
+/* HC level used for compresslevel 2, and upwards from there */
+#define LZ4_HC_LEVEL_OFFSET 3
+
+/* Internal state for lz4 */
+typedef struct lz4_state
+{
+	int			level;			/* Compression level */
+	bool		compress;		/* Compress if true, decompress otherwise */
+	void	   *compress_state; /* LZ4 or LZ4 HC compression state */
+} lz4_state;
+
+Datum
+lz4_constructor(PG_FUNCTION_ARGS)
+{
+	/* PG_GETARG_POINTER(0) is TupleDesc that is currently unused. */
+
+	StorageAttributes *sa = (StorageAttributes *) PG_GETARG_POINTER(1);
+	CompressionState *cs = palloc0(sizeof(CompressionState));
+	lz4_state  *state = palloc0(sizeof(lz4_state));
+	bool		compress = PG_GETARG_BOOL(2);
+
+	if (!PointerIsValid(sa->comptype))
+		elog(ERROR, "lz4_constructor called with no compression type");
+
+	cs->opaque = (void *) state;
+	cs->desired_sz = NULL;
+
+	if (sa->complevel == 0)
+		sa->complevel = 1;
+
+	state->level = sa->complevel;
+	state->compress = compress;
+
+	/*
+	 * Allocate the compression state once, rather than letting the library
+	 * allocate one for each block.
+	 */
+	if (compress)
+		state->compress_state = palloc(state->level > 1 ?
+									   LZ4_sizeofStateHC() : LZ4_sizeofState());
+
+	PG_RETURN_POINTER(cs);
+}
+
+Datum
+lz4_destructor(PG_FUNCTION_ARGS)
+{
+	CompressionState *cs = (CompressionState *) PG_GETARG_POINTER(0);
+
+	if (cs != NULL && cs->opaque != NULL)
+	{
+		lz4_state  *state = (lz4_state *) cs->opaque;
+
+		if (state->compress_state)
+			pfree(state->compress_state);
+		pfree(cs->opaque);
+	}
+
+	PG_RETURN_VOID();
+}
+
+Datum
+lz4_compress(PG_FUNCTION_ARGS)
+{
+	const void *src = PG_GETARG_POINTER(0);
+	int32		src_sz = PG_GETARG_INT32(1);
+	void	   *dst = PG_GETARG_POINTER(2);
+	int32		dst_sz = PG_GETARG_INT32(3);
+	int32	   *dst_used = (int32 *) PG_GETARG_POINTER(4);
+	CompressionState *cs = (CompressionState *) PG_GETARG_POINTER(5);
+	lz4_state  *state = (lz4_state *) cs->opaque;
+	int			dst_length_used;
+
+	Assert(state->compress_state != NULL);
+
+	if (state->level > 1)
+		dst_length_used = LZ4_compress_HC_extStateHC(state->compress_state,
+													 src, dst, src_sz, dst_sz,
+													 state->level + LZ4_HC_LEVEL_OFFSET);
+	else
+		dst_length_used = LZ4_compress_fast_extState(state->compress_state,
+													 src, dst, src_sz, dst_sz,
+													 1);
+
+	/*
+	 * LZ4 returns 0 when the result doesn't fit in the destination buffer.
+	 * Like for zlib, the caller expects to detect that the data didn't
+	 * compress by itself.
+	 */
+	if (dst_length_used <= 0)
+		dst_length_used = src_sz;
+
+	*dst_used = (int32) dst_length_used;
+
+	PG_RETURN_VOID();
+}
+
+Datum
+lz4_decompress(PG_FUNCTION_ARGS)
+{
+	const void *src = PG_GETARG_POINTER(0);
+	int32		src_sz = PG_GETARG_INT32(1);
+	void	   *dst = PG_GETARG_POINTER(2);
+	int32		dst_sz = PG_GETARG_INT32(3);
+	int32	   *dst_used = (int32 *) PG_GETARG_POINTER(4);
+	int			dst_length_used;
+
+	if (src_sz <= 0)
+		elog(ERROR, "invalid source buffer size %d", src_sz);
+	if (dst_sz <= 0)
+		elog(ERROR, "invalid destination buffer size %d", dst_sz);
+
+	dst_length_used = LZ4_decompress_safe(src, dst, src_sz, dst_sz);
+
+	if (dst_length_used < 0)
+		elog(ERROR, "lz4 decompression failed, the compressed data is corrupt");
+
+	*dst_used = (int32) dst_length_used;
+
+	PG_RETURN_VOID();
+}
+
+Datum
+lz4_validator(PG_FUNCTION_ARGS)
+{
+	PG_RETURN_VOID();
+}
+
+
+#else							/* HAVE_LIBLZ4 */
+/* LZ4 library is not provided; use dummy functions instead */
+
+#define NO_LZ4_SUPPORT() \
+	ereport(ERROR, \
+			(errcode(ERRCODE_FEATURE_NOT_SUPPORTED), \
+			 errmsg("LZ4 library is not supported by this build"), \
+			 errhint("Compile with --with-lz4 to use LZ4 compression.")))
+
+Datum
+lz4_constructor(PG_FUNCTION_ARGS)
+{
+	NO_LZ4_SUPPORT();
+}
+
+Datum
+lz4_destructor(PG_FUNCTION_ARGS)
+{
+	NO_LZ4_SUPPORT();
+}
+
+Datum
+lz4_compress(PG_FUNCTION_ARGS)
+{
+	NO_LZ4_SUPPORT();
+}
+
+Datum
+lz4_decompress(PG_FUNCTION_ARGS)
+{
+	NO_LZ4_SUPPORT();
+}
+
+Datum
+lz4_validator(PG_FUNCTION_ARGS)
+{
+	NO_LZ4_SUPPORT();
+}
+
+#endif							/* HAVE_LIBLZ4 */
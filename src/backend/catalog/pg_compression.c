@@ -41,7 +41,7 @@
 
 /* names we expect to see in ENCODING clauses */
 char *storage_directive_names[] = {"compresstype", "compresslevel",
-								   "blocksize", NULL};
+								   "blocksize", "dictionary", NULL};
 
 
 /* Internal state for zlib */
@@ -375,6 +375,11 @@ zlib_validator(PG_FUNCTION_ARGS)
 	PG_RETURN_VOID();
 }
 
+/*
+ * RLE_TYPE is not a block compressor. The run-length and delta encoding is
+ * done by the datum stream layer, see init_datumstream_info(), which then
+ * hands the block to zlib or zstd according to the compresslevel.
+ */
 Datum
 rle_type_constructor(PG_FUNCTION_ARGS)
 {
@@ -467,7 +472,7 @@ compresstype_is_valid(char *comptype)
 	 * must change!
 	 */
 	static const char *const valid_comptypes[] =
-			{"quicklz", "zlib", "rle_type", "none", "zstd"};
+			{"quicklz", "zlib", "rle_type", "none", "zstd", "lz4"};
 	for (i = 0; !found && i < ARRAY_SIZE(valid_comptypes); ++i)
 	{
 		if (pg_strcasecmp(valid_comptypes[i], comptype) == 0)
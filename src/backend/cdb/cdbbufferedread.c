@@ -17,11 +17,17 @@
 #include "postgres.h"
 
 #include "cdb/cdbbufferedread.h"
+#include "portability/instr_time.h"
 #include "utils/guc.h"
 #include "miscadmin.h"
 
+/* GUC: number of large reads to request ahead of the one being read */
+int			gp_appendonly_readahead_depth = 0;
+
 static void BufferedReadIo(
 			   BufferedRead *bufferedRead);
+static void BufferedReadAhead(
+				  BufferedRead *bufferedRead);
 static uint8 *BufferedReadUseBeforeBuffer(
 							BufferedRead *bufferedRead,
 							int32 maxReadAheadLen,
@@ -110,6 +116,12 @@ BufferedReadInit(
 	 */
 	bufferedRead->haveTemporaryLimitInEffect = false;
 	bufferedRead->temporaryLimitFileLen = 0;
+
+	/*
+	 * Read-ahead support.
+	 */
+	bufferedRead->readAheadDepth = gp_appendonly_readahead_depth;
+	bufferedRead->readAheadPosition = 0;
 }
 
 /*
@@ -143,6 +155,8 @@ BufferedReadSetFile(
 	bufferedRead->haveTemporaryLimitInEffect = false;
 	bufferedRead->temporaryLimitFileLen = 0;
 
+	bufferedRead->readAheadPosition = 0;
+
 	if (fileLen > 0)
 	{
 		/*
@@ -156,6 +170,60 @@ BufferedReadSetFile(
 	}
 }
 
+/*
+ * Ask the kernel to start reading the large reads that follow the current
+ * one, up to the read-ahead depth, so that the storage works on them while
+ * the caller processes the current one.
+ *
+ * Only the part of the window not already requested is requested, so in a
+ * sequential scan each large read is requested once, readAheadDepth reads
+ * before it is needed.
+ */
+static void
+BufferedReadAhead(
+				  BufferedRead *bufferedRead)
+{
+	int64		inEffectFileLen;
+	int64		position;
+	int64		windowEnd;
+
+	if (bufferedRead->readAheadDepth <= 0)
+		return;
+
+	if (bufferedRead->haveTemporaryLimitInEffect)
+		inEffectFileLen = bufferedRead->temporaryLimitFileLen;
+	else
+		inEffectFileLen = bufferedRead->fileLen;
+
+	position = bufferedRead->largeReadPosition + bufferedRead->largeReadLen;
+	if (bufferedRead->readAheadPosition > position)
+		position = bufferedRead->readAheadPosition;
+
+	windowEnd = bufferedRead->largeReadPosition + bufferedRead->largeReadLen +
+		(int64) bufferedRead->readAheadDepth * bufferedRead->maxLargeReadLen;
+	if (windowEnd > inEffectFileLen)
+		windowEnd = inEffectFileLen;
+
+	while (position < windowEnd)
+	{
+		int32		amount;
+
+		if (windowEnd - position > bufferedRead->maxLargeReadLen)
+			amount = bufferedRead->maxLargeReadLen;
+		else
+			amount = (int32) (windowEnd - position);
+
+		/* It is only a hint, so a failure is of no consequence */
+		(void) FilePrefetch(bufferedRead->file, position, amount);
+
+		bufferedRead->numReadAheads++;
+		position += amount;
+	}
+
+	if (position > bufferedRead->readAheadPosition)
+		bufferedRead->readAheadPosition = position;
+}
+
 /*
  * Perform a large read i/o.
  */
@@ -166,11 +234,17 @@ BufferedReadIo(
 	int32		largeReadLen;
 	uint8	   *largeReadMemory;
 	int32		offset;
+	instr_time	starttime;
+	instr_time	endtime;
 
 	largeReadLen = bufferedRead->largeReadLen;
 	Assert(bufferedRead->largeReadLen > 0);
 	largeReadMemory = bufferedRead->largeReadMemory;
 
+	BufferedReadAhead(bufferedRead);
+
+	INSTR_TIME_SET_CURRENT(starttime);
+
 #ifdef USE_ASSERT_CHECKING
 	{
 		int64		currentReadPosition;
@@ -241,6 +315,13 @@ BufferedReadIo(
 		offset += actualLen;
 	}
 
+	INSTR_TIME_SET_CURRENT(endtime);
+	INSTR_TIME_SUBTRACT(endtime, starttime);
+
+	bufferedRead->numLargeReads++;
+	bufferedRead->bytesRead += bufferedRead->largeReadLen;
+	bufferedRead->readWaitMs += INSTR_TIME_GET_MILLISEC(endtime);
+
 	if (VacuumCostActive)
 		VacuumCostBalance += VacuumCostPageMiss;
 }
@@ -444,6 +525,14 @@ BufferedReadSetTemporaryRange(
 
 		bufferedRead->largeReadPosition = beginFileOffset;
 
+		/*
+		 * Set the temporary limit before reading, so that read-ahead stays
+		 * within the requested range.
+		 */
+		bufferedRead->haveTemporaryLimitInEffect = true;
+		bufferedRead->temporaryLimitFileLen = afterFileOffset;
+		bufferedRead->readAheadPosition = 0;
+
 		if (bufferedRead->largeReadLen > 0)
 			BufferedReadIo(bufferedRead);
 	}
@@ -699,6 +788,8 @@ BufferedReadCompleteFile(
 
 	bufferedRead->largeReadPosition = 0;
 	bufferedRead->largeReadLen = 0;
+
+	bufferedRead->readAheadPosition = 0;
 }
 
 
@@ -716,6 +807,17 @@ BufferedReadFinish(BufferedRead *bufferedRead)
 	Assert(bufferedRead->bufferOffset == 0);
 	Assert(bufferedRead->bufferLen == 0);
 
+	elogif(Debug_appendonly_print_scan && bufferedRead->numLargeReads > 0, LOG,
+		   "Append-Only storage read statistics: table \"%s\", "
+		   "%ld large reads of " INT64_FORMAT " bytes in total, "
+		   "%ld read-ahead requests (depth %d), %.3f ms waiting for reads",
+		   bufferedRead->relationName,
+		   (long) bufferedRead->numLargeReads,
+		   bufferedRead->bytesRead,
+		   (long) bufferedRead->numReadAheads,
+		   bufferedRead->readAheadDepth,
+		   bufferedRead->readWaitMs);
+
 	if (bufferedRead->memory)
 	{
 		pfree(bufferedRead->memory);
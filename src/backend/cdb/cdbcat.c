@@ -32,6 +32,8 @@
 #include "utils/syscache.h"
 
 static void extract_INT2OID_array(Datum array_datum, int *lenp, int16 **vecp);
+static char GpPolicyHashReduceToChar(GpPolicyHashReduce hashreduce);
+static GpPolicyHashReduce GpPolicyHashReduceFromChar(char hashreduce);
 
 GpPolicy *
 makeGpPolicy(MemoryContext mcxt, GpPolicyType ptype, int nattrs)
@@ -51,6 +53,7 @@ makeGpPolicy(MemoryContext mcxt, GpPolicyType ptype, int nattrs)
 		policy->attrs = (AttrNumber *) ((char*)policy + sizeof(GpPolicy));
 	else
 		policy->attrs = NULL;
+	policy->hashreduce = POLICY_HASHREDUCE_MODULO;
 
 	return policy;
 }
@@ -77,6 +80,9 @@ createRandomPartitionedPolicy(MemoryContext mcxt)
 /*
  * createHashPartitionedPolicy-- Create a policy with data
  * partitioned by keys 
+ *
+ * The hash reduction of the new policy is taken from
+ * gp_create_table_hash_reduction.
  */
 GpPolicy *
 createHashPartitionedPolicy(MemoryContext mcxt, List *keys)
@@ -94,6 +100,7 @@ createHashPartitionedPolicy(MemoryContext mcxt, List *keys)
 	{
 		policy->attrs[idx++] = (AttrNumber)lfirst_int(lc);
 	}
+	policy->hashreduce = (GpPolicyHashReduce) gp_create_table_hash_reduction;
 
 	return policy;	
 }
@@ -116,6 +123,7 @@ GpPolicyCopy(MemoryContext mcxt, const GpPolicy *src)
 
 	for (i = 0; i < src->nattrs; i++)
 		tgt->attrs[i] = src->attrs[i];
+	tgt->hashreduce = src->hashreduce;
 
 	return tgt;
 }								/* GpPolicyCopy */
@@ -144,6 +152,10 @@ GpPolicyEqual(const GpPolicy *lft, const GpPolicy *rgt)
 		if (lft->attrs[i] != rgt->attrs[i])
 			return false;
 
+	/* The hash reduction only matters if there are keys to hash. */
+	if (lft->nattrs > 0 && lft->hashreduce != rgt->hashreduce)
+		return false;
+
 	return true;
 }								/* GpPolicyEqual */
 
@@ -207,6 +219,51 @@ GpPolicyIsEntry(const GpPolicy *policy)
 	return policy->ptype == POLICYTYPE_ENTRY;
 }
 
+/*
+ * Returns true if the policy is hash partitioned and reduces hash values to
+ * segments with jump consistent hashing.
+ */
+bool
+GpPolicyIsJumpHashed(const GpPolicy *policy)
+{
+	return GpPolicyIsHashPartitioned(policy) &&
+			policy->hashreduce == POLICY_HASHREDUCE_JUMP;
+}
+
+/*
+ * Conversions between GpPolicyHashReduce and the symbolic values stored in
+ * gp_distribution_policy.hashreduce.
+ */
+static char
+GpPolicyHashReduceToChar(GpPolicyHashReduce hashreduce)
+{
+	switch (hashreduce)
+	{
+		case POLICY_HASHREDUCE_MODULO:
+			return SYM_HASHREDUCE_MODULO;
+		case POLICY_HASHREDUCE_JUMP:
+			return SYM_HASHREDUCE_JUMP;
+	}
+
+	elog(ERROR, "unrecognized hash reduction %d", (int) hashreduce);
+	return SYM_HASHREDUCE_MODULO;	/* keep compiler quiet */
+}
+
+static GpPolicyHashReduce
+GpPolicyHashReduceFromChar(char hashreduce)
+{
+	switch (hashreduce)
+	{
+		case SYM_HASHREDUCE_MODULO:
+			return POLICY_HASHREDUCE_MODULO;
+		case SYM_HASHREDUCE_JUMP:
+			return POLICY_HASHREDUCE_JUMP;
+	}
+
+	elog(ERROR, "unrecognized hash reduction \"%c\"", hashreduce);
+	return POLICY_HASHREDUCE_MODULO;	/* keep compiler quiet */
+}
+
 /*
  * GpPolicyFetch
  *
@@ -315,6 +372,17 @@ GpPolicyFetch(MemoryContext mcxt, Oid tbloid)
 				{
 					policy->attrs[i] = attrnums[i];
 				}
+
+				/*
+				 * The hash reduction is kept even while the keys are
+				 * NULLed out, e.g. by gpexpand, so that redistributing
+				 * the table later on restores it.
+				 */
+				attr = SysCacheGetAttr(GPPOLICYID, gp_policy_tuple,
+									   Anum_gp_policy_hashreduce,
+									   &isNull);
+				Assert(!isNull);
+				policy->hashreduce = GpPolicyHashReduceFromChar(DatumGetChar(attr));
 				break;
 			default:
 				ReleaseSysCache(gp_policy_tuple);
@@ -368,15 +436,17 @@ GpPolicyStore(Oid tbloid, const GpPolicy *policy)
 
 	ArrayType  *attrnums;
 
-	bool		nulls[3];
-	Datum		values[3];
+	bool		nulls[Natts_gp_policy];
+	Datum		values[Natts_gp_policy];
 
 	Insist(policy->ptype != POLICYTYPE_ENTRY);
 
 	nulls[0] = false;
 	nulls[1] = false;
 	nulls[2] = false;
+	nulls[3] = false;
 	values[0] = ObjectIdGetDatum(tbloid);
+	values[3] = CharGetDatum(GpPolicyHashReduceToChar(policy->hashreduce));
 
 	/*
 	 * Open and lock the gp_distribution_policy catalog.
@@ -442,16 +512,18 @@ GpPolicyReplace(Oid tbloid, const GpPolicy *policy)
 	SysScanDesc scan;
 	ScanKeyData skey;
 	ArrayType  *attrnums;
-	bool		nulls[3];
-	Datum		values[3];
-	bool		repl[3];
+	bool		nulls[Natts_gp_policy];
+	Datum		values[Natts_gp_policy];
+	bool		repl[Natts_gp_policy];
 
 	Insist(!GpPolicyIsEntry(policy));
 
 	nulls[0] = false;
 	nulls[1] = false;
 	nulls[2] = false;
+	nulls[3] = false;
 	values[0] = ObjectIdGetDatum(tbloid);
+	values[3] = CharGetDatum(GpPolicyHashReduceToChar(policy->hashreduce));
 
 	/*
 	 * Open and lock the gp_distribution_policy catalog.
@@ -495,6 +567,7 @@ GpPolicyReplace(Oid tbloid, const GpPolicy *policy)
 	repl[0] = false;
 	repl[1] = true;
 	repl[2] = true;
+	repl[3] = true;
 
 
 	/*
@@ -15,6 +15,7 @@
  */
 #include "postgres.h"
 
+#include "access/transam.h"
 #include "access/tuptoaster.h"
 #include "utils/builtins.h"
 #include "catalog/pg_type.h"
@@ -59,10 +60,12 @@
 #define FASTMOD(x,y)		((x) & ((y)-1))
 
 /* local function declarations */
+static inline uint32 fnv1_32_octet(uint32 hval, unsigned char octet);
 static uint32 fnv1_32_buf(void *buf, size_t len, uint32 hashval);
 static int	inet_getkey(inet *addr, unsigned char *inet_key, int key_size);
 static int	ignoreblanks(char *data, int len);
 static int	ispowof2(int numsegs);
+static int	jump_consistent_hash(uint64 key, int numsegs);
 
 
 /*================================================================
@@ -85,7 +88,7 @@ static int	ispowof2(int numsegs);
  * The hash value itself will be initialized for every tuple in cdbhashinit()
  */
 CdbHash *
-makeCdbHash(int numsegs)
+makeCdbHash(int numsegs, GpPolicyHashReduce hashreduce)
 {
 	CdbHash    *h;
 
@@ -101,10 +104,15 @@ makeCdbHash(int numsegs)
 	h->numsegs = numsegs;
 
 	/*
-	 * set the reduction algorithm: If num_segs is power of 2 use bit mask,
-	 * else use lazy mod (h mod n)
+	 * set the reduction algorithm: jump consistent hash if the policy asks
+	 * for it, otherwise if num_segs is power of 2 use bit mask, else use lazy
+	 * mod (h mod n)
 	 */
-	if (ispowof2(numsegs))
+	if (hashreduce == POLICY_HASHREDUCE_JUMP)
+	{
+		h->reducealg = REDUCE_JUMP_CONSISTENT;
+	}
+	else if (ispowof2(numsegs))
 	{
 		h->reducealg = REDUCE_BITMASK;
 	}
@@ -225,7 +233,11 @@ hashDatum(Datum datum, Oid type, datumHashFunction hashFn, void *clientData)
 
 	void	   *tofree = NULL;
 
-	if (typeIsEnumType(type))
+	/*
+	 * Enum types are always user-defined, so don't pay for a syscache lookup
+	 * per datum to find out whether one of the built-in types is an enum.
+	 */
+	if (type >= FirstBootstrapObjectId && typeIsEnumType(type))
 		type = ANYENUMOID;
 
 	/*
@@ -663,7 +675,8 @@ cdbhashreduce(CdbHash *h)
 								 * Database and therefore initialize to this
 								 * value for error checking? */
 
-	Assert(h->reducealg == REDUCE_BITMASK || h->reducealg == REDUCE_LAZYMOD);
+	Assert(h->reducealg == REDUCE_BITMASK || h->reducealg == REDUCE_LAZYMOD ||
+		   h->reducealg == REDUCE_JUMP_CONSISTENT);
 
 	/*
 	 * Reduce our 32-bit hash value to a segment number
@@ -677,6 +690,10 @@ cdbhashreduce(CdbHash *h)
 		case REDUCE_LAZYMOD:
 			result = (h->hash) % (h->numsegs);	/* simple mod */
 			break;
+
+		case REDUCE_JUMP_CONSISTENT:
+			result = jump_consistent_hash(h->hash, h->numsegs);
+			break;
 	}
 
 	return result;
@@ -786,6 +803,25 @@ isGreenplumDbHashable(Oid typid)
 	}
 }
 
+/*
+ * fnv1_32_octet - add one octet to a 32 bit FNV 1 hash
+ */
+static inline uint32
+fnv1_32_octet(uint32 hval, unsigned char octet)
+{
+	/*
+	 * multiply by the 32 bit FNV magic prime mod 2^32.
+	 *
+	 * This used to be spelled out as a sum of shifts, which gives the same
+	 * result but is a longer dependency chain than a single multiply on any
+	 * CPU we care about.
+	 */
+	hval *= FNV_32_PRIME;
+
+	/* xor the bottom with the current octet */
+	return hval ^ (uint32) octet;
+}
+
 /*
  * fnv1_32_buf - perform a 32 bit FNV 1 hash on a buffer
  *
@@ -804,21 +840,36 @@ fnv1_32_buf(void *buf, size_t len, uint32 hval)
 	unsigned char *be = bp + len;	/* beyond end of buffer */
 
 	/*
-	 * FNV-1 hash each octet in the buffer
+	 * Most distribution keys are integers, which hashDatum() widens to 8
+	 * bytes, or other fixed-width values of 8 or 4 bytes.  Hash those without
+	 * a loop.  The octets are still consumed in memory order, so the result
+	 * is identical to the generic loop below.
 	 */
-	while (bp < be)
+	if (len == 8)
+	{
+		hval = fnv1_32_octet(hval, bp[0]);
+		hval = fnv1_32_octet(hval, bp[1]);
+		hval = fnv1_32_octet(hval, bp[2]);
+		hval = fnv1_32_octet(hval, bp[3]);
+		hval = fnv1_32_octet(hval, bp[4]);
+		hval = fnv1_32_octet(hval, bp[5]);
+		hval = fnv1_32_octet(hval, bp[6]);
+		return fnv1_32_octet(hval, bp[7]);
+	}
+	if (len == 4)
 	{
-		/* multiply by the 32 bit FNV magic prime mod 2^32 */
-#if defined(NO_FNV_GCC_OPTIMIZATION)
-		hval *= FNV_32_PRIME;
-#else
-		hval += (hval << 1) + (hval << 4) + (hval << 7) + (hval << 8) + (hval << 24);
-#endif
-
-		/* xor the bottom with the current octet */
-		hval ^= (uint32) *bp++;
+		hval = fnv1_32_octet(hval, bp[0]);
+		hval = fnv1_32_octet(hval, bp[1]);
+		hval = fnv1_32_octet(hval, bp[2]);
+		return fnv1_32_octet(hval, bp[3]);
 	}
 
+	/*
+	 * FNV-1 hash each octet in the buffer
+	 */
+	while (bp < be)
+		hval = fnv1_32_octet(hval, *bp++);
+
 	/* return our new hash value */
 	return hval;
 }
@@ -893,3 +944,33 @@ ispowof2(int numsegs)
 {
 	return !(numsegs & (numsegs - 1));
 }
+
+/*
+ * jump_consistent_hash
+ *
+ * Map a key to one of numsegs buckets such that, when numsegs grows from N
+ * to M, only the keys that end up in the new buckets N..M-1 change bucket
+ * (about (M-N)/M of them).  See Lamping and Veach, "A Fast, Minimal Memory,
+ * Consistent Hash Algorithm".
+ *
+ * The key is stepped through a 64-bit linear congruential generator, and
+ * each step jumps forward to the next bucket the key would move to as the
+ * number of buckets grows; the last jump below numsegs is the answer.  This
+ * takes O(log numsegs) iterations.
+ */
+static int
+jump_consistent_hash(uint64 key, int numsegs)
+{
+	int64		b = -1;
+	int64		j = 0;
+
+	while (j < numsegs)
+	{
+		b = j;
+		key = key * UINT64CONST(2862933555777941757) + 1;
+		j = (int64) ((b + 1) * ((double) (INT64CONST(1) << 31) /
+								(double) ((key >> 33) + 1)));
+	}
+
+	return (int) b;
+}
@@ -82,7 +82,8 @@ static bool adjustPlanFlow(Plan *plan,
 			   bool stable,
 			   bool rescannable,
 			   Movement req_move,
-			   List *hashExpr);
+			   List *hashExpr,
+			   GpPolicyHashReduce hashReduce);
 
 static void motion_sanity_check(PlannerInfo *root, Plan *plan);
 static bool loci_compatible(List *hashExpr1, List *hashExpr2);
@@ -970,7 +971,10 @@ pull_up_Flow(Plan *plan, Plan *subplan)
 		if (!is_projection_capable_plan(plan) ||
 			cdbpullup_isExprCoveredByTargetlist((Expr *) model_flow->hashExpr,
 												plan->targetlist))
+		{
 			new_flow->hashExpr = copyObject(model_flow->hashExpr);
+			new_flow->hashReduce = model_flow->hashReduce;
+		}
 	}
 
 	new_flow->locustype = model_flow->locustype;
@@ -1030,7 +1034,8 @@ focusPlan(Plan *plan, bool stable, bool rescannable)
 	if (plan->flow->flotype == FLOW_REPLICATED)
 		return false;
 
-	return adjustPlanFlow(plan, stable, rescannable, MOVEMENT_FOCUS, NIL);
+	return adjustPlanFlow(plan, stable, rescannable, MOVEMENT_FOCUS, NIL,
+						  POLICY_HASHREDUCE_MODULO);
 }
 
 /*
@@ -1041,7 +1046,8 @@ broadcastPlan(Plan *plan, bool stable, bool rescannable)
 {
 	Assert(plan->flow && plan->flow->flotype != FLOW_UNDEFINED);
 
-	return adjustPlanFlow(plan, stable, rescannable, MOVEMENT_BROADCAST, NIL);
+	return adjustPlanFlow(plan, stable, rescannable, MOVEMENT_BROADCAST, NIL,
+						  POLICY_HASHREDUCE_MODULO);
 }
 
 
@@ -1078,16 +1084,20 @@ loci_compatible(List *hashExpr1, List *hashExpr2)
 
 /*
  * Function: repartitionPlan
+ *
+ * hashReduce is the reduction the hash motion must use, normally that of
+ * the target relation's policy.
  */
 bool
-repartitionPlan(Plan *plan, bool stable, bool rescannable, List *hashExpr)
+repartitionPlan(Plan *plan, bool stable, bool rescannable, List *hashExpr,
+				GpPolicyHashReduce hashReduce)
 {
 	Assert(plan->flow);
 	Assert(plan->flow->flotype == FLOW_PARTITIONED ||
 		   plan->flow->flotype == FLOW_SINGLETON);
 
 	/* Already partitioned on the given hashExpr?  Do nothing. */
-	if (hashExpr)
+	if (hashExpr && plan->flow->hashReduce == hashReduce)
 	{
 		if (equal(hashExpr, plan->flow->hashExpr))
 			return true;
@@ -1101,7 +1111,8 @@ repartitionPlan(Plan *plan, bool stable, bool rescannable, List *hashExpr)
 			return true;
 	}
 
-	return adjustPlanFlow(plan, stable, rescannable, MOVEMENT_REPARTITION, hashExpr);
+	return adjustPlanFlow(plan, stable, rescannable, MOVEMENT_REPARTITION,
+						  hashExpr, hashReduce);
 }
 
 /*
@@ -1129,7 +1140,8 @@ repartitionPlanForGroupClauses(PlannerInfo *root, Plan *plan,
 		hashExpr = lappend(hashExpr, n);
 	}
 
-	return repartitionPlan(plan, stable, rescannable, hashExpr);
+	return repartitionPlan(plan, stable, rescannable, hashExpr,
+						   POLICY_HASHREDUCE_MODULO);
 }
 
 /*
@@ -1147,7 +1159,8 @@ adjustPlanFlow(Plan *plan,
 			   bool stable,
 			   bool rescannable,
 			   Movement req_move,
-			   List *hashExpr)
+			   List *hashExpr,
+			   GpPolicyHashReduce hashReduce)
 {
 	Flow	   *flow = plan->flow;
 	bool		disorder = false;
@@ -1243,7 +1256,8 @@ adjustPlanFlow(Plan *plan,
 							stable && !reorder,
 							rescannable,
 							req_move,
-							hashExpr))
+							hashExpr,
+							hashReduce))
 			return false;
 
 		/* After updating subplan, bubble new distribution back up the tree. */
@@ -1252,6 +1266,7 @@ adjustPlanFlow(Plan *plan,
 		flow->flotype = kidflow->flotype;
 		flow->segindex = kidflow->segindex;
 		flow->hashExpr = copyObject(kidflow->hashExpr);
+		flow->hashReduce = kidflow->hashReduce;
 		plan->dispatch = plan->lefttree->dispatch;
 
 		return true;			/* success */
@@ -1315,6 +1330,7 @@ adjustPlanFlow(Plan *plan,
 		case MOVEMENT_REPARTITION:
 			flow->flotype = FLOW_PARTITIONED;
 			flow->hashExpr = copyObject(hashExpr);
+			flow->hashReduce = hashReduce;
 			flow->segindex = 0;
 			break;
 
@@ -143,7 +143,7 @@ directDispatchCalculateHash(Plan *plan, GpPolicy *targetPolicy)
 	ListCell   *cell = NULL;
 	bool		directDispatch;
 
-	h = makeCdbHash(GpIdentity.numsegments);
+	h = makeCdbHash(GpIdentity.numsegments, targetPolicy->hashreduce);
 	cdbhashinit(h);
 
 	/*
@@ -460,7 +460,8 @@ apply_motion(PlannerInfo *root, Plan *plan, Query *query)
 							targetPolicy->nattrs,
 							targetPolicy->attrs,
 							true);
-					if (!repartitionPlan(plan, false, false, hashExpr))
+					if (!repartitionPlan(plan, false, false, hashExpr,
+										 targetPolicy->hashreduce))
 						ereport(ERROR, (errcode(ERRCODE_GP_FEATURE_NOT_YET),
 									errmsg("Cannot parallelize that SELECT INTO yet")
 							       ));
@@ -733,10 +734,17 @@ apply_motion_mutator(Node *node, ApplyMotionState *context)
 			break;
 
 		case MOVEMENT_REPARTITION:
-			newnode = (Node *) make_hashed_motion(plan,
-												  flow->hashExpr,
-												  true	/* useExecutorVarFormat */
-				);
+			{
+				Motion	   *motion;
+
+				motion = make_hashed_motion(plan,
+											flow->hashExpr,
+											true	/* useExecutorVarFormat */
+					);
+				motion->hashReduce = flow->hashReduce;
+				motion->plan.flow->hashReduce = flow->hashReduce;
+				newnode = (Node *) motion;
+			}
 			break;
 
 		case MOVEMENT_EXPLICIT:
@@ -2256,11 +2264,14 @@ assign_plannode_id(PlannedStmt *stmt)
 
 /*
  * Hash a const value with GPDB's hash function
+ *
+ * These are only used by ORCA, which does not plan queries on tables with
+ * jump consistent hash distribution, so modulo reduction is assumed.
  */
 int32
 cdbhash_const(Const *pconst, int iSegments)
 {
-	CdbHash    *pcdbhash = makeCdbHash(iSegments);
+	CdbHash    *pcdbhash = makeCdbHash(iSegments, POLICY_HASHREDUCE_MODULO);
 
 	cdbhashinit(pcdbhash);
 
@@ -2290,7 +2301,7 @@ cdbhash_const_list(List *plConsts, int iSegments)
 {
 	Assert(0 < list_length(plConsts));
 
-	CdbHash    *pcdbhash = makeCdbHash(iSegments);
+	CdbHash    *pcdbhash = makeCdbHash(iSegments, POLICY_HASHREDUCE_MODULO);
 
 	cdbhashinit(pcdbhash);
 
@@ -3163,10 +3174,12 @@ sri_optimize_for_result(PlannerInfo *root, Plan *plan, RangeTblEntry *rte,
 
 		rNode->hashFilter = true;
 		rNode->hashList = hList;
+		rNode->hashReduce = (*targetPolicy)->hashreduce;
 
 		/* Build a partitioned flow */
 		plan->flow->flotype = FLOW_PARTITIONED;
 		plan->flow->locustype = CdbLocusType_Hashed;
 		plan->flow->hashExpr = *hashExpr;
+		plan->flow->hashReduce = (*targetPolicy)->hashreduce;
 	}
 }
@@ -2483,7 +2483,9 @@ partition_policies_equal(GpPolicy *p, PartitionNode *pn)
 			PartitionRule *rule = lfirst(lc);
 			Relation	rel = heap_open(rule->parchildrelid, NoLock);
 
-			if (p->nattrs != rel->rd_cdbpolicy->nattrs)
+			if (p->nattrs != rel->rd_cdbpolicy->nattrs ||
+				(p->nattrs > 0 &&
+				 p->hashreduce != rel->rd_cdbpolicy->hashreduce))
 			{
 				heap_close(rel, NoLock);
 				return false;
@@ -317,8 +317,15 @@ cdbpathlocus_from_baserel(struct PlannerInfo *root,
 
 	if (GpPolicyIsPartitioned(policy))
 	{
-		/* Are the rows distributed by hashing on specified columns? */
-		if (policy->nattrs > 0)
+		/*
+		 * Are the rows distributed by hashing on specified columns?
+		 *
+		 * Tables that use jump consistent hashing are treated as strewn: a
+		 * Hashed locus implies the modulo placement that hash motions
+		 * produce, so claiming it would make the planner skip needed
+		 * motions when joining or grouping such tables.
+		 */
+		if (policy->nattrs > 0 && !GpPolicyIsJumpHashed(policy))
 		{
 			List	   *partkey = cdb_build_distribution_pathkeys(root,
 					rel,
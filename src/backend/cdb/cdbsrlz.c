@@ -14,20 +14,55 @@
  */
 
 #include "postgres.h"
+#include "access/hash.h"
+#include "catalog/pg_type.h"
+#include "cdb/cdbllize.h"
 #include "cdb/cdbplan.h"
 #include "cdb/cdbsrlz.h"
 #include <math.h>
 #include "miscadmin.h"
+#include "nodes/makefuncs.h"
 #include "nodes/print.h"
 #include "optimizer/clauses.h"
+#include "portability/instr_time.h"
 #include "regex/regex.h"
 #include "utils/guc.h"
 #include "utils/memaccounting.h"
+#include "utils/memutils.h"
 #include "utils/zlib_wrapper.h"
 
+#ifdef HAVE_LIBZSTD
+#include <zstd.h>
+#endif
+
+/* GUC: codec used to compress dispatched plans */
+int			gp_plan_serialization_codec = PLAN_CODEC_ZLIB;
+
+/*
+ * Layout of a serialized node.
+ *
+ * A zlib-compressed node starts with its uncompressed length, which is never
+ * negative, followed by the zlib stream. This is the format older releases
+ * understand, so it is kept as is.
+ *
+ * Any other codec starts with a PlanCodecHeader, whose first field is the
+ * negated codec id.
+ */
+typedef struct PlanCodecHeader
+{
+	int32		codec;			/* -PlanCodec */
+	int32		uncompressed_len;
+	uint32		dictid;			/* checksum of the dictionary used, or 0 */
+} PlanCodecHeader;
+
 static char *compress_string(const char *src, int uncompressed_size, int *size);
 static char *uncompress_string(const char *src, int size, int *uncompressed_len);
 
+#ifdef HAVE_LIBZSTD
+static char *compress_string_zstd(const char *src, int uncompressed_size, int *size);
+static char *uncompress_string_zstd(const char *src, int size, int *uncompressed_len);
+#endif
+
 /*
  * This is used by dispatcher to serialize Plan and Query Trees for
  * dispatching to qExecs.
@@ -40,10 +75,16 @@ serializeNode(Node *node, int *size, int *uncompressed_size_out)
 	char	   *sNode;
 	int			uncompressed_size;
 
+	instr_time	starttime;
+	instr_time	endtime;
+
 	Assert(node != NULL);
 	Assert(size != NULL);
 	START_MEMORY_ACCOUNT(MemoryAccounting_CreateAccount(0, MEMORY_OWNER_TYPE_Serializer));
 	{
+		if (DEBUG1 >= log_min_messages)
+			INSTR_TIME_SET_CURRENT(starttime);
+
 		pszNode = nodeToBinaryStringFast(node, &uncompressed_size);
 		Assert(pszNode != NULL);
 
@@ -51,8 +92,32 @@ serializeNode(Node *node, int *size, int *uncompressed_size_out)
 		{
 			*uncompressed_size_out = uncompressed_size;
 		}
-		sNode = compress_string(pszNode, uncompressed_size, size);
+
+		switch (gp_plan_serialization_codec)
+		{
+#ifdef HAVE_LIBZSTD
+			case PLAN_CODEC_ZSTD:
+				sNode = compress_string_zstd(pszNode, uncompressed_size, size);
+				break;
+#endif
+			default:
+				sNode = compress_string(pszNode, uncompressed_size, size);
+				break;
+		}
 		pfree(pszNode);
+
+		/*
+		 * Report the compression ratio and cost, so that codecs can be
+		 * compared by running a workload with each of them.
+		 */
+		if (DEBUG1 >= log_min_messages)
+		{
+			INSTR_TIME_SET_CURRENT(endtime);
+			INSTR_TIME_SUBTRACT(endtime, starttime);
+			elog(DEBUG1, "serialized %s node: %d bytes, compressed to %d bytes in %.3f ms",
+				 GetConfigOption("gp_plan_serialization_codec", false),
+				 uncompressed_size, *size, INSTR_TIME_GET_MILLISEC(endtime));
+		}
 	}
 	END_MEMORY_ACCOUNT();
 
@@ -70,18 +135,53 @@ deserializeNode(const char *strNode, int size)
 	char	   *sNode;
 	Node	   *node;
 	int			uncompressed_len;
+	int32		codec;
+	instr_time	starttime;
+	instr_time	endtime;
 
 	Assert(strNode != NULL);
+	Assert(size >= sizeof(int32));
 
 	START_MEMORY_ACCOUNT(MemoryAccounting_CreateAccount(0, MEMORY_OWNER_TYPE_Deserializer));
 	{
-		sNode = uncompress_string(strNode, size, &uncompressed_len);
+		if (DEBUG1 >= log_min_messages)
+			INSTR_TIME_SET_CURRENT(starttime);
+
+		/* the codec is identified by the sign of the leading length word */
+		memcpy(&codec, strNode, sizeof(int32));
+		codec = (codec >= 0) ? PLAN_CODEC_ZLIB : -codec;
+
+		switch (codec)
+		{
+			case PLAN_CODEC_ZLIB:
+				sNode = uncompress_string(strNode, size, &uncompressed_len);
+				break;
+#ifdef HAVE_LIBZSTD
+			case PLAN_CODEC_ZSTD:
+				sNode = uncompress_string_zstd(strNode, size, &uncompressed_len);
+				break;
+#endif
+			default:
+				ereport(ERROR,
+						(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+						 errmsg("serialized plan is compressed with an unsupported codec (%d)",
+								codec)));
+				sNode = NULL;	/* keep compiler quiet */
+		}
 
 		Assert(sNode != NULL);
 
 		node = readNodeFromBinaryString(sNode, uncompressed_len);
 
 		pfree(sNode);
+
+		if (DEBUG1 >= log_min_messages)
+		{
+			INSTR_TIME_SET_CURRENT(endtime);
+			INSTR_TIME_SUBTRACT(endtime, starttime);
+			elog(DEBUG1, "deserialized node: %d bytes, uncompressed to %d bytes in %.3f ms",
+				 size, uncompressed_len, INSTR_TIME_GET_MILLISEC(endtime));
+		}
 	}
 	END_MEMORY_ACCOUNT();
 
@@ -155,3 +255,230 @@ uncompress_string(const char *src, int size, int *uncompressed_len)
 
 	return (char *) result;
 }
+
+#ifdef HAVE_LIBZSTD
+
+/*
+ * Plans are compressed with zstd at its default level, primed with a
+ * dictionary. Most dispatched plans are small, and a small input gives the
+ * compressor little history to find matches in; the dictionary provides
+ * that history up front. On plans of a few hundred bytes it saves about a
+ * quarter of the output and most of the time. Level 1 is no faster on
+ * plans of that size and falls behind on large ones, e.g. plans with many
+ * partitions; from level 6 up, compression takes several times longer for
+ * a few percent.
+ */
+#define PLAN_ZSTD_LEVEL		3
+
+static ZSTD_CCtx *plan_zstd_cctx = NULL;
+static ZSTD_DCtx *plan_zstd_dctx = NULL;
+static ZSTD_CDict *plan_zstd_cdict = NULL;
+static ZSTD_DDict *plan_zstd_ddict = NULL;
+static uint32 plan_zstd_dictid = 0;
+
+static void
+appendDictNode(StringInfo buf, void *node)
+{
+	char	   *str;
+	int			len;
+
+	str = nodeToBinaryStringFast(node, &len);
+	appendBinaryStringInfo(buf, str, len);
+	pfree(str);
+}
+
+/*
+ * Build the dictionary the plans are compressed with.
+ *
+ * It is the serialized form of a skeleton plan made of the nodes that
+ * appear in almost every dispatched plan. Their node tags and the mostly
+ * zero fields around them are the bulk of a small plan. The content
+ * depends only on the node serialization code, not on the catalogs, so
+ * the QD and the QEs come up with the same dictionary; its checksum goes
+ * into each compressed node so that a mismatch is detected rather than
+ * misdecoded.
+ */
+static void
+buildPlanDictionary(StringInfo buf)
+{
+	Motion	   *motion = makeNode(Motion);
+	HashJoin   *hashjoin = makeNode(HashJoin);
+	Hash	   *hash = makeNode(Hash);
+	SeqScan    *outerscan = makeNode(SeqScan);
+	SeqScan    *innerscan = makeNode(SeqScan);
+	Agg		   *agg = makeNode(Agg);
+	Sort	   *sort = makeNode(Sort);
+	Result	   *result = makeNode(Result);
+	Var		   *var = makeVar(1, 1, INT4OID, -1, 0);
+	Const	   *cnst = makeConst(INT4OID, -1, sizeof(int32), (Datum) 0, true, true);
+	OpExpr	   *opexpr = makeNode(OpExpr);
+	List	   *tlist;
+
+	tlist = list_make1(makeTargetEntry((Expr *) var, 1, NULL, false));
+	opexpr->opresulttype = BOOLOID;
+	opexpr->args = list_make2(copyObject(var), cnst);
+
+	outerscan->plan.targetlist = tlist;
+	outerscan->plan.qual = list_make1(opexpr);
+	outerscan->plan.flow = makeFlow(FLOW_PARTITIONED);
+	innerscan->plan.targetlist = copyObject(tlist);
+	innerscan->plan.flow = makeFlow(FLOW_PARTITIONED);
+
+	hash->plan.targetlist = copyObject(tlist);
+	hash->plan.lefttree = (Plan *) innerscan;
+	hashjoin->join.plan.targetlist = copyObject(tlist);
+	hashjoin->join.plan.lefttree = (Plan *) outerscan;
+	hashjoin->join.plan.righttree = (Plan *) hash;
+	hashjoin->hashclauses = list_make1(copyObject(opexpr));
+
+	motion->plan.targetlist = copyObject(tlist);
+	motion->plan.lefttree = (Plan *) hashjoin;
+	motion->plan.flow = makeFlow(FLOW_SINGLETON);
+
+	agg->plan.targetlist = copyObject(tlist);
+	sort->plan.targetlist = copyObject(tlist);
+	result->plan.targetlist = copyObject(tlist);
+
+	appendDictNode(buf, agg);
+	appendDictNode(buf, sort);
+	appendDictNode(buf, result);
+	appendDictNode(buf, motion);
+}
+
+static void
+initPlanZstd(void)
+{
+	StringInfoData dict;
+	MemoryContext dictcontext;
+	MemoryContext oldcontext;
+
+	if (plan_zstd_cctx != NULL)
+		return;
+
+	dictcontext = AllocSetContextCreate(CurrentMemoryContext,
+										"plan dictionary",
+										ALLOCSET_SMALL_MINSIZE,
+										ALLOCSET_SMALL_INITSIZE,
+										ALLOCSET_SMALL_MAXSIZE);
+	oldcontext = MemoryContextSwitchTo(dictcontext);
+	initStringInfo(&dict);
+	buildPlanDictionary(&dict);
+	MemoryContextSwitchTo(oldcontext);
+
+	/* zstd keeps its own copy of the dictionary */
+	plan_zstd_cdict = ZSTD_createCDict(dict.data, dict.len, PLAN_ZSTD_LEVEL);
+	plan_zstd_ddict = ZSTD_createDDict(dict.data, dict.len);
+	plan_zstd_dictid = DatumGetUInt32(hash_any((const unsigned char *) dict.data, dict.len));
+	MemoryContextDelete(dictcontext);
+
+	plan_zstd_dctx = ZSTD_createDCtx();
+	plan_zstd_cctx = ZSTD_createCCtx();
+
+	if (plan_zstd_cdict == NULL || plan_zstd_ddict == NULL ||
+		plan_zstd_dctx == NULL || plan_zstd_cctx == NULL)
+	{
+		ZSTD_freeCDict(plan_zstd_cdict);
+		ZSTD_freeDDict(plan_zstd_ddict);
+		ZSTD_freeDCtx(plan_zstd_dctx);
+		ZSTD_freeCCtx(plan_zstd_cctx);
+		plan_zstd_cdict = NULL;
+		plan_zstd_ddict = NULL;
+		plan_zstd_dctx = NULL;
+		plan_zstd_cctx = NULL;
+
+		ereport(ERROR,
+				(errcode(ERRCODE_OUT_OF_MEMORY),
+				 errmsg("out of memory"),
+				 errdetail("Failed to set up zstd plan compression.")));
+	}
+}
+
+/*
+ * Compress a (binary) string using zstd and the plan dictionary.
+ *
+ * returns the compressed data and the size of the compressed data.
+ */
+static char *
+compress_string_zstd(const char *src, int uncompressed_size, int *size)
+{
+	PlanCodecHeader hdr;
+	size_t		bound;
+	size_t		compressed_size;
+	char	   *result;
+
+	Assert(size != NULL);
+
+	if (src == NULL)
+	{
+		*size = 0;
+		return NULL;
+	}
+
+	initPlanZstd();
+
+	bound = ZSTD_compressBound(uncompressed_size);
+	result = palloc(sizeof(hdr) + bound);
+
+	compressed_size = ZSTD_compress_usingCDict(plan_zstd_cctx,
+											   result + sizeof(hdr), bound,
+											   src, uncompressed_size,
+											   plan_zstd_cdict);
+	if (ZSTD_isError(compressed_size))
+		elog(ERROR, "Compression failed: %s uncompressed len %d",
+			 ZSTD_getErrorName(compressed_size), uncompressed_size);
+
+	hdr.codec = -PLAN_CODEC_ZSTD;
+	hdr.uncompressed_len = uncompressed_size;
+	hdr.dictid = plan_zstd_dictid;
+	memcpy(result, &hdr, sizeof(hdr));
+
+	*size = compressed_size + sizeof(hdr);
+
+	return result;
+}
+
+/*
+ * Uncompress a string compressed by compress_string_zstd()
+ */
+static char *
+uncompress_string_zstd(const char *src, int size, int *uncompressed_len)
+{
+	PlanCodecHeader hdr;
+	char	   *result;
+	size_t		resultlen;
+
+	*uncompressed_len = 0;
+
+	if (src == NULL)
+		return NULL;
+
+	if (size < sizeof(hdr))
+		elog(ERROR, "Uncompress failed: truncated zstd header (compressed len %d)",
+			 size);
+	memcpy(&hdr, src, sizeof(hdr));
+
+	initPlanZstd();
+
+	if (hdr.dictid != plan_zstd_dictid)
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("serialized plan was compressed with a different plan dictionary"),
+				 errhint("Make sure that the master and the segments run the same version, or set gp_plan_serialization_codec to zlib.")));
+
+	result = palloc(hdr.uncompressed_len);
+
+	resultlen = ZSTD_decompress_usingDDict(plan_zstd_dctx,
+										   result, hdr.uncompressed_len,
+										   src + sizeof(hdr), size - sizeof(hdr),
+										   plan_zstd_ddict);
+	if (ZSTD_isError(resultlen) || resultlen != hdr.uncompressed_len)
+		elog(ERROR, "Uncompress failed: %s (compressed len %d, uncompressed %d)",
+			 ZSTD_isError(resultlen) ? ZSTD_getErrorName(resultlen) : "length mismatch",
+			 size, hdr.uncompressed_len);
+
+	*uncompressed_len = hdr.uncompressed_len;
+
+	return result;
+}
+
+#endif   /* HAVE_LIBZSTD */
@@ -277,7 +277,8 @@ GetContentIdsFromPlanForSingleRelation(List *rtable, Plan *plan, int rangeTableI
 			/* don't bother for ones which will likely hash to many segments */
 				 totalCombinations < GpIdentity.numsegments * 3)
 		{
-			CdbHash    *h = makeCdbHash(GpIdentity.numsegments);
+			CdbHash    *h = makeCdbHash(GpIdentity.numsegments,
+											policy->hashreduce);
 			long		index = 0;
 
 			result.dd.isDirectDispatch = true;
@@ -183,6 +183,7 @@ int			Gp_interconnect_fc_method = INTERCONNECT_FC_METHOD_LOSS;
 int			Gp_interconnect_transmit_timeout = 3600;
 int			Gp_interconnect_min_retries_before_timeout = 100;
 int			Gp_interconnect_debug_retry_interval = 10;
+int			Gp_interconnect_io_batch_size = 16;
 
 int			Gp_interconnect_hash_multiplier = 2;	/* sets the size of the
 													 * hash table used by the
@@ -201,6 +202,8 @@ bool		gp_interconnect_log_stats = false;	/* emit stats at log-level */
 
 bool		gp_interconnect_cache_future_packets = true;
 
+bool		gp_interconnect_local_sockets = false;
+
 int			Gp_udp_bufsize_k;	/* UPD recv buf size, in KB */
 
 #ifdef USE_ASSERT_CHECKING
@@ -240,6 +243,7 @@ bool		gp_selectivity_damping_sigsort = true;
 
 int			gp_hashjoin_tuples_per_bucket = 5;
 int			gp_hashagg_groups_per_bucket = 5;
+int			gp_hashagg_probe_batch_size = 16;
 
 
 /* default value to 0, which means we do not try to control number of spill batches */
@@ -281,7 +285,17 @@ int			gp_max_plan_size = 0;
 /* Disable setting of tuple hints while reading */
 bool		gp_disable_tuple_hints = false;
 
+/* Evaluate simple quals of AOCS scans over batches of rows */
+bool		gp_enable_aocs_batch_scan = true;
+
+/* Read the columns that batch quals don't need only for qualifying rows */
+bool		gp_enable_aocs_late_materialization = true;
+
+/* Specialize function calls on columns and constants above this plan cost */
+double		gp_expr_specialize_above_cost = 100000;
+
 int			gp_workfile_compress_algorithm = 0;
+int			gp_workfile_compress_zstd_level = 1;
 bool		gp_workfile_checksumming = false;
 int			gp_workfile_caching_loglevel = DEBUG1;
 int			gp_sessionstate_loglevel = DEBUG1;
@@ -296,6 +310,10 @@ double		gp_workfile_limit_per_query = 0;
 int			gp_workfile_limit_files_per_query = 0;
 int			gp_workfile_bytes_to_checksum = 16;
 
+/* Read-ahead and write-behind distance of workfile I/O, in blocks */
+int			gp_workfile_prefetch_blocks = 16;
+int			gp_workfile_writeback_blocks = 0;
+
 /* The type of work files that HashJoin should use */
 int			gp_workfile_type_hashjoin = 0;
 
@@ -184,70 +184,87 @@ cdbdisp_getWaitSocketFd_async(struct CdbDispatcherState *ds)
 	return PGINVALID_SOCKET;
 }
 
+/*
+ * Push out any pending output of a QE connection, without blocking.
+ *
+ * Returns true if some of the query is still waiting to be sent.
+ */
+static bool
+flushDispatchOutput(CdbDispatchResult *qeResult)
+{
+	PGconn	   *conn = qeResult->segdbDesc->conn;
+	int			ret;
+
+	ret = pqFlushNonBlocking(conn);
+
+	if (ret < 0)
+	{
+		pqHandleSendFailure(conn);
+		char	   *msg = PQerrorMessage(conn);
+
+		qeResult->stillRunning = false;
+		ereport(ERROR,
+				(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+				 errmsg("Command could not be dispatch to segment %s: %s", qeResult->segdbDesc->whoami, msg ? msg : "unknown error")));
+	}
+
+	return ret > 0;
+}
+
 /*
  * Block until all data are dispatched.
+ *
+ * The command was already pushed to each QE as far as its socket buffer
+ * allowed when it was dispatched. Send the rest to all QEs in an interleaved
+ * fashion: after one more pass over every connection, only the connections
+ * that poll() reports writable are flushed again, so a slow QE doesn't hold
+ * up the others, nor do we keep retrying sends that can't make progress.
  */
 static void
 cdbdisp_waitDispatchFinish_async(struct CdbDispatcherState *ds)
 {
 	const static int DISPATCH_POLL_TIMEOUT = 500;
 	struct pollfd *fds;
+	CdbDispatchResult **pending;
 	int			nfds,
-				i;
+				i,
+				j;
 	CdbDispatchCmdAsync *pParms = (CdbDispatchCmdAsync *) ds->dispatchParams;
 	int			dispatchCount = pParms->dispatchCount;
 
 	fds = (struct pollfd *) palloc(dispatchCount * sizeof(struct pollfd));
+	pending = (CdbDispatchResult **) palloc(dispatchCount * sizeof(CdbDispatchResult *));
 
-	while (true)
+	/*
+	 * Call send for all connections regardless of their POLLOUT status,
+	 * because they may be writable NOW
+	 */
+	nfds = 0;
+	for (i = 0; i < dispatchCount; i++)
 	{
-		int			pollRet;
+		CdbDispatchResult *qeResult = pParms->dispatchResultPtrArray[i];
+		PGconn	   *conn = qeResult->segdbDesc->conn;
 
-		nfds = 0;
-		memset(fds, 0, dispatchCount * sizeof(struct pollfd));
+		/* skip already completed connections */
+		if (conn->outCount == 0)
+			continue;
 
-		for (i = 0; i < dispatchCount; i++)
+		if (flushDispatchOutput(qeResult))
 		{
-			CdbDispatchResult *qeResult = pParms->dispatchResultPtrArray[i];
-			SegmentDatabaseDescriptor *segdbDesc = qeResult->segdbDesc;
-			PGconn	   *conn = segdbDesc->conn;
-			int			ret;
-
-			/* skip already completed connections */
-			if (conn->outCount == 0)
-				continue;
-
-			/*
-			 * call send for this connection regardless of its POLLOUT status,
-			 * because it may be writable NOW
-			 */
-			ret = pqFlushNonBlocking(conn);
-
-			if (ret == 0)
-				continue;
-			else if (ret > 0)
-			{
-				int			sock = PQsocket(segdbDesc->conn);
-
-				Assert(sock >= 0);
-				fds[nfds].fd = sock;
-				fds[nfds].events = POLLOUT;
-				nfds++;
-			}
-			else if (ret < 0)
-			{
-				pqHandleSendFailure(conn);
-				char	   *msg = PQerrorMessage(conn);
+			int			sock = PQsocket(conn);
 
-				qeResult->stillRunning = false;
-				ereport(ERROR,
-						(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
-						 errmsg("Command could not be dispatch to segment %s: %s", qeResult->segdbDesc->whoami, msg ? msg : "unknown error")));
-			}
+			Assert(sock >= 0);
+			fds[nfds].fd = sock;
+			fds[nfds].events = POLLOUT;
+			fds[nfds].revents = 0;
+			pending[nfds] = qeResult;
+			nfds++;
 		}
+	}
 
-		if (nfds == 0)
-			break;
+	while (nfds > 0)
+	{
+		int			pollRet;
 
 		/* guarantee poll() is interruptible */
 		do
@@ -262,8 +279,26 @@ cdbdisp_waitDispatchFinish_async(struct CdbDispatcherState *ds)
 
 		if (pollRet < 0)
 			elog(ERROR, "Poll failed during dispatch");
+
+		/*
+		 * Flush the connections that are ready (or broken, in which case the
+		 * send reports the error), and keep the rest in the poll set.
+		 */
+		for (i = 0, j = 0; i < nfds; i++)
+		{
+			if (fds[i].revents != 0 && !flushDispatchOutput(pending[i]))
+				continue;
+
+			fds[j].fd = fds[i].fd;
+			fds[j].events = POLLOUT;
+			fds[j].revents = 0;
+			pending[j] = pending[i];
+			j++;
+		}
+		nfds = j;
 	}
 
+	pfree(pending);
 	pfree(fds);
 }
 
@@ -20,6 +20,7 @@
 #include "libpq-fe.h"
 #include "libpq-int.h"
 #include "cdb/cdbconn.h"
+#include "cdb/cdbexplain.h"
 #include "cdb/cdbgang.h"
 #include "cdb/cdbutil.h"
 #include "cdb/cdbvars.h"
@@ -27,6 +28,7 @@
 #include "cdb/cdbsrlz.h"
 #include "cdb/tupleremap.h"
 #include "nodes/execnodes.h"
+#include "portability/instr_time.h"
 #include "tcop/tcopprot.h"
 #include "utils/datum.h"
 #include "utils/guc.h"
@@ -103,6 +105,12 @@ typedef struct DispatchCommandQueryParms
 	/* the map from sliceIndex to gang_id, in array form */
 	int			numSlices;
 	int		   *sliceIndexGangIdMap;
+
+	/*
+	 * time spent serializing and compressing the plan and its parameters,
+	 * for EXPLAIN ANALYZE
+	 */
+	instr_time	serializeTime;
 } DispatchCommandQueryParms;
 
 static void cdbdisp_dispatchCommandInternal(const char *strCommand,
@@ -565,6 +573,9 @@ cdbdisp_buildPlanQueryParms(struct QueryDesc *queryDesc,
 	CdbComponentDatabaseInfo *qdinfo;
 
 	DispatchCommandQueryParms *pQueryParms = (DispatchCommandQueryParms *) palloc0(sizeof(*pQueryParms));
+	instr_time	starttime;
+
+	INSTR_TIME_SET_CURRENT(starttime);
 
 	/*
 	 * serialized plan tree. Note that we're called for a single slice tree
@@ -602,6 +613,9 @@ cdbdisp_buildPlanQueryParms(struct QueryDesc *queryDesc,
 
 	sddesc = serializeNode((Node *) queryDesc->ddesc, &sddesc_len, NULL /* uncompressed_size */ );
 
+	INSTR_TIME_SET_CURRENT(pQueryParms->serializeTime);
+	INSTR_TIME_SUBTRACT(pQueryParms->serializeTime, starttime);
+
 	pQueryParms->strCommand = queryDesc->sourceText;
 	pQueryParms->serializedQuerytree = NULL;
 	pQueryParms->serializedQuerytreelen = 0;
@@ -1115,6 +1129,9 @@ cdbdisp_dispatchX(DispatchCommandQueryParms *pQueryParms,
 	int			queryTextLength = 0;
 	struct SliceTable *sliceTbl;
 	CdbDispatcherState *ds;
+	instr_time	starttime;
+	instr_time	serializetime;
+	instr_time	sendtime;
 
 	if (log_dispatch_stats)
 		ResetUsage();
@@ -1143,7 +1160,9 @@ cdbdisp_dispatchX(DispatchCommandQueryParms *pQueryParms,
 	ds = cdbdisp_makeDispatcherState();
 	MemoryContext oldContext = NULL;
 	oldContext = MemoryContextSwitchTo(DispatcherContext);
+	INSTR_TIME_SET_CURRENT(starttime);
 	queryText = buildGpQueryString(pQueryParms, &queryTextLength);
+	INSTR_TIME_SET_CURRENT(serializetime);
 	ds->primaryResults = cdbdisp_makeDispatchResults(nTotalSlices, cancelOnError);
 	ds->dispatchParams = cdbdisp_makeDispatchParams(nTotalSlices, queryText, queryTextLength);
 	MemoryContextSwitchTo(oldContext);
@@ -1251,6 +1270,24 @@ cdbdisp_dispatchX(DispatchCommandQueryParms *pQueryParms,
 
 	cdbdisp_waitDispatchFinish(ds);
 
+	/*
+	 * For EXPLAIN ANALYZE, remember how long it took to serialize the plan
+	 * and to get it out to all the QEs.
+	 */
+	if (estate->showstatctx)
+	{
+		INSTR_TIME_SET_CURRENT(sendtime);
+		INSTR_TIME_SUBTRACT(sendtime, serializetime);
+		INSTR_TIME_SUBTRACT(serializetime, starttime);
+		INSTR_TIME_ADD(serializetime, pQueryParms->serializeTime);
+
+		cdbexplain_recordDispatchStats(estate->showstatctx,
+									   ds->primaryResults->resultCount,
+									   queryTextLength,
+									   INSTR_TIME_GET_MILLISEC(serializetime),
+									   INSTR_TIME_GET_MILLISEC(sendtime));
+	}
+
 	/*
 	 * If bailed before completely dispatched, stop QEs and throw error.
 	 */
@@ -39,6 +39,7 @@
 #include "cdb/cdbconn.h"		/* SegmentDatabaseDescriptor */
 #include "cdb/cdbfts.h"
 #include "cdb/cdbdisp_query.h"
+#include "cdb/cdbsrlz.h"		/* gp_plan_serialization_codec */
 #include "cdb/cdbgang.h"		/* me */
 #include "cdb/cdbgang_thread.h"
 #include "cdb/cdbgang_async.h"
@@ -656,7 +657,23 @@ makeOptions(void)
 
 		if ((guc->flags & GUC_GPDB_ADDOPT) &&
 			(guc->context == PGC_USERSET || procRoleIsSuperuser()))
+		{
+			/*
+			 * Segments of older releases don't know the plan codec setting
+			 * and would refuse the connection, while all of them decode
+			 * zlib. So only a codec other than zlib is passed on.
+			 */
+			if (strcmp(guc->name, "gp_plan_serialization_codec") == 0 &&
+				gp_plan_serialization_codec == PLAN_CODEC_ZLIB)
+				continue;
+
+			/* Likewise, same-host sockets are only asked for when on */
+			if (strcmp(guc->name, "gp_interconnect_local_sockets") == 0 &&
+				!gp_interconnect_local_sockets)
+				continue;
+
 			addOneOption(&string, guc);
+		}
 	}
 
 	return string.data;
@@ -65,6 +65,11 @@ static void processIncomingChunks(MotionLayerState *mlStates,
 					  int16 srcRoute);
 
 static inline void reconstructTuple(MotionNodeEntry *pMNEntry, ChunkSorterEntry *pCSEntry, TupleRemapper *remapper);
+static void reconstructTupleBatch(MotionNodeEntry *pMNEntry, ChunkSorterEntry *pCSEntry,
+					  TupleChunkListItem tcItem, TupleRemapper *remapper);
+static GenericTuple getBatchTuple(MotionNodeEntry *pMNEntry, bool *shouldFree);
+static void releaseBatches(ChunkTransportState *transportStates,
+			   MotionNodeEntry *pMNEntry, int16 motNodeID);
 
 /* Stats-function declarations. */
 static void statSendTuple(MotionLayerState *mlStates, MotionNodeEntry *pMNEntry, TupleChunkList tcList);
@@ -107,6 +112,91 @@ reconstructTuple(MotionNodeEntry *pMNEntry, ChunkSorterEntry *pCSEntry, TupleRem
 	statNewTupleArrived(pMNEntry, pCSEntry);
 }
 
+/*
+ * Like reconstructTuple(), for all the tuples packed into a TC_WHOLE_BATCH
+ * chunk.  The chunk is freed.  The tuples are copied, as a merge receiver
+ * holds on to them across receives; unordered receivers return them in place
+ * instead, see getBatchTuple().
+ */
+static void
+reconstructTupleBatch(MotionNodeEntry *pMNEntry, ChunkSorterEntry *pCSEntry,
+					  TupleChunkListItem tcItem, TupleRemapper *remapper)
+{
+	GenericTuple tup;
+	GenericTuple copy;
+	int			offset = 0;
+
+	while ((tup = CvtBatchChunkToTup(tcItem, &offset)) != NULL)
+	{
+		copy = TRCheckAndRemap(remapper, pMNEntry->ser_tup_info.tupdesc, tup);
+		if (copy == tup)
+			copy = (GenericTuple) memtuple_copy_to((MemTuple) tup, NULL, NULL);
+		tup = copy;
+
+		htfifo_addtuple(pCSEntry->ready_tuples, tup);
+
+		/* Stats */
+		statNewTupleArrived(pMNEntry, pCSEntry);
+	}
+
+	pfree(tcItem);
+}
+
+/*
+ * Return the next tuple of the TC_WHOLE_BATCH chunks that an unordered
+ * receiver has received, or NULL if there are none left.  The tuple points
+ * into the receive buffer, which stays until the next receive, unless it had
+ * to be remapped: *shouldFree tells which.
+ */
+static GenericTuple
+getBatchTuple(MotionNodeEntry *pMNEntry, bool *shouldFree)
+{
+	GenericTuple tup;
+	GenericTuple remapped;
+
+	while (pMNEntry->cur_batch != NULL)
+	{
+		tup = CvtBatchChunkToTup(pMNEntry->cur_batch, &pMNEntry->batch_offset);
+		if (tup != NULL)
+		{
+			remapped = TRCheckAndRemap(pMNEntry->batch_remapper,
+									   pMNEntry->ser_tup_info.tupdesc, tup);
+			*shouldFree = (remapped != tup);
+
+			/* Stats */
+			statNewTupleArrived(pMNEntry, NULL);
+
+			return remapped;
+		}
+
+		/* On to the next chunk; they are all freed by the next receive. */
+		pMNEntry->cur_batch = pMNEntry->cur_batch->p_next;
+		pMNEntry->batch_offset = 0;
+	}
+
+	return NULL;
+}
+
+/*
+ * Free the TC_WHOLE_BATCH chunks of the last receive of an unordered
+ * receiver, and release the receive buffer that they point into.
+ */
+static void
+releaseBatches(ChunkTransportState *transportStates,
+			   MotionNodeEntry *pMNEntry, int16 motNodeID)
+{
+	clearTCList(NULL, &pMNEntry->ready_batches);
+	pMNEntry->cur_batch = NULL;
+	pMNEntry->batch_offset = 0;
+
+	if (pMNEntry->batch_route >= 0)
+	{
+		if (Gp_interconnect_type == INTERCONNECT_TYPE_UDPIFC)
+			MlPutRxBufferIFC(transportStates, motNodeID, pMNEntry->batch_route);
+		pMNEntry->batch_route = -1;
+	}
+}
+
 /*
  * FUNCTION DEFINITIONS
  */
@@ -354,6 +444,15 @@ UpdateMotionLayerNode(MotionLayerState *mlStates, int16 motNodeID, bool preserve
 	else
 		pEntry->ready_tuples = NULL;
 
+	pEntry->ready_batches.p_first = NULL;
+	pEntry->ready_batches.p_last = NULL;
+	pEntry->ready_batches.num_chunks = 0;
+	pEntry->ready_batches.serialized_data_length = 0;
+	pEntry->ready_batches.max_chunk_length = 0;
+	pEntry->cur_batch = NULL;
+	pEntry->batch_offset = 0;
+	pEntry->batch_route = -1;
+	pEntry->batch_remapper = NULL;
 
 	pEntry->num_stream_ends_recvd = 0;
 
@@ -546,15 +645,16 @@ SendTuple(MotionLayerState *mlStates,
 
 		if (b.pri != NULL && b.prilen > TUPLE_CHUNK_HEADER_SIZE)
 		{
+			unsigned char *batch = b.batch;
 			int			sent = 0;
 
 			sent = SerializeTupleDirect(tuple, &pMNEntry->ser_tup_info, &b);
 			if (sent > 0)
 			{
-				putTransportDirectBuffer(transportStates, motNodeID, targetRoute, sent);
+				putTransportDirectBuffer(transportStates, motNodeID, targetRoute, sent, b.batch);
 
 				/* fill-in tcList fields to update stats */
-				tcList.num_chunks = 1;
+				tcList.num_chunks = (b.batch != NULL && b.batch == batch) ? 0 : 1;
 				tcList.serialized_data_length = sent;
 
 				/* update stats */
@@ -645,6 +745,7 @@ RecvTupleFrom(MotionLayerState *mlStates,
 			  ChunkTransportState *transportStates,
 			  int16 motNodeID,
 			  GenericTuple *tup_i,
+			  bool *shouldFree,
 			  int16 srcRoute)
 {
 	MotionNodeEntry *pMNEntry;
@@ -678,7 +779,13 @@ RecvTupleFrom(MotionLayerState *mlStates,
 	}
 
 	/* Get the next HeapTuple, if one is available! */
-	*tup_i = htfifo_gettuple(ReadyList);
+	*shouldFree = true;
+	if (srcRoute == ANY_ROUTE)
+		*tup_i = getBatchTuple(pMNEntry, shouldFree);
+	else
+		*tup_i = NULL;
+	if (*tup_i == NULL)
+		*tup_i = htfifo_gettuple(ReadyList);
 
 	if (*tup_i != NULL)
 	{
@@ -712,7 +819,11 @@ RecvTupleFrom(MotionLayerState *mlStates,
 		processIncomingChunks(mlStates, transportStates, pMNEntry, motNodeID, srcRoute);
 
 		if (srcRoute == ANY_ROUTE)
-			*tup_i = htfifo_gettuple(pMNEntry->ready_tuples);
+		{
+			*tup_i = getBatchTuple(pMNEntry, shouldFree);
+			if (*tup_i == NULL)
+				*tup_i = htfifo_gettuple(pMNEntry->ready_tuples);
+		}
 		else
 			*tup_i = htfifo_gettuple(pCSEntry->ready_tuples);
 
@@ -778,6 +889,10 @@ processIncomingChunks(MotionLayerState *mlStates,
 
 	oldCtxt = MemoryContextSwitchTo(mlStates->motion_layer_mctx);
 
+	/* The tuples returned in place by the last receive are done with. */
+	if (!pMNEntry->preserve_order)
+		releaseBatches(transportStates, pMNEntry, motNodeID);
+
 	/*
 	 * Get all of the currently available tuple-chunks, and push each one into
 	 * the chunk-sorter.
@@ -818,8 +933,16 @@ processIncomingChunks(MotionLayerState *mlStates,
 		tcItem = tcNext;
 	}
 
-	/* The chunk list we just processed freed-up our rx-buffer space. */
-	if (Gp_interconnect_type == INTERCONNECT_TYPE_UDPIFC)
+	/*
+	 * The chunk list we just processed freed-up our rx-buffer space, unless
+	 * it holds batches of tuples that are returned in place.
+	 */
+	if (pMNEntry->ready_batches.p_first != NULL)
+	{
+		pMNEntry->cur_batch = pMNEntry->ready_batches.p_first;
+		pMNEntry->batch_route = srcRoute;
+	}
+	else if (Gp_interconnect_type == INTERCONNECT_TYPE_UDPIFC)
 		MlPutRxBufferIFC(transportStates, motNodeID, srcRoute);
 
 	/* Stats */
@@ -953,8 +1076,15 @@ EndMotionLayerNode(MotionLayerState *mlStates, int16 motNodeID, bool flushCommLa
 	CleanupSerTupInfo(&pMNEntry->ser_tup_info);
 	FreeTupleDesc(pMNEntry->tuple_desc);
 	if (!pMNEntry->preserve_order)
+	{
 		htfifo_destroy(pMNEntry->ready_tuples);
 
+		/* The receive buffer they point into goes with the interconnect. */
+		clearTCList(NULL, &pMNEntry->ready_batches);
+		pMNEntry->cur_batch = NULL;
+		pMNEntry->batch_route = -1;
+	}
+
 	pMNEntry->valid = false;
 }
 
@@ -1154,6 +1284,30 @@ addChunkToSorter(MotionLayerState *mlStates,
 
 			break;
 
+		case TC_WHOLE_BATCH:
+			/* There shouldn't be any partial tuple data in the list! */
+			if (chunkSorterEntry->chunk_list.num_chunks != 0)
+			{
+				ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+								errmsg("Received TC_WHOLE_BATCH chunk from [src=%d,mn=%d] after"
+									   " partial tuple data.", srcRoute, motNodeID)));
+			}
+
+			/*
+			 * A merge receiver turns all the tuples in this chunk into tuples
+			 * at once.  An unordered receiver returns them in place, one at a
+			 * time, see RecvTupleFrom().
+			 */
+			if (pMNEntry->preserve_order)
+				reconstructTupleBatch(pMNEntry, chunkSorterEntry, tcItem, conn->remapper);
+			else
+			{
+				appendChunkToTCList(&pMNEntry->ready_batches, tcItem);
+				pMNEntry->batch_remapper = conn->remapper;
+			}
+
+			break;
+
 		case TC_PARTIAL_START:
 
 			/* There shouldn't be any partial tuple data in the list! */
@@ -1332,7 +1486,7 @@ statNewTupleArrived(MotionNodeEntry *pMNEntry, ChunkSorterEntry *pCSEntry)
 	uint32		tupsAvail;
 
 	AssertArg(pMNEntry != NULL);
-	AssertArg(pCSEntry != NULL);
+	AssertArg(pCSEntry != NULL || !pMNEntry->preserve_order);
 
 	/*
 	 * High-watermarks:  We track the number of tuples available to receive,
@@ -321,6 +321,19 @@ SendTupleChunkToAMS(MotionLayerState *mlStates,
 
 	getChunkTransportState(transportStates, motNodeID, &pEntry);
 
+	/*
+	 * The chunks may flush the buffers and refill them, so that the message
+	 * size could come back to the end of an earlier batch chunk by chance.
+	 * Make sure that later tuples start a new one.
+	 */
+	if (targetRoute == BROADCAST_SEGIDX)
+	{
+		for (i = 0; i < pEntry->numConns; i++)
+			pEntry->conns[i].batchChunkEnd = 0;
+	}
+	else
+		pEntry->conns[targetRoute].batchChunkEnd = 0;
+
 	/*
 	 * tcItem can actually be a chain of tcItems.  we need to send out all of
 	 * them.
@@ -413,6 +426,12 @@ getTransportDirectBuffer(ChunkTransportState *transportStates,
 		b->pri = conn->pBuff + conn->msgSize;
 		b->prilen = Gp_max_packet_size - conn->msgSize;
 
+		/* can the next tuple go into the same batch chunk as the last one? */
+		if (conn->batchChunkEnd != 0 && conn->batchChunkEnd == conn->msgSize)
+			b->batch = conn->pBuff + conn->batchChunkOffset;
+		else
+			b->batch = NULL;
+
 		/* got buffer. */
 		return;
 	}
@@ -422,6 +441,7 @@ getTransportDirectBuffer(ChunkTransportState *transportStates,
 
 	b->pri = NULL;
 	b->prilen = 0;
+	b->batch = NULL;
 
 	return;
 }
@@ -436,7 +456,8 @@ getTransportDirectBuffer(ChunkTransportState *transportStates,
 void
 putTransportDirectBuffer(ChunkTransportState *transportStates,
 						 int16 motNodeID,
-						 int16 targetRoute, int length)
+						 int16 targetRoute, int length,
+						 unsigned char *batch)
 {
 	ChunkTransportStateEntry *pEntry = NULL;
 	MotionConn *conn;
@@ -463,6 +484,14 @@ putTransportDirectBuffer(ChunkTransportState *transportStates,
 	{
 		conn->msgSize += length;
 		conn->tupleCount++;
+
+		if (batch != NULL)
+		{
+			conn->batchChunkOffset = batch - conn->pBuff;
+			conn->batchChunkEnd = conn->msgSize;
+		}
+		else
+			conn->batchChunkEnd = 0;
 	}
 
 	/* put buffer. */
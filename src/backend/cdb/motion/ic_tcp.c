@@ -42,6 +42,9 @@
 #include <arpa/inet.h>
 #include <sys/time.h>
 #include <netinet/in.h>
+#ifdef HAVE_SYS_UN_H
+#include <sys/un.h>
+#endif
 
 /*
  * backlog for listen() call: it is important that this be something like a
@@ -116,6 +119,26 @@ WSAPoll(
 /* our timeout value for select() and other socket operations. */
 static struct timeval tval;
 
+/*
+ * Same-host connections.
+ *
+ * Besides the TCP listener, every backend listens on a Unix-domain socket in
+ * the Linux abstract namespace, named after its pid and TCP listener port.
+ * A sender whose peer has the same interconnect address as itself connects
+ * there instead, so that motion traffic between segments on the same host
+ * bypasses the TCP/IP stack.  Once connected, such a connection behaves
+ * exactly like a TCP one.  If anything goes wrong while setting it up, we
+ * quietly fall back to TCP.
+ */
+#if defined(HAVE_UNIX_SOCKETS) && defined(__linux__)
+#define IC_TCP_LOCAL_SOCKETS
+#endif
+
+static int	TCP_localListenerFd = -1;
+
+/* Address our TCP listener is bound to, for same-host checks; "" if any. */
+static char TCP_listenerAddr[128] = "";
+
 static inline MotionConn *
 getMotionConn(ChunkTransportStateEntry *pEntry, int iConn)
 {
@@ -140,9 +163,15 @@ static void updateOutgoingConnection(ChunkTransportState *transportStates,
 static void sendRegisterMessage(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, MotionConn *conn);
 static bool readRegisterMessage(ChunkTransportState *transportStates,
 					MotionConn *conn);
-static MotionConn *acceptIncomingConnection(void);
-
-static void flushInterconnectListenerBacklog(void);
+static MotionConn *acceptIncomingConnection(int listenerFd);
+
+static void flushInterconnectListenerBacklog(int listenerFd);
+#ifdef IC_TCP_LOCAL_SOCKETS
+static void getLocalSocketAddr(struct sockaddr_un *addr, socklen_t *addrlen, int pid, int port);
+static void setupLocalListeningSocket(int backlog, uint16 listenerPort);
+static bool setupLocalOutgoingConnection(ChunkTransportState *transportStates,
+							 ChunkTransportStateEntry *pEntry, MotionConn *conn);
+#endif
 
 static void waitOnOutbound(ChunkTransportStateEntry *pEntry);
 
@@ -220,6 +249,7 @@ setupTCPListeningSocket(int backlog, int *listenerSocketFd, uint16 *listenerPort
 					NULL, 0, NI_NUMERICHOST);
 		hints.ai_flags |= AI_NUMERICHOST;
 		localname = myname;
+		strlcpy(TCP_listenerAddr, myname, sizeof(TCP_listenerAddr));
 		elog(DEBUG1, "binding to %s only", localname);
 		if (gp_log_interconnect >= GPVARS_VERBOSITY_DEBUG)
 			ereport(DEBUG4, (errmsg("binding listener %s", localname)));
@@ -350,6 +380,10 @@ InitMotionTCP(int *listenerSocketFd, uint16 *listenerPort)
 
 	setupTCPListeningSocket(listenerBacklog, listenerSocketFd, listenerPort);
 
+#ifdef IC_TCP_LOCAL_SOCKETS
+	setupLocalListeningSocket(listenerBacklog, *listenerPort);
+#endif
+
 	return;
 }
 
@@ -357,10 +391,149 @@ InitMotionTCP(int *listenerSocketFd, uint16 *listenerPort)
 void
 CleanupMotionTCP(void)
 {
-	/* nothing to do. */
+	if (TCP_localListenerFd >= 0)
+		closesocket(TCP_localListenerFd);
+	TCP_localListenerFd = -1;
+	TCP_listenerAddr[0] = '\0';
+}
+
+#ifdef IC_TCP_LOCAL_SOCKETS
+/*
+ * getLocalSocketAddr
+ *
+ * Build the abstract Unix-domain socket address of the same-host listener
+ * belonging to the backend with the given pid and TCP listener port.
+ */
+static void
+getLocalSocketAddr(struct sockaddr_un *addr, socklen_t *addrlen, int pid, int port)
+{
+	int			len;
+
+	MemSet(addr, 0, sizeof(*addr));
+	addr->sun_family = AF_UNIX;
+
+	/* A leading NUL byte selects the abstract namespace. */
+	len = snprintf(addr->sun_path + 1, sizeof(addr->sun_path) - 1,
+				   "gpic.%d.%d", pid, port);
+	*addrlen = offsetof(struct sockaddr_un, sun_path) + 1 + len;
+}
+
+/*
+ * setupLocalListeningSocket
+ *
+ * Create the same-host listener.  Failure is not an error: peers will simply
+ * not find us, and use TCP.
+ */
+static void
+setupLocalListeningSocket(int backlog, uint16 listenerPort)
+{
+	struct sockaddr_un addr;
+	socklen_t	addrlen;
+	const char *fun;
+	int			fd;
+
+	Assert(TCP_localListenerFd < 0);
+
+	getLocalSocketAddr(&addr, &addrlen, MyProcPid, listenerPort);
+
+	fun = "socket";
+	fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0)
+		goto error;
+
+	fun = "bind";
+	if (bind(fd, (struct sockaddr *) &addr, addrlen) < 0)
+		goto error;
+
+	fun = "fcntl(O_NONBLOCK)";
+	if (!pg_set_noblock(fd))
+		goto error;
+
+	fun = "listen";
+	if (listen(fd, backlog) < 0)
+		goto error;
+
+	TCP_localListenerFd = fd;
 	return;
+
+error:
+	ereport(LOG, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+				  errmsg("Interconnect could not set up same-host listener socket, using tcp only."),
+				  errdetail("%s: %m", fun)));
+	if (fd >= 0)
+		closesocket(fd);
 }
 
+/*
+ * setupLocalOutgoingConnection
+ *
+ * Try to connect to the same-host listener of conn's peer.  Returns true,
+ * with the registration message (being) sent, on success.  Returns false if
+ * the caller should use TCP instead.
+ */
+static bool
+setupLocalOutgoingConnection(ChunkTransportState *transportStates,
+							 ChunkTransportStateEntry *pEntry, MotionConn *conn)
+{
+	CdbProcess *cdbProc = conn->cdbProc;
+	struct sockaddr_un addr;
+	socklen_t	addrlen;
+	int			n;
+
+	if (!gp_interconnect_local_sockets ||
+		TCP_listenerAddr[0] == '\0' ||
+		cdbProc->listenerAddr == NULL ||
+		strcmp(cdbProc->listenerAddr, TCP_listenerAddr) != 0)
+		return false;
+
+	conn->sockfd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (conn->sockfd < 0)
+		return false;
+
+	if (!pg_set_noblock(conn->sockfd))
+	{
+		closesocket(conn->sockfd);
+		conn->sockfd = -1;
+		return false;
+	}
+
+	getLocalSocketAddr(&addr, &addrlen, cdbProc->pid, cdbProc->listenerPort);
+
+	for (;;)
+	{							/* connect() EINTR retry loop */
+		ML_CHECK_FOR_INTERRUPTS(transportStates->teardownActive);
+
+		/* Unix-domain connect() completes or fails immediately. */
+		n = connect(conn->sockfd, (struct sockaddr *) &addr, addrlen);
+		if (n == 0)
+			break;
+
+		if (errno == EINTR)
+			continue;
+
+		if (gp_log_interconnect >= GPVARS_VERBOSITY_DEBUG)
+			ereport(DEBUG1, (errmsg("Interconnect could not connect to seg%d "
+									"pid=%d on same-host socket, using tcp: %m",
+									conn->remoteContentId, cdbProc->pid)));
+		closesocket(conn->sockfd);
+		conn->sockfd = -1;
+		return false;
+	}
+
+	if (gp_log_interconnect >= GPVARS_VERBOSITY_DEBUG)
+		ereport(DEBUG1, (errmsg("Interconnect connected to seg%d slice%d %s "
+								"pid=%d sockfd=%d through same-host socket",
+								conn->remoteContentId,
+								pEntry->recvSlice->sliceIndex,
+								conn->remoteHostAndPort,
+								cdbProc->pid,
+								conn->sockfd)));
+
+	sendRegisterMessage(transportStates, pEntry, conn);
+	return true;
+}
+#endif							/* IC_TCP_LOCAL_SOCKETS */
+
 /* Function readPacket() is used to read in the next packet from the given
  * MotionConn.
  *
@@ -661,6 +834,12 @@ setupOutgoingConnection(ChunkTransportState *transportStates, ChunkTransportStat
 		conn->sockfd = -1;
 	}
 
+#ifdef IC_TCP_LOCAL_SOCKETS
+	/* Peer on the same host?  Try to bypass TCP. */
+	if (setupLocalOutgoingConnection(transportStates, pEntry, conn))
+		return;
+#endif
+
 	/* Initialize hint structure */
 	MemSet(&hint, 0, sizeof(hint));
 	hint.ai_socktype = SOCK_STREAM;
@@ -1263,7 +1442,7 @@ old_conn:
  * socket does not have any pending connection requests.
  */
 static MotionConn *
-acceptIncomingConnection(void)
+acceptIncomingConnection(int listenerFd)
 {
 	int			newsockfd;
 	socklen_t	addrsize;
@@ -1278,7 +1457,7 @@ acceptIncomingConnection(void)
 	{							/* loop until success or EWOULDBLOCK */
 		MemSet(&remoteAddr, 0, sizeof(remoteAddr));
 		addrsize = sizeof(remoteAddr);
-		newsockfd = accept(TCP_listenerFd, (struct sockaddr *) &remoteAddr, &addrsize);
+		newsockfd = accept(listenerFd, (struct sockaddr *) &remoteAddr, &addrsize);
 		if (newsockfd >= 0)
 			break;
 
@@ -1305,7 +1484,7 @@ acceptIncomingConnection(void)
 									   Gp_listener_port),
 								errdetail("%s sockfd=%d: %m",
 										  "accept",
-										  TCP_listenerFd)));
+										  listenerFd)));
 				break;			/* not reached */
 			case ENOMEM:
 			case ENFILE:
@@ -1317,7 +1496,7 @@ acceptIncomingConnection(void)
 									   Gp_listener_port),
 								errdetail("%s sockfd=%d: %m",
 										  "accept",
-										  TCP_listenerFd)));
+										  listenerFd)));
 				break;			/* not reached */
 			default:
 				/* Network problem, connection aborted, etc.  Continue. */
@@ -1327,7 +1506,7 @@ acceptIncomingConnection(void)
 									 Gp_listener_port),
 							  errdetail("%s sockfd=%d: %m",
 										"accept",
-										TCP_listenerFd)));
+										listenerFd)));
 		}						/* switch (errno) */
 	}							/* loop until success or EWOULDBLOCK */
 
@@ -1509,6 +1688,12 @@ SetupTCPInterconnect(SliceTable *sliceTable)
 
 			MPP_FD_SET(TCP_listenerFd, &rset);
 			highsock = TCP_listenerFd;
+
+			if (TCP_localListenerFd >= 0)
+			{
+				MPP_FD_SET(TCP_localListenerFd, &rset);
+				highsock = Max(highsock, TCP_localListenerFd);
+			}
 		}
 
 		/* Inbound connections awaiting registration message */
@@ -1803,12 +1988,17 @@ SetupTCPInterconnect(SliceTable *sliceTable)
 		}
 
 		/*
-		 * Someone tickling our listener port?  Accept pending connections.
+		 * Someone tickling our listener ports?  Accept pending connections.
 		 */
-		if (MPP_FD_ISSET(TCP_listenerFd, &rset))
+		for (i = 0; i < 2; i++)
 		{
+			int			listenerFd = (i == 0) ? TCP_listenerFd : TCP_localListenerFd;
+
+			if (listenerFd < 0 || !MPP_FD_ISSET(listenerFd, &rset))
+				continue;
+
 			n--;
-			while ((conn = acceptIncomingConnection()) != NULL)
+			while ((conn = acceptIncomingConnection(listenerFd)) != NULL)
 			{
 				/*
 				 * get the connection read for a subsequent call to
@@ -2165,7 +2355,9 @@ TeardownTCPInterconnect(ChunkTransportState *transportStates,
 	 * them on a subsequent query!)
 	 */
 	if (TCP_listenerFd != -1)
-		flushInterconnectListenerBacklog();
+		flushInterconnectListenerBacklog(TCP_listenerFd);
+	if (TCP_localListenerFd != -1)
+		flushInterconnectListenerBacklog(TCP_localListenerFd);
 
 	transportStates->activated = false;
 	transportStates->sliceTable = NULL;
@@ -2298,6 +2490,10 @@ format_sockaddr(struct sockaddr *sa, char *buf, int bufsize)
 		}
 		snprintf(buf, 8, ":%s", remote_port);
 	}
+#endif
+#ifdef HAVE_UNIX_SOCKETS
+	else if (sa->sa_family == AF_UNIX)
+		snprintf(buf, bufsize, "[local]");
 #endif
 	else
 		snprintf(buf, bufsize, "?host?:?port?");
@@ -2306,7 +2502,7 @@ format_sockaddr(struct sockaddr *sa, char *buf, int bufsize)
 }								/* format_sockaddr */
 
 static void
-flushInterconnectListenerBacklog(void)
+flushInterconnectListenerBacklog(int listenerFd)
 {
 	int			pendingConn,
 				newfd,
@@ -2317,11 +2513,11 @@ flushInterconnectListenerBacklog(void)
 	do
 	{
 		MPP_FD_ZERO(&rset);
-		MPP_FD_SET(TCP_listenerFd, &rset);
+		MPP_FD_SET(listenerFd, &rset);
 		timeout.tv_sec = 0;
 		timeout.tv_usec = 0;
 
-		pendingConn = select(TCP_listenerFd + 1, (fd_set *) &rset, NULL, NULL, &timeout);
+		pendingConn = select(listenerFd + 1, (fd_set *) &rset, NULL, NULL, &timeout);
 		if (pendingConn > 0)
 		{
 			for (i = 0; i < pendingConn; i++)
@@ -2333,7 +2529,7 @@ flushInterconnectListenerBacklog(void)
 				socklen_t	addrsize;
 
 				addrsize = sizeof(remoteAddr);
-				newfd = accept(TCP_listenerFd, (struct sockaddr *) &remoteAddr, &addrsize);
+				newfd = accept(listenerFd, (struct sockaddr *) &remoteAddr, &addrsize);
 				if (newfd < 0)
 				{
 					ereport(DEBUG3, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
@@ -2387,7 +2583,7 @@ flushInterconnectListenerBacklog(void)
 		{
 			ereport(LOG, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
 						  errmsg("Interconnect error during listener cleanup."),
-						  errdetail("%s sockfd=%d: %m", "select", TCP_listenerFd)));
+						  errdetail("%s sockfd=%d: %m", "select", listenerFd)));
 		}
 
 		/*
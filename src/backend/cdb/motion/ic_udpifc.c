@@ -135,6 +135,20 @@ int
 /* 1/4 sec in msec */
 #define RX_THREAD_POLL_TIMEOUT (250)
 
+/*
+ * Batched socket I/O.
+ *
+ * Where sendmmsg()/recvmmsg() are available, the sender flushes the packets
+ * released by one sendBuffers() call, and the rx thread drains the listener
+ * socket, with one system call per batch of up to
+ * Gp_interconnect_io_batch_size packets.  Otherwise, or if the kernel turns
+ * out not to implement them, we fall back to one sendto()/recvfrom() per
+ * packet.
+ */
+#if defined(__linux__) && defined(MSG_WAITFORONE)
+#define UDPIC_HAVE_MMSG
+#endif
+
 /*
  * Flags definitions for flag-field of UDP-messages
  *
@@ -322,7 +336,9 @@ struct RxBufferPool
  * The buffer pool used for keeping data packets.
  *
  * maxCount is set to 1 to make sure there is always a buffer
- * for picking packets from OS buffer.
+ * for picking packets from OS buffer.  When the rx thread reads
+ * packets in batches it raises maxCount by one for every extra
+ * buffer slot it keeps, see rxThreadFunc().
  */
 static RxBufferPool rx_buffer_pool = {1, 0, NULL};
 
@@ -608,6 +624,10 @@ typedef struct AckSendParam
  * duplicatedPktNum          - duplicate packet number.
  * recvAckNum                - the number of Acks received.
  * statusQueryMsgNum         - the number of status query messages sent.
+ * sndBatchNum               - the number of sendmmsg() calls.
+ * sndBatchPktNum            - the number of packets sent by sendmmsg().
+ * recvBatchNum              - the number of recvmmsg() calls returning more than one packet.
+ * recvBatchPktNum           - the number of packets received by those calls.
  *
  */
 typedef struct ICStatistics
@@ -629,11 +649,23 @@ typedef struct ICStatistics
 	int32		duplicatedPktNum;
 	int32		recvAckNum;
 	int32		statusQueryMsgNum;
+	int32		sndBatchNum;
+	int32		sndBatchPktNum;
+	int32		recvBatchNum;
+	int32		recvBatchPktNum;
 } ICStatistics;
 
 /* Statistics for UDP interconnect. */
 static ICStatistics ic_statistics;
 
+/*
+ * Set once sendmmsg() or recvmmsg() fails with ENOSYS, so that we stop trying.
+ * The former is only touched by the main thread, the latter only by the rx
+ * thread.
+ */
+static bool sendmmsgUnavailable = false;
+static bool recvmmsgUnavailable = false;
+
 /*=========================================================================
  * STATIC FUNCTIONS declarations
  */
@@ -744,6 +776,10 @@ static inline void addCRC(icpkthdr *pkt);
 static inline bool checkCRC(icpkthdr *pkt);
 static void sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, MotionConn *conn);
 static void sendOnce(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, ICBuffer *buf, MotionConn *conn);
+static void sendBatch(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, ICBuffer **bufs, int nbufs);
+static inline int getIoBatchSize(bool forSend);
+static int	receivePackets(icpkthdr **pkts, int npkts, struct sockaddr_storage *peers, socklen_t *peerlens, int *lens);
+static bool handleRxPacket(icpkthdr *pkt, int read_count, struct sockaddr_storage *peer, socklen_t peerlen);
 static inline uint64 computeExpirationPeriod(MotionConn *conn, uint32 retry);
 
 static ICBuffer *getSndBuffer(MotionConn *conn);
@@ -902,6 +938,10 @@ dumpTransProtoStats()
 
 	pthread_mutex_unlock(&trans_proto_stats.lock);
 
+	fprintf(ofile, "snd_batch_num %d snd_batch_pkt_num %d recv_batch_num %d recv_batch_pkt_num %d\n",
+			ic_statistics.sndBatchNum, ic_statistics.sndBatchPktNum,
+			ic_statistics.recvBatchNum, ic_statistics.recvBatchPktNum);
+
 	fclose(ofile);
 }
 
@@ -3519,7 +3559,8 @@ TeardownUDPIFCInterconnect_Internal(ChunkTransportState *transportStates,
 		 " freebuf_avg %f "
 		 "mismatch_pkt_num %d disordered_pkt_num %d duplicated_pkt_num %d"
 		 " rtt/dev [" UINT64_FORMAT "/" UINT64_FORMAT ", %f/%f, " UINT64_FORMAT "/" UINT64_FORMAT "] "
-		 " cwnd %f status_query_msg_num %d",
+		 " cwnd %f status_query_msg_num %d"
+		 " snd_batch_num %d snd_batch_pkt_num %d recv_batch_num %d recv_batch_pkt_num %d",
 		 ic_control_info.isSender, isReceiver,
 		 Gp_interconnect_snd_queue_depth, Gp_interconnect_queue_depth, Gp_max_packet_size,
 		 UNACK_QUEUE_RING_SLOTS_NUM, TIMER_SPAN, DEFAULT_RTT,
@@ -3532,7 +3573,9 @@ TeardownUDPIFCInterconnect_Internal(ChunkTransportState *transportStates,
 		 (double) ((double) ic_statistics.totalBuffers) / ((double) ic_statistics.bufferCountingTime),
 		 ic_statistics.mismatchNum, ic_statistics.disorderedPktNum, ic_statistics.duplicatedPktNum,
 		 (minRtt == ~((uint64) 0) ? 0 : minRtt), (minDev == ~((uint64) 0) ? 0 : minDev), avgRtt, avgDev, maxRtt, maxDev,
-		 snd_control_info.cwnd, ic_statistics.statusQueryMsgNum);
+		 snd_control_info.cwnd, ic_statistics.statusQueryMsgNum,
+		 ic_statistics.sndBatchNum, ic_statistics.sndBatchPktNum,
+		 ic_statistics.recvBatchNum, ic_statistics.recvBatchPktNum);
 
 	ic_control_info.isSender = false;
 	memset(&ic_statistics, 0, sizeof(ICStatistics));
@@ -4509,6 +4552,138 @@ xmit_retry:
 	return;
 }
 
+/*
+ * getIoBatchSize
+ * 		Number of packets to move per system call.
+ *
+ * Returns 1 when batched socket I/O is disabled or not available.
+ */
+static inline int
+getIoBatchSize(bool forSend)
+{
+#ifdef UDPIC_HAVE_MMSG
+	if (forSend ? sendmmsgUnavailable : recvmmsgUnavailable)
+		return 1;
+
+	return Min(Max(Gp_interconnect_io_batch_size, 1), GP_INTERCONNECT_MAX_IO_BATCH);
+#else
+	return 1;
+#endif
+}
+
+/*
+ * sendBatch
+ * 		Send a batch of packets with as few system calls as possible.
+ *
+ * Error handling follows sendOnce(): packets that cannot be sent because the
+ * socket buffer is full, or that are dropped by the local firewall, are left
+ * for the retransmission logic.
+ */
+static void
+sendBatch(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, ICBuffer **bufs, int nbufs)
+{
+#ifdef UDPIC_HAVE_MMSG
+	struct mmsghdr msgs[GP_INTERCONNECT_MAX_IO_BATCH];
+	struct iovec iovs[GP_INTERCONNECT_MAX_IO_BATCH];
+	ICBuffer   *sent[GP_INTERCONNECT_MAX_IO_BATCH];
+	int			nmsgs = 0;
+	int			done = 0;
+	int			i;
+
+	Assert(nbufs <= GP_INTERCONNECT_MAX_IO_BATCH);
+
+	for (i = 0; i < nbufs; i++)
+	{
+		ICBuffer   *buf = bufs[i];
+
+#ifdef USE_ASSERT_CHECKING
+		if (testmode_inject_fault(gp_udpic_dropxmit_percent))
+		{
+#ifdef AMS_VERBOSE_LOGGING
+			write_log("THROW PKT with seq %d srcpid %d despid %d", buf->pkt->seq, buf->pkt->srcPid, buf->pkt->dstPid);
+#endif
+			continue;
+		}
+#endif
+
+		iovs[nmsgs].iov_base = buf->pkt;
+		iovs[nmsgs].iov_len = buf->pkt->len;
+
+		memset(&msgs[nmsgs], 0, sizeof(struct mmsghdr));
+		msgs[nmsgs].msg_hdr.msg_name = &buf->conn->peer;
+		msgs[nmsgs].msg_hdr.msg_namelen = buf->conn->peer_len;
+		msgs[nmsgs].msg_hdr.msg_iov = &iovs[nmsgs];
+		msgs[nmsgs].msg_hdr.msg_iovlen = 1;
+		sent[nmsgs] = buf;
+		nmsgs++;
+	}
+
+	while (done < nmsgs)
+	{
+		MotionConn *conn = sent[done]->conn;
+		int			n;
+
+		n = sendmmsg(pEntry->txfd, &msgs[done], nmsgs - done, 0);
+		if (n < 0)
+		{
+			if (errno == EINTR)
+				continue;
+
+			if (errno == EAGAIN)	/* no space ? not an error. */
+				return;
+
+			if (errno == ENOSYS)
+			{
+				/* Kernel without sendmmsg(), send the rest one by one. */
+				sendmmsgUnavailable = true;
+				for (; done < nmsgs; done++)
+					sendOnce(transportStates, pEntry, sent[done], sent[done]->conn);
+				return;
+			}
+
+			/* See sendOnce() */
+			if (errno == EPERM)
+			{
+				ereport(LOG,
+						(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+						 errmsg("Interconnect error writing an outgoing packet: %m"),
+						 errdetail("error during sendmmsg() for Remote Connection: contentId=%d at %s",
+								   conn->remoteContentId, conn->remoteHostAndPort)));
+				done++;
+				continue;
+			}
+
+			ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+							errmsg("Interconnect error writing an outgoing packet: %m"),
+							errdetail("error during sendmmsg() call (error:%d).\n"
+									  "For Remote Connection: contentId=%d at %s",
+									  errno, conn->remoteContentId,
+									  conn->remoteHostAndPort)));
+			/* not reached */
+		}
+
+		ic_statistics.sndBatchNum++;
+		ic_statistics.sndBatchPktNum += n;
+
+		for (i = done; i < done + n; i++)
+		{
+			if (msgs[i].msg_len != sent[i]->pkt->len && DEBUG1 >= log_min_messages)
+				write_log("Interconnect error writing an outgoing packet [seq %d]: short transmit (given %d sent %d) during sendmmsg() call."
+						  "For Remote Connection: contentId=%d at %s", sent[i]->pkt->seq, sent[i]->pkt->len, msgs[i].msg_len,
+						  sent[i]->conn->remoteContentId,
+						  sent[i]->conn->remoteHostAndPort);
+		}
+
+		done += n;
+	}
+#else
+	int			i;
+
+	for (i = 0; i < nbufs; i++)
+		sendOnce(transportStates, pEntry, bufs[i], bufs[i]->conn);
+#endif
+}
+
 
 /*
  * handleStopMsgs
@@ -4618,6 +4793,10 @@ handleStopMsgs(ChunkTransportState *transportStates, ChunkTransportStateEntry *p
 static void
 sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, MotionConn *conn)
 {
+	ICBuffer   *batch[GP_INTERCONNECT_MAX_IO_BATCH];
+	int			batchSize = getIoBatchSize(true);
+	int			nbatch = 0;
+
 	while (conn->capacity > 0 && icBufferListLength(&conn->sndQueue) > 0)
 	{
 		ICBuffer   *buf = NULL;
@@ -4662,12 +4841,25 @@ sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEnt
 		 * will be output. In the time of error message output, interrupts is
 		 * potentially checked, if there is a pending query cancel, it will
 		 * lead to a dangled buffer (memory leak).
+		 *
+		 * The same holds for batched sending: a buffer only enters the batch
+		 * after it is on the unack queue.
 		 */
 #ifdef TRANSFER_PROTOCOL_STATS
 		updateStats(TPE_DATA_PKT_SEND, conn, buf->pkt);
 #endif
 
-		sendOnce(transportStates, pEntry, buf, conn);
+		if (batchSize > 1)
+		{
+			batch[nbatch++] = buf;
+			if (nbatch == batchSize)
+			{
+				sendBatch(transportStates, pEntry, batch, nbatch);
+				nbatch = 0;
+			}
+		}
+		else
+			sendOnce(transportStates, pEntry, buf, conn);
 		ic_statistics.sndPktNum++;
 
 #ifdef AMS_VERBOSE_LOGGING
@@ -4676,6 +4868,9 @@ sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEnt
 
 		buf->conn->sentSeq = buf->pkt->seq;
 	}
+
+	if (nbatch > 0)
+		sendBatch(transportStates, pEntry, batch, nbatch);
 }
 
 /*
@@ -6057,6 +6252,207 @@ handleDataPacket(MotionConn *conn, icpkthdr *pkt, struct sockaddr_storage *peer,
 	return true;
 }
 
+/*
+ * receivePackets
+ * 		Read up to npkts datagrams from the listener socket.
+ *
+ * On success returns the number of packets read into pkts[], with their
+ * lengths and peer addresses in lens[], peers[] and peerlens[]. Returns -1
+ * and sets errno on failure, exactly like recvfrom().
+ *
+ * NOTE: This function MUST NOT contain elog or ereport statements.
+ * elog is NOT thread-safe.  Developers should instead use something like:
+ *
+ *	if (DEBUG3 >= log_min_messages)
+ *		write_log("my brilliant log statement here.");
+ */
+static int
+receivePackets(icpkthdr **pkts, int npkts, struct sockaddr_storage *peers, socklen_t *peerlens, int *lens)
+{
+	int			read_count;
+
+#ifdef UDPIC_HAVE_MMSG
+	if (npkts > 1)
+	{
+		struct mmsghdr msgs[GP_INTERCONNECT_MAX_IO_BATCH];
+		struct iovec iovs[GP_INTERCONNECT_MAX_IO_BATCH];
+		int			i;
+
+		Assert(npkts <= GP_INTERCONNECT_MAX_IO_BATCH);
+
+		for (i = 0; i < npkts; i++)
+		{
+			iovs[i].iov_base = pkts[i];
+			iovs[i].iov_len = Gp_max_packet_size;
+
+			memset(&msgs[i], 0, sizeof(struct mmsghdr));
+			msgs[i].msg_hdr.msg_name = &peers[i];
+			msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+			msgs[i].msg_hdr.msg_iov = &iovs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		read_count = recvmmsg(UDP_listenerFd, msgs, npkts, 0, NULL);
+		if (read_count >= 0)
+		{
+			for (i = 0; i < read_count; i++)
+			{
+				lens[i] = msgs[i].msg_len;
+				peerlens[i] = msgs[i].msg_hdr.msg_namelen;
+			}
+
+			if (read_count > 1)
+			{
+				pg_atomic_add_fetch_u32((pg_atomic_uint32 *) &ic_statistics.recvBatchNum, 1);
+				pg_atomic_add_fetch_u32((pg_atomic_uint32 *) &ic_statistics.recvBatchPktNum, read_count);
+			}
+			return read_count;
+		}
+
+		if (errno != ENOSYS)
+			return -1;
+
+		/* Kernel without recvmmsg(), fall back to recvfrom() from now on. */
+		recvmmsgUnavailable = true;
+	}
+#endif
+
+	peerlens[0] = sizeof(struct sockaddr_storage);
+	read_count = recvfrom(UDP_listenerFd, (char *) pkts[0], Gp_max_packet_size, 0,
+						  (struct sockaddr *) &peers[0], &peerlens[0]);
+	if (read_count < 0)
+		return -1;
+
+	lens[0] = read_count;
+	return 1;
+}
+
+/*
+ * handleRxPacket
+ * 		Validate one datagram read by the rx thread and dispatch it to its
+ * 		connection.
+ *
+ * Returns true if the packet buffer has been taken over (queued on a
+ * connection, or cached as a future packet), false if the caller still owns
+ * it.
+ *
+ * NOTE: This function MUST NOT contain elog or ereport statements.
+ * elog is NOT thread-safe.  Developers should instead use something like:
+ *
+ *	if (DEBUG3 >= log_min_messages)
+ *		write_log("my brilliant log statement here.");
+ *
+ * NOTE: In threads, we cannot use palloc/pfree, because it's not thread safe.
+ */
+static bool
+handleRxPacket(icpkthdr *pkt, int read_count, struct sockaddr_storage *peer, socklen_t peerlen)
+{
+	MotionConn *conn = NULL;
+	bool		consumed = false;
+	bool		wakeup_mainthread = false;
+	AckSendParam param;
+
+	if (DEBUG5 >= log_min_messages)
+		write_log("received inbound len %d", read_count);
+
+	if (read_count < sizeof(icpkthdr))
+	{
+		if (DEBUG1 >= log_min_messages)
+			write_log("Interconnect error: short conn receive (%d)", read_count);
+		return false;
+	}
+
+	/* length must be >= 0 */
+	if (pkt->len < 0)
+	{
+		if (DEBUG3 >= log_min_messages)
+			write_log("received inbound with negative length");
+		return false;
+	}
+
+	if (pkt->len != read_count)
+	{
+		if (DEBUG3 >= log_min_messages)
+			write_log("received inbound packet [%d], short: read %d bytes, pkt->len %d", pkt->seq, read_count, pkt->len);
+		return false;
+	}
+
+	/*
+	 * check the CRC of the payload.
+	 */
+	if (gp_interconnect_full_crc)
+	{
+		if (!checkCRC(pkt))
+		{
+			pg_atomic_add_fetch_u32((pg_atomic_uint32 *) &ic_statistics.crcErrors, 1);
+			if (DEBUG2 >= log_min_messages)
+				write_log("received network data error, dropping bad packet, user data unaffected.");
+			return false;
+		}
+	}
+
+#ifdef AMS_VERBOSE_LOGGING
+	logPkt("GOT MESSAGE", pkt);
+#endif
+
+	memset(&param, 0, sizeof(AckSendParam));
+
+	/*
+	 * Get the connection for the pkt.
+	 *
+	 * The connection hash table should be locked until finishing the
+	 * processing of the packet to avoid the connection addition/removal from
+	 * the hash table during the mean time.
+	 */
+
+	pthread_mutex_lock(&ic_control_info.lock);
+	conn = findConnByHeader(&ic_control_info.connHtab, pkt);
+
+	if (conn != NULL)
+	{
+		/* Handling a regular packet */
+		if (handleDataPacket(conn, pkt, peer, &peerlen, &param, &wakeup_mainthread))
+			consumed = true;
+		ic_statistics.recvPktNum++;
+	}
+	else
+	{
+		/*
+		 * There may have two kinds of Mismatched packets: a) Past packets
+		 * from previous command after I was torn down b) Future packets from
+		 * current command before my connections are built.
+		 *
+		 * The handling logic is to "Ack the past and Nak the future".
+		 */
+		if ((pkt->flags & UDPIC_FLAGS_RECEIVER_TO_SENDER) == 0)
+		{
+			if (DEBUG1 >= log_min_messages)
+				write_log("mismatched packet received, seq %d, srcpid %d, dstpid %d, icid %d, sid %d", pkt->seq, pkt->srcPid, pkt->dstPid, pkt->icId, pkt->sessionId);
+
+#ifdef AMS_VERBOSE_LOGGING
+			logPkt("Got a Mismatched Packet", pkt);
+#endif
+
+			if (handleMismatch(pkt, peer, peerlen))
+				consumed = true;
+			ic_statistics.mismatchNum++;
+		}
+	}
+	pthread_mutex_unlock(&ic_control_info.lock);
+
+	if (wakeup_mainthread)
+		SetLatch(&ic_control_info.latch);
+
+	/*
+	 * real ack sending is after lock release to decrease the lock holding
+	 * time.
+	 */
+	if (param.msg.len != 0)
+		sendAckWithParam(&param);
+
+	return consumed;
+}
+
 /*
  * rxThreadFunc
  * 		Main function of the receive background thread.
@@ -6072,16 +6468,24 @@ handleDataPacket(MotionConn *conn, icpkthdr *pkt, struct sockaddr_storage *peer,
 static void *
 rxThreadFunc(void *arg)
 {
-	icpkthdr   *pkt = NULL;
+	icpkthdr   *pkts[GP_INTERCONNECT_MAX_IO_BATCH];
+	struct sockaddr_storage peers[GP_INTERCONNECT_MAX_IO_BATCH];
+	socklen_t	peerlens[GP_INTERCONNECT_MAX_IO_BATCH];
+	int			lens[GP_INTERCONNECT_MAX_IO_BATCH];
+	int			reserved = 1;	/* slots counted in rx_buffer_pool.maxCount */
 	bool		skip_poll = false;
 	uint32		expected = 1;
+	int			i;
 
 	gp_set_thread_sigmasks();
 
+	memset(pkts, 0, sizeof(pkts));
+
 	for (;;)
 	{
 		struct pollfd nfd;
 		int			n;
+		int			npkts;
 
 		/* check shutdown condition */
 		expected = 1;
@@ -6094,18 +6498,41 @@ rxThreadFunc(void *arg)
 			break;
 		}
 
-		/* Try to get a buffer */
-		if (pkt == NULL)
+		/*
+		 * Try to get buffers. Slots whose packet was handed over to a
+		 * connection in the previous round are refilled; we read into as
+		 * many leading slots as we could fill.
+		 */
+		npkts = getIoBatchSize(false);
+		pthread_mutex_lock(&ic_control_info.lock);
+
+		/*
+		 * The buffers held in pkts[] are in neither a connection's queue nor
+		 * the freelist, so the pool must allow for them; otherwise teardown
+		 * would try to prune more buffers than the freelist holds.  Slots
+		 * above the current batch size may still hold a buffer from an
+		 * earlier, larger batch, so the reservation only ever grows.
+		 */
+		if (npkts > reserved)
 		{
-			pthread_mutex_lock(&ic_control_info.lock);
-			pkt = getRxBuffer(&rx_buffer_pool);
-			pthread_mutex_unlock(&ic_control_info.lock);
+			rx_buffer_pool.maxCount += npkts - reserved;
+			reserved = npkts;
+		}
 
-			if (pkt == NULL)
-			{
-				setRxThreadError(ENOMEM);
-				continue;
-			}
+		for (i = 0; i < npkts; i++)
+		{
+			if (pkts[i] == NULL)
+				pkts[i] = getRxBuffer(&rx_buffer_pool);
+			if (pkts[i] == NULL)
+				break;
+		}
+		pthread_mutex_unlock(&ic_control_info.lock);
+		npkts = i;
+
+		if (npkts == 0)
+		{
+			setRxThreadError(ENOMEM);
+			continue;
 		}
 
 		if (!skip_poll)
@@ -6152,15 +6579,9 @@ rxThreadFunc(void *arg)
 			/* we've got something interesting to read */
 			/* handle incoming */
 			/* ready to read on our socket */
-			MotionConn *conn = NULL;
 			int			read_count = 0;
 
-			struct sockaddr_storage peer;
-			socklen_t	peerlen;
-
-			peerlen = sizeof(peer);
-			read_count = recvfrom(UDP_listenerFd, (char *) pkt, Gp_max_packet_size, 0,
-								  (struct sockaddr *) &peer, &peerlen);
+			read_count = receivePackets(pkts, npkts, peers, peerlens, lens);
 
 			expected = 1;
 			if (pg_atomic_compare_exchange_u32((pg_atomic_uint32 *) &ic_control_info.shutdown, &expected, 0))
@@ -6172,9 +6593,6 @@ rxThreadFunc(void *arg)
 				break;
 			}
 
-			if (DEBUG5 >= log_min_messages)
-				write_log("received inbound len %d", read_count);
-
 			if (read_count < 0)
 			{
 				skip_poll = false;
@@ -6196,123 +6614,34 @@ rxThreadFunc(void *arg)
 				continue;
 			}
 
-			if (read_count < sizeof(icpkthdr))
-			{
-				if (DEBUG1 >= log_min_messages)
-					write_log("Interconnect error: short conn receive (%d)", read_count);
-				continue;
-			}
-
 			/*
 			 * when we get a "good" recvfrom() result, we can skip poll()
 			 * until we get a bad one.
 			 */
 			skip_poll = true;
 
-			/* length must be >= 0 */
-			if (pkt->len < 0)
-			{
-				if (DEBUG3 >= log_min_messages)
-					write_log("received inbound with negative length");
-				continue;
-			}
-
-			if (pkt->len != read_count)
-			{
-				if (DEBUG3 >= log_min_messages)
-					write_log("received inbound packet [%d], short: read %d bytes, pkt->len %d", pkt->seq, read_count, pkt->len);
-				continue;
-			}
-
-			/*
-			 * check the CRC of the payload.
-			 */
-			if (gp_interconnect_full_crc)
-			{
-				if (!checkCRC(pkt))
-				{
-					pg_atomic_add_fetch_u32((pg_atomic_uint32 *) &ic_statistics.crcErrors, 1);
-					if (DEBUG2 >= log_min_messages)
-						write_log("received network data error, dropping bad packet, user data unaffected.");
-					continue;
-				}
-			}
-
-#ifdef AMS_VERBOSE_LOGGING
-			logPkt("GOT MESSAGE", pkt);
-#endif
-
-			bool		wakeup_mainthread = false;
-			AckSendParam param;
-
-			memset(&param, 0, sizeof(AckSendParam));
-
-			/*
-			 * Get the connection for the pkt.
-			 *
-			 * The connection hash table should be locked until finishing the
-			 * processing of the packet to avoid the connection
-			 * addition/removal from the hash table during the mean time.
-			 */
-
-			pthread_mutex_lock(&ic_control_info.lock);
-			conn = findConnByHeader(&ic_control_info.connHtab, pkt);
-
-			if (conn != NULL)
+			for (i = 0; i < read_count; i++)
 			{
-				/* Handling a regular packet */
-				if (handleDataPacket(conn, pkt, &peer, &peerlen, &param, &wakeup_mainthread))
-					pkt = NULL;
-				ic_statistics.recvPktNum++;
-			}
-			else
-			{
-				/*
-				 * There may have two kinds of Mismatched packets: a) Past
-				 * packets from previous command after I was torn down b)
-				 * Future packets from current command before my connections
-				 * are built.
-				 *
-				 * The handling logic is to "Ack the past and Nak the future".
-				 */
-				if ((pkt->flags & UDPIC_FLAGS_RECEIVER_TO_SENDER) == 0)
-				{
-					if (DEBUG1 >= log_min_messages)
-						write_log("mismatched packet received, seq %d, srcpid %d, dstpid %d, icid %d, sid %d", pkt->seq, pkt->srcPid, pkt->dstPid, pkt->icId, pkt->sessionId);
-
-#ifdef AMS_VERBOSE_LOGGING
-					logPkt("Got a Mismatched Packet", pkt);
-#endif
-
-					if (handleMismatch(pkt, &peer, peerlen))
-						pkt = NULL;
-					ic_statistics.mismatchNum++;
-				}
+				if (handleRxPacket(pkts[i], lens[i], &peers[i], peerlens[i]))
+					pkts[i] = NULL;
 			}
-			pthread_mutex_unlock(&ic_control_info.lock);
-
-			if (wakeup_mainthread)
-				SetLatch(&ic_control_info.latch);
-
-			/*
-			 * real ack sending is after lock release to decrease the lock
-			 * holding time.
-			 */
-			if (param.msg.len != 0)
-				sendAckWithParam(&param);
 		}
 
 		/* pthread_yield(); */
 	}
 
-	/* Before return, we release the packet. */
-	if (pkt)
+	/* Before return, we release the packets. */
+	pthread_mutex_lock(&ic_control_info.lock);
+	for (i = 0; i < GP_INTERCONNECT_MAX_IO_BATCH; i++)
 	{
-		pthread_mutex_lock(&ic_control_info.lock);
-		freeRxBuffer(&rx_buffer_pool, pkt);
-		pkt = NULL;
-		pthread_mutex_unlock(&ic_control_info.lock);
+		if (pkts[i])
+		{
+			freeRxBuffer(&rx_buffer_pool, pkts[i]);
+			pkts[i] = NULL;
+		}
 	}
+	rx_buffer_pool.maxCount -= reserved - 1;
+	pthread_mutex_unlock(&ic_control_info.lock);
 
 	/* nothing to return */
 	return NULL;
@@ -0,0 +1,248 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include "cmockery.h"
+
+#include "../tupser.c"
+
+#define BUFFER_SIZE 256
+
+static MemoryContext exception_cxt;
+
+/*
+ * A MemTuple of len bytes, a multiple of 8, filled with fill.  Only its
+ * length word matters to the serialization.
+ */
+static MemTuple
+make_memtuple(uint32 len, char fill)
+{
+	MemTuple	mtup = (MemTuple) palloc(len);
+
+	memset(mtup, fill, len);
+	memtuple_set_mtlen(mtup, len | MEMTUP_LEAD_BIT);
+
+	return mtup;
+}
+
+static void
+init_ser_tup_info(SerTupInfo *pSerInfo, int natts)
+{
+	TupleDesc	tupdesc = (TupleDesc) palloc0(sizeof(*tupdesc));
+
+	tupdesc->natts = natts;
+	memset(pSerInfo, 0, sizeof(SerTupInfo));
+	pSerInfo->tupdesc = tupdesc;
+}
+
+/*
+ * A chunk-list item for the chunk at data, as the interconnect hands it
+ * to the motion layer.
+ */
+static TupleChunkListItem
+make_chunk_item(unsigned char *data)
+{
+	TupleChunkListItem tcItem = palloc0(sizeof(TupleChunkListItemData));
+	uint16		size;
+
+	memcpy(&size, data, sizeof(uint16));
+	tcItem->inplace = (char *) data;
+	tcItem->chunk_length = TUPLE_CHUNK_HEADER_SIZE + size;
+
+	return tcItem;
+}
+
+/*
+ * Call CvtBatchChunkToTup(), and check that it raises an interconnect
+ * error.
+ */
+static void
+expect_batch_error(TupleChunkListItem tcItem, int offset)
+{
+	MemoryContext oldcxt = CurrentMemoryContext;
+	bool		raised = false;
+
+	PG_TRY();
+	{
+		CvtBatchChunkToTup(tcItem, &offset);
+	}
+	PG_CATCH();
+	{
+		ErrorData  *edata;
+
+		MemoryContextSwitchTo(exception_cxt);
+		edata = CopyErrorData();
+		FlushErrorState();
+		MemoryContextSwitchTo(oldcxt);
+
+		assert_int_equal(edata->sqlerrcode, ERRCODE_GP_INTERCONNECTION_ERROR);
+		assert_int_equal(edata->elevel, ERROR);
+		raised = true;
+	}
+	PG_END_TRY();
+
+	assert_true(raised);
+}
+
+/*
+ * MemTuples serialized one after another are appended to one
+ * TC_WHOLE_BATCH chunk, and read back in place, in order.
+ */
+void
+test__SerializeTupleDirect__BatchRoundTrip(void **state)
+{
+	unsigned char *buffer = palloc0(BUFFER_SIZE);
+	struct directTransportBuffer b;
+	SerTupInfo	serInfo;
+	MemTuple	tuples[3];
+	TupleChunkListItem tcItem;
+	TupleChunkType tcType;
+	GenericTuple tup;
+	int			offset = 0;
+	int			sent;
+	int			i;
+
+	init_ser_tup_info(&serInfo, 2);
+	tuples[0] = make_memtuple(16, 'a');
+	tuples[1] = make_memtuple(24, 'b');
+	tuples[2] = make_memtuple(16, 'c');
+
+	b.pri = buffer;
+	b.prilen = BUFFER_SIZE;
+	b.batch = NULL;
+
+	for (i = 0; i < 3; i++)
+	{
+		sent = SerializeTupleDirect((GenericTuple) tuples[i], &serInfo, &b);
+
+		/* only the first tuple needs a chunk header */
+		assert_int_equal(sent, memtuple_get_size(tuples[i]) +
+						 (i == 0 ? TUPLE_CHUNK_HEADER_SIZE : 0));
+		assert_true(b.batch == buffer);
+
+		b.pri += sent;
+		b.prilen -= sent;
+	}
+
+	tcItem = make_chunk_item(buffer);
+	GetChunkType(tcItem, &tcType);
+	assert_int_equal(tcType, TC_WHOLE_BATCH);
+	assert_int_equal(tcItem->chunk_length, TUPLE_CHUNK_HEADER_SIZE + 16 + 24 + 16);
+
+	for (i = 0; i < 3; i++)
+	{
+		tup = CvtBatchChunkToTup(tcItem, &offset);
+
+		/* the tuple is not copied out of the buffer */
+		assert_true((char *) tup >= (char *) buffer &&
+					(char *) tup < (char *) b.pri);
+		assert_memory_equal(tup, tuples[i], memtuple_get_size(tuples[i]));
+	}
+
+	assert_true(CvtBatchChunkToTup(tcItem, &offset) == NULL);
+	assert_int_equal(offset, 16 + 24 + 16);
+}
+
+/*
+ * A tuple that doesn't fit after the batch chunk starts a chunk of its own,
+ * or isn't serialized at all if that doesn't fit either.
+ */
+void
+test__SerializeTupleDirect__BatchFull(void **state)
+{
+	unsigned char *buffer = palloc0(BUFFER_SIZE);
+	struct directTransportBuffer b;
+	SerTupInfo	serInfo;
+	MemTuple	small = make_memtuple(16, 's');
+	MemTuple	large = make_memtuple(64, 'l');
+	int			sent;
+
+	init_ser_tup_info(&serInfo, 1);
+
+	b.pri = buffer;
+	b.prilen = TUPLE_CHUNK_HEADER_SIZE + 16 + 24;
+	b.batch = NULL;
+
+	sent = SerializeTupleDirect((GenericTuple) small, &serInfo, &b);
+	assert_int_equal(sent, TUPLE_CHUNK_HEADER_SIZE + 16);
+	b.pri += sent;
+	b.prilen -= sent;
+
+	/* 24 bytes are left, not enough for the large tuple */
+	assert_int_equal(SerializeTupleDirect((GenericTuple) large, &serInfo, &b), 0);
+
+	/* the next buffer starts a new chunk */
+	b.pri = buffer + 128;
+	b.prilen = 128;
+	b.batch = NULL;
+	sent = SerializeTupleDirect((GenericTuple) large, &serInfo, &b);
+	assert_int_equal(sent, TUPLE_CHUNK_HEADER_SIZE + 64);
+	assert_true(b.batch == buffer + 128);
+}
+
+/*
+ * A corrupt batch chunk raises an error rather than reading past its end.
+ */
+void
+test__CvtBatchChunkToTup__BoundsChecks(void **state)
+{
+	unsigned char *buffer = palloc0(BUFFER_SIZE);
+	struct directTransportBuffer b;
+	SerTupInfo	serInfo;
+	TupleChunkListItem tcItem;
+	uint32		lenword;
+	int			offset;
+
+	init_ser_tup_info(&serInfo, 1);
+
+	b.pri = buffer;
+	b.prilen = BUFFER_SIZE;
+	b.batch = NULL;
+	SerializeTupleDirect((GenericTuple) make_memtuple(16, 'x'), &serInfo, &b);
+	tcItem = make_chunk_item(buffer);
+
+	/* a length word that is cut off by the end of the chunk */
+	SetChunkDataSize(buffer, 18);
+	tcItem->chunk_length = TUPLE_CHUNK_HEADER_SIZE + 18;
+	offset = 0;
+	assert_true(CvtBatchChunkToTup(tcItem, &offset) != NULL);
+	assert_int_equal(offset, 16);
+	expect_batch_error(tcItem, offset);
+
+	/* a tuple that is longer than the rest of the chunk */
+	SetChunkDataSize(buffer, 16);
+	tcItem->chunk_length = TUPLE_CHUNK_HEADER_SIZE + 16;
+	lenword = 24 | MEMTUP_LEAD_BIT;
+	memcpy(buffer + TUPLE_CHUNK_HEADER_SIZE, &lenword, sizeof(uint32));
+	expect_batch_error(tcItem, 0);
+
+	/* a tuple that is shorter than its length word */
+	lenword = 0 | MEMTUP_LEAD_BIT;
+	memcpy(buffer + TUPLE_CHUNK_HEADER_SIZE, &lenword, sizeof(uint32));
+	expect_batch_error(tcItem, 0);
+
+	/* a tuple that is not a MemTuple */
+	lenword = 16;
+	memcpy(buffer + TUPLE_CHUNK_HEADER_SIZE, &lenword, sizeof(uint32));
+	expect_batch_error(tcItem, 0);
+}
+
+int
+main(int argc, char *argv[])
+{
+	cmockery_parse_arguments(argc, argv);
+
+	const		UnitTest tests[] = {
+		unit_test(test__SerializeTupleDirect__BatchRoundTrip),
+		unit_test(test__SerializeTupleDirect__BatchFull),
+		unit_test(test__CvtBatchChunkToTup__BoundsChecks)
+	};
+
+	MemoryContextInit();
+	exception_cxt = AllocSetContextCreate(TopMemoryContext,
+										  "mock error handling context",
+										  ALLOCSET_DEFAULT_MINSIZE,
+										  ALLOCSET_DEFAULT_INITSIZE,
+										  ALLOCSET_DEFAULT_MAXSIZE);
+
+	return run_tests(tests);
+}
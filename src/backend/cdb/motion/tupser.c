@@ -620,6 +620,13 @@ SerializeTupleIntoChunks(GenericTuple gtuple, SerTupInfo *pSerInfo, TupleChunkLi
  * Serialize a tuple directly into a buffer.
  *
  * We're called with at least enough space for a tuple-chunk-header.
+ *
+ * MemTuples are packed into TC_WHOLE_BATCH chunks: if b->batch points to the
+ * header of such a chunk that ends right where the free space begins, the
+ * tuple is appended to it, saving the chunk header, and the per-chunk work on
+ * the receiving side.  Otherwise a new batch chunk is started.  On return,
+ * b->batch is set to the batch chunk that the tuple went into, or NULL if it
+ * was sent as a chunk of its own.
  */
 int
 SerializeTupleDirect(GenericTuple gtuple, SerTupInfo *pSerInfo, struct directTransportBuffer *b)
@@ -643,6 +650,7 @@ SerializeTupleDirect(GenericTuple gtuple, SerTupInfo *pSerInfo, struct directTra
 			SetChunkType(b->pri, TC_EMPTY);
 			SetChunkDataSize(b->pri, 0);
 
+			b->batch = NULL;
 			break;
 		}
 
@@ -656,6 +664,24 @@ SerializeTupleDirect(GenericTuple gtuple, SerTupInfo *pSerInfo, struct directTra
 			tupleSize = memtuple_get_size(tuple);
 			paddedSize = TYPEALIGN(TUPLE_CHUNK_ALIGN, tupleSize);
 
+			if (b->batch != NULL)
+			{
+				uint16		batchSize;
+
+				memcpy(&batchSize, b->batch, sizeof(uint16));
+
+				if (paddedSize <= b->prilen &&
+					batchSize + paddedSize <= PG_UINT16_MAX)
+				{
+					/* append to the open batch chunk */
+					memcpy(b->pri, tuple, tupleSize);
+					memset(b->pri + tupleSize, 0, paddedSize - tupleSize);
+
+					SetChunkDataSize(b->batch, batchSize + paddedSize);
+					return paddedSize;
+				}
+			}
+
 			if (paddedSize + TUPLE_CHUNK_HEADER_SIZE > b->prilen)
 				return 0;
 
@@ -665,8 +691,10 @@ SerializeTupleDirect(GenericTuple gtuple, SerTupInfo *pSerInfo, struct directTra
 
 			dataSize += paddedSize;
 
-			SetChunkType(b->pri, TC_WHOLE);
+			SetChunkType(b->pri, TC_WHOLE_BATCH);
 			SetChunkDataSize(b->pri, dataSize - TUPLE_CHUNK_HEADER_SIZE);
+
+			b->batch = b->pri;
 			break;
 		}
 		else
@@ -718,6 +746,7 @@ SerializeTupleDirect(GenericTuple gtuple, SerTupInfo *pSerInfo, struct directTra
 			SetChunkType(b->pri, TC_WHOLE);
 			SetChunkDataSize(b->pri, dataSize - TUPLE_CHUNK_HEADER_SIZE);
 
+			b->batch = NULL;
 			break;
 		}
 
@@ -848,6 +877,53 @@ DeserializeTuple(SerTupInfo *pSerInfo, StringInfo serialTup)
 	return htup;
 }
 
+/*
+ * Extract the next MemTuple from a TC_WHOLE_BATCH chunk.
+ *
+ * *offset is the position of the tuple in the chunk's data, after the
+ * header; it is advanced past the tuple.  Returns NULL once all tuples have
+ * been extracted.  The tuple is not copied: it points into the chunk, which
+ * usually still points into the receive buffer, and is only valid as long
+ * as that is.
+ */
+GenericTuple
+CvtBatchChunkToTup(TupleChunkListItem tcItem, int *offset)
+{
+	char	   *data = GetChunkDataPtr(tcItem) + TUPLE_CHUNK_HEADER_SIZE;
+	int			datalen = tcItem->chunk_length - TUPLE_CHUNK_HEADER_SIZE;
+	uint32		lenword;
+	uint32		tuplen;
+	GenericTuple tup;
+
+	AssertArg(*offset >= 0);
+
+	if (*offset >= datalen)
+		return NULL;
+
+	if (datalen - *offset < sizeof(uint32))
+		ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+						errmsg("Interconnect error: truncated tuple in batch chunk."),
+						errdetail("offset %d, chunk data length %d", *offset, datalen)));
+
+	memcpy(&lenword, data + *offset, sizeof(uint32));
+	if ((lenword & MEMTUP_LEAD_BIT) == 0)
+		ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+						errmsg("Interconnect error: batch chunk contains a tuple that is not a memtuple.")));
+
+	tuplen = memtuple_size_from_uint32(lenword);
+	if (tuplen < sizeof(uint32) || tuplen > datalen - *offset)
+		ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+						errmsg("Interconnect error: invalid tuple length in batch chunk."),
+						errdetail("tuple length %u at offset %d, chunk data length %d",
+								  tuplen, *offset, datalen)));
+
+	tup = (GenericTuple) (data + *offset);
+
+	*offset += TYPEALIGN(TUPLE_CHUNK_ALIGN, tuplen);
+
+	return tup;
+}
+
 GenericTuple
 CvtChunksToTup(TupleChunkList tcList, SerTupInfo *pSerInfo, TupleRemapper *remapper)
 {
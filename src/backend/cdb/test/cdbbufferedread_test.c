@@ -84,6 +84,54 @@ test__BufferedReadUseBeforeBuffer__IsNextReadLenZero(void **state)
 	PG_END_TRY();	
 }
 
+/*
+ * Test that read-ahead requests each large read once, up to the depth ahead
+ * of the current read, and not beyond the end of the file.
+ */
+void
+test__BufferedReadAhead__RequestsWindowOnce(void **state)
+{
+	BufferedRead *bufferedRead = palloc(sizeof(BufferedRead));
+	int32 memoryLen = 200;
+	uint8 *memory = palloc(memoryLen);
+
+	BufferedReadInit(bufferedRead, memory, memoryLen, 100, 100, "test");
+	bufferedRead->readAheadDepth = 2;
+	bufferedRead->file = 7;
+	bufferedRead->fileLen = 350;
+	bufferedRead->largeReadPosition = 0;
+	bufferedRead->largeReadLen = 100;
+
+	expect_value(FilePrefetch, file, 7);
+	expect_value(FilePrefetch, offset, 100);
+	expect_value(FilePrefetch, amount, 100);
+	will_return(FilePrefetch, 0);
+	expect_value(FilePrefetch, file, 7);
+	expect_value(FilePrefetch, offset, 200);
+	expect_value(FilePrefetch, amount, 100);
+	will_return(FilePrefetch, 0);
+
+	BufferedReadAhead(bufferedRead);
+	assert_int_equal(bufferedRead->readAheadPosition, 300);
+
+	/* The next read only extends the window, up to the end of the file */
+	bufferedRead->largeReadPosition = 100;
+
+	expect_value(FilePrefetch, file, 7);
+	expect_value(FilePrefetch, offset, 300);
+	expect_value(FilePrefetch, amount, 50);
+	will_return(FilePrefetch, 0);
+
+	BufferedReadAhead(bufferedRead);
+	assert_int_equal(bufferedRead->readAheadPosition, 350);
+	assert_int_equal(bufferedRead->numReadAheads, 3);
+
+	/* At the end of the file, nothing is left to request */
+	bufferedRead->largeReadPosition = 200;
+	BufferedReadAhead(bufferedRead);
+	assert_int_equal(bufferedRead->numReadAheads, 3);
+}
+
 int
 main(int argc, char* argv[])
 {
@@ -91,7 +139,8 @@ main(int argc, char* argv[])
 
 	const UnitTest tests[] = {
 		unit_test(test__BufferedReadUseBeforeBuffer__IsNextReadLenZero),
-		unit_test(test__BufferedReadInit__IsConsistent)
+		unit_test(test__BufferedReadInit__IsConsistent),
+		unit_test(test__BufferedReadAhead__RequestsWindowOnce)
 	};
 
 	MemoryContextInit();
@@ -0,0 +1,170 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include "cmockery.h"
+
+#include "../cdbhash.c"
+
+#include "utils/memutils.h"
+
+/*
+ * The FNV-1 implementation cdbhash.c used before the fixed-width fast
+ * paths were added.  Data placement depends on every hash value staying
+ * exactly the same.
+ */
+static uint32
+reference_fnv1_32_buf(void *buf, size_t len, uint32 hval)
+{
+	unsigned char *bp = (unsigned char *) buf;
+	unsigned char *be = bp + len;
+
+	while (bp < be)
+	{
+		hval += (hval << 1) + (hval << 4) + (hval << 7) + (hval << 8) + (hval << 24);
+		hval ^= (uint32) *bp++;
+	}
+
+	return hval;
+}
+
+void
+test__fnv1_32_buf__MatchesReference(void **state)
+{
+	unsigned char buf[32];
+	size_t		len;
+	int			i;
+
+	for (i = 0; i < sizeof(buf); i++)
+		buf[i] = (unsigned char) (i * 37 + 11);
+
+	for (len = 0; len <= sizeof(buf); len++)
+	{
+		assert_int_equal(fnv1_32_buf(buf, len, FNV1_32_INIT),
+						 reference_fnv1_32_buf(buf, len, FNV1_32_INIT));
+		assert_int_equal(fnv1_32_buf(buf, len, 0xdeadbeef),
+						 reference_fnv1_32_buf(buf, len, 0xdeadbeef));
+	}
+}
+
+void
+test__cdbhash__IntegerWidthsHashAlike(void **state)
+{
+	CdbHash		h2, h4, h8;
+	int64		intbuf = 12345;
+
+	cdbhashinit(&h2);
+	cdbhash(&h2, Int16GetDatum(12345), INT2OID);
+	cdbhashinit(&h4);
+	cdbhash(&h4, Int32GetDatum(12345), INT4OID);
+	cdbhashinit(&h8);
+	cdbhash(&h8, Int64GetDatum(12345), INT8OID);
+
+	assert_int_equal(h2.hash, h4.hash);
+	assert_int_equal(h4.hash, h8.hash);
+	assert_int_equal(h8.hash,
+					 reference_fnv1_32_buf(&intbuf, sizeof(intbuf), FNV1_32_INIT));
+}
+
+/*
+ * Growing the cluster from N to N+1 segments must only move keys onto the
+ * new segment, never between the existing ones.
+ */
+void
+test__jump_consistent_hash__MovesOnlyToNewSegment(void **state)
+{
+	uint32		key;
+	int			numsegs;
+
+	for (key = 0; key < 10000; key++)
+	{
+		uint32		hval = fnv1_32_buf(&key, sizeof(key), FNV1_32_INIT);
+
+		assert_int_equal(jump_consistent_hash(hval, 1), 0);
+
+		for (numsegs = 1; numsegs < 100; numsegs++)
+		{
+			int			before = jump_consistent_hash(hval, numsegs);
+			int			after = jump_consistent_hash(hval, numsegs + 1);
+
+			assert_true(before >= 0 && before < numsegs);
+			assert_true(after == before || after == numsegs);
+		}
+	}
+}
+
+/*
+ * Known answers.  Rows placed by jump consistent hashing must stay where they
+ * are across releases, like the modulo placement.
+ */
+void
+test__jump_consistent_hash__KnownAnswers(void **state)
+{
+	static const uint64 keys[] = {0, 1, 42, 0xdeadbeef, 0xffffffff};
+	static const int numsegs[] = {1, 2, 3, 10, 100, 1000};
+	static const int expected[lengthof(keys)][lengthof(numsegs)] = {
+		{0, 0, 0, 0, 0, 0},
+		{0, 0, 0, 6, 55, 549},
+		{0, 1, 2, 2, 43, 571},
+		{0, 1, 2, 5, 87, 285},
+		{0, 0, 2, 5, 74, 875}
+	};
+	int			i;
+	int			j;
+
+	for (i = 0; i < lengthof(keys); i++)
+		for (j = 0; j < lengthof(numsegs); j++)
+			assert_int_equal(jump_consistent_hash(keys[i], numsegs[j]),
+							 expected[i][j]);
+}
+
+/*
+ * Segments of int4 distribution keys 1..12 on 3 and 8 segments, with jump
+ * and modulo reduction.  The regression tests of jump tables expect the same
+ * placement.
+ */
+void
+test__cdbhashreduce__Jump(void **state)
+{
+	static const int jump3[] = {2, 1, 2, 0, 1, 1, 0, 0, 1, 1, 0, 1};
+	static const int mod3[] = {0, 0, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2};
+	static const int jump8[] = {2, 7, 2, 7, 1, 1, 3, 6, 1, 1, 3, 1};
+	int			i;
+
+	for (i = 0; i < lengthof(jump3); i++)
+	{
+		CdbHash    *h;
+
+		h = makeCdbHash(3, POLICY_HASHREDUCE_JUMP);
+		cdbhashinit(h);
+		cdbhash(h, Int32GetDatum(i + 1), INT4OID);
+		assert_int_equal(cdbhashreduce(h), jump3[i]);
+
+		h = makeCdbHash(3, POLICY_HASHREDUCE_MODULO);
+		cdbhashinit(h);
+		cdbhash(h, Int32GetDatum(i + 1), INT4OID);
+		assert_int_equal(cdbhashreduce(h), mod3[i]);
+
+		h = makeCdbHash(8, POLICY_HASHREDUCE_JUMP);
+		cdbhashinit(h);
+		cdbhash(h, Int32GetDatum(i + 1), INT4OID);
+		assert_int_equal(cdbhashreduce(h), jump8[i]);
+	}
+}
+
+int
+main(int argc, char* argv[])
+{
+	cmockery_parse_arguments(argc, argv);
+
+	const UnitTest tests[] = {
+		unit_test(test__fnv1_32_buf__MatchesReference),
+		unit_test(test__cdbhash__IntegerWidthsHashAlike),
+		unit_test(test__jump_consistent_hash__MovesOnlyToNewSegment),
+		unit_test(test__jump_consistent_hash__KnownAnswers),
+		unit_test(test__cdbhashreduce__Jump)
+	};
+
+	MemoryContextInit();
+
+	return run_tests(tests);
+}
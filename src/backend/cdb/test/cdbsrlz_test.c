@@ -130,6 +130,7 @@ test__uncompress_string__palloc_uncompress(void **state)
 	char *output = uncompress_string(compressedString, compressed_size, &uncompressed_size);
 	assert_true(NULL != output);
 	assert_true(strlen(uncompressedString) == uncompressed_size);
+	assert_memory_equal(output, uncompressedString, uncompressed_size);
 
 	Size afterAlloc = MemoryContextGetPeakSpace(TopMemoryContext);
 
@@ -138,6 +139,120 @@ test__uncompress_string__palloc_uncompress(void **state)
 	assert_true(afterAlloc - beforeAlloc > memZlib);
 }
 
+/*
+ * Test that zlib-compressed strings keep the format older segments can read:
+ * the uncompressed length, which deserializeNode() also relies on to tell
+ * zlib from the other codecs, followed by the zlib stream.
+ */
+void
+test__compress_string__zlib_header(void **state)
+{
+	int32 header;
+
+	assert_true(NULL != compressedString);
+	assert_true(compressed_size > sizeof(int32));
+
+	memcpy(&header, compressedString, sizeof(int32));
+	assert_int_equal(header, strlen(uncompressedString));
+}
+
+#ifdef HAVE_LIBZSTD
+/*
+ * Compress src with compress_string_zstd(), check the header, and check that
+ * uncompress_string_zstd() gives back src.
+ */
+static void
+check_zstd_round_trip(const char *src, int len)
+{
+	PlanCodecHeader hdr;
+	char *compressed;
+	char *output;
+	int size = 0;
+	int output_len = 0;
+
+	compressed = compress_string_zstd(src, len, &size);
+	assert_true(NULL != compressed);
+	assert_true(size > sizeof(hdr));
+
+	memcpy(&hdr, compressed, sizeof(hdr));
+	assert_int_equal(hdr.codec, -PLAN_CODEC_ZSTD);
+	assert_int_equal(hdr.uncompressed_len, len);
+	assert_int_equal(hdr.dictid, plan_zstd_dictid);
+
+	output = uncompress_string_zstd(compressed, size, &output_len);
+	assert_int_equal(output_len, len);
+	assert_memory_equal(output, src, len);
+
+	pfree(compressed);
+	pfree(output);
+}
+
+/*
+ * Test that zstd-compressed strings, a serialized plan and random text,
+ * uncompress to the original.
+ */
+void
+test__compress_string_zstd__round_trip(void **state)
+{
+	Result *result = makeNode(Result);
+	char *plan;
+	int plan_len;
+
+	result->plan.targetlist =
+		list_make1(makeTargetEntry((Expr *) makeVar(1, 1, INT4OID, -1, 0), 1, NULL, false));
+	plan = nodeToBinaryStringFast(result, &plan_len);
+	check_zstd_round_trip(plan, plan_len);
+
+	assert_true(NULL != uncompressedString);
+	check_zstd_round_trip(uncompressedString, strlen(uncompressedString));
+}
+
+/*
+ * Plans are compressed at PLAN_ZSTD_LEVEL, but the decoder must not depend
+ * on it. Test that uncompress_string_zstd() reads the output of every zstd
+ * compression level that uses the plan dictionary.
+ */
+void
+test__uncompress_string_zstd__each_level(void **state)
+{
+	StringInfoData dict;
+	PlanCodecHeader hdr;
+	ZSTD_CCtx *cctx = ZSTD_createCCtx();
+	int len = strlen(uncompressedString);
+	size_t bound = ZSTD_compressBound(len);
+	char *compressed = palloc(sizeof(hdr) + bound);
+	int level;
+
+	initPlanZstd();
+	initStringInfo(&dict);
+	buildPlanDictionary(&dict);
+
+	for (level = 1; level <= ZSTD_maxCLevel(); level++)
+	{
+		size_t frame_size;
+		char *output;
+		int output_len = 0;
+
+		frame_size = ZSTD_compress_usingDict(cctx, compressed + sizeof(hdr), bound,
+											 uncompressedString, len,
+											 dict.data, dict.len, level);
+		assert_false(ZSTD_isError(frame_size));
+
+		hdr.codec = -PLAN_CODEC_ZSTD;
+		hdr.uncompressed_len = len;
+		hdr.dictid = plan_zstd_dictid;
+		memcpy(compressed, &hdr, sizeof(hdr));
+
+		output = uncompress_string_zstd(compressed, sizeof(hdr) + frame_size, &output_len);
+		assert_int_equal(output_len, len);
+		assert_memory_equal(output, uncompressedString, len);
+		pfree(output);
+	}
+
+	ZSTD_freeCCtx(cctx);
+}
+#endif
+
 int
 main(int argc, char* argv[])
 {
@@ -146,7 +261,12 @@ main(int argc, char* argv[])
 	const UnitTest tests[] =
 	{
 		unit_test(test__compress_string__palloc_compress),
-		unit_test(test__uncompress_string__palloc_uncompress)
+		unit_test(test__uncompress_string__palloc_uncompress),
+		unit_test(test__compress_string__zlib_header),
+#ifdef HAVE_LIBZSTD
+		unit_test(test__compress_string_zstd__round_trip),
+		unit_test(test__uncompress_string_zstd__each_level)
+#endif
 	};
 
 	MemoryContextInit();
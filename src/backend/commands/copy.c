@@ -7813,7 +7813,8 @@ InitDistributionData(CopyState cstate, Form_pg_attribute *attr,
 		else
 			p_nattrs = 0;
 		/* Create hash API reference */
-		cdbHash = makeCdbHash(total_segs);
+		cdbHash = makeCdbHash(total_segs,
+							  policy ? policy->hashreduce : POLICY_HASHREDUCE_MODULO);
 	}
 	else
 	{
@@ -8079,9 +8080,10 @@ GetDistributionPolicyForPartition(CopyState cstate, EState *estate,
 			 * iteration.
 			 */
 			d->relid = relid;
-			part_hash = d->cdbHash = makeCdbHash(
-			        getAttrContext->cdbCopy->total_segs);
 			part_policy = d->policy = GpPolicyCopy(ctxt, rel->rd_cdbpolicy);
+			part_hash = d->cdbHash = makeCdbHash(
+			        getAttrContext->cdbCopy->total_segs,
+			        part_policy->hashreduce);
 			part_p_nattrs = part_policy->nattrs;
 			heap_close(rel, NoLock);
 			MemoryContextSwitchTo(save_cxt);
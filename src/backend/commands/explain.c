@@ -557,6 +557,11 @@ ExplainOnePlan(PlannedStmt *plannedstmt, ExplainState *es,
 		ExplainCloseGroup("Triggers", "Triggers", false, es);
 	}
 
+	/* Function calls that got a specialized evaluator, see execQual.c */
+	if (es->analyze && queryDesc->estate->es_num_specialized_exprs > 0)
+		ExplainPropertyInteger("Specialized function calls",
+							   queryDesc->estate->es_num_specialized_exprs, es);
+
     /*
      * Display per-slice and whole-query statistics.
      */
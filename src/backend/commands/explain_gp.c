@@ -240,6 +240,13 @@ typedef struct CdbExplain_ShowStatCtx
 	double		workmemused_max;
 	double		workmemwanted_max;
 
+	/* Plan dispatch, summed over all dispatches of the query */
+	int			ndispatch;
+	int			dispatch_nqe;
+	double		dispatch_bytes;
+	double		dispatch_serialize_ms;
+	double		dispatch_send_ms;
+
 	/* Per-slice statistics are deposited in this SliceSummary array */
 	int			nslice;			/* num of slots in slices array */
 	CdbExplain_SliceSummary *slices;	/* -> array[0..nslice-1] of
@@ -1487,6 +1494,22 @@ cdbexplain_showExecStatsBegin(struct QueryDesc *queryDesc,
 	return ctx;
 }								/* cdbexplain_showExecStatsBegin */
 
+/*
+ * cdbexplain_recordDispatchStats
+ *	  Account one dispatch of the plan (or of an initplan) to the qExecs.
+ */
+void
+cdbexplain_recordDispatchStats(CdbExplain_ShowStatCtx *showstatctx,
+							   int nqe, int len,
+							   double serialize_ms, double send_ms)
+{
+	showstatctx->ndispatch++;
+	showstatctx->dispatch_nqe += nqe;
+	showstatctx->dispatch_bytes += (double) nqe * len;
+	showstatctx->dispatch_serialize_ms += serialize_ms;
+	showstatctx->dispatch_send_ms += send_ms;
+}								/* cdbexplain_recordDispatchStats */
+
 /*
  * nodeSupportWorkfileCaching
  *	 Return true if a given node supports workfile caching.
@@ -2092,6 +2115,33 @@ cdbexplain_showExecStatsEnd(struct PlannedStmt *stmt,
 		ExplainCloseGroup("Slice statistics", "Slice statistics", true, es);
 	}
 
+	/*
+	 * Plan dispatch timings. Only shown in verbose mode, to keep the
+	 * default output stable.
+	 */
+	if (es->verbose && showstatctx->ndispatch > 0)
+	{
+		ExplainOpenGroup("Dispatch statistics", "Dispatch statistics", true, es);
+		if (es->format == EXPLAIN_FORMAT_TEXT)
+		{
+			cdbexplain_formatMemory(maxbuf, sizeof(maxbuf), showstatctx->dispatch_bytes);
+			appendStringInfo(es->str,
+							 "Dispatch: %d QEs, %s sent, serialize %.3f ms, send %.3f ms\n",
+							 showstatctx->dispatch_nqe,
+							 maxbuf,
+							 showstatctx->dispatch_serialize_ms,
+							 showstatctx->dispatch_send_ms);
+		}
+		else
+		{
+			ExplainPropertyInteger("Dispatched QEs", showstatctx->dispatch_nqe, es);
+			ExplainPropertyLong("Dispatched Bytes", (long) showstatctx->dispatch_bytes, es);
+			ExplainPropertyFloat("Serialize Time", showstatctx->dispatch_serialize_ms, 3, es);
+			ExplainPropertyFloat("Send Time", showstatctx->dispatch_send_ms, 3, es);
+		}
+		ExplainCloseGroup("Dispatch statistics", "Dispatch statistics", true, es);
+	}
+
 	if (!IsResManagerMemoryPolicyNone())
 	{
 		ExplainOpenGroup("Statement statistics", "Statement statistics", true, es);
@@ -11937,7 +11937,8 @@ prebuild_temp_table(Relation rel, RangeVar *tmpname, DistributedBy *distro, List
 					if (de->defname &&
 						(strcmp("compresstype", de->defname) == 0 ||
 						 strcmp("compresslevel", de->defname) == 0 ||
-						 strcmp("blocksize", de->defname) == 0))
+						 strcmp("blocksize", de->defname) == 0 ||
+						 strcmp("dictionary", de->defname) == 0))
 						continue;
 					else
 						cs->options = lappend(cs->options, de);
@@ -12143,6 +12144,7 @@ ATExecSetDistributedBy(Relation rel, Node *node, AlterTableCmd *cmd)
 	SetDistributionCmd *qe_data = NULL; 
 	bool save_optimizer_replicated_table_insert;
 	int save_gp_singleton_segindex;
+	int save_gp_create_table_hash_reduction;
 
 	/* Permissions checks */
 	if (!pg_class_ownercheck(RelationGetRelid(rel), GetUserId()))
@@ -12430,13 +12432,22 @@ ATExecSetDistributedBy(Relation rel, Node *node, AlterTableCmd *cmd)
 				Assert(policykeys != NIL);
 				policy = createHashPartitionedPolicy(NULL, policykeys);
 
+				/*
+				 * Once a table uses jump consistent hashing, keep it. gpexpand
+				 * NULLs out the keys and then redistributes with this
+				 * command, which must not fall back to modulo.
+				 */
+				if (rel->rd_cdbpolicy->hashreduce == POLICY_HASHREDUCE_JUMP)
+					policy->hashreduce = POLICY_HASHREDUCE_JUMP;
+
 				/*
 				 * See if the the old policy is the same as the new one but
 				 * remember, we still might have to rebuild if there are new
 				 * storage options.
 				 */
 				if (!DatumGetPointer(newOptions) && !force_reorg &&
-					(policy->nattrs == rel->rd_cdbpolicy->nattrs))
+					(policy->nattrs == rel->rd_cdbpolicy->nattrs) &&
+					(policy->hashreduce == rel->rd_cdbpolicy->hashreduce))
 				{
 					int i;
 					bool diff = false;
@@ -12511,6 +12522,15 @@ ATExecSetDistributedBy(Relation rel, Node *node, AlterTableCmd *cmd)
 
 		GpPolicy *original_policy = NULL;
 
+		/*
+		 * The temporary table must place rows with the hash reduction the
+		 * relation ends up with: that of the new policy, or of the current
+		 * one if the distribution key is not being changed.
+		 */
+		save_gp_create_table_hash_reduction = gp_create_table_hash_reduction;
+		gp_create_table_hash_reduction = policy ? policy->hashreduce :
+			rel->rd_cdbpolicy->hashreduce;
+
 		/*
 		 * Disable optimizer_replicated_table_insert so planner 
 		 * can force a broadcast motion even both source and target
@@ -12569,6 +12589,7 @@ ATExecSetDistributedBy(Relation rel, Node *node, AlterTableCmd *cmd)
 		optimizer = saveOptimizerGucValue;
 		optimizer_replicated_table_insert = save_optimizer_replicated_table_insert;
 		gp_singleton_segindex = save_gp_singleton_segindex;
+		gp_create_table_hash_reduction = save_gp_create_table_hash_reduction;
 
 		CommandCounterIncrement(); /* see the effects of the command */
 
@@ -405,15 +405,19 @@ vacuum(VacuumStmt *vacstmt, Oid relid, bool do_toast,
 /*
  * Assigns the compaction segment information.
  *
- * The segment to compact is returned in *compact_segno, and
- * the segment to move rows to, is returned in *insert_segno.
+ * The segments to compact, up to gp_appendonly_compaction_segfiles of them,
+ * are returned in *compactNowList, and the segments to move their rows to in
+ * *insertSegnoList. Each segment to compact gets its own insert segment, if
+ * enough are available; otherwise the rest share the last one. In utility
+ * mode, all segments are compacted into one insert segment, and
+ * *insertSegnoList has a single entry.
  */
 static bool
 vacuum_assign_compaction_segno(Relation onerel,
 							   List *compactedSegmentFileList,
 							   List *insertedSegmentFileList,
 							   List **compactNowList,
-							   int *insert_segno)
+							   List **insertSegnoList)
 {
 	List *new_compaction_list;
 	bool is_drop;
@@ -428,7 +432,7 @@ vacuum_assign_compaction_segno(Relation onerel,
 	 */
 	if (!gp_appendonly_compaction)
 	{
-		*insert_segno = -1;
+		*insertSegnoList = list_make1_int(APPENDONLY_COMPACTION_SEGNO_INVALID);
 		*compactNowList = NIL;
 		return true;
 	}
@@ -440,15 +444,50 @@ vacuum_assign_compaction_segno(Relation onerel,
 	}
 
 	new_compaction_list = SetSegnoForCompaction(onerel,
-			compactedSegmentFileList, insertedSegmentFileList, &is_drop);
+			compactedSegmentFileList, insertedSegmentFileList,
+			gp_appendonly_compaction_segfiles, &is_drop);
 	if (new_compaction_list)
 	{
+		List	   *insert_segnos = NIL;
+
 		if (!is_drop)
 		{
-			*insert_segno = SetSegnoForCompactionInsert(onerel,
-														new_compaction_list,
-														compactedSegmentFileList,
-														insertedSegmentFileList);
+			List	   *excluded = list_copy(new_compaction_list);
+			int			insert_segno;
+			int			i;
+
+			/*
+			 * The first insert segment must exist. Passing the ones already
+			 * chosen as compacted keeps the next calls from reusing them.
+			 */
+			insert_segno = SetSegnoForCompactionInsert(onerel,
+													   excluded,
+													   compactedSegmentFileList,
+													   insertedSegmentFileList,
+													   false);
+			insert_segnos = lappend_int(insert_segnos, insert_segno);
+
+			for (i = 1; i < list_length(new_compaction_list) &&
+				 insert_segno != RESERVED_SEGNO; i++)
+			{
+				int			next_segno;
+
+				excluded = lappend_int(excluded, insert_segno);
+				next_segno = InvalidFileSegNumber;
+#ifdef FAULT_INJECTOR
+				/* Act as if all other segments were in use */
+				if (SIMPLE_FAULT_INJECTOR(CompactionInsertSegnoUnavailable) != FaultInjectorTypeSkip)
+#endif
+					next_segno = SetSegnoForCompactionInsert(onerel,
+															 excluded,
+															 compactedSegmentFileList,
+															 insertedSegmentFileList,
+															 true);
+				if (next_segno != InvalidFileSegNumber)
+					insert_segno = next_segno;
+				insert_segnos = lappend_int(insert_segnos, insert_segno);
+			}
+			list_free(excluded);
 		}
 		else
 		{
@@ -456,14 +495,17 @@ vacuum_assign_compaction_segno(Relation onerel,
 			 * If we continue an aborted drop phase, we do not assign a real
 			 * insert segment file.
 			 */
-			*insert_segno = APPENDONLY_COMPACTION_SEGNO_INVALID;
+			insert_segnos = list_make1_int(APPENDONLY_COMPACTION_SEGNO_INVALID);
 		}
 		*compactNowList = new_compaction_list;
+		*insertSegnoList = insert_segnos;
 
 		elogif(Debug_appendonly_print_compaction, LOG,
 				"Schedule compaction on AO table: "
-				"compact segno list length %d, insert segno %d",
-				list_length(new_compaction_list), *insert_segno);
+				"compact segno list length %d, insert segno list length %d, "
+				"first insert segno %d",
+				list_length(new_compaction_list), list_length(insert_segnos),
+				linitial_int(insert_segnos));
 		return true;
 	}
 	else
@@ -792,7 +834,7 @@ vacuumStatement_Relation(VacuumStmt *vacstmt, Oid relid,
 		for (;;)
 		{
 			List	   *compactNowList = NIL;
-			int			insertSegNo = -1;
+			List	   *insertSegnoList = NIL;
 
 			if (gp_appendonly_compaction)
 			{
@@ -808,7 +850,7 @@ vacuumStatement_Relation(VacuumStmt *vacstmt, Oid relid,
 													compactedSegmentFileList,
 													insertedSegmentFileList,
 													&compactNowList,
-													&insertSegNo))
+													&insertSegnoList))
 				{
 					/*
 					 * There is nothing left to do for this relation. Proceed to
@@ -824,12 +866,12 @@ vacuumStatement_Relation(VacuumStmt *vacstmt, Oid relid,
 				compactedSegmentFileList =
 					list_union_int(compactedSegmentFileList, compactNowList);
 				insertedSegmentFileList =
-					lappend_int(insertedSegmentFileList, insertSegNo);
+					list_concat(insertedSegmentFileList, list_copy(insertSegnoList));
 
 				MemoryContextSwitchTo(oldcontext);
 
 				vacuum_rel_ao_phase(onerel, relid, vacstmt, lmode, for_wraparound,
-									list_make1_int(insertSegNo),
+									insertSegnoList,
 									compactNowList,
 									AOVAC_COMPACT);
 				onerel = NULL;
@@ -2097,7 +2139,14 @@ vacuum_rel(Relation onerel, Oid relid, VacuumStmt *vacstmt, LOCKMODE lmode,
 				/* this was a "pseudo" compaction phase. */
 			}
 			else
-				UpdateMasterAosegTotalsFromSegments(onerel, SnapshotNow, vacstmt->appendonly_compaction_insert_segno, 0);
+			{
+				/* Several segments may have been compacted into the same one */
+				List	   *insert_segnos;
+
+				insert_segnos = list_union_int(NIL, vacstmt->appendonly_compaction_insert_segno);
+				UpdateMasterAosegTotalsFromSegments(onerel, SnapshotNow, insert_segnos, 0);
+				list_free(insert_segnos);
+			}
 		}
 		else if (vacstmt->appendonly_phase == AOVAC_DROP)
 		{
@@ -131,6 +131,8 @@ static BufferAccessStrategy vac_strategy;
 
 /* non-export function prototypes */
 static void lazy_vacuum_aorel(Relation onerel, VacuumStmt *vacstmt);
+static void vacuum_appendonly_compact(Relation aorel, List *compaction_segnos,
+						  List *insert_segnos, bool isFull);
 static void lazy_scan_heap(Relation onerel, LVRelStats *vacrelstats,
 			   Relation *Irel, int nindexes, bool scan_all);
 static void lazy_vacuum_heap(Relation onerel, LVRelStats *vacrelstats);
@@ -1479,12 +1481,12 @@ vacuum_appendonly_rel(Relation aorel, VacuumStmt *vacstmt)
 	}
 	else
 	{
-		Assert(vacstmt->appendonly_phase == AOVAC_COMPACT);
-		Assert(list_length(vacstmt->appendonly_compaction_insert_segno) == 1);
+		List	   *insert_segnos = vacstmt->appendonly_compaction_insert_segno;
 
-		int insert_segno = linitial_int(vacstmt->appendonly_compaction_insert_segno);
+		Assert(vacstmt->appendonly_phase == AOVAC_COMPACT);
+		Assert(list_length(insert_segnos) >= 1);
 
-		if (insert_segno == APPENDONLY_COMPACTION_SEGNO_INVALID)
+		if (linitial_int(insert_segnos) == APPENDONLY_COMPACTION_SEGNO_INVALID)
 		{
 			elogif(Debug_appendonly_print_compaction, LOG,
 			"Vacuum pseudo-compaction phase %s", RelationGetRelationName(aorel));
@@ -1493,21 +1495,69 @@ vacuum_appendonly_rel(Relation aorel, VacuumStmt *vacstmt)
 		{
 			elogif(Debug_appendonly_print_compaction, LOG,
 				"Vacuum compaction phase %s", RelationGetRelationName(aorel));
-			if (RelationIsAoRows(aorel))
-			{
-				AppendOnlyCompact(aorel,
-								  vacstmt->appendonly_compaction_segno,
-								  insert_segno, (vacstmt->options & VACOPT_FULL));
-			}
-			else
+			vacuum_appendonly_compact(aorel,
+									  vacstmt->appendonly_compaction_segno,
+									  insert_segnos,
+									  (vacstmt->options & VACOPT_FULL));
+		}
+	}
+}
+
+/*
+ * Moves the rows of the segment files to compact into the insert segment
+ * files.
+ *
+ * There is either a single insert segment, for all the compacted ones, or one
+ * per compacted segment, in the same order. Several compacted segments may
+ * share an insert segment, if there weren't enough available. They are
+ * compacted one insert segment at a time, so that each one is only opened
+ * once.
+ */
+static void
+vacuum_appendonly_compact(Relation aorel, List *compaction_segnos,
+						  List *insert_segnos, bool isFull)
+{
+	List	   *done_insert_segnos = NIL;
+	ListCell   *lc;
+
+	Assert(list_length(insert_segnos) == 1 ||
+		   list_length(insert_segnos) == list_length(compaction_segnos));
+
+	foreach(lc, insert_segnos)
+	{
+		int			insert_segno = lfirst_int(lc);
+		List	   *segnos = NIL;
+
+		if (list_member_int(done_insert_segnos, insert_segno))
+			continue;
+		done_insert_segnos = lappend_int(done_insert_segnos, insert_segno);
+
+		if (list_length(insert_segnos) == 1)
+			segnos = compaction_segnos;
+		else
+		{
+			ListCell   *lc_compact;
+			ListCell   *lc_insert;
+
+			forboth(lc_compact, compaction_segnos, lc_insert, insert_segnos)
 			{
-				Assert(RelationIsAoCols(aorel));
-				AOCSCompact(aorel,
-							vacstmt->appendonly_compaction_segno,
-							insert_segno, (vacstmt->options & VACOPT_FULL));
+				if (lfirst_int(lc_insert) == insert_segno)
+					segnos = lappend_int(segnos, lfirst_int(lc_compact));
 			}
 		}
+
+		if (RelationIsAoRows(aorel))
+		{
+			AppendOnlyCompact(aorel, segnos, insert_segno, isFull, elevel);
+		}
+		else
+		{
+			Assert(RelationIsAoCols(aorel));
+			AOCSCompact(aorel, segnos, insert_segno, isFull, elevel);
+		}
 	}
+
+	list_free(done_insert_segnos);
 }
 
 /*
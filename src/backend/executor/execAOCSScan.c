@@ -16,8 +16,108 @@
 
 #include "utils/snapmgr.h"
 #include "executor/executor.h"
+#include "executor/execBatchQual.h"
 #include "nodes/execnodes.h"
 #include "cdb/cdbaocsam.h"
+#include "cdb/cdbvars.h"
+#include "miscadmin.h"
+
+/*
+ * Number of rows read at a time in batch mode. The batch is made smaller for
+ * wide tables, to bound the size of the column vectors.
+ */
+#define AOCS_BATCH_MAX_ROWS		1024
+#define AOCS_BATCH_MAX_BYTES	(1024 * 1024)
+
+static void
+InitAOCSScanBatch(ScanState *scanState)
+{
+	AOCSScanOpaqueData *opaque = ((AOCSScanState *) scanState)->opaque;
+	Relation	currentRelation = scanState->ss_currentRelation;
+	List	   *residual;
+	int			i;
+
+	opaque->batchQual = NULL;
+
+	/*
+	 * The qual of a dynamic scan refers to the attribute numbers of the
+	 * parent table, which need not match those of the partition scanned.
+	 */
+	if (!gp_enable_aocs_batch_scan || !IsA(scanState, TableScanState))
+		return;
+
+	opaque->batchQual = ExecInitBatchQual(scanState->ps.plan->qual,
+										  scanState->ps.qual,
+										  ((Scan *) scanState->ps.plan)->scanrelid,
+										  RelationGetDescr(currentRelation),
+										  &residual);
+	if (opaque->batchQual == NULL)
+		return;
+
+	opaque->origQual = scanState->ps.qual;
+	scanState->ps.qual = residual;
+
+	opaque->batchSize = AOCS_BATCH_MAX_BYTES /
+		(opaque->ncol * (sizeof(Datum) + sizeof(bool) + sizeof(uint32)));
+	opaque->batchSize = Max(Min(opaque->batchSize, AOCS_BATCH_MAX_ROWS), 1);
+
+	/*
+	 * Unless late materialization is off, read only the columns of the batch
+	 * clauses with the batch, and the rest for the rows that pass them.
+	 */
+	opaque->batchLate = palloc0(sizeof(bool) * opaque->ncol);
+	if (gp_enable_aocs_late_materialization)
+	{
+		memcpy(opaque->batchLate, opaque->proj, sizeof(bool) * opaque->ncol);
+		for (i = 0; i < opaque->batchQual->nclauses; i++)
+			opaque->batchLate[opaque->batchQual->clauses[i].attno] = false;
+	}
+
+	opaque->batchAtts = palloc(sizeof(int) * opaque->ncol);
+	opaque->nbatchAtts = 0;
+	opaque->lateAtts = palloc(sizeof(int) * opaque->ncol);
+	opaque->nlateAtts = 0;
+	for (i = 0; i < opaque->ncol; i++)
+	{
+		if (opaque->batchLate[i])
+			opaque->lateAtts[opaque->nlateAtts++] = i;
+		else if (opaque->proj[i])
+			opaque->batchAtts[opaque->nbatchAtts++] = i;
+	}
+
+	opaque->batchValues = palloc(sizeof(Datum) * opaque->ncol * opaque->batchSize);
+	opaque->batchIsnull = palloc(sizeof(bool) * opaque->ncol * opaque->batchSize);
+	opaque->batchRuns = palloc(sizeof(uint32) * opaque->ncol * opaque->batchSize);
+	opaque->batchDicts = palloc0(sizeof(BatchDict) * opaque->ncol);
+	opaque->batchCtids = palloc(sizeof(ItemPointerData) * opaque->batchSize);
+	opaque->batchSel = palloc(sizeof(int) * opaque->batchSize);
+	opaque->batchNumSel = 0;
+	opaque->batchNextSel = 0;
+}
+
+static void
+FreeAOCSScanBatch(ScanState *scanState)
+{
+	AOCSScanOpaqueData *opaque = ((AOCSScanState *) scanState)->opaque;
+
+	if (opaque->batchQual == NULL)
+		return;
+
+	list_free(scanState->ps.qual);
+	scanState->ps.qual = opaque->origQual;
+
+	ExecEndBatchQual(opaque->batchQual);
+	pfree(opaque->batchLate);
+	pfree(opaque->batchAtts);
+	pfree(opaque->lateAtts);
+	pfree(opaque->batchValues);
+	pfree(opaque->batchIsnull);
+	pfree(opaque->batchRuns);
+	pfree(opaque->batchDicts);
+	pfree(opaque->batchCtids);
+	pfree(opaque->batchSel);
+	opaque->batchQual = NULL;
+}
 
 static void
 InitAOCSScanOpaque(ScanState *scanState)
@@ -53,6 +153,8 @@ InitAOCSScanOpaque(ScanState *scanState)
 	{
 		opaque->proj[0] = true;
 	}
+
+	InitAOCSScanBatch(scanState);
 }
 
 static void
@@ -62,12 +164,98 @@ FreeAOCSScanOpaque(ScanState *scanState)
 	Assert(state->opaque != NULL);
 
 	AOCSScanOpaqueData *opaque = (AOCSScanOpaqueData *)state->opaque;
+	FreeAOCSScanBatch(scanState);
 	Assert(opaque->proj != NULL);
 	pfree(opaque->proj);
 	pfree(state->opaque);
 	state->opaque = NULL;
 }
 
+/*
+ * Return the next row of the scan in batch mode.
+ *
+ * Rows are read a batch at a time, and the clauses of the qual in batchQual
+ * are evaluated over the whole batch. Only the rows that pass them are
+ * returned, for ExecScan() to check the rest of the qual. The late columns
+ * are read as these rows are returned.
+ */
+static TupleTableSlot *
+AOCSScanNextBatch(AOCSScanState *node)
+{
+	AOCSScanOpaqueData *opaque = node->opaque;
+	TupleTableSlot *slot = node->ss.ss_ScanTupleSlot;
+	Datum	   *values;
+	bool	   *isnull;
+	int			batchSize = opaque->batchSize;
+	int			row;
+	int			i;
+
+	Assert(ScanDirectionIsForward(node->ss.ps.state->es_direction));
+
+	while (opaque->batchNextSel >= opaque->batchNumSel)
+	{
+		int			nrows;
+
+		CHECK_FOR_INTERRUPTS();
+
+		nrows = aocs_getnext_batch(opaque->scandesc, batchSize,
+								   opaque->batchValues, opaque->batchIsnull,
+								   opaque->batchRuns, opaque->batchCtids);
+		if (nrows == 0)
+			return ExecClearTuple(slot);
+
+		for (i = 0; i < opaque->nbatchAtts; i++)
+		{
+			int			attno = opaque->batchAtts[i];
+			BatchDict  *dict = &opaque->batchDicts[attno];
+
+			dict->ncodes = aocs_batch_dictionary(opaque->scandesc, attno,
+												 &dict->entries,
+												 &dict->generation);
+		}
+
+		opaque->batchNumSel = ExecBatchQual(opaque->batchQual,
+											opaque->batchValues,
+											opaque->batchIsnull,
+											opaque->batchRuns,
+											opaque->batchDicts,
+											batchSize, nrows,
+											opaque->batchSel);
+		opaque->batchNextSel = 0;
+	}
+
+	row = opaque->batchSel[opaque->batchNextSel++];
+
+	values = slot_get_values(slot);
+	isnull = slot_get_isnull(slot);
+	for (i = 0; i < opaque->nbatchAtts; i++)
+	{
+		int			attno = opaque->batchAtts[i];
+
+		values[attno] = opaque->batchValues[attno * batchSize + row];
+		isnull[attno] = opaque->batchIsnull[attno * batchSize + row];
+	}
+
+	if (opaque->nlateAtts > 0 &&
+		!aocs_batch_late_values(opaque->scandesc, &opaque->batchCtids[row],
+								values, isnull))
+	{
+		/* The late columns were read with this batch */
+		for (i = 0; i < opaque->nlateAtts; i++)
+		{
+			int			attno = opaque->lateAtts[i];
+
+			values[attno] = opaque->batchValues[attno * batchSize + row];
+			isnull[attno] = opaque->batchIsnull[attno * batchSize + row];
+		}
+	}
+
+	TupSetVirtualTupleNValid(slot, slot->tts_tupleDescriptor->natts);
+	slot_set_ctid(slot, &opaque->batchCtids[row]);
+
+	return slot;
+}
+
 TupleTableSlot *
 AOCSScanNext(ScanState *scanState)
 {
@@ -77,6 +265,9 @@ AOCSScanNext(ScanState *scanState)
 	Assert(node->opaque != NULL &&
 		   node->opaque->scandesc != NULL);
 
+	if (node->opaque->batchQual != NULL)
+		return AOCSScanNextBatch(node);
+
 	aocs_getnext(node->opaque->scandesc, node->ss.ps.state->es_direction, node->ss.ss_ScanTupleSlot);
 	return node->ss.ss_ScanTupleSlot;
 }
@@ -85,6 +276,8 @@ void
 BeginScanAOCSRelation(ScanState *scanState)
 {
 	Snapshot appendOnlyMetaDataSnapshot;
+	ScanKey		zonemapKeys;
+	int			nzonemapKeys;
 
 	Assert(IsA(scanState, TableScanState) ||
 		   IsA(scanState, DynamicTableScanState));
@@ -111,6 +304,16 @@ BeginScanAOCSRelation(ScanState *scanState)
 					   NULL /* relationTupleDesc */,
 					   node->opaque->proj);
 
+	if (node->opaque->batchQual != NULL && node->opaque->nlateAtts > 0)
+		aocs_setlatecolumns(node->opaque->scandesc, node->opaque->batchLate);
+
+	zonemapKeys = ExecAppendOnlyZoneMapKeys(scanState, &nzonemapKeys);
+	if (zonemapKeys != NULL)
+	{
+		aocs_setzonemapkeys(node->opaque->scandesc, nzonemapKeys, zonemapKeys);
+		pfree(zonemapKeys);
+	}
+
 	node->ss.scan_state = SCAN_SCAN;
 }
  
@@ -142,4 +345,6 @@ ReScanAOCSRelation(ScanState *scanState)
 		   node->opaque->scandesc != NULL);
 
 	aocs_rescan(node->opaque->scandesc); 
+	node->opaque->batchNumSel = 0;
+	node->opaque->batchNextSel = 0;
 }
@@ -14,10 +14,135 @@
  */
 #include "postgres.h"
 
+#include "access/skey.h"
 #include "executor/executor.h"
 #include "nodes/execnodes.h"
 #include "cdb/cdbappendonlyam.h"
+#include "cdb/cdbappendonlyblockdirectory.h"
+#include "utils/lsyscache.h"
 #include "utils/snapmgr.h"
+#include "utils/typcache.h"
+
+/*
+ * Turn a "Var op Const" or "Const op Var" qual clause into a zone map scan
+ * key, if the operator is a btree comparison of a pass-by-value type.
+ */
+static bool
+ZoneMapKeyFromOpExpr(OpExpr *op, ScanKey key)
+{
+	Node	   *left;
+	Node	   *right;
+	Oid			opno = op->opno;
+	Var		   *var;
+	Const	   *con;
+	TypeCacheEntry *typentry;
+	int			strategy;
+
+	if (list_length(op->args) != 2)
+		return false;
+	left = (Node *) linitial(op->args);
+	right = (Node *) lsecond(op->args);
+
+	if (IsA(left, Var) && IsA(right, Const))
+	{
+		var = (Var *) left;
+		con = (Const *) right;
+	}
+	else if (IsA(left, Const) && IsA(right, Var))
+	{
+		var = (Var *) right;
+		con = (Const *) left;
+		opno = get_commutator(opno);
+		if (!OidIsValid(opno))
+			return false;
+	}
+	else
+		return false;
+
+	if (var->varattno <= 0 || con->constisnull ||
+		con->consttype != var->vartype || !con->constbyval)
+		return false;
+
+	typentry = lookup_type_cache(var->vartype,
+								 TYPECACHE_BTREE_OPFAMILY | TYPECACHE_CMP_PROC_FINFO);
+	if (!OidIsValid(typentry->btree_opf) ||
+		!OidIsValid(typentry->cmp_proc_finfo.fn_oid))
+		return false;
+
+	strategy = get_op_opfamily_strategy(opno, typentry->btree_opf);
+	if (strategy == 0)
+		return false;
+
+	ScanKeyEntryInitializeWithInfo(key, 0, var->varattno, strategy,
+								   var->vartype, &typentry->cmp_proc_finfo,
+								   con->constvalue);
+	return true;
+}
+
+/*
+ * Build the zone map scan keys of an append-only table scan from the simple
+ * comparisons and null tests in its qual. The keys are only used to skip
+ * whole blocks; the qual is still evaluated for every tuple that is read.
+ *
+ * Returns NULL if no clause qualifies.
+ */
+ScanKey
+ExecAppendOnlyZoneMapKeys(ScanState *scanState, int *nkeys)
+{
+	List	   *qual = scanState->ps.plan->qual;
+	ScanKey		keys;
+	ListCell   *lc;
+	int			n = 0;
+
+	*nkeys = 0;
+
+	/*
+	 * The qual of a dynamic scan refers to the attribute numbers of the
+	 * parent table, which need not match those of the partition scanned.
+	 */
+	if (!gp_appendonly_zonemap || qual == NIL ||
+		!IsA(scanState, TableScanState))
+		return NULL;
+
+	keys = (ScanKey) palloc(sizeof(ScanKeyData) * list_length(qual));
+
+	foreach(lc, qual)
+	{
+		Node	   *clause = (Node *) lfirst(lc);
+
+		if (IsA(clause, OpExpr))
+		{
+			if (ZoneMapKeyFromOpExpr((OpExpr *) clause, &keys[n]))
+				n++;
+		}
+		else if (IsA(clause, NullTest))
+		{
+			NullTest   *ntest = (NullTest *) clause;
+
+			if (IsA(ntest->arg, Var) && ((Var *) ntest->arg)->varattno > 0 &&
+				!ntest->argisrow)
+			{
+				ScanKeyEntryInitialize(&keys[n],
+									   SK_ISNULL |
+									   (ntest->nulltesttype == IS_NULL ?
+										SK_SEARCHNULL : SK_SEARCHNOTNULL),
+									   ((Var *) ntest->arg)->varattno,
+									   InvalidStrategy, InvalidOid,
+									   InvalidOid, (Datum) 0);
+				n++;
+			}
+		}
+	}
+
+	if (n == 0)
+	{
+		pfree(keys);
+		return NULL;
+	}
+
+	*nkeys = n;
+	return keys;
+}
 
 TupleTableSlot *
 AppendOnlyScanNext(ScanState *scanState)
@@ -52,6 +177,8 @@ void
 BeginScanAppendOnlyRelation(ScanState *scanState)
 {
 	Snapshot appendOnlyMetaDataSnapshot;
+	ScanKey		zonemapKeys;
+	int			nzonemapKeys;
 
 	Assert(IsA(scanState, TableScanState) ||
 		   IsA(scanState, DynamicTableScanState));
@@ -76,6 +203,14 @@ BeginScanAppendOnlyRelation(ScanState *scanState)
 			node->ss.ps.state->es_snapshot, 
 			appendOnlyMetaDataSnapshot,
 			0, NULL);
+
+	zonemapKeys = ExecAppendOnlyZoneMapKeys(scanState, &nzonemapKeys);
+	if (zonemapKeys != NULL)
+	{
+		appendonly_setzonemapkeys(node->aos_ScanDesc, nzonemapKeys, zonemapKeys);
+		pfree(zonemapKeys);
+	}
+
 	node->ss.scan_state = SCAN_SCAN;
 }
 
@@ -0,0 +1,772 @@
+/*-------------------------------------------------------------------------
+ *
+ * execBatchQual.c
+ *	  Evaluation of simple scan quals over column vectors.
+ *
+ * The expression evaluator in execQual.c works one tuple at a time, going
+ * through a function call per operator and per column reference. For scans
+ * that produce rows in batches, the comparisons of a column with a constant
+ * and the null tests in the qual are instead evaluated here, one clause at a
+ * time over the whole batch, in tight loops over the column vectors. The
+ * rows that pass are tracked in a selection vector, an array of the row
+ * numbers in the batch that are still qualifying.
+ *
+ * When the scan can tell which consecutive values are copies of the same
+ * stored value, as for RLE_TYPE compressed columns, a comparison over a
+ * column made of long runs is evaluated once per run instead of once per row.
+ *
+ * Only comparisons with the default btree operators of pass-by-value
+ * integer, date, timestamp and floating point types are handled, whose
+ * result is known to be a plain comparison of the native values, plus
+ * equality and IN of text and varchar columns with constants. All other
+ * clauses are left for ExecQual().
+ *
+ * Text equality is a byte comparison. When the values of a column come
+ * from a dictionary encoded block, the scan passes the code of each value
+ * instead of a run id, and the clause is evaluated once per dictionary
+ * entry. Then each row only costs a lookup of its code.
+ *
+ * Portions Copyright (c) 2018-Present Pivotal Software, Inc.
+ *
+ * IDENTIFICATION
+ *	    src/backend/executor/execBatchQual.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include <math.h>
+
+#include "access/skey.h"
+#include "catalog/pg_operator.h"
+#include "catalog/pg_type.h"
+#include "executor/execBatchQual.h"
+#include "nodes/primnodes.h"
+#include "utils/array.h"
+#include "utils/builtins.h"
+#include "utils/lsyscache.h"
+#include "utils/typcache.h"
+
+static bool
+BatchQualTypeForOid(Oid typid, BatchQualType *type)
+{
+	switch (typid)
+	{
+		case INT2OID:
+			*type = BQT_INT16;
+			return true;
+		case INT4OID:
+		case DATEOID:
+			*type = BQT_INT32;
+			return true;
+		case INT8OID:
+#ifdef HAVE_INT64_TIMESTAMP
+		case TIMESTAMPOID:
+		case TIMESTAMPTZOID:
+#endif
+			*type = BQT_INT64;
+			return true;
+		case FLOAT4OID:
+			*type = BQT_FLOAT4;
+			return true;
+		case FLOAT8OID:
+			*type = BQT_FLOAT8;
+			return true;
+		default:
+			return false;
+	}
+}
+
+static bool
+BatchQualClauseFromOpExpr(OpExpr *op, Index scanrelid, TupleDesc tupdesc,
+						  BatchQualClause *clause)
+{
+	Node	   *left;
+	Node	   *right;
+	Oid			opno = op->opno;
+	Var		   *var;
+	Const	   *con;
+	TypeCacheEntry *typentry;
+	int			strategy;
+
+	if (list_length(op->args) != 2)
+		return false;
+	left = (Node *) linitial(op->args);
+	right = (Node *) lsecond(op->args);
+
+	if (IsA(left, Var) && IsA(right, Const))
+	{
+		var = (Var *) left;
+		con = (Const *) right;
+	}
+	else if (IsA(left, Const) && IsA(right, Var))
+	{
+		var = (Var *) right;
+		con = (Const *) left;
+		opno = get_commutator(opno);
+		if (!OidIsValid(opno))
+			return false;
+	}
+	else
+		return false;
+
+	if (var->varno != scanrelid || var->varlevelsup != 0 ||
+		var->varattno <= 0 || var->varattno > tupdesc->natts ||
+		tupdesc->attrs[var->varattno - 1]->atttypid != var->vartype ||
+		!tupdesc->attrs[var->varattno - 1]->attbyval ||
+		con->constisnull || con->consttype != var->vartype)
+		return false;
+
+	if (!BatchQualTypeForOid(var->vartype, &clause->type))
+		return false;
+
+	typentry = lookup_type_cache(var->vartype, TYPECACHE_BTREE_OPFAMILY);
+	if (!OidIsValid(typentry->btree_opf))
+		return false;
+
+	strategy = get_op_opfamily_strategy(opno, typentry->btree_opf);
+	switch (strategy)
+	{
+		case BTLessStrategyNumber:
+			clause->op = BQ_LT;
+			break;
+		case BTLessEqualStrategyNumber:
+			clause->op = BQ_LE;
+			break;
+		case BTEqualStrategyNumber:
+			clause->op = BQ_EQ;
+			break;
+		case BTGreaterEqualStrategyNumber:
+			clause->op = BQ_GE;
+			break;
+		case BTGreaterStrategyNumber:
+			clause->op = BQ_GT;
+			break;
+		default:
+			/* <> is not in the opfamily, but its negator is */
+			opno = get_negator(opno);
+			if (!OidIsValid(opno) ||
+				get_op_opfamily_strategy(opno, typentry->btree_opf) != BTEqualStrategyNumber)
+				return false;
+			clause->op = BQ_NE;
+			break;
+	}
+
+	clause->attno = var->varattno - 1;
+	switch (clause->type)
+	{
+		case BQT_INT16:
+			clause->constval.i = DatumGetInt16(con->constvalue);
+			break;
+		case BQT_INT32:
+			clause->constval.i = DatumGetInt32(con->constvalue);
+			break;
+		case BQT_INT64:
+			clause->constval.i = DatumGetInt64(con->constvalue);
+			break;
+		case BQT_FLOAT4:
+			clause->constval.f = DatumGetFloat4(con->constvalue);
+			break;
+		case BQT_FLOAT8:
+			clause->constval.f = DatumGetFloat8(con->constvalue);
+			break;
+		case BQT_TEXT:
+			/* text clauses are built by BatchQualClauseFromTextOpExpr */
+			return false;
+	}
+
+	/*
+	 * The float comparison operators sort NaN above all other values. The
+	 * kernels get that right for NaN column values, but not for a NaN
+	 * constant.
+	 */
+	if ((clause->type == BQT_FLOAT4 || clause->type == BQT_FLOAT8) &&
+		isnan(clause->constval.f))
+		return false;
+
+	return true;
+}
+
+/*
+ * The column of a text equality, if it is a text or varchar column of the
+ * scanned relation. varchar values are relabeled as text.
+ */
+static Var *
+BatchQualTextVar(Node *node, Index scanrelid, TupleDesc tupdesc)
+{
+	Var		   *var;
+	Oid			atttypid;
+
+	if (IsA(node, RelabelType))
+		node = (Node *) ((RelabelType *) node)->arg;
+	if (!IsA(node, Var))
+		return NULL;
+
+	var = (Var *) node;
+	if (var->varno != scanrelid || var->varlevelsup != 0 ||
+		var->varattno <= 0 || var->varattno > tupdesc->natts)
+		return NULL;
+
+	atttypid = tupdesc->attrs[var->varattno - 1]->atttypid;
+	if (atttypid != var->vartype ||
+		(atttypid != TEXTOID && atttypid != VARCHAROID))
+		return NULL;
+
+	return var;
+}
+
+static Const *
+BatchQualTextConst(Node *node)
+{
+	if (IsA(node, RelabelType))
+		node = (Node *) ((RelabelType *) node)->arg;
+	if (!IsA(node, Const) || ((Const *) node)->constisnull)
+		return NULL;
+
+	return (Const *) node;
+}
+
+/*
+ * "text column = constant", with the operands in either order.
+ */
+static bool
+BatchQualClauseFromTextOpExpr(OpExpr *op, Index scanrelid, TupleDesc tupdesc,
+							  BatchQualClause *clause)
+{
+	Var		   *var;
+	Const	   *con;
+
+	if (op->opno != TextEqualOperator || list_length(op->args) != 2)
+		return false;
+
+	var = BatchQualTextVar((Node *) linitial(op->args), scanrelid, tupdesc);
+	con = BatchQualTextConst((Node *) lsecond(op->args));
+	if (var == NULL || con == NULL)
+	{
+		var = BatchQualTextVar((Node *) lsecond(op->args), scanrelid, tupdesc);
+		con = BatchQualTextConst((Node *) linitial(op->args));
+		if (var == NULL || con == NULL)
+			return false;
+	}
+
+	clause->attno = var->varattno - 1;
+	clause->op = BQ_EQ;
+	clause->type = BQT_TEXT;
+	clause->nconsts = 1;
+	clause->consts = (text **) palloc(sizeof(text *));
+	clause->consts[0] = DatumGetTextPP(con->constvalue);
+
+	return true;
+}
+
+/*
+ * "text column IN (constants)", which is "column = ANY (array constant)".
+ * NULL elements can't make the clause true, so they are left out.
+ */
+static bool
+BatchQualClauseFromTextArrayOp(ScalarArrayOpExpr *saop, Index scanrelid,
+							   TupleDesc tupdesc, BatchQualClause *clause)
+{
+	Var		   *var;
+	Const	   *con;
+	ArrayType  *arr;
+	Oid			elemtype;
+	int16		elmlen;
+	bool		elmbyval;
+	char		elmalign;
+	Datum	   *elems;
+	bool	   *elemnulls;
+	int			nelems;
+	int			i;
+
+	if (!saop->useOr || saop->opno != TextEqualOperator ||
+		list_length(saop->args) != 2)
+		return false;
+
+	var = BatchQualTextVar((Node *) linitial(saop->args), scanrelid, tupdesc);
+	con = BatchQualTextConst((Node *) lsecond(saop->args));
+	if (var == NULL || con == NULL)
+		return false;
+
+	arr = DatumGetArrayTypeP(con->constvalue);
+	elemtype = ARR_ELEMTYPE(arr);
+	if (elemtype != TEXTOID && elemtype != VARCHAROID)
+		return false;
+
+	get_typlenbyvalalign(elemtype, &elmlen, &elmbyval, &elmalign);
+	deconstruct_array(arr, elemtype, elmlen, elmbyval, elmalign,
+					  &elems, &elemnulls, &nelems);
+
+	clause->attno = var->varattno - 1;
+	clause->op = BQ_EQ;
+	clause->type = BQT_TEXT;
+	clause->nconsts = 0;
+	clause->consts = (text **) palloc(sizeof(text *) * Max(nelems, 1));
+	for (i = 0; i < nelems; i++)
+	{
+		if (!elemnulls[i])
+			clause->consts[clause->nconsts++] = DatumGetTextPP(elems[i]);
+	}
+
+	pfree(elems);
+	pfree(elemnulls);
+
+	return true;
+}
+
+/*
+ * Find the clauses of a scan qual that can be evaluated by ExecBatchQual().
+ *
+ * 'qual' is the implicitly ANDed list of clauses of the plan, 'qualstate'
+ * the list of their ExprStates. The ExprStates of the clauses that are not
+ * handled are returned in *residual, to be evaluated with ExecQual().
+ *
+ * Returns NULL if no clause qualifies.
+ */
+BatchQual *
+ExecInitBatchQual(List *qual, List *qualstate, Index scanrelid,
+				  TupleDesc tupdesc, List **residual)
+{
+	BatchQual  *bq;
+	ListCell   *lc;
+	ListCell   *lcs;
+
+	Assert(list_length(qual) == list_length(qualstate));
+
+	*residual = NIL;
+	if (qual == NIL)
+		return NULL;
+
+	bq = (BatchQual *) palloc(sizeof(BatchQual));
+	bq->nclauses = 0;
+	bq->clauses = (BatchQualClause *) palloc0(sizeof(BatchQualClause) * list_length(qual));
+	bq->mcxt = CurrentMemoryContext;
+
+	forboth(lc, qual, lcs, qualstate)
+	{
+		Node	   *clause = (Node *) lfirst(lc);
+		BatchQualClause *bqc = &bq->clauses[bq->nclauses];
+
+		if (IsA(clause, OpExpr) &&
+			(BatchQualClauseFromOpExpr((OpExpr *) clause, scanrelid, tupdesc, bqc) ||
+			 BatchQualClauseFromTextOpExpr((OpExpr *) clause, scanrelid, tupdesc, bqc)))
+		{
+			bq->nclauses++;
+			continue;
+		}
+
+		if (IsA(clause, ScalarArrayOpExpr) &&
+			BatchQualClauseFromTextArrayOp((ScalarArrayOpExpr *) clause,
+										   scanrelid, tupdesc, bqc))
+		{
+			bq->nclauses++;
+			continue;
+		}
+
+		if (IsA(clause, NullTest) && !((NullTest *) clause)->argisrow &&
+			IsA(((NullTest *) clause)->arg, Var))
+		{
+			NullTest   *ntest = (NullTest *) clause;
+			Var		   *var = (Var *) ntest->arg;
+
+			if (var->varno == scanrelid && var->varlevelsup == 0 &&
+				var->varattno > 0 && var->varattno <= tupdesc->natts)
+			{
+				bqc->attno = var->varattno - 1;
+				bqc->op = (ntest->nulltesttype == IS_NULL) ? BQ_ISNULL : BQ_NOTNULL;
+				bq->nclauses++;
+				continue;
+			}
+		}
+
+		*residual = lappend(*residual, lfirst(lcs));
+	}
+
+	if (bq->nclauses == 0)
+	{
+		pfree(bq->clauses);
+		pfree(bq);
+		list_free(*residual);
+		*residual = qualstate;
+		return NULL;
+	}
+
+	return bq;
+}
+
+void
+ExecEndBatchQual(BatchQual *bq)
+{
+	int			c;
+
+	for (c = 0; c < bq->nclauses; c++)
+	{
+		BatchQualClause *clause = &bq->clauses[c];
+
+		if (clause->consts != NULL)
+			pfree(clause->consts);
+		if (clause->dict_match != NULL)
+			pfree(clause->dict_match);
+	}
+	pfree(bq->clauses);
+	pfree(bq);
+}
+
+/*
+ * The comparison kernels. Each one narrows the selection vector down to the
+ * rows for which the clause is true, without branching on the outcome.
+ *
+ * > and >= are computed as the negation of <= and <, so that NaN values sort
+ * above everything else, like in the float comparison operators. NULLs never
+ * qualify, as the operators are strict.
+ */
+#define BATCH_CMP_LOOP(getter, expr) \
+	do { \
+		if (dense) \
+		{ \
+			for (i = 0; i < n; i++) \
+			{ \
+				v = getter(vals[i]); \
+				sel[k] = i; \
+				k += (!nulls[i]) & (expr); \
+			} \
+		} \
+		else \
+		{ \
+			for (i = 0; i < n; i++) \
+			{ \
+				int			r = sel[i]; \
+				v = getter(vals[r]); \
+				sel[k] = r; \
+				k += (!nulls[r]) & (expr); \
+			} \
+		} \
+	} while (0)
+
+#define DEFINE_BATCH_CMP(fname, ctype, getter) \
+static int \
+fname(BatchQualOp op, const Datum *vals, const bool *nulls, ctype c, \
+	  int *sel, int n, bool dense) \
+{ \
+	ctype		v; \
+	int			i; \
+	int			k = 0; \
+\
+	switch (op) \
+	{ \
+		case BQ_LT: \
+			BATCH_CMP_LOOP(getter, v < c); \
+			break; \
+		case BQ_LE: \
+			BATCH_CMP_LOOP(getter, v <= c); \
+			break; \
+		case BQ_EQ: \
+			BATCH_CMP_LOOP(getter, v == c); \
+			break; \
+		case BQ_NE: \
+			BATCH_CMP_LOOP(getter, v != c); \
+			break; \
+		case BQ_GE: \
+			BATCH_CMP_LOOP(getter, !(v < c)); \
+			break; \
+		case BQ_GT: \
+			BATCH_CMP_LOOP(getter, !(v <= c)); \
+			break; \
+		default: \
+			elog(ERROR, "unexpected batch qual operator %d", (int) op); \
+	} \
+	return k; \
+}
+
+DEFINE_BATCH_CMP(BatchCmpInt16, int16, DatumGetInt16)
+DEFINE_BATCH_CMP(BatchCmpInt32, int32, DatumGetInt32)
+DEFINE_BATCH_CMP(BatchCmpInt64, int64, DatumGetInt64)
+DEFINE_BATCH_CMP(BatchCmpFloat4, float4, DatumGetFloat4)
+DEFINE_BATCH_CMP(BatchCmpFloat8, float8, DatumGetFloat8)
+
+static int
+BatchNullTest(bool wantnull, const bool *nulls, int *sel, int n, bool dense)
+{
+	int			i;
+	int			k = 0;
+
+	if (dense)
+	{
+		for (i = 0; i < n; i++)
+		{
+			sel[k] = i;
+			k += (nulls[i] == wantnull);
+		}
+	}
+	else
+	{
+		for (i = 0; i < n; i++)
+		{
+			int			r = sel[i];
+
+			sel[k] = r;
+			k += (nulls[r] == wantnull);
+		}
+	}
+	return k;
+}
+
+/*
+ * Use the per run evaluation for a column if its batch has at most one run
+ * for every BATCH_RUN_MIN_LENGTH rows. Below that, the branch per row costs
+ * more than the comparisons it saves.
+ */
+#define BATCH_RUN_MIN_LENGTH	4
+
+#define BATCH_CMP_ONE(v, c, op) \
+	((op) == BQ_LT ? (v) < (c) : \
+	 (op) == BQ_LE ? (v) <= (c) : \
+	 (op) == BQ_EQ ? (v) == (c) : \
+	 (op) == BQ_NE ? (v) != (c) : \
+	 (op) == BQ_GE ? !((v) < (c)) : \
+	 !((v) <= (c)))
+
+/*
+ * Is a text value equal to any constant of a BQT_TEXT clause? This is
+ * texteq(), without the function calls.
+ */
+static bool
+BatchTextEqualAny(BatchQualClause *clause, Datum d)
+{
+	text	   *t = DatumGetTextPP(d);
+	int			len = VARSIZE_ANY_EXHDR(t);
+	bool		result = false;
+	int			i;
+
+	for (i = 0; i < clause->nconsts; i++)
+	{
+		text	   *c = clause->consts[i];
+
+		if (VARSIZE_ANY_EXHDR(c) == len &&
+			strncmp(VARDATA_ANY(c), VARDATA_ANY(t), len) == 0)
+		{
+			result = true;
+			break;
+		}
+	}
+
+	if ((Pointer) t != DatumGetPointer(d))
+		pfree(t);
+
+	return result;
+}
+
+static int
+BatchCmpText(BatchQualClause *clause, const Datum *vals, const bool *nulls,
+			 int *sel, int n, bool dense)
+{
+	int			i;
+	int			k = 0;
+
+	for (i = 0; i < n; i++)
+	{
+		int			r = dense ? i : sel[i];
+
+		sel[k] = r;
+		k += (!nulls[r] && BatchTextEqualAny(clause, vals[r]));
+	}
+	return k;
+}
+
+/*
+ * Kernel for a BQT_TEXT clause on a column of dictionary codes. The clause
+ * is evaluated once per entry when the dictionary changes; after that, a row
+ * is a lookup of its code. The extra code for NULL never matches.
+ */
+static int
+BatchCmpDict(BatchQual *bq, BatchQualClause *clause, BatchDict *dict,
+			 const uint32 *codes, int *sel, int n, bool dense)
+{
+	const bool *match;
+	int			i;
+	int			k = 0;
+
+	if (clause->dict_match == NULL || clause->dict_generation != dict->generation)
+	{
+		if (clause->dict_match_size < dict->ncodes + 1)
+		{
+			if (clause->dict_match != NULL)
+				pfree(clause->dict_match);
+			clause->dict_match = (bool *) MemoryContextAlloc(bq->mcxt,
+															  dict->ncodes + 1);
+			clause->dict_match_size = dict->ncodes + 1;
+		}
+
+		for (i = 0; i < dict->ncodes; i++)
+			clause->dict_match[i] = BatchTextEqualAny(clause, dict->entries[i]);
+		clause->dict_match[dict->ncodes] = false;
+		clause->dict_generation = dict->generation;
+	}
+
+	match = clause->dict_match;
+	if (dense)
+	{
+		for (i = 0; i < n; i++)
+		{
+			sel[k] = i;
+			k += match[codes[i]];
+		}
+	}
+	else
+	{
+		for (i = 0; i < n; i++)
+		{
+			int			r = sel[i];
+
+			sel[k] = r;
+			k += match[codes[r]];
+		}
+	}
+	return k;
+}
+
+/*
+ * Evaluate a comparison clause on a single non-NULL value.
+ */
+static bool
+BatchQualCompareOne(BatchQualClause *clause, Datum d)
+{
+	switch (clause->type)
+	{
+		case BQT_INT16:
+			return BATCH_CMP_ONE(DatumGetInt16(d), (int16) clause->constval.i, clause->op);
+		case BQT_INT32:
+			return BATCH_CMP_ONE(DatumGetInt32(d), (int32) clause->constval.i, clause->op);
+		case BQT_INT64:
+			return BATCH_CMP_ONE(DatumGetInt64(d), clause->constval.i, clause->op);
+		case BQT_FLOAT4:
+			return BATCH_CMP_ONE(DatumGetFloat4(d), (float4) clause->constval.f, clause->op);
+		case BQT_FLOAT8:
+			return BATCH_CMP_ONE(DatumGetFloat8(d), clause->constval.f, clause->op);
+		case BQT_TEXT:
+			return BatchTextEqualAny(clause, d);
+	}
+	return false;				/* keep compiler quiet */
+}
+
+static int
+BatchCountRuns(const uint32 *runs, int nrows)
+{
+	int			nruns = 1;
+	int			i;
+
+	for (i = 1; i < nrows; i++)
+		nruns += (runs[i] != runs[i - 1]);
+	return nruns;
+}
+
+/*
+ * Comparison kernel for a column made of runs: the clause is evaluated for
+ * the first selected row of each run, and the result reused for the rest of
+ * it. Rows of a run are consecutive, so the selected rows of one run are too.
+ */
+static int
+BatchCmpRuns(BatchQualClause *clause, const Datum *vals, const bool *nulls,
+			 const uint32 *runs, int *sel, int n, bool dense)
+{
+	uint32		run = 0;
+	bool		result = false;
+	int			i;
+	int			k = 0;
+
+	for (i = 0; i < n; i++)
+	{
+		int			r = dense ? i : sel[i];
+
+		if (i == 0 || runs[r] != run)
+		{
+			run = runs[r];
+			result = !nulls[r] && BatchQualCompareOne(clause, vals[r]);
+		}
+		sel[k] = r;
+		k += result;
+	}
+	return k;
+}
+
+/*
+ * Evaluate the clauses of a BatchQual over a batch of nrows rows.
+ *
+ * The value of column attno in the i'th row is values[attno * stride + i].
+ * If runs is not NULL, runs[attno * stride + i] holds a run id for it; two
+ * consecutive rows with the same run id must have the same value. If dicts
+ * is not NULL and dicts[attno].ncodes is not 0, the run ids of the column
+ * are codes of dicts[attno] instead. The numbers of the rows that pass all
+ * clauses are stored in sel, in ascending order, and their count is
+ * returned.
+ */
+int
+ExecBatchQual(BatchQual *bq, Datum *values, bool *isnull, uint32 *runs,
+			  BatchDict *dicts, int stride, int nrows, int *sel)
+{
+	int			n = nrows;
+	int			c;
+
+	for (c = 0; c < bq->nclauses && n > 0; c++)
+	{
+		BatchQualClause *clause = &bq->clauses[c];
+		Datum	   *vals = values + clause->attno * stride;
+		bool	   *nulls = isnull + clause->attno * stride;
+		bool		dense = (c == 0);
+
+		if (clause->op == BQ_ISNULL || clause->op == BQ_NOTNULL)
+		{
+			n = BatchNullTest(clause->op == BQ_ISNULL, nulls, sel, n, dense);
+			continue;
+		}
+
+		if (clause->type == BQT_TEXT && dicts != NULL &&
+			dicts[clause->attno].ncodes > 0)
+		{
+			Assert(runs != NULL);
+			n = BatchCmpDict(bq, clause, &dicts[clause->attno],
+							 runs + clause->attno * stride, sel, n, dense);
+			continue;
+		}
+
+		if (runs != NULL)
+		{
+			uint32	   *colruns = runs + clause->attno * stride;
+
+			if (BatchCountRuns(colruns, nrows) * BATCH_RUN_MIN_LENGTH <= nrows)
+			{
+				n = BatchCmpRuns(clause, vals, nulls, colruns, sel, n, dense);
+				continue;
+			}
+		}
+
+		switch (clause->type)
+		{
+			case BQT_INT16:
+				n = BatchCmpInt16(clause->op, vals, nulls,
+								  (int16) clause->constval.i, sel, n, dense);
+				break;
+			case BQT_INT32:
+				n = BatchCmpInt32(clause->op, vals, nulls,
+								  (int32) clause->constval.i, sel, n, dense);
+				break;
+			case BQT_INT64:
+				n = BatchCmpInt64(clause->op, vals, nulls,
+								  clause->constval.i, sel, n, dense);
+				break;
+			case BQT_FLOAT4:
+				n = BatchCmpFloat4(clause->op, vals, nulls,
+								   (float4) clause->constval.f, sel, n, dense);
+				break;
+			case BQT_FLOAT8:
+				n = BatchCmpFloat8(clause->op, vals, nulls,
+								   clause->constval.f, sel, n, dense);
+				break;
+			case BQT_TEXT:
+				n = BatchCmpText(clause, vals, nulls, sel, n, dense);
+				break;
+		}
+	}
+
+	return n;
+}
@@ -41,6 +41,7 @@
 #include "access/tupconvert.h"
 #include "catalog/pg_type.h"
 #include "cdb/cdbpartition.h"
+#include "cdb/cdbvars.h"
 #include "cdb/partitionselection.h"
 #include "commands/typecmds.h"
 #include "executor/execdebug.h"
@@ -118,6 +119,12 @@ static Datum ExecEvalFunc(FuncExprState *fcache, ExprContext *econtext,
 			 bool *isNull, ExprDoneCond *isDone);
 static Datum ExecEvalOper(FuncExprState *fcache, ExprContext *econtext,
 			 bool *isNull, ExprDoneCond *isDone);
+static void ExecInitFuncSpecialization(FuncExprState *fstate, List *args,
+						   PlanState *parent);
+static void ExecSpecializeFuncExpr(FuncExprState *fcache);
+static Datum ExecEvalSpecializedFunc(FuncExprState *fcache,
+						ExprContext *econtext,
+						bool *isNull, ExprDoneCond *isDone);
 static Datum ExecEvalDistinct(FuncExprState *fcache, ExprContext *econtext,
 				 bool *isNull, ExprDoneCond *isDone);
 static Datum ExecEvalScalarArrayOp(ScalarArrayOpExprState *sstate,
@@ -2447,6 +2454,7 @@ ExecEvalFunc(FuncExprState *fcache,
 {
 	/* This is called only the first time through */
 	FuncExpr   *func = (FuncExpr *) fcache->xprstate.expr;
+	Datum		result;
 
 	/* Initialize function lookup info */
 	init_fcache(func->funcid, fcache, econtext->ecxt_per_query_memory, true);
@@ -2454,7 +2462,14 @@ ExecEvalFunc(FuncExprState *fcache,
 	/* Go directly to ExecMakeFunctionResult on subsequent uses */
 	fcache->xprstate.evalfunc = (ExprStateEvalFunc) ExecMakeFunctionResult;
 
-	return ExecMakeFunctionResult(fcache, econtext, isNull, isDone);
+	result = ExecMakeFunctionResult(fcache, econtext, isNull, isDone);
+
+	/* If it turned out to be a plain call, take the shortcut from now on */
+	if (fcache->spec &&
+		fcache->xprstate.evalfunc == (ExprStateEvalFunc) ExecMakeFunctionResultNoSets)
+		ExecSpecializeFuncExpr(fcache);
+
+	return result;
 }
 
 /* ----------------------------------------------------------------
@@ -2469,6 +2484,7 @@ ExecEvalOper(FuncExprState *fcache,
 {
 	/* This is called only the first time through */
 	OpExpr	   *op = (OpExpr *) fcache->xprstate.expr;
+	Datum		result;
 
 	/* Initialize function lookup info */
 	init_fcache(op->opfuncid, fcache, econtext->ecxt_per_query_memory, true);
@@ -2476,7 +2492,14 @@ ExecEvalOper(FuncExprState *fcache,
 	/* Go directly to ExecMakeFunctionResult on subsequent uses */
 	fcache->xprstate.evalfunc = (ExprStateEvalFunc) ExecMakeFunctionResult;
 
-	return ExecMakeFunctionResult(fcache, econtext, isNull, isDone);
+	result = ExecMakeFunctionResult(fcache, econtext, isNull, isDone);
+
+	/* If it turned out to be a plain call, take the shortcut from now on */
+	if (fcache->spec &&
+		fcache->xprstate.evalfunc == (ExprStateEvalFunc) ExecMakeFunctionResultNoSets)
+		ExecSpecializeFuncExpr(fcache);
+
+	return result;
 }
 
 /* ----------------------------------------------------------------
@@ -2637,6 +2660,158 @@ static void FastPathStrict2Func(Oid funcoid, FuncExprState *fstate)
 	}
 }
 
+/*
+ * Specialized evaluation of function calls.
+ *
+ * A function or operator whose arguments are all plain columns of the input
+ * tuples or constants, like the "a < 10" or "a + b" that make up most scan
+ * quals and target lists, is evaluated with one call of the argument's
+ * evalfunc per argument, plus the call of ExecMakeFunctionResultNoSets and
+ * its argument loop. For such a call we instead prepare a FunctionCallInfo
+ * with the constant arguments already filled in, and fetch the columns from
+ * the slots directly.
+ *
+ * The decision is made in ExecInitExpr, for plans costing more than
+ * gp_expr_specialize_above_cost, but the switch happens only after the first
+ * call has gone through the general path. That call does the permission
+ * check and the type checks of the Vars, and tells whether the function
+ * returns a set.
+ */
+#define FUNC_SPEC_MAX_ARGS	4
+
+typedef struct FuncExprSpec
+{
+	EState	   *estate;			/* counts the calls that switch over */
+	int			nargs;
+	Index		varno[FUNC_SPEC_MAX_ARGS];		/* INNER, OUTER or scan tuple */
+	AttrNumber	attno[FUNC_SPEC_MAX_ARGS];		/* column, or 0 for a constant */
+	FunctionCallInfoData fcinfo;	/* constant arguments are preset */
+} FuncExprSpec;
+
+static void
+ExecInitFuncSpecialization(FuncExprState *fstate, List *args, PlanState *parent)
+{
+	FuncExprSpec *spec;
+	PlannedStmt *stmt;
+	ListCell   *lc;
+	int			nargs = list_length(args);
+	int			i;
+
+	if (parent == NULL || gp_expr_specialize_above_cost < 0)
+		return;
+	stmt = parent->state->es_plannedstmt;
+	if (stmt == NULL || stmt->planTree == NULL ||
+		stmt->planTree->total_cost < gp_expr_specialize_above_cost)
+		return;
+
+	if (nargs == 0 || nargs > FUNC_SPEC_MAX_ARGS)
+		return;
+
+	foreach(lc, args)
+	{
+		Node	   *arg = (Node *) lfirst(lc);
+
+		if (IsA(arg, Var))
+		{
+			if (((Var *) arg)->varattno <= 0)
+				return;
+		}
+		else if (!IsA(arg, Const) || ((Const *) arg)->constisnull)
+			return;
+	}
+
+	spec = (FuncExprSpec *) palloc0(sizeof(FuncExprSpec));
+	spec->estate = parent->state;
+	spec->nargs = nargs;
+	i = 0;
+	foreach(lc, args)
+	{
+		Node	   *arg = (Node *) lfirst(lc);
+
+		if (IsA(arg, Var))
+		{
+			spec->varno[i] = ((Var *) arg)->varno;
+			spec->attno[i] = ((Var *) arg)->varattno;
+		}
+		else
+		{
+			spec->attno[i] = 0;
+			spec->fcinfo.arg[i] = ((Const *) arg)->constvalue;
+			spec->fcinfo.argnull[i] = false;
+		}
+		i++;
+	}
+
+	fstate->spec = spec;
+}
+
+static void
+ExecSpecializeFuncExpr(FuncExprState *fcache)
+{
+	FuncExprSpec *spec = fcache->spec;
+
+	/* The shortcut doesn't keep function call statistics */
+	if (pgstat_track_functions > fcache->func.fn_stats)
+		return;
+
+	Assert(!fcache->func.fn_retset);
+	Assert(spec->nargs == list_length(fcache->args));
+
+	InitFunctionCallInfoData(spec->fcinfo, &(fcache->func), spec->nargs,
+							 NULL, NULL);
+	fcache->xprstate.evalfunc = (ExprStateEvalFunc) ExecEvalSpecializedFunc;
+	spec->estate->es_num_specialized_exprs++;
+}
+
+static Datum
+ExecEvalSpecializedFunc(FuncExprState *fcache,
+						ExprContext *econtext,
+						bool *isNull,
+						ExprDoneCond *isDone)
+{
+	FuncExprSpec *spec = fcache->spec;
+	FunctionCallInfo fcinfo = &spec->fcinfo;
+	Datum		result;
+	int			i;
+
+	if (isDone)
+		*isDone = ExprSingleResult;
+
+	for (i = 0; i < spec->nargs; i++)
+	{
+		TupleTableSlot *slot;
+
+		if (spec->attno[i] == 0)
+			continue;
+
+		switch (spec->varno[i])
+		{
+			case INNER:
+				slot = econtext->ecxt_innertuple;
+				break;
+			case OUTER:
+				slot = econtext->ecxt_outertuple;
+				break;
+			default:
+				slot = econtext->ecxt_scantuple;
+				break;
+		}
+
+		fcinfo->arg[i] = slot_getattr(slot, spec->attno[i], &fcinfo->argnull[i]);
+		if (fcinfo->argnull[i] && fcache->func.fn_strict)
+		{
+			*isNull = true;
+			return (Datum) 0;
+		}
+	}
+
+	fcinfo->isnull = false;
+	result = FunctionCallInvoke(fcinfo);
+	*isNull = fcinfo->isnull;
+
+	return result;
+}
+
 static Datum
 ExecEvalFPScalarArrayInt(ScalarArrayOpExprState *sstate,
 					  ExprContext *econtext,
@@ -5329,6 +5504,8 @@ ExecInitExpr(Expr *node, PlanState *parent)
 					ExecInitExpr((Expr *) funcexpr->args, parent);
 				fstate->func.fn_oid = InvalidOid;		/* not initialized */
 				FastPathStrict2Func(funcexpr->funcid, fstate);
+				if (fstate->xprstate.evalfunc == (ExprStateEvalFunc) ExecEvalFunc)
+					ExecInitFuncSpecialization(fstate, funcexpr->args, parent);
 				state = (ExprState *) fstate;
 				assign_func_result_transient_type(funcexpr->funcid);
 			}
@@ -5343,6 +5520,8 @@ ExecInitExpr(Expr *node, PlanState *parent)
 					ExecInitExpr((Expr *) opexpr->args, parent);
 				fstate->func.fn_oid = InvalidOid;		/* not initialized */
 				FastPathStrict2Func(opexpr->opfuncid, fstate);
+				if (fstate->xprstate.evalfunc == (ExprStateEvalFunc) ExecEvalOper)
+					ExecInitFuncSpecialization(fstate, opexpr->args, parent);
 				state = (ExprState *) fstate;
 			}
 			break;
@@ -17,6 +17,7 @@
 #include "postgres.h"
 
 #include "executor/executor.h"
+#include "executor/nodeHash.h"
 #include "miscadmin.h"
 #include "utils/memutils.h"
 
@@ -159,7 +160,7 @@ ExecScan(ScanState *node,
 	 * If we have neither a qual to check nor a projection to do, just skip
 	 * all the overhead and return the raw scan tuple.
 	 */
-	if (!qual && !projInfo)
+	if (!qual && !projInfo && !node->ss_runtimeFilter)
 		return ExecScanFetch(node, accessMtd, recheckMtd);
 
 	/*
@@ -210,7 +211,9 @@ ExecScan(ScanState *node,
 		 * when the qual is nil ... saves only a few cycles, but they add up
 		 * ...
 		 */
-		if (!qual || ExecQual(qual, econtext, false))
+		if ((!qual || ExecQual(qual, econtext, false)) &&
+			(!node->ss_runtimeFilter ||
+			 !ExecHashRuntimeFilterReject(node->ss_runtimeFilter, econtext)))
 		{
 			/*
 			 * Found a satisfactory scan tuple.
@@ -246,6 +246,8 @@ ExecWorkFile_Write(ExecWorkFile *workfile,
 
 			WorkfileDiskspace_Commit( (new_size - current_size), size, true /* update_query_size */);
 			workfile_set_update_in_progress_size(workfile->work_set, new_size - current_size);
+			workfile_set_update_bytes_written(workfile->work_set,
+					new_size - current_size, new_size - current_size);
 
 			if (bytes != size)
 			{
@@ -275,6 +277,8 @@ ExecWorkFile_Write(ExecWorkFile *workfile,
 				WorkfileDiskspace_Commit(size, size, true /* update_query_size */);
 			}
 			workfile_set_update_in_progress_size(workfile->work_set, size);
+			/* The compressed size is accounted for in ExecWorkFile_AdjustBFZSize */
+			workfile_set_update_bytes_written(workfile->work_set, size, 0);
 
 			break;
 		default:
@@ -556,6 +560,8 @@ ExecWorkFile_Seek(ExecWorkFile *workfile, uint64 offset, int whence)
 	{
 		WorkfileDiskspace_Commit(additional_size, additional_size, true /* update_query_size */);
 		workfile_set_update_in_progress_size(workfile->work_set, additional_size);
+		workfile_set_update_bytes_written(workfile->work_set,
+				additional_size, additional_size);
 	}
 
 	return result;
@@ -575,6 +581,29 @@ ExecWorkFile_Flush(ExecWorkFile *workfile)
 	}
 }
 
+/*
+ * Hint that [offset, offset + size) of the file is going to be read soon, so
+ * that the read can be started in the background.
+ *
+ * Only random-access BufFile workfiles support this; bfz files are read
+ * sequentially and do their own read-ahead.
+ */
+void
+ExecWorkFile_Prefetch(ExecWorkFile *workfile, int64 offset, int64 size)
+{
+	Assert(workfile != NULL);
+	switch(workfile->fileType)
+	{
+	case BUFFILE:
+		BufFilePrefetch((BufFile *) workfile->file, offset, size);
+		break;
+	case BFZ:
+		break;
+	default:
+		insist_log(false, "invalid work file type: %d", workfile->fileType);
+	}
+}
+
 /*
  * Suspend a file without closing it. For bfz, which allocates a buffer for
  * each open a file, this frees up that buffer but keeps the fd so we can
@@ -710,6 +739,8 @@ ExecWorkFile_AdjustBFZSize(ExecWorkFile *workfile, int64 file_size)
 	bfz_t *bfz_file = (bfz_t *) workfile->file;
 #endif
 
+	workfile_set_update_bytes_written(workfile->work_set, 0, file_size);
+
 	if (file_size <= workfile->size)
 	{
 		/*
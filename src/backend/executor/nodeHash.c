@@ -65,6 +65,67 @@ ExecHashTableExplainBatches(HashJoinTable   hashtable,
 /* Amount of metadata memory required per bucket */
 #define MD_MEM_PER_BUCKET (sizeof(HashJoinTuple) + sizeof(uint64))
 
+/* GUC: hand a Bloom filter of the inner join keys to the outer side scan */
+bool		gp_enable_runtime_filter = true;
+
+/*
+ * Sizing of the runtime join filter. Two bits are set for each inner tuple,
+ * so with at least 8 bits per tuple about 5% of the outer rows that have no
+ * match still get through. The filter is sized from the planner's estimate,
+ * and is not used if the actual inner side turns out to be too large for it.
+ */
+#define RUNTIME_FILTER_BITS_PER_TUPLE		16
+#define RUNTIME_FILTER_MIN_BITS_PER_TUPLE	8
+#define RUNTIME_FILTER_MIN_BITS				(1 << 16)
+#define RUNTIME_FILTER_MAX_BITS				(1 << 24)
+
+/*
+ * The filter is dropped if it rejects less than a tenth of the rows in a
+ * window of checked rows, because then the join's own hash lookups are about
+ * as cheap.  Every window is judged on its own, so a filter that only stops
+ * paying off late in the scan (e.g. on a table clustered by the join key) is
+ * dropped as well.
+ */
+#define RUNTIME_FILTER_WINDOW_ROWS			4096
+
+/*
+ * The filter lives as long as the join and is charged to the operator's
+ * memory; it may take at most this fraction of it.
+ */
+#define RUNTIME_FILTER_MAX_MEM_FRACTION		4
+
+static inline void
+ExecHashBloomBits(HashJoinTable hashtable, uint32 hashvalue,
+				  uint32 *bit1, uint32 *bit2)
+{
+	uint32		mixed = hashvalue * 0x9E3779B1;
+
+	*bit1 = hashvalue & hashtable->bloomMask;
+	*bit2 = ((mixed >> 16) | (mixed << 16)) & hashtable->bloomMask;
+}
+
+static inline void
+ExecHashBloomAdd(HashJoinTable hashtable, uint32 hashvalue)
+{
+	uint32		bit1;
+	uint32		bit2;
+
+	ExecHashBloomBits(hashtable, hashvalue, &bit1, &bit2);
+	hashtable->bloomBits[bit1 / 64] |= UINT64CONST(1) << (bit1 % 64);
+	hashtable->bloomBits[bit2 / 64] |= UINT64CONST(1) << (bit2 % 64);
+}
+
+static inline bool
+ExecHashBloomTest(HashJoinTable hashtable, uint32 hashvalue)
+{
+	uint32		bit1;
+	uint32		bit2;
+
+	ExecHashBloomBits(hashtable, hashvalue, &bit1, &bit2);
+	return (hashtable->bloomBits[bit1 / 64] & (UINT64CONST(1) << (bit1 % 64))) != 0 &&
+		(hashtable->bloomBits[bit2 / 64] & (UINT64CONST(1) << (bit2 % 64))) != 0;
+}
+
 /* ----------------------------------------------------------------
  *		ExecHash
  *
@@ -131,6 +192,9 @@ MultiExecHash(HashState *node)
 		{
 			int			bucketNumber;
 
+			if (hashtable->bloomBits != NULL)
+				ExecHashBloomAdd(hashtable, hashvalue);
+
 			bucketNumber = ExecHashGetSkewBucket(hashtable, hashvalue);
 			if (bucketNumber != INVALID_SKEW_BUCKET_NO)
 			{
@@ -405,6 +469,32 @@ ExecHashTableCreate(HashState *hashState, HashJoinState *hjstate, List *hashOper
 		PrepareTempTablespaces();
 	}
 
+	/* Bloom filter for the runtime join filter, covering all batches */
+	if (hjstate->hj_RuntimeFilter != NULL)
+	{
+		double		wantbits = outerNode->plan_rows * RUNTIME_FILTER_BITS_PER_TUPLE;
+		uint32		nbits = RUNTIME_FILTER_MIN_BITS;
+
+		uint64		maxbytes = hashtable->spaceAllowed / RUNTIME_FILTER_MAX_MEM_FRACTION;
+
+		while (nbits < wantbits && nbits < RUNTIME_FILTER_MAX_BITS &&
+			   (nbits << 1) / 8 <= maxbytes)
+			nbits <<= 1;
+
+		/*
+		 * The bits are not part of any batch, so take them out of the space
+		 * the hash table may use for tuples.
+		 */
+		if (nbits / 8 <= maxbytes)
+		{
+			hashtable->bloomBits = (uint64 *) palloc0(nbits / 8);
+			hashtable->bloomMask = nbits - 1;
+			hashtable->spaceAllowed -= nbits / 8;
+			hashtable->spaceAllowedSkew =
+				hashtable->spaceAllowed * SKEW_WORK_MEM_PERCENT / 100;
+		}
+	}
+
 	/*
 	 * Prepare context for the first-scan space allocations; allocate the
 	 * hashbucket array therein, and set each bucket "empty".
@@ -677,6 +767,18 @@ ExecHashTableDestroy(HashState *hashState, HashJoinTable hashtable)
 		hashtable->work_set = NULL;
 	}
 
+	/* The outer side scan must stop using the Bloom filter before it goes */
+	if (hashtable->hjstate != NULL &&
+		hashtable->hjstate->hj_RuntimeFilter != NULL &&
+		hashtable->hjstate->hj_RuntimeFilter->hashtable == hashtable)
+	{
+		RuntimeFilterState *filter = hashtable->hjstate->hj_RuntimeFilter;
+
+		filter->scan->ss_runtimeFilter = NULL;
+		filter->hashtable = NULL;
+	}
+	hashtable->bloomBits = NULL;
+
 	/* Release working memory (batchCxt is a child, so it goes away too) */
 	MemoryContextDelete(hashtable->hashCxt);
 	}
@@ -1049,6 +1151,108 @@ ExecHashGetHashValue(HashState *hashState, HashJoinTable hashtable,
 	return result;
 }
 
+/*
+ * ExecHashPublishRuntimeFilter
+ *		Hand the Bloom filter built along with the hash table to the scan on
+ *		the outer side of the join, once the hash table is complete.
+ */
+void
+ExecHashPublishRuntimeFilter(HashJoinTable hashtable, RuntimeFilterState *filter)
+{
+	uint64		nbits;
+
+	if (hashtable->bloomBits == NULL)
+		return;
+
+	nbits = (uint64) hashtable->bloomMask + 1;
+	if (hashtable->totalTuples * RUNTIME_FILTER_MIN_BITS_PER_TUPLE > nbits)
+	{
+		elog(DEBUG1, "runtime join filter not used, " UINT64_FORMAT
+			 " inner tuples are too many for " UINT64_FORMAT " bits",
+			 hashtable->totalTuples, nbits);
+		return;
+	}
+
+	filter->hashtable = hashtable;
+	filter->scan->ss_runtimeFilter = filter;
+}
+
+/*
+ * ExecHashRuntimeFilterReject
+ *		Check the tuple in econtext->ecxt_scantuple against a runtime join
+ *		filter.
+ *
+ * Returns true if the tuple's join keys cannot match any inner tuple, in
+ * which case the scan can drop it. The hash value is computed the same way
+ * as ExecHashGetHashValue() does for outer tuples, except that the caller's
+ * per-tuple memory is not reset, since the scan tuple may live there.
+ */
+bool
+ExecHashRuntimeFilterReject(RuntimeFilterState *filter, ExprContext *econtext)
+{
+	HashJoinTable hashtable = filter->hashtable;
+	uint32		hashkey = 0;
+	ListCell   *hk;
+	int			i = 0;
+	bool		reject = false;
+	MemoryContext oldContext;
+
+	Assert(hashtable != NULL && hashtable->bloomBits != NULL);
+
+	oldContext = MemoryContextSwitchTo(econtext->ecxt_per_tuple_memory);
+
+	foreach(hk, filter->hashkeys)
+	{
+		ExprState  *keyexpr = (ExprState *) lfirst(hk);
+		Datum		keyval;
+		bool		isNull = false;
+
+		/* rotate hashkey left 1 bit at each step */
+		hashkey = (hashkey << 1) | ((hashkey & 0x80000000) ? 1 : 0);
+
+		keyval = ExecEvalExpr(keyexpr, econtext, &isNull, NULL);
+
+		if (isNull)
+		{
+			/* strict join operators never match nulls */
+			if (hashtable->hashStrict[i] && !filter->keep_nulls)
+			{
+				reject = true;
+				break;
+			}
+		}
+		else
+			hashkey ^= DatumGetUInt32(FunctionCall1(&hashtable->outer_hashfunctions[i],
+													keyval));
+		i++;
+	}
+
+	MemoryContextSwitchTo(oldContext);
+
+	if (!reject)
+		reject = !ExecHashBloomTest(hashtable, hashkey);
+
+	filter->nchecked++;
+	if (reject)
+		filter->nrejected++;
+
+	if (filter->nchecked % RUNTIME_FILTER_WINDOW_ROWS == 0)
+	{
+		int64		nwindowrejected = filter->nrejected - filter->nrejected_window;
+
+		if (nwindowrejected < RUNTIME_FILTER_WINDOW_ROWS / 10)
+		{
+			elog(DEBUG1, "runtime join filter dropped, it rejected only "
+				 INT64_FORMAT " of the last %d rows",
+				 nwindowrejected, RUNTIME_FILTER_WINDOW_ROWS);
+			filter->scan->ss_runtimeFilter = NULL;
+		}
+		filter->nrejected_window = filter->nrejected;
+	}
+
+	return reject;
+}
+
 /*
  * ExecHashGetBucketAndBatch
  *		Determine the bucket number and batch number for a hash value
@@ -1354,6 +1558,14 @@ ExecHashTableExplainEnd(PlanState *planstate, struct StringInfoData *buf)
                              hashtable->nbatch - stats->nonemptybatches);
         appendStringInfoChar(buf, '\n');
     }
+
+    /* Report how many outer rows the runtime join filter dropped. */
+    if (hjstate->hj_RuntimeFilter && hjstate->hj_RuntimeFilter->nchecked > 0)
+        appendStringInfo(buf,
+                         "Runtime filter removed " INT64_FORMAT
+                         " of " INT64_FORMAT " outer rows.\n",
+                         hjstate->hj_RuntimeFilter->nrejected,
+                         hjstate->hj_RuntimeFilter->nchecked);
 }                               /* ExecHashTableExplainEnd */
 
 
@@ -22,6 +22,9 @@
 #include "executor/instrument.h"	/* Instrumentation */
 #include "executor/nodeHash.h"
 #include "executor/nodeHashjoin.h"
+#include "nodes/nodeFuncs.h"
+#include "optimizer/clauses.h"
+#include "parser/parsetree.h"
 #include "utils/faultinjector.h"
 #include "utils/memutils.h"
 
@@ -45,6 +48,7 @@ static void ReleaseHashTable(HashJoinState *node);
 
 static void SpillCurrentBatch(HashJoinState *node);
 static bool ExecHashJoinReloadHashTable(HashJoinState *hjstate);
+static RuntimeFilterState *ExecHashJoinInitRuntimeFilter(HashJoinState *hjstate);
 
 /* ----------------------------------------------------------------
  *		ExecHashJoin
@@ -247,6 +251,12 @@ ExecHashJoin(HashJoinState *node)
 			return NULL;
 		}
 
+		/*
+		 * Let the outer side scan drop rows that cannot find a match.
+		 */
+		if (node->hj_RuntimeFilter != NULL)
+			ExecHashPublishRuntimeFilter(hashtable, node->hj_RuntimeFilter);
+
 		/*
 		 * Reset OuterNotEmpty for scan.  (It's OK if we fetched a tuple
 		 * above, because ExecHashJoinOuterGetTuple will immediately set it
@@ -630,9 +640,89 @@ ExecInitHashJoin(HashJoin *node, EState *estate, int eflags)
 	hjstate->hj_MatchedOuter = false;
 	hjstate->hj_OuterNotEmpty = false;
 
+	hjstate->hj_RuntimeFilter = ExecHashJoinInitRuntimeFilter(hjstate);
+
 	return hjstate;
 }
 
+/*
+ * Replace the references to the outer plan's output in a hash key with the
+ * outer plan's target list expressions.
+ */
+static Node *
+runtime_filter_key_mutator(Node *node, List *outer_tlist)
+{
+	if (node == NULL)
+		return NULL;
+
+	if (IsA(node, Var) && ((Var *) node)->varno == OUTER)
+	{
+		Var		   *var = (Var *) node;
+		TargetEntry *tle = get_tle_by_resno(outer_tlist, var->varattno);
+
+		if (tle == NULL)
+			elog(ERROR, "hash key refers to nonexistent outer column %d",
+				 var->varattno);
+		return (Node *) copyObject(tle->expr);
+	}
+
+	return expression_tree_mutator(node, runtime_filter_key_mutator,
+								   (void *) outer_tlist);
+}
+
+/*
+ * ExecHashJoinInitRuntimeFilter
+ *		Set up a runtime join filter, if the outer side of the join is a
+ *		plain table scan that can use one.
+ *
+ * The filter is checked by the scan before it projects a row, so the outer
+ * hash keys are rewritten to refer to the scan tuple. Only joins that drop
+ * outer rows without a match can use a filter. Dynamic table scans are not
+ * supported, because attribute numbers differ between partitions.
+ */
+static RuntimeFilterState *
+ExecHashJoinInitRuntimeFilter(HashJoinState *hjstate)
+{
+	PlanState  *outerState = outerPlanState(hjstate);
+	List	   *outer_tlist = outerState->plan->targetlist;
+	RuntimeFilterState *filter;
+	ListCell   *lc;
+
+	if (!gp_enable_runtime_filter)
+		return NULL;
+
+	if (hjstate->js.jointype != JOIN_INNER &&
+		hjstate->js.jointype != JOIN_SEMI)
+		return NULL;
+
+	if (!IsA(outerState, SeqScanState) &&
+		!IsA(outerState, TableScanState) &&
+		!IsA(outerState, AppendOnlyScanState) &&
+		!IsA(outerState, AOCSScanState))
+		return NULL;
+
+	/* The rewritten keys must be safe to evaluate twice. */
+	if (contain_volatile_functions((Node *) outer_tlist) ||
+		contain_subplans((Node *) outer_tlist))
+		return NULL;
+
+	filter = (RuntimeFilterState *) palloc0(sizeof(RuntimeFilterState));
+	foreach(lc, hjstate->hj_OuterHashKeys)
+	{
+		ExprState  *keystate = (ExprState *) lfirst(lc);
+		Expr	   *key;
+
+		key = (Expr *) runtime_filter_key_mutator((Node *) keystate->expr,
+												  outer_tlist);
+		filter->hashkeys = lappend(filter->hashkeys,
+								   ExecInitExpr(key, outerState));
+	}
+	filter->keep_nulls = hjstate->hj_nonequijoin;
+	filter->scan = (ScanState *) outerState;
+
+	return filter;
+}
+
 /* ----------------------------------------------------------------
  *		ExecEndHashJoin
  *
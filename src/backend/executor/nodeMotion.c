@@ -352,6 +352,7 @@ execMotionUnsortedReceiver(MotionState * node)
 	GenericTuple tuple;
 	Motion	   *motion = (Motion *) node->ps.plan;
 	ReceiveReturnCode recvRC;
+	bool		shouldFree;
 
 	AssertState(motion->motionType == MOTIONTYPE_HASH ||
 			(motion->motionType == MOTIONTYPE_EXPLICIT && motion->segidColIdx > 0) || 
@@ -370,7 +371,7 @@ execMotionUnsortedReceiver(MotionState * node)
 
 	recvRC = RecvTupleFrom(node->ps.state->motionlayer_context,
 						   node->ps.state->interconnect_context,
-						   motion->motionID, &tuple, ANY_ROUTE);
+						   motion->motionID, &tuple, &shouldFree, ANY_ROUTE);
 
 	if (recvRC == END_OF_STREAM)
 	{
@@ -389,7 +390,7 @@ execMotionUnsortedReceiver(MotionState * node)
 
     /* store it in our result slot and return this. */
     slot = node->ps.ps_ResultTupleSlot;
-    slot = ExecStoreGenericTuple(tuple, slot, true /* shouldFree */);
+    slot = ExecStoreGenericTuple(tuple, slot, shouldFree);
 
 #ifdef CDB_MOTION_DEBUG
     if (node->numTuplesToParent <= 20)
@@ -445,7 +446,7 @@ execMotionUnsortedReceiver(MotionState * node)
  *
  */
 
-/* Sorted receiver using mk heap */
+/* Sorted receiver using mk loser tree */
 typedef struct MotionMKHeapReaderContext
 {
     MotionState *node;
@@ -455,7 +456,7 @@ typedef struct MotionMKHeapReaderContext
 typedef struct MotionMKHeapContext
 {
     MKHeapReader *readers;      /* Readers, one per sender */
-    MKHeap *heap;               /* The mkheap */
+    MKLoserTree *tree;          /* Loser tree merging the readers */
     MKContext mkctxt;           /* compare context */
 } MotionMKHeapContext;
     
@@ -468,6 +469,7 @@ static bool motion_mkhp_read(void *vpctxt, MKEntry *a)
 	Motion *motion = (Motion *) node->ps.plan;
 
     ReceiveReturnCode recvRC;
+    bool        shouldFree;
     if ( ctxt->srcRoute < 0 )
     {
     	/* routes have not been set yet so set them */
@@ -501,6 +503,7 @@ static bool motion_mkhp_read(void *vpctxt, MKEntry *a)
 							   node->ps.state->interconnect_context,
 							   motion->motionID, 
 							   &inputTuple,
+							   &shouldFree,
 							   ctxt->srcRoute);
 
     if (recvRC == GOT_TUPLE)
@@ -595,14 +598,12 @@ execMotionSortedReceiver_mk(MotionState * node)
     if (!node->tupleheapReady)
     {
         Assert(ctxt->readers); 
-        Assert(!ctxt->heap);
-        ctxt->heap = mkheap_from_reader(ctxt->readers, node->numInputSegs, &ctxt->mkctxt);
+        Assert(!ctxt->tree);
+        ctxt->tree = mkloser_from_reader(ctxt->readers, node->numInputSegs, &ctxt->mkctxt);
         node->tupleheapReady = true;
     }
 
-    mke_set_empty(&e);
-    mkheap_putAndGet(ctxt->heap, &e);
-    if (mke_is_empty(&e))
+    if (!mkloser_get(ctxt->tree, &e))
         return NULL;
 
     slot = node->ps.ps_ResultTupleSlot;
@@ -620,6 +621,7 @@ execMotionSortedReceiver(MotionState * node)
 				inputTuple;
 	Motion	   *motion = (Motion *) node->ps.plan;
 	ReceiveReturnCode recvRC;
+	bool		shouldFree;
 	CdbTupleHeapInfo *tupHeapInfo;
 
 	AssertState(motion->motionType == MOTIONTYPE_FIXED &&
@@ -663,6 +665,7 @@ execMotionSortedReceiver(MotionState * node)
 							   node->ps.state->interconnect_context,
 							   motion->motionID, 
 							   &inputTuple,
+							   &shouldFree,
 							   node->routeIdNext);
 
         /* Substitute it in the pq for its predecessor. */
@@ -765,6 +768,7 @@ execMotionSortedReceiverFirstTime(MotionState * node)
     ListCell *lcProcess;
 
 	ReceiveReturnCode recvRC;
+	bool		shouldFree;
 
 	Slice *sendSlice = (Slice *)list_nth(node->ps.state->es_sliceTable->slices, motion->motionID);
 	Assert(sendSlice->sliceIndex == motion->motionID);
@@ -783,7 +787,7 @@ execMotionSortedReceiverFirstTime(MotionState * node)
 		 */
 		recvRC = RecvTupleFrom(node->ps.state->motionlayer_context,
 							   node->ps.state->interconnect_context,
-							   motion->motionID, &inputTuple, iSegIdx);
+							   motion->motionID, &inputTuple, &shouldFree, iSegIdx);
 
 		if (recvRC == GOT_TUPLE)
 		{
@@ -983,7 +987,7 @@ ExecInitMotion(Motion * node, EState *estate, int eflags)
 		/*
 		 * Create hash API reference
 		 */
-		motionstate->cdbhash = makeCdbHash(node->numOutputSegs);
+		motionstate->cdbhash = makeCdbHash(node->numOutputSegs, node->hashReduce);
     }
 
 	/* Merge Receive: Set up the key comparator and priority queue. */
@@ -265,7 +265,7 @@ static bool TupleMatchesHashFilter(Result *resultNode, TupleTableSlot *resultSlo
 		Assert(resultNode->hashFilter);
 		ListCell	*cell = NULL;
 
-		CdbHash *hash = makeCdbHash(GpIdentity.numsegments);
+		CdbHash *hash = makeCdbHash(GpIdentity.numsegments, resultNode->hashReduce);
 		cdbhashinit(hash);
 		foreach(cell, resultNode->hashList)
 		{
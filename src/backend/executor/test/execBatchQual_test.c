@@ -0,0 +1,270 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include "cmockery.h"
+
+#include "../execBatchQual.c"
+#include "utils/memutils.h"
+
+#define NROWS 8
+
+/*
+ * Two columns of NROWS rows, stored column after column as the AOCS scan
+ * does: an int4 column with a NULL in row 3, and a float8 column with a NaN
+ * in row 5.
+ */
+static void
+fill_batch(Datum *values, bool *isnull)
+{
+	int			i;
+
+	for (i = 0; i < NROWS; i++)
+	{
+		values[i] = Int32GetDatum(i * 10);
+		isnull[i] = (i == 3);
+		values[NROWS + i] = Float8GetDatum(i == 5 ? NAN : (double) i);
+		isnull[NROWS + i] = false;
+	}
+}
+
+static BatchQual *
+make_batch_qual(int nclauses)
+{
+	BatchQual  *bq = palloc(sizeof(BatchQual));
+
+	bq->nclauses = nclauses;
+	bq->clauses = palloc0(sizeof(BatchQualClause) * nclauses);
+	bq->mcxt = CurrentMemoryContext;
+
+	return bq;
+}
+
+/* ==================== ExecBatchQual ==================== */
+/*
+ * Tests that the clauses are ANDed together and that NULLs don't qualify.
+ */
+void
+test__ExecBatchQual__IntRange(void **state)
+{
+	Datum		values[2 * NROWS];
+	bool		isnull[2 * NROWS];
+	int			sel[NROWS];
+	BatchQual  *bq = make_batch_qual(2);
+	int			n;
+
+	fill_batch(values, isnull);
+
+	/* col0 >= 20 AND col0 <> 50 */
+	bq->clauses[0].attno = 0;
+	bq->clauses[0].op = BQ_GE;
+	bq->clauses[0].type = BQT_INT32;
+	bq->clauses[0].constval.i = 20;
+	bq->clauses[1].attno = 0;
+	bq->clauses[1].op = BQ_NE;
+	bq->clauses[1].type = BQT_INT32;
+	bq->clauses[1].constval.i = 50;
+
+	n = ExecBatchQual(bq, values, isnull, NULL, NULL, NROWS, NROWS, sel);
+
+	assert_int_equal(n, 4);
+	assert_int_equal(sel[0], 2);
+	assert_int_equal(sel[1], 4);
+	assert_int_equal(sel[2], 6);
+	assert_int_equal(sel[3], 7);
+}
+
+/*
+ * Tests that NaN sorts above all other float values.
+ */
+void
+test__ExecBatchQual__FloatNaN(void **state)
+{
+	Datum		values[2 * NROWS];
+	bool		isnull[2 * NROWS];
+	int			sel[NROWS];
+	BatchQual  *bq = make_batch_qual(1);
+	int			n;
+
+	fill_batch(values, isnull);
+
+	bq->clauses[0].attno = 1;
+	bq->clauses[0].type = BQT_FLOAT8;
+	bq->clauses[0].constval.f = 5.5;
+
+	bq->clauses[0].op = BQ_GT;
+	n = ExecBatchQual(bq, values, isnull, NULL, NULL, NROWS, NROWS, sel);
+	assert_int_equal(n, 3);
+	assert_int_equal(sel[0], 5);
+	assert_int_equal(sel[1], 6);
+	assert_int_equal(sel[2], 7);
+
+	bq->clauses[0].op = BQ_LT;
+	n = ExecBatchQual(bq, values, isnull, NULL, NULL, NROWS, NROWS, sel);
+	assert_int_equal(n, 5);
+	assert_int_equal(sel[4], 4);
+}
+
+/*
+ * Tests null tests, and that a later clause only looks at the rows still
+ * selected.
+ */
+void
+test__ExecBatchQual__NullTest(void **state)
+{
+	Datum		values[2 * NROWS];
+	bool		isnull[2 * NROWS];
+	int			sel[NROWS];
+	BatchQual  *bq = make_batch_qual(2);
+	int			n;
+
+	fill_batch(values, isnull);
+
+	bq->clauses[0].attno = 0;
+	bq->clauses[0].op = BQ_NOTNULL;
+	bq->clauses[1].attno = 1;
+	bq->clauses[1].op = BQ_LE;
+	bq->clauses[1].type = BQT_FLOAT8;
+	bq->clauses[1].constval.f = 4.0;
+
+	n = ExecBatchQual(bq, values, isnull, NULL, NULL, NROWS, NROWS, sel);
+	assert_int_equal(n, 4);
+	assert_int_equal(sel[0], 0);
+	assert_int_equal(sel[1], 1);
+	assert_int_equal(sel[2], 2);
+	assert_int_equal(sel[3], 4);
+
+	bq->clauses[0].op = BQ_ISNULL;
+	n = ExecBatchQual(bq, values, isnull, NULL, NULL, NROWS, NROWS, sel);
+	assert_int_equal(n, 1);
+	assert_int_equal(sel[0], 3);
+}
+
+/*
+ * Tests that the per run evaluation gives the same rows as the per row one,
+ * for a column of runs of varying length with a NULL in between.
+ */
+void
+test__ExecBatchQual__Runs(void **state)
+{
+#define NRUNROWS 64
+	Datum		values[NRUNROWS];
+	bool		isnull[NRUNROWS];
+	uint32		runs[NRUNROWS];
+	int			sel[NRUNROWS];
+	int			expected[NRUNROWS];
+	BatchQual  *bq = make_batch_qual(2);
+	uint32		run = 7;
+	int			i;
+	int			n;
+	int			nexpected;
+
+	for (i = 0; i < NRUNROWS; i++)
+	{
+		/* runs of 1, 2, ..., 10 rows, of the values 8, 9, 10, ... */
+		if (i == 0 || i == 1 || i == 3 || i == 6 || i == 10 || i == 15 ||
+			i == 21 || i == 28 || i == 36 || i == 45 || i == 55)
+			run++;
+		values[i] = Int32GetDatum(run);
+		isnull[i] = false;
+		runs[i] = run;
+	}
+	isnull[30] = true;
+	runs[30] = ++run;
+	runs[31] = ++run;
+
+	/* col0 >= 10 AND col0 <> 14 */
+	bq->clauses[0].attno = 0;
+	bq->clauses[0].op = BQ_GE;
+	bq->clauses[0].type = BQT_INT32;
+	bq->clauses[0].constval.i = 10;
+	bq->clauses[1].attno = 0;
+	bq->clauses[1].op = BQ_NE;
+	bq->clauses[1].type = BQT_INT32;
+	bq->clauses[1].constval.i = 14;
+
+	nexpected = ExecBatchQual(bq, values, isnull, NULL, NULL, NRUNROWS, NRUNROWS, expected);
+	n = ExecBatchQual(bq, values, isnull, runs, NULL, NRUNROWS, NRUNROWS, sel);
+
+	assert_true(BatchCountRuns(runs, NRUNROWS) * BATCH_RUN_MIN_LENGTH <= NRUNROWS);
+	assert_int_equal(n, nexpected);
+	for (i = 0; i < n; i++)
+		assert_int_equal(sel[i], expected[i]);
+	assert_int_equal(sel[0], 3);
+}
+
+/*
+ * Tests a text IN list on a dictionary encoded column, against the same
+ * column with its values in place, and that the clause follows a change of
+ * dictionary.
+ */
+void
+test__ExecBatchQual__TextDict(void **state)
+{
+	Datum		entries[] = {CStringGetTextDatum("red"), CStringGetTextDatum("green"),
+		CStringGetTextDatum("blue"), CStringGetTextDatum("")};
+	int			codes[NROWS] = {0, 1, 2, 3, 4, 2, 1, 0};
+	Datum		values[NROWS];
+	bool		isnull[NROWS];
+	uint32		runs[NROWS];
+	int			sel[NROWS];
+	int			expected[NROWS];
+	BatchDict	dict;
+	BatchQual  *bq = make_batch_qual(1);
+	text	   *consts[2];
+	int			i;
+	int			n;
+	int			nexpected;
+
+	for (i = 0; i < NROWS; i++)
+	{
+		/* code 4, one past the last entry, is NULL */
+		isnull[i] = (codes[i] == 4);
+		values[i] = isnull[i] ? (Datum) 0 : entries[codes[i]];
+		runs[i] = codes[i];
+	}
+	dict.ncodes = 4;
+	dict.entries = entries;
+	dict.generation = 1;
+
+	/* col0 IN ('blue', 'red') */
+	consts[0] = cstring_to_text("blue");
+	consts[1] = cstring_to_text("red");
+	bq->clauses[0].attno = 0;
+	bq->clauses[0].op = BQ_EQ;
+	bq->clauses[0].type = BQT_TEXT;
+	bq->clauses[0].nconsts = 2;
+	bq->clauses[0].consts = consts;
+
+	nexpected = ExecBatchQual(bq, values, isnull, NULL, NULL, NROWS, NROWS, expected);
+	n = ExecBatchQual(bq, values, isnull, runs, &dict, NROWS, NROWS, sel);
+	assert_int_equal(nexpected, 4);
+	assert_int_equal(n, nexpected);
+	for (i = 0; i < n; i++)
+		assert_int_equal(sel[i], expected[i]);
+
+	/* a new dictionary, in which code 1 is "blue" */
+	entries[1] = CStringGetTextDatum("blue");
+	dict.generation = 2;
+	n = ExecBatchQual(bq, values, isnull, runs, &dict, NROWS, NROWS, sel);
+	assert_int_equal(n, 6);
+	assert_int_equal(sel[1], 1);
+	assert_int_equal(sel[5], 7);
+}
+
+int
+main(int argc, char* argv[])
+{
+	cmockery_parse_arguments(argc, argv);
+
+	const UnitTest tests[] = {
+		unit_test(test__ExecBatchQual__IntRange),
+		unit_test(test__ExecBatchQual__FloatNaN),
+		unit_test(test__ExecBatchQual__NullTest),
+		unit_test(test__ExecBatchQual__Runs),
+		unit_test(test__ExecBatchQual__TextDict)
+	};
+
+	MemoryContextInit();
+
+	return run_tests(tests);
+}
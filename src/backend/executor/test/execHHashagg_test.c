@@ -172,8 +172,7 @@ test__destroy_agg_hash_table__check_for_leaks(void **state)
 #define NUM_SPILL_FILES 3
 #define NUM_BUCKETS 1024
 
-	ht->buckets = MemoryContextAllocZero(testContext, sizeof(HashAggEntry) * NUM_BUCKETS);
-	ht->bloom = MemoryContextAllocZero(testContext, NUM_BUCKETS / (sizeof(uint64) * 8 /* bits */));
+	ht->buckets = MemoryContextAllocZero(testContext, sizeof(HashAggBucket) * NUM_BUCKETS);
 
 	SpillSet *spill_set = createSpillSet(NUM_SPILL_FILES, 0 /* parent_hash_bit */);
 	ht->spill_set = spill_set;
@@ -2985,7 +2985,9 @@ gpdb::UlLeafPartitions
  * individual entries ATM, so we just blow the whole cache whenever anything
  * changes. The callback simply increments a counter. Whenever we start
  * planning a query, we check the counter to see if it has changed since the
- * last planned query, and reset the whole cache if it has.
+ * last planned query, and reset the whole cache if it has. The reset cache
+ * is refilled from the metadata cache shared across backends (see
+ * utils/cache/mdsharedcache.c), which does evict individual relations.
  *
  * To make sure we've covered all catalog tables that contain information
  * that's stored in the metadata cache, there are "catalog tables: xxx"
@@ -3002,12 +3004,18 @@ static void
 mdsyscache_invalidation_counter_callback(Datum arg, int cacheid,  ItemPointer tuplePtr)
 {
 	mdcache_invalidation_counter++;
+
+	/* the plans in the plan cache depend on the same catalogs */
+	OptPlanCacheReset();
 }
 
 static void
 mdrelcache_invalidation_counter_callback(Datum arg, Oid relid)
 {
 	mdcache_invalidation_counter++;
+
+	/* only the cached plans that use the relation are affected */
+	OptPlanCacheInvalidateRelation(relid);
 }
 
 static void
@@ -3105,6 +3113,138 @@ gpdb::FMDCacheNeedsReset
 	return true;
 }
 
+bool
+gpdb::FMDSharedCacheUsable
+	(
+	void
+	)
+{
+	GP_WRAP_START;
+	{
+		return MDSharedCacheIsUsable();
+	}
+	GP_WRAP_END;
+
+	return false;
+}
+
+char *
+gpdb::SzMDSharedCacheLookup
+	(
+	const char *szMdid,
+	Size *pulLen,
+	uint64 *pullGeneration
+	)
+{
+	GP_WRAP_START;
+	{
+		return MDSharedCacheLookup(szMdid, pulLen, pullGeneration);
+	}
+	GP_WRAP_END;
+
+	return NULL;
+}
+
+void
+gpdb::MDSharedCacheInsert
+	(
+	const char *szMdid,
+	Oid oidRel,
+	bool fStats,
+	uint64 ullGeneration,
+	const char *pcData,
+	Size ulLen
+	)
+{
+	GP_WRAP_START;
+	{
+		::MDSharedCacheInsert(szMdid, oidRel, fStats, ullGeneration, pcData, ulLen);
+		return;
+	}
+	GP_WRAP_END;
+}
+
+char *
+gpdb::SzOptPlanCacheKey
+	(
+	Query *pquery,
+	int iSegments,
+	List **pplLiterals
+	)
+{
+	GP_WRAP_START;
+	{
+		return OptPlanCacheMakeKey(pquery, iSegments, pplLiterals);
+	}
+	GP_WRAP_END;
+
+	return NULL;
+}
+
+const char *
+gpdb::SzOptPlanCacheLookup
+	(
+	const char *szKey,
+	List **pplLiterals
+	)
+{
+	GP_WRAP_START;
+	{
+		return OptPlanCacheLookup(szKey, pplLiterals);
+	}
+	GP_WRAP_END;
+
+	return NULL;
+}
+
+bool
+gpdb::FOptPlanCacheBindLiterals
+	(
+	PlannedStmt *pplstmt,
+	List *plPlanLiterals,
+	List *plQueryLiterals
+	)
+{
+	GP_WRAP_START;
+	{
+		return OptPlanCacheBindLiterals(pplstmt, plPlanLiterals, plQueryLiterals);
+	}
+	GP_WRAP_END;
+
+	return false;
+}
+
+void
+gpdb::OptPlanCacheInsert
+	(
+	const char *szKey,
+	const char *szPlan,
+	List *plLiterals,
+	List *plRelids
+	)
+{
+	GP_WRAP_START;
+	{
+		::OptPlanCacheInsert(szKey, szPlan, plLiterals, plRelids);
+		return;
+	}
+	GP_WRAP_END;
+}
+
+void
+gpdb::OptPlanCacheReset
+	(
+	void
+	)
+{
+	GP_WRAP_START;
+	{
+		::OptPlanCacheReset();
+		return;
+	}
+	GP_WRAP_END;
+}
+
 // Functions for ORCA's memory consumption to be tracked by GPDB
 void *
 gpdb::OptimizerAlloc
@@ -17,9 +17,13 @@
 #include "postgres.h"
 #include "gpopt/relcache/CMDProviderRelcache.h"
 #include "gpopt/translate/CTranslatorRelcacheToDXL.h"
+#include "gpopt/translate/CTranslatorUtils.h"
+#include "gpopt/gpdbwrappers.h"
 #include "gpopt/mdcache/CMDAccessor.h"
 
 #include "naucrates/dxl/CDXLUtils.h"
+#include "naucrates/md/CMDIdColStats.h"
+#include "naucrates/md/CMDIdGPDB.h"
 
 #include "naucrates/exception.h"
 
@@ -47,14 +51,85 @@ CMDProviderRelcache::CMDProviderRelcache
 
 //---------------------------------------------------------------------------
 //	@function:
-//		CMDProviderRelcache::PstrObject
+//		CMDProviderRelcache::FSharedCacheable
 //
 //	@doc:
-//		Returns the DXL of the requested object in the provided memory pool
+//		Can the given object be kept in the metadata cache shared across
+//		backends? If so, also return the relation the object is derived from,
+//		if any, so that it is evicted together with that relation, and whether
+//		it holds column statistics. Relation statistics are estimated from the
+//		current size of the relation, which does not cause an invalidation
+//		when it changes, so they are never shared. Neither are multi-level
+//		partitioned tables, since whether they can be translated at all
+//		depends on the session's optimizer_multilevel_partitioning setting.
 //
 //---------------------------------------------------------------------------
-CWStringBase *
-CMDProviderRelcache::PstrObject
+BOOL
+CMDProviderRelcache::FSharedCacheable
+	(
+	IMDId *pmdid,
+	OID *poidRel,
+	BOOL *pfStats
+	)
+{
+	*poidRel = InvalidOid;
+	*pfStats = false;
+
+	switch (pmdid->Emdidt())
+	{
+		case IMDId::EmdidGPDB:
+		{
+			OID oid = CMDIdGPDB::PmdidConvert(pmdid)->OidObjectId();
+
+			// triggers and check constraints are invalidated through the
+			// relcache entry of the relation they belong to
+			if (gpdb::FRelationExists(oid))
+			{
+				if (1 < gpdb::UlListLength(gpdb::PlPartitionAttrs(oid)))
+				{
+					return false;
+				}
+				*poidRel = oid;
+			}
+			else if (gpdb::FTriggerExists(oid))
+			{
+				*poidRel = gpdb::OidTriggerRelid(oid);
+			}
+			else if (gpdb::FCheckConstraintExists(oid))
+			{
+				*poidRel = gpdb::OidCheckConstraintRelid(oid);
+			}
+			return true;
+		}
+
+		case IMDId::EmdidColStats:
+		{
+			IMDId *pmdidRel = CMDIdColStats::PmdidConvert(pmdid)->PmdidRel();
+			*poidRel = CMDIdGPDB::PmdidConvert(pmdidRel)->OidObjectId();
+			*pfStats = true;
+			return true;
+		}
+
+		case IMDId::EmdidCastFunc:
+		case IMDId::EmdidScCmp:
+			return true;
+
+		default:
+			return false;
+	}
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CMDProviderRelcache::PstrTranslate
+//
+//	@doc:
+//		Translate the requested object from the relcache and serialize it
+//		to DXL in the provider's memory pool
+//
+//---------------------------------------------------------------------------
+CWStringDynamic *
+CMDProviderRelcache::PstrTranslate
 	(
 	IMemoryPool *pmp,
 	CMDAccessor *pmda,
@@ -74,4 +149,65 @@ CMDProviderRelcache::PstrObject
 	return pstr;
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CMDProviderRelcache::PstrObject
+//
+//	@doc:
+//		Returns the DXL of the requested object in the provided memory pool.
+//		The DXL is taken from the metadata cache shared across backends if
+//		another backend already translated the object, and published there
+//		otherwise.
+//
+//---------------------------------------------------------------------------
+CWStringBase *
+CMDProviderRelcache::PstrObject
+	(
+	IMemoryPool *pmp,
+	CMDAccessor *pmda,
+	IMDId *pmdid
+	)
+	const
+{
+	OID oidRel = InvalidOid;
+	BOOL fStats = false;
+
+	if (!gpdb::FMDSharedCacheUsable() || !FSharedCacheable(pmdid, &oidRel, &fStats))
+	{
+		return PstrTranslate(pmp, pmda, pmdid);
+	}
+
+	CHAR *szMdid = CTranslatorUtils::SzFromWsz(pmdid->Wsz());
+	Size ulLen = 0;
+	uint64 ullGeneration = 0;
+	CHAR *pcData = gpdb::SzMDSharedCacheLookup(szMdid, &ulLen, &ullGeneration);
+
+	if (NULL != pcData)
+	{
+		GPOS_ASSERT(0 == ulLen % GPOS_SIZEOF(WCHAR));
+
+		CWStringDynamic *pstr = GPOS_NEW(m_pmp) CWStringDynamic(m_pmp, (const WCHAR *) pcData);
+		gpdb::GPDBFree(pcData);
+		gpdb::GPDBFree(szMdid);
+
+		return pstr;
+	}
+
+	CWStringDynamic *pstr = PstrTranslate(pmp, pmda, pmdid);
+
+	// include the terminating null character
+	gpdb::MDSharedCacheInsert
+			(
+			szMdid,
+			oidRel,
+			fStats,
+			ullGeneration,
+			(const CHAR *) pstr->Wsz(),
+			(pstr->UlLength() + 1) * GPOS_SIZEOF(WCHAR)
+			);
+	gpdb::GPDBFree(szMdid);
+
+	return pstr;
+}
+
 // EOF
@@ -911,6 +911,11 @@ CTranslatorRelcacheToDXL::Ereldistribution
 			return IMDRelation::EreldistrRandom;
 		}
 
+		if (POLICY_HASHREDUCE_JUMP == pgppolicy->hashreduce)
+		{
+			GPOS_RAISE(gpdxl::ExmaMD, gpdxl::ExmiMDObjUnsupported, GPOS_WSZ_LIT("Jump consistent hash distribution"));
+		}
+
 		return IMDRelation::EreldistrHash;
 	}
 
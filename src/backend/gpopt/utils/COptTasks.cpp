@@ -923,6 +923,104 @@ COptTasks::Pcm
 	return pcm;
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		COptTasks::SzPlanCacheKey
+//
+//	@doc:
+//		Return the plan cache key of the query to optimize, or NULL if the
+//		plan cache is disabled or the plan of the query is not to be cached.
+//		Only plain queries translated to a planned statement are cached.
+//		The literals of the query, which are not part of the key, are
+//		returned in pplLiterals.
+//
+//---------------------------------------------------------------------------
+CHAR *
+COptTasks::SzPlanCacheKey
+	(
+	SOptContext *poctx,
+	List **pplLiterals
+	)
+{
+	Query *pquery = poctx->m_pquery;
+
+	if (0 == optimizer_plan_cache_size ||
+		!poctx->m_fGeneratePlStmt ||
+		poctx->m_fSerializePlanDXL ||
+		CMD_SELECT != pquery->commandType ||
+		NULL != pquery->intoClause ||
+		NULL != pquery->utilityStmt)
+	{
+		return NULL;
+	}
+
+	return gpdb::SzOptPlanCacheKey(pquery, gpdb::UlSegmentCountGP(), pplLiterals);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptTasks::FPlstmtFromPlanCache
+//
+//	@doc:
+//		If a plan of the query to optimize is cached, translate it into a
+//		planned statement, bind the literals of the query into it and
+//		return true. Return false if there is no such plan, or if the
+//		literals can't be bound into it.
+//
+//---------------------------------------------------------------------------
+BOOL
+COptTasks::FPlstmtFromPlanCache
+	(
+	IMemoryPool *pmp,
+	SOptContext *poctx,
+	const CHAR *szPlanCacheKey,
+	List *plLiterals
+	)
+{
+	List *plPlanLiterals = NIL;
+	const CHAR *szPlanDXL = gpdb::SzOptPlanCacheLookup(szPlanCacheKey, &plPlanLiterals);
+	if (NULL == szPlanDXL)
+	{
+		return false;
+	}
+
+	ULLONG ullPlanId = 0;
+	ULLONG ullPlanSpaceSize = 0;
+	CDXLNode *pdxlnPlan = NULL;
+
+	GPOS_TRY
+	{
+		pdxlnPlan = CDXLUtils::PdxlnParsePlan(pmp, szPlanDXL, NULL /*XSD location*/, &ullPlanId, &ullPlanSpaceSize);
+
+		// relcache MD provider
+		CMDProviderRelcache *pmdpRelcache = GPOS_NEW(pmp) CMDProviderRelcache(pmp);
+
+		{
+			// scope for MD accessor
+			CMDAccessor mda(pmp, CMDCache::Pcache(), sysidDefault, pmdpRelcache);
+
+			poctx->m_pplstmt = (PlannedStmt *) gpdb::PvCopyObject(Pplstmt(pmp, &mda, pdxlnPlan, poctx->m_pquery->canSetTag));
+		}
+
+		pdxlnPlan->Release();
+	}
+	GPOS_CATCH_EX(ex)
+	{
+		CRefCount::SafeRelease(pdxlnPlan);
+		CMDCache::Shutdown();
+		GPOS_RETHROW(ex);
+	}
+	GPOS_CATCH_END;
+
+	if (!gpdb::FOptPlanCacheBindLiterals(poctx->m_pplstmt, plPlanLiterals, plLiterals))
+	{
+		poctx->m_pplstmt = NULL;
+		return false;
+	}
+
+	return true;
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		COptTasks::PvOptimizeTask
@@ -974,6 +1072,18 @@ COptTasks::PvOptimizeTask
 		CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
 	}
 
+	// reuse the plan of a query that differs at most in its literals
+	List *plLiterals = NIL;
+	CHAR *szPlanCacheKey = SzPlanCacheKey(poctx, &plLiterals);
+	if (NULL != szPlanCacheKey && FPlstmtFromPlanCache(pmp, poctx, szPlanCacheKey, plLiterals))
+	{
+		gpdb::GPDBFree(szPlanCacheKey);
+		if (!optimizer_metadata_caching)
+		{
+			CMDCache::Shutdown();
+		}
+		return NULL;
+	}
 
 	// load search strategy
 	DrgPss *pdrgpss = PdrgPssLoad(pmp, optimizer_search_strategy_path);
@@ -1072,6 +1182,16 @@ COptTasks::PvOptimizeTask
 				poctx->m_pplstmt = (PlannedStmt *) gpdb::PvCopyObject(Pplstmt(pmp, &mda, pdxlnPlan, poctx->m_pquery->canSetTag));
 			}
 
+			if (NULL != szPlanCacheKey)
+			{
+				CWStringDynamic strPlan(pmp);
+				COstreamString oss(&strPlan);
+				CDXLUtils::SerializePlan(pmp, oss, pdxlnPlan, pocconf->Pec()->UllPlanId(), pocconf->Pec()->UllPlanSpaceSize(), true /*fSerializeHeaderFooter*/, false /*fIndent*/);
+				CHAR *szPlanDXL = SzFromWsz(strPlan.Wsz());
+				gpdb::OptPlanCacheInsert(szPlanCacheKey, szPlanDXL, plLiterals, poctx->m_pplstmt->relationOids);
+				gpdb::GPDBFree(szPlanDXL);
+			}
+
 			CStatisticsConfig *pstatsconf = pocconf->Pstatsconf();
 			pdrgmdidCol = GPOS_NEW(pmp) DrgPmdid(pmp);
 			pstatsconf->CollectMissingStatsColumns(pdrgmdidCol);
@@ -1121,6 +1241,10 @@ COptTasks::PvOptimizeTask
 	CRefCount::SafeRelease(pbsEnabled);
 	CRefCount::SafeRelease(pbsDisabled);
 	CRefCount::SafeRelease(pbsTraceFlags);
+	if (NULL != szPlanCacheKey)
+	{
+		gpdb::GPDBFree(szPlanCacheKey);
+	}
 	if (!optimizer_metadata_caching)
 	{
 		CMDCache::Shutdown();
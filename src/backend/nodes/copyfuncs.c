@@ -258,6 +258,7 @@ _copyResult(Result *from)
 
 	COPY_SCALAR_FIELD(hashFilter);
 	COPY_NODE_FIELD(hashList);
+	COPY_SCALAR_FIELD(hashReduce);
 
 	return newnode;
 }
@@ -1238,6 +1239,7 @@ _copyMotion(Motion *from)
 
 	COPY_NODE_FIELD(hashExpr);
 	COPY_NODE_FIELD(hashDataTypes);
+	COPY_SCALAR_FIELD(hashReduce);
 
 	COPY_SCALAR_FIELD(numOutputSegs);
 	COPY_POINTER_FIELD(outputSegIdx, from->numOutputSegs * sizeof(int));
@@ -2171,6 +2173,7 @@ _copyFlow(Flow *from)
 	COPY_SCALAR_FIELD(locustype);
 	COPY_SCALAR_FIELD(segindex);
 	COPY_NODE_FIELD(hashExpr);
+	COPY_SCALAR_FIELD(hashReduce);
 	COPY_NODE_FIELD(flow_before_req_move);
 
 	return newnode;
@@ -4710,6 +4713,7 @@ _copyGpPolicy(GpPolicy *from)
 	COPY_SCALAR_FIELD(ptype);
 	COPY_SCALAR_FIELD(nattrs);
 	COPY_POINTER_FIELD(attrs, from->nattrs * sizeof(AttrNumber));
+	COPY_SCALAR_FIELD(hashreduce);
 
 	return newnode;
 }
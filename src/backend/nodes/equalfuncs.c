@@ -782,6 +782,7 @@ _equalFlow(Flow *a, Flow *b)
 	COMPARE_SCALAR_FIELD(locustype);
 	COMPARE_SCALAR_FIELD(segindex);
 	COMPARE_NODE_FIELD(hashExpr);
+	COMPARE_SCALAR_FIELD(hashReduce);
 
 	return true;
 }
@@ -543,6 +543,7 @@ _outMotion(StringInfo str, Motion *node)
 
 	WRITE_NODE_FIELD(hashExpr);
 	WRITE_NODE_FIELD(hashDataTypes);
+	WRITE_ENUM_FIELD(hashReduce, GpPolicyHashReduce);
 
 	WRITE_INT_FIELD(numOutputSegs);
 	WRITE_INT_ARRAY(outputSegIdx, node->numOutputSegs, int);
@@ -1294,6 +1295,7 @@ _outGpPolicy(StringInfo str, GpPolicy *node)
 	WRITE_ENUM_FIELD(ptype, GpPolicyType);
 	WRITE_INT_FIELD(nattrs);
 	WRITE_INT_ARRAY(attrs, node->nattrs, AttrNumber);
+	WRITE_ENUM_FIELD(hashreduce, GpPolicyHashReduce);
 }
 
 /*
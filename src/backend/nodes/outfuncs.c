@@ -426,6 +426,7 @@ _outResult(StringInfo str, Result *node)
 
 	WRITE_BOOL_FIELD(hashFilter);
 	WRITE_NODE_FIELD(hashList);
+	WRITE_ENUM_FIELD(hashReduce, GpPolicyHashReduce);
 }
 
 static void
@@ -1095,6 +1096,7 @@ _outMotion(StringInfo str, Motion *node)
 
 	WRITE_NODE_FIELD(hashExpr);
 	WRITE_NODE_FIELD(hashDataTypes);
+	WRITE_ENUM_FIELD(hashReduce, GpPolicyHashReduce);
 
 	WRITE_INT_FIELD(numOutputSegs);
 	appendStringInfoLiteral(str, " :outputSegIdx");
@@ -1799,6 +1801,7 @@ _outFlow(StringInfo str, Flow *node)
 	WRITE_INT_FIELD(segindex);
 
 	WRITE_NODE_FIELD(hashExpr);
+	WRITE_ENUM_FIELD(hashReduce, GpPolicyHashReduce);
 
 	WRITE_NODE_FIELD(flow_before_req_move);
 }
@@ -1510,6 +1510,7 @@ _readResult(void)
 
 	READ_BOOL_FIELD(hashFilter);
 	READ_NODE_FIELD(hashList);
+	READ_ENUM_FIELD(hashReduce, GpPolicyHashReduce);
 
 	READ_DONE();
 }
@@ -2205,6 +2206,7 @@ _readFlow(void)
 	READ_INT_FIELD(segindex);
 
 	READ_NODE_FIELD(hashExpr);
+	READ_ENUM_FIELD(hashReduce, GpPolicyHashReduce);
 	READ_NODE_FIELD(flow_before_req_move);
 
 	READ_DONE();
@@ -2227,6 +2229,7 @@ _readMotion(void)
 
 	READ_NODE_FIELD(hashExpr);
 	READ_NODE_FIELD(hashDataTypes);
+	READ_ENUM_FIELD(hashReduce, GpPolicyHashReduce);
 
 	READ_INT_FIELD(numOutputSegs);
 	READ_INT_ARRAY(outputSegIdx, local_node->numOutputSegs, int);
@@ -2934,6 +2937,7 @@ _readGpPolicy(void)
 
 	READ_INT_FIELD(nattrs);
 	READ_INT_ARRAY(attrs, local_node->nattrs, AttrNumber);
+	READ_ENUM_FIELD(hashreduce, GpPolicyHashReduce);
 
 	READ_DONE();
 }
@@ -1551,6 +1551,8 @@ transformDistributedBy(ParseState *pstate, CreateStmtContext *cxt,
 	List		*policykeys = NIL;
 	int		numUniqueIndexes = 0;
 	Constraint	*uniqueindex = NULL;
+	bool		inheritHashReduce = false;
+	GpPolicyHashReduce hashreduce = POLICY_HASHREDUCE_MODULO;
 
 	/*
 	 * utility mode creates can't have a policy.  Only the QD can have policies
@@ -1717,6 +1719,17 @@ transformDistributedBy(ParseState *pstate, CreateStmtContext *cxt,
 								  "non-distributed tables.")));
 			}
 
+			/*
+			 * Children, e.g. partitions added later on, must place rows the
+			 * same way as their parent whatever
+			 * gp_create_table_hash_reduction says now.
+			 */
+			if (GpPolicyIsHashPartitioned(oldTablePolicy))
+			{
+				inheritHashReduce = true;
+				hashreduce = oldTablePolicy->hashreduce;
+			}
+
 			/*
 			 * If we still don't know what distribution to use, and this
 			 * is an inherited table, set the distribution based on the
@@ -2003,6 +2016,8 @@ transformDistributedBy(ParseState *pstate, CreateStmtContext *cxt,
 	Assert(policykeys != NIL);
 
 	policy = createHashPartitionedPolicy(NULL, policykeys);
+	if (inheritHashReduce)
+		policy->hashreduce = hashreduce;
 
 	if (cxt && cxt->pkey)	/* Primary key	specified.	Make sure
 								 * distribution columns match */
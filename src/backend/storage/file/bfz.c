@@ -32,6 +32,12 @@ static const struct{
 {
     {{"none", "false", "no", "off", "0", 0}, bfz_nothing_init},
     {{"zlib", 0}, bfz_zlib_init},
+#ifdef HAVE_LIBLZ4
+    {{"lz4", 0}, bfz_lz4_init},
+#endif
+#ifdef HAVE_LIBZSTD
+    {{"zstd", 0}, bfz_zstd_init},
+#endif
     {{0}}
 };
 
@@ -90,6 +96,54 @@ compute_checksum(const char *buffer, uint32 size)
 	return crc;
 }
 
+/*
+ * Start the writeback of what has been appended to the file since the last
+ * call, once that amounts to gp_workfile_writeback_blocks blocks.  The
+ * compressor decides when data actually reaches the file, so go by the file
+ * position rather than by the number of buffers written.
+ */
+static void
+bfz_writeback(bfz_t *bfz)
+{
+	int64		threshold = (int64) gp_workfile_writeback_blocks * BLCKSZ;
+	int64		pos;
+
+	if (threshold <= 0)
+		return;
+
+	pos = FileSeek(bfz->file, 0, SEEK_CUR);
+	if (pos - bfz->writeback_start >= threshold)
+	{
+		FileWriteback(bfz->file, bfz->writeback_start,
+					  (int) (pos - bfz->writeback_start));
+		bfz->writeback_start = pos;
+	}
+}
+
+/*
+ * Keep gp_workfile_prefetch_blocks blocks of read-ahead in flight in front
+ * of the current file position.  A new request is only issued once half of
+ * the previous one has been consumed.
+ */
+static void
+bfz_prefetch(bfz_t *bfz)
+{
+	int64		distance = (int64) gp_workfile_prefetch_blocks * BLCKSZ;
+	int64		pos;
+
+	if (distance <= 0)
+		return;
+
+	pos = FileSeek(bfz->file, 0, SEEK_CUR);
+	if (pos + distance / 2 < bfz->prefetch_end)
+		return;
+
+	if (bfz->prefetch_end < pos)
+		bfz->prefetch_end = pos;
+	FilePrefetch(bfz->file, bfz->prefetch_end, (int) (pos + distance - bfz->prefetch_end));
+	bfz->prefetch_end = pos + distance;
+}
+
 /*
  * Write out a bfz buffer.
  *
@@ -139,6 +193,8 @@ write_bfz_buffer(bfz_t *bfz, bool isLast)
 	}
 	PG_END_TRY();
 
+	bfz_writeback(bfz);
+
 	bfz->numBlocks ++;
 }
 
@@ -160,7 +216,9 @@ read_bfz_buffer(bfz_t *bfz, char *buffer)
 	int bytesRead = 0;
 	struct bfz_freeable_stuff *fs = bfz->freeable_stuff;
 	int dataSize = 0;
-	
+
+	bfz_prefetch(bfz);
+
 	bytesRead = fs->read_ex(bfz, buffer, sizeof(fs->buffer));
 	Assert(bytesRead <= sizeof(fs->buffer));
 
@@ -390,6 +448,7 @@ bfz_scan_begin(bfz_t * thiz)
 				errmsg("could not seek in temporary file: %m")));
 
 	thiz->mode = BFZ_MODE_SCAN;
+	thiz->prefetch_end = 0;
 
 	/*
 	 * Allocating in the TopMemoryContext since this memory context
@@ -59,11 +59,19 @@ struct BufFile
 	int			nbytes;			/* total # of valid bytes in buffer */
 	int64		maxoffset;		/* maximum offset that this file has reached, for disk usage */
 
+	/*
+	 * Range of a workfile that has been written, but whose writeback has not
+	 * been started yet.  See BufFileScheduleWriteback.
+	 */
+	int64		writebackStart;
+	int64		writebackEnd;
+
 	char	   *buffer;			/* CDB: -> buffer */
 };
 
 static BufFile *makeBufFile(File firstfile);
 static void BufFileUpdateSize(BufFile *buffile);
+static void BufFileScheduleWriteback(BufFile *file, int64 offset, Size nbytes);
 
 
 /*
@@ -88,6 +96,8 @@ makeBufFile(File firstfile)
 	file->pos = 0;
 	file->nbytes = 0;
 	file->maxoffset = 0L;
+	file->writebackStart = 0L;
+	file->writebackEnd = 0L;
 	file->buffer = palloc(BLCKSZ);
 
 	return file;
@@ -260,6 +270,7 @@ BufFileDumpBuffer(BufFile *file, const void* buffer, Size nbytes)
 	size_t wpos = 0;
 	size_t bytestowrite;
 	int wrote = 0;
+	int64 startoffset = file->offset;
 
 	/*
 	 * Unlike BufFileLoadBuffer, we must dump the whole buffer.
@@ -294,6 +305,9 @@ BufFileDumpBuffer(BufFile *file, const void* buffer, Size nbytes)
 	}
 	file->dirty = false;
 
+	if (file->isWorkfile)
+		BufFileScheduleWriteback(file, startoffset, nbytes);
+
 	/*
 	 * Now we can set the buffer empty without changing the logical position
 	 */
@@ -301,6 +315,54 @@ BufFileDumpBuffer(BufFile *file, const void* buffer, Size nbytes)
 	file->nbytes = 0;
 }
 
+/*
+ * BufFileScheduleWriteback
+ *
+ * Remember that [offset, offset + nbytes) has been written.  Once
+ * gp_workfile_writeback_blocks worth of contiguously written data has
+ * accumulated, ask the kernel to start writing it out, so that spilling
+ * operators don't stall later on a large amount of dirty pages.  The backend
+ * does not wait for the writeback to complete.
+ */
+static void
+BufFileScheduleWriteback(BufFile *file, int64 offset, Size nbytes)
+{
+	int64		threshold = (int64) gp_workfile_writeback_blocks * BLCKSZ;
+
+	if (threshold <= 0)
+		return;
+
+	/*
+	 * A write that does not extend the pending range starts a new one.  The
+	 * old, short range is left for the kernel to write out on its own.
+	 */
+	if (offset != file->writebackEnd)
+		file->writebackStart = offset;
+	file->writebackEnd = offset + nbytes;
+
+	if (file->writebackEnd - file->writebackStart >= threshold)
+	{
+		FileWriteback(file->file, file->writebackStart,
+					  (int) (file->writebackEnd - file->writebackStart));
+		file->writebackStart = file->writebackEnd;
+	}
+}
+
+/*
+ * BufFilePrefetch
+ *
+ * Ask the kernel to read [offset, offset + nbytes) of the file ahead of
+ * time.  The logical position of the file is unaffected.
+ */
+void
+BufFilePrefetch(BufFile *file, int64 offset, int64 nbytes)
+{
+	Assert(offset >= 0 && nbytes >= 0);
+
+	if (nbytes > 0)
+		FilePrefetch(file->file, offset, (int) nbytes);
+}
+
 /*
  * BufFileRead
  *
@@ -0,0 +1,165 @@
+/* compress_block.c */
+#include "postgres.h"
+
+#include "storage/bfz.h"
+#include "storage/fd.h"
+
+/*
+ * This file implements the framing shared by the block compression
+ * algorithms of bfz ("lz4" and "zstd").
+ *
+ * Unlike zlib, which compresses the whole file as one stream, every buffer
+ * handed to write_ex is compressed on its own and stored as a header
+ * followed by the compressed data. Since bfz always reads and writes whole
+ * buffers, read_ex then decompresses exactly one block per call. A block
+ * that does not get smaller is stored as is, flagged by a compressed length
+ * equal to the raw length.
+ */
+typedef struct bfz_block_header
+{
+	uint32		compressed_len;
+	uint32		raw_len;
+} bfz_block_header;
+
+struct bfz_block_freeable_stuff
+{
+	struct bfz_freeable_stuff super;
+
+	const bfz_block_codec *codec;
+
+	/* block header followed by the compressed data */
+	char		cbuf[sizeof(bfz_block_header) + BFZ_BUFFER_SIZE];
+};
+
+static void
+bfz_block_read_fully(bfz_t * thiz, char *buffer, int size)
+{
+	while (size)
+	{
+		int			i = FileRead(thiz->file, buffer, size);
+
+		if (i < 0)
+			ereport(ERROR,
+					(errcode_for_file_access(),
+					 errmsg("could not read from temporary file: %m")));
+		if (i == 0)
+			ereport(ERROR,
+					(errcode(ERRCODE_IO_ERROR),
+					 errmsg("unexpected end of temporary file")));
+		buffer += i;
+		size -= i;
+	}
+}
+
+static void
+bfz_block_write_fully(bfz_t * thiz, const char *buffer, int size)
+{
+	while (size)
+	{
+		int			i = FileWrite(thiz->file, (char *) buffer, size);
+
+		if (i < 0)
+			ereport(ERROR,
+					(errcode_for_file_access(),
+					 errmsg("could not write to temporary file: %m")));
+		buffer += i;
+		size -= i;
+	}
+}
+
+/*
+ * bfz_block_close_ex
+ *	Free up descriptor, buffers etc. Does not close the underlying file!
+ */
+static void
+bfz_block_close_ex(bfz_t * thiz)
+{
+	pfree(thiz->freeable_stuff);
+	thiz->freeable_stuff = NULL;
+}
+
+static int
+bfz_block_read_ex(bfz_t * thiz, char *buffer, int size)
+{
+	struct bfz_block_freeable_stuff *fs = (void *) thiz->freeable_stuff;
+	bfz_block_header hdr;
+	int			i;
+
+	/* A clean end of file can only occur at a block boundary */
+	i = FileRead(thiz->file, (char *) &hdr, sizeof(hdr));
+	if (i < 0)
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not read from temporary file: %m")));
+	if (i == 0)
+		return 0;
+	if (i < sizeof(hdr))
+		bfz_block_read_fully(thiz, (char *) &hdr + i, sizeof(hdr) - i);
+
+	if (hdr.raw_len > size || hdr.compressed_len > hdr.raw_len)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg("invalid block header in temporary file: compressed length %u, raw length %u",
+						hdr.compressed_len, hdr.raw_len)));
+
+	if (hdr.compressed_len == hdr.raw_len)
+	{
+		bfz_block_read_fully(thiz, buffer, hdr.raw_len);
+		return hdr.raw_len;
+	}
+
+	bfz_block_read_fully(thiz, fs->cbuf, hdr.compressed_len);
+
+	i = fs->codec->decompress(fs->cbuf, hdr.compressed_len, buffer, hdr.raw_len);
+	if (i != hdr.raw_len)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg("could not decompress temporary file block using %s",
+						fs->codec->name)));
+
+	return hdr.raw_len;
+}
+
+static void
+bfz_block_write_ex(bfz_t * thiz, const char *buffer, int size)
+{
+	struct bfz_block_freeable_stuff *fs = (void *) thiz->freeable_stuff;
+	bfz_block_header *hdr = (bfz_block_header *) fs->cbuf;
+	char	   *data = fs->cbuf + sizeof(bfz_block_header);
+	int			clen;
+
+	Assert(size <= BFZ_BUFFER_SIZE);
+
+	if (size == 0)
+		return;
+
+	/*
+	 * Only keep the compressed form if it saves some space. Capping the
+	 * output at size - 1 bytes lets the algorithm give up early otherwise.
+	 */
+	clen = fs->codec->compress(buffer, size, data, size - 1);
+	if (clen <= 0 || clen >= size)
+	{
+		memcpy(data, buffer, size);
+		clen = size;
+	}
+
+	/* The header goes out with the data, in a single write */
+	hdr->compressed_len = clen;
+	hdr->raw_len = size;
+	bfz_block_write_fully(thiz, fs->cbuf, sizeof(bfz_block_header) + clen);
+}
+
+void
+bfz_block_init(bfz_t * thiz, const bfz_block_codec *codec)
+{
+	struct bfz_block_freeable_stuff *fs = palloc(sizeof *fs);
+
+	fs->codec = codec;
+
+	thiz->freeable_stuff = &fs->super;
+
+	fs->super.read_ex = bfz_block_read_ex;
+	fs->super.write_ex = bfz_block_write_ex;
+	fs->super.close_ex = bfz_block_close_ex;
+}
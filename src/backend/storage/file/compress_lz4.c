@@ -0,0 +1,41 @@
+/* compress_lz4.c */
+#include "postgres.h"
+
+#include "storage/bfz.h"
+
+#ifdef HAVE_LIBLZ4
+
+#include <lz4.h>
+
+/*
+ * This file implements bfz compression algorithm "lz4". The block framing
+ * is in compress_block.c.
+ */
+
+static int
+bfz_lz4_compress(const char *src, int srclen, char *dst, int dstcap)
+{
+	if (dstcap <= 0)
+		return 0;
+	return LZ4_compress_default(src, dst, srclen, dstcap);
+}
+
+static int
+bfz_lz4_decompress(const char *src, int srclen, char *dst, int dstcap)
+{
+	return LZ4_decompress_safe(src, dst, srclen, dstcap);
+}
+
+static const bfz_block_codec bfz_lz4_codec = {
+	"lz4",
+	bfz_lz4_compress,
+	bfz_lz4_decompress
+};
+
+void
+bfz_lz4_init(bfz_t * thiz)
+{
+	bfz_block_init(thiz, &bfz_lz4_codec);
+}
+
+#endif   /* HAVE_LIBLZ4 */
@@ -0,0 +1,82 @@
+/* compress_zstd.c */
+#include "postgres.h"
+
+#include "cdb/cdbvars.h"
+#include "storage/bfz.h"
+
+#ifdef HAVE_LIBZSTD
+
+#include <zstd.h>
+
+/*
+ * This file implements bfz compression algorithm "zstd", at the level given
+ * by gp_workfile_compress_zstd_level. The block framing is in
+ * compress_block.c.
+ *
+ * The compression and decompression contexts are allocated on first use and
+ * kept for the life of the backend, since every workfile block is
+ * (de)compressed on its own.
+ */
+static ZSTD_CCtx *bfz_zstd_cctx = NULL;
+static ZSTD_DCtx *bfz_zstd_dctx = NULL;
+
+static int
+bfz_zstd_compress(const char *src, int srclen, char *dst, int dstcap)
+{
+	size_t		ret;
+
+	if (dstcap <= 0)
+		return 0;
+
+	ret = ZSTD_compressCCtx(bfz_zstd_cctx, dst, dstcap, src, srclen,
+							gp_workfile_compress_zstd_level);
+
+	/* Also fails if the result doesn't fit, in which case it's stored raw */
+	if (ZSTD_isError(ret))
+		return 0;
+	return (int) ret;
+}
+
+static int
+bfz_zstd_decompress(const char *src, int srclen, char *dst, int dstcap)
+{
+	size_t		ret;
+
+	ret = ZSTD_decompressDCtx(bfz_zstd_dctx, dst, dstcap, src, srclen);
+	if (ZSTD_isError(ret))
+		return -1;
+	return (int) ret;
+}
+
+static const bfz_block_codec bfz_zstd_codec = {
+	"zstd",
+	bfz_zstd_compress,
+	bfz_zstd_decompress
+};
+
+void
+bfz_zstd_init(bfz_t * thiz)
+{
+	if (bfz_zstd_cctx == NULL)
+	{
+		bfz_zstd_cctx = ZSTD_createCCtx();
+		if (bfz_zstd_cctx == NULL)
+			ereport(ERROR,
+					(errcode(ERRCODE_OUT_OF_MEMORY),
+					 errmsg("out of memory"),
+					 errdetail("Failed to create zstd compression context.")));
+	}
+	if (bfz_zstd_dctx == NULL)
+	{
+		bfz_zstd_dctx = ZSTD_createDCtx();
+		if (bfz_zstd_dctx == NULL)
+			ereport(ERROR,
+					(errcode(ERRCODE_OUT_OF_MEMORY),
+					 errmsg("out of memory"),
+					 errdetail("Failed to create zstd decompression context.")));
+	}
+
+	bfz_block_init(thiz, &bfz_zstd_codec);
+}
+
+#endif   /* HAVE_LIBZSTD */
@@ -1356,6 +1356,39 @@ FilePrefetch(File file, off_t offset, int amount)
 #endif
 }
 
+/*
+ * FileWriteback - initiate asynchronous writeback of a given range of the
+ * file.  The logical seek position is unaffected.
+ *
+ * This only asks the kernel to start writing out dirty pages, it does not
+ * wait for them to reach disk.  Without sync_file_range() it does nothing.
+ */
+int
+FileWriteback(File file, off_t offset, int amount)
+{
+#if defined(SYNC_FILE_RANGE_WRITE)
+	int			returnCode;
+
+	Assert(FileIsValid(file));
+
+	DO_DB(elog(LOG, "FileWriteback: %d (%s) " INT64_FORMAT " %d",
+			   file, VfdCache[file].fileName,
+			   (int64) offset, amount));
+
+	returnCode = FileAccess(file);
+	if (returnCode < 0)
+		return returnCode;
+
+	returnCode = sync_file_range(VfdCache[file].fd, offset, amount,
+								 SYNC_FILE_RANGE_WRITE);
+
+	return returnCode;
+#else
+	Assert(FileIsValid(file));
+	return 0;
+#endif
+}
+
 int
 FileRead(File file, char *buffer, int amount)
 {
@@ -46,6 +46,7 @@
 #include "utils/backend_cancel.h"
 #include "utils/resource_manager.h"
 #include "utils/faultinjector.h"
+#include "utils/mdsharedcache.h"
 #include "utils/sharedsnapshot.h"
 
 #include "libpq-fe.h"
@@ -158,6 +159,7 @@ CreateSharedMemoryAndSemaphores(bool makePrivate, int port)
 		size = add_size(size, BTreeShmemSize());
 		size = add_size(size, SyncScanShmemSize());
 		size = add_size(size, AsyncShmemSize());
+		size = add_size(size, MDSharedCacheShmemSize());
 #ifdef EXEC_BACKEND
 		size = add_size(size, ShmemBackendArraySize());
 #endif
@@ -318,6 +320,7 @@ CreateSharedMemoryAndSemaphores(bool makePrivate, int port)
 	BTreeShmemInit();
 	SyncScanShmemInit();
 	AsyncShmemInit();
+	MDSharedCacheShmemInit();
 	workfile_mgr_cache_init();
 	BackendCancelShmemInit();
 
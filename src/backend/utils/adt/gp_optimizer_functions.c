@@ -8,13 +8,17 @@
  *
  * gp_opt_version: This function wraps LibraryVersion. 
  *
+ * gp_opt_plan_cache_stats: Reports the counters of the optimizer plan cache.
+ *
  * Copyright(c) 2012 - present, EMC/Greenplum
  */
 
 #include "postgres.h"
 
+#include "access/htup.h"
 #include "funcapi.h"
 #include "utils/builtins.h"
+#include "utils/optplancache.h"
 
 extern Datum EnableXform(PG_FUNCTION_ARGS);
 
@@ -60,3 +64,33 @@ gp_opt_version(PG_FUNCTION_ARGS __attribute__((unused)))
 	return CStringGetTextDatum("Server has been compiled without ORCA");
 #endif
 }
+
+/*
+* Returns the hits, misses, number of entries and size of the optimizer
+* plan cache of the current session.
+*/
+Datum
+gp_opt_plan_cache_stats(PG_FUNCTION_ARGS)
+{
+	TupleDesc	tupdesc;
+	Datum		values[4];
+	bool		nulls[4];
+	int64		hits;
+	int64		misses;
+	int			entries;
+	int64		size;
+
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+	tupdesc = BlessTupleDesc(tupdesc);
+
+	OptPlanCacheGetStats(&hits, &misses, &entries, &size);
+
+	MemSet(nulls, 0, sizeof(nulls));
+	values[0] = Int64GetDatum(hits);
+	values[1] = Int64GetDatum(misses);
+	values[2] = Int32GetDatum(entries);
+	values[3] = Int64GetDatum(size);
+
+	PG_RETURN_DATUM(HeapTupleGetDatum(heap_form_tuple(tupdesc, values, nulls)));
+}
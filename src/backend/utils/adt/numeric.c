@@ -1248,6 +1248,57 @@ cmp_numerics(Numeric num1, Numeric num2)
 	return result;
 }
 
+/*
+ * numeric_abbrev() -
+ *
+ *	Abbreviated sort key of a numeric: a uint64, in a Datum, whose unsigned
+ *	order agrees with cmp_numerics().  The top two bits hold the class of the
+ *	value (negative, zero, positive, NaN), followed by the weight and the
+ *	first three digits of the magnitude, inverted for negative values.
+ *	Values that differ only in later digits get equal keys.
+ */
+Datum
+numeric_abbrev(Datum d)
+{
+	Numeric		num = DatumGetNumeric(d);
+	NumericDigit *digits = NUMERIC_DIGITS(num);
+	int			ndigits = NUMERIC_NDIGITS(num);
+	int			weight = NUMERIC_WEIGHT(num);
+	uint64		mag;
+	uint64		result;
+	int			i;
+
+	/* Skip any leading zero digits, to be safe */
+	while (ndigits > 0 && digits[0] == 0)
+	{
+		digits++;
+		ndigits--;
+		weight--;
+	}
+
+	if (NUMERIC_IS_NAN(num))
+		result = UINT64CONST(3) << 62;
+	else if (ndigits == 0)
+		result = UINT64CONST(1) << 62;
+	else
+	{
+		/* 16 bits of biased weight, then 14 bits for each digit < NBASE */
+		mag = (uint64) (weight - PG_INT16_MIN) & 0xFFFF;
+		for (i = 0; i < 3; i++)
+			mag = (mag << 14) | (uint64) (i < ndigits ? digits[i] : 0);
+
+		if (NUMERIC_SIGN(num) == NUMERIC_POS)
+			result = (UINT64CONST(2) << 62) | mag;
+		else
+			result = ((UINT64CONST(1) << 58) - 1) - mag;
+	}
+
+	if ((Pointer) num != DatumGetPointer(d))
+		pfree(num);
+
+	return (Datum) result;
+}
+
 Datum
 hash_numeric(PG_FUNCTION_ARGS)
 {
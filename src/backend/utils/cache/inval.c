@@ -94,6 +94,7 @@
 #include "storage/sinval.h"
 #include "storage/smgr.h"
 #include "utils/inval.h"
+#include "utils/mdsharedcache.h"
 #include "utils/memutils.h"
 #include "utils/rel.h"
 #include "utils/relmapper.h"
@@ -989,6 +990,14 @@ AtEOXact_Inval(bool isCommit)
 		ProcessInvalidationMessagesMulti(&transInvalInfo->PriorCmdInvalidMsgs,
 										 SendSharedInvalidMessages);
 
+		/*
+		 * The optimizer's shared metadata cache is not invalidated by the SI
+		 * messages, since backends only read those lazily. Evict the affected
+		 * entries now that our changes are visible to everyone.
+		 */
+		ProcessInvalidationMessagesMulti(&transInvalInfo->PriorCmdInvalidMsgs,
+										 MDSharedCacheProcessInvalidations);
+
 		if (transInvalInfo->RelcacheInitFileInval)
 			RelationCacheInitFilePostInvalidate();
 	}
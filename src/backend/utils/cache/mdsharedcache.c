@@ -0,0 +1,485 @@
+/*-------------------------------------------------------------------------
+ *
+ * mdsharedcache.c
+ *	  Shared-memory cache of serialized optimizer metadata objects.
+ *
+ * ORCA keeps its own metadata cache in each backend. That cache is private
+ * to the backend and is discarded wholesale on every catalog change, so each
+ * new session (and each session after any DDL) has to translate every
+ * relation, type, operator and statistics object it needs from the relcache
+ * all over again.
+ *
+ * This module keeps the serialized DXL form of those objects in shared
+ * memory, keyed by database and metadata id, so that a backend can fill its
+ * private ORCA cache from the work other backends already did. The cache is
+ * only maintained on the dispatcher, where ORCA runs.
+ *
+ * Each entry records the relation it was derived from, if any. Invalidation
+ * happens in the backend that committed the catalog change, right after the
+ * commit has become visible (see AtEOXact_Inval()):
+ *
+ * - A relcache invalidation of a relation evicts only the entries that
+ *	 depend on that relation.
+ * - A pg_statistic invalidation evicts the column statistics entries.
+ * - Any other change to a catalog that ORCA metadata is built from evicts
+ *	 all entries of that database.
+ *
+ * Every eviction bumps a generation counter. A backend remembers the
+ * generation it saw when its lookup missed, and the insertion of the object
+ * it then translated is discarded if the generation has moved on in the
+ * meantime, since the translation may have read catalog state that was
+ * invalidated while it was running. The generation alone does not protect
+ * against a backend that has not yet processed the invalidation messages
+ * behind an eviction it has already seen: its caches still hold the old
+ * catalog state. So after a miss, the backend processes its pending
+ * invalidations before it translates the object; the committing backend
+ * sends its messages before it evicts.
+ *
+ * The DXL strings are stored in a simple bump-allocated arena. Space of
+ * evicted entries is not reused until the cache runs empty; when an insert
+ * does not fit, the whole cache is reset.
+ *
+ * Portions Copyright (c) 2018-Present Pivotal Software, Inc.
+ *
+ * IDENTIFICATION
+ *	    src/backend/utils/cache/mdsharedcache.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/transam.h"
+#include "access/xact.h"
+#include "cdb/cdbvars.h"
+#include "miscadmin.h"
+#include "storage/lwlock.h"
+#include "storage/shmem.h"
+#include "utils/hsearch.h"
+#include "utils/inval.h"
+#include "utils/mdsharedcache.h"
+#include "utils/syscache.h"
+
+/* GUC: size of the shared cache in kB, 0 disables it */
+int			optimizer_shared_mdcache_size = 16384;
+
+/* Assumed average size of a cached object, used to size the hash table */
+#define MDSHAREDCACHE_AVG_ENTRY_SIZE	2048
+#define MDSHAREDCACHE_MIN_ENTRIES		128
+
+/*
+ * Max number of distinct relations evicted one by one per batch of
+ * invalidation messages; larger batches evict the whole database.
+ */
+#define MDSHAREDCACHE_MAX_BATCH_RELS	64
+
+typedef struct MDSharedCacheKey
+{
+	Oid			dbid;
+	char		mdid[MDSHAREDCACHE_KEYLEN];
+} MDSharedCacheKey;
+
+typedef struct MDSharedCacheEntry
+{
+	MDSharedCacheKey key;		/* hash key, must be first */
+	Oid			relid;			/* relation the object depends on, or InvalidOid */
+	bool		isstats;		/* column statistics object? */
+	Size		offset;			/* start of the DXL string in the arena */
+	Size		len;			/* length of the DXL string */
+} MDSharedCacheEntry;
+
+typedef struct MDSharedCacheHeader
+{
+	uint64		generation;		/* bumped on every eviction */
+	Size		used;			/* bytes of the arena handed out */
+	Size		capacity;		/* total bytes of the arena */
+	char		data[1];		/* VARIABLE LENGTH ARRAY */
+} MDSharedCacheHeader;
+
+/* Describes what a batch of invalidation messages evicts */
+typedef struct MDSharedCacheEviction
+{
+	bool		all;			/* evict every entry */
+	Oid			statsdb;		/* evict stats of this db, or InvalidOid */
+	bool		statsalldb;		/* evict stats of all databases */
+	Oid			db;				/* evict all entries of this db, or InvalidOid */
+	int			nrels;
+	Oid			reldbs[MDSHAREDCACHE_MAX_BATCH_RELS];
+	Oid			rels[MDSHAREDCACHE_MAX_BATCH_RELS];
+} MDSharedCacheEviction;
+
+static MDSharedCacheHeader *MDSharedCache = NULL;
+static HTAB *MDSharedCacheHash = NULL;
+
+static Size MDSharedCacheCapacity(void);
+static long MDSharedCacheMaxEntries(void);
+static void MDSharedCacheReset(void);
+static bool MDSharedCacheEntryIsEvicted(MDSharedCacheEntry *entry,
+						   MDSharedCacheEviction *eviction);
+static void MDSharedCacheEvict(MDSharedCacheEviction *eviction);
+
+static Size
+MDSharedCacheCapacity(void)
+{
+	if (Gp_role != GP_ROLE_DISPATCH)
+		return 0;
+
+	return MAXALIGN(mul_size((Size) optimizer_shared_mdcache_size, 1024));
+}
+
+static long
+MDSharedCacheMaxEntries(void)
+{
+	return Max(MDSharedCacheCapacity() / MDSHAREDCACHE_AVG_ENTRY_SIZE,
+			   MDSHAREDCACHE_MIN_ENTRIES);
+}
+
+/*
+ * MDSharedCacheShmemSize --- report amount of shared memory space needed
+ */
+Size
+MDSharedCacheShmemSize(void)
+{
+	Size		size;
+
+	if (MDSharedCacheCapacity() == 0)
+		return 0;
+
+	size = add_size(offsetof(MDSharedCacheHeader, data), MDSharedCacheCapacity());
+	size = add_size(size, hash_estimate_size(MDSharedCacheMaxEntries(),
+											 sizeof(MDSharedCacheEntry)));
+	return size;
+}
+
+/*
+ * MDSharedCacheShmemInit --- initialize this module's shared memory
+ */
+void
+MDSharedCacheShmemInit(void)
+{
+	HASHCTL		info;
+	bool		found;
+	Size		capacity = MDSharedCacheCapacity();
+
+	if (capacity == 0)
+		return;
+
+	MDSharedCache = (MDSharedCacheHeader *)
+		ShmemInitStruct("Optimizer Shared Metadata Cache",
+						add_size(offsetof(MDSharedCacheHeader, data), capacity),
+						&found);
+	if (!found)
+	{
+		MDSharedCache->generation = 0;
+		MDSharedCache->used = 0;
+		MDSharedCache->capacity = capacity;
+	}
+
+	MemSet(&info, 0, sizeof(info));
+	info.keysize = sizeof(MDSharedCacheKey);
+	info.entrysize = sizeof(MDSharedCacheEntry);
+	info.hash = tag_hash;
+
+	MDSharedCacheHash = ShmemInitHash("Optimizer Shared Metadata Cache Hash",
+									  MDSharedCacheMaxEntries(),
+									  MDSharedCacheMaxEntries(),
+									  &info,
+									  HASH_ELEM | HASH_FUNCTION);
+}
+
+/*
+ * Can the current backend use the shared cache?
+ *
+ * A transaction that has modified the catalogs sees its own uncommitted
+ * changes, which must neither be published to nor hidden by the shared
+ * cache.
+ */
+bool
+MDSharedCacheIsUsable(void)
+{
+	return MDSharedCache != NULL &&
+		!TransactionIdIsValid(GetTopTransactionIdIfAny());
+}
+
+static void
+MDSharedCacheMakeKey(MDSharedCacheKey *key, const char *mdid)
+{
+	MemSet(key, 0, sizeof(MDSharedCacheKey));
+	key->dbid = MyDatabaseId;
+	strlcpy(key->mdid, mdid, MDSHAREDCACHE_KEYLEN);
+}
+
+/*
+ * Look up the serialized metadata object with the given id.
+ *
+ * Returns a palloc'd copy of the object and its length, or NULL if it is
+ * not cached. In either case *generation is set to the cache generation that
+ * must be passed to MDSharedCacheInsert() for an object translated after a
+ * miss. On a miss, the invalidations of all evictions up to that generation
+ * have been processed when this returns, so the caller's translation cannot
+ * see catalog state older than the generation.
+ */
+char *
+MDSharedCacheLookup(const char *mdid, Size *len, uint64 *generation)
+{
+	MDSharedCacheKey key;
+	MDSharedCacheEntry *entry;
+	char	   *result = NULL;
+
+	Assert(MDSharedCache != NULL);
+
+	if (strlen(mdid) >= MDSHAREDCACHE_KEYLEN)
+	{
+		*generation = 0;
+		return NULL;
+	}
+
+	MDSharedCacheMakeKey(&key, mdid);
+
+	LWLockAcquire(OptMDSharedCacheLock, LW_SHARED);
+
+	*generation = MDSharedCache->generation;
+
+	entry = (MDSharedCacheEntry *) hash_search(MDSharedCacheHash, &key,
+											   HASH_FIND, NULL);
+	if (entry != NULL)
+	{
+		/*
+		 * Copying into local memory may fail. That's fine, the lock is
+		 * released on error.
+		 */
+		result = palloc(entry->len);
+		memcpy(result, MDSharedCache->data + entry->offset, entry->len);
+		*len = entry->len;
+	}
+
+	LWLockRelease(OptMDSharedCacheLock);
+
+	if (result == NULL)
+		AcceptInvalidationMessages();
+
+	return result;
+}
+
+/*
+ * Remove all entries and reclaim the whole arena. Caller must hold the lock
+ * exclusively.
+ */
+static void
+MDSharedCacheReset(void)
+{
+	HASH_SEQ_STATUS status;
+	MDSharedCacheEntry *entry;
+
+	hash_seq_init(&status, MDSharedCacheHash);
+	while ((entry = (MDSharedCacheEntry *) hash_seq_search(&status)) != NULL)
+		hash_search(MDSharedCacheHash, &entry->key, HASH_REMOVE, NULL);
+
+	MDSharedCache->used = 0;
+}
+
+/*
+ * Publish a serialized metadata object that was translated after a miss.
+ *
+ * 'relid' is the relation the object was derived from, or InvalidOid if it
+ * can only be invalidated by a database-wide eviction. The object is dropped
+ * silently if anything was evicted since 'generation' was obtained from
+ * MDSharedCacheLookup(), or if it is too large for the cache. The generation
+ * is checked again under the exclusive lock that the insertion itself holds,
+ * so an eviction cannot slip in between the check and the insertion.
+ */
+void
+MDSharedCacheInsert(const char *mdid, Oid relid, bool isstats,
+					uint64 generation, const char *data, Size len)
+{
+	MDSharedCacheKey key;
+	MDSharedCacheEntry *entry;
+	bool		found;
+
+	Assert(MDSharedCache != NULL);
+
+	if (strlen(mdid) >= MDSHAREDCACHE_KEYLEN ||
+		MAXALIGN(len) > MDSharedCache->capacity)
+		return;
+
+	MDSharedCacheMakeKey(&key, mdid);
+
+	LWLockAcquire(OptMDSharedCacheLock, LW_EXCLUSIVE);
+
+	if (MDSharedCache->generation != generation)
+	{
+		LWLockRelease(OptMDSharedCacheLock);
+		return;
+	}
+
+	if (MDSharedCache->used + MAXALIGN(len) > MDSharedCache->capacity)
+		MDSharedCacheReset();
+
+	entry = (MDSharedCacheEntry *) hash_search(MDSharedCacheHash, &key,
+											   HASH_ENTER_NULL, &found);
+	if (entry == NULL)
+	{
+		/* out of hash table entries, start over */
+		MDSharedCacheReset();
+		entry = (MDSharedCacheEntry *) hash_search(MDSharedCacheHash, &key,
+												   HASH_ENTER_NULL, &found);
+	}
+
+	/* someone else may have beaten us to it */
+	if (entry != NULL && !found)
+	{
+		entry->relid = relid;
+		entry->isstats = isstats;
+		entry->offset = MDSharedCache->used;
+		entry->len = len;
+		memcpy(MDSharedCache->data + entry->offset, data, len);
+		MDSharedCache->used += MAXALIGN(len);
+	}
+
+	LWLockRelease(OptMDSharedCacheLock);
+}
+
+static bool
+MDSharedCacheEntryIsEvicted(MDSharedCacheEntry *entry,
+							MDSharedCacheEviction *eviction)
+{
+	int			i;
+
+	if (eviction->all || entry->key.dbid == eviction->db)
+		return true;
+
+	if (entry->isstats &&
+		(eviction->statsalldb || entry->key.dbid == eviction->statsdb))
+		return true;
+
+	if (!OidIsValid(entry->relid))
+		return false;
+
+	for (i = 0; i < eviction->nrels; i++)
+	{
+		if (entry->relid == eviction->rels[i] &&
+			(entry->key.dbid == eviction->reldbs[i] ||
+			 !OidIsValid(eviction->reldbs[i])))
+			return true;
+	}
+
+	return false;
+}
+
+static void
+MDSharedCacheEvict(MDSharedCacheEviction *eviction)
+{
+	HASH_SEQ_STATUS status;
+	MDSharedCacheEntry *entry;
+
+	LWLockAcquire(OptMDSharedCacheLock, LW_EXCLUSIVE);
+
+	MDSharedCache->generation++;
+
+	hash_seq_init(&status, MDSharedCacheHash);
+	while ((entry = (MDSharedCacheEntry *) hash_seq_search(&status)) != NULL)
+	{
+		if (MDSharedCacheEntryIsEvicted(entry, eviction))
+			hash_search(MDSharedCacheHash, &entry->key, HASH_REMOVE, NULL);
+	}
+
+	if (hash_get_num_entries(MDSharedCacheHash) == 0)
+		MDSharedCache->used = 0;
+
+	LWLockRelease(OptMDSharedCacheLock);
+}
+
+/*
+ * Evict the entries affected by a batch of committed invalidation messages.
+ *
+ * This is called at commit, after the transaction has become visible to
+ * other backends, so it must not throw errors.
+ */
+void
+MDSharedCacheProcessInvalidations(const SharedInvalidationMessage *msgs, int n)
+{
+	MDSharedCacheEviction eviction;
+	bool		needed = false;
+	int			i;
+
+	if (MDSharedCache == NULL)
+		return;
+
+	MemSet(&eviction, 0, sizeof(eviction));
+
+	for (i = 0; i < n && !eviction.all; i++)
+	{
+		const SharedInvalidationMessage *msg = &msgs[i];
+		Oid			dbid = InvalidOid;
+		bool		evictdb = false;
+
+		if (msg->id == STATRELATTINH)
+		{
+			if (OidIsValid(msg->cc.dbId))
+				eviction.statsdb = msg->cc.dbId;
+			else
+				eviction.statsalldb = true;
+			needed = true;
+			continue;
+		}
+
+		switch (msg->id)
+		{
+			/*
+			 * Catalogs whose contents end up in ORCA metadata objects other
+			 * than relations. These objects are not tracked individually.
+			 * The list mirrors the invalidation callbacks registered by the
+			 * ORCA translator.
+			 */
+			case AGGFNOID:
+			case AMOPOPID:
+			case CASTSOURCETARGET:
+			case OPEROID:
+			case OPFAMILYOID:
+			case PARTOID:
+			case PARTRULEOID:
+			case TYPEOID:
+			case PROCOID:
+				dbid = msg->cc.dbId;
+				evictdb = true;
+				break;
+
+			case SHAREDINVALCATALOG_ID:
+				dbid = msg->cat.dbId;
+				evictdb = true;
+				break;
+
+			case SHAREDINVALRELCACHE_ID:
+				dbid = msg->rc.dbId;
+				if (!OidIsValid(msg->rc.relId))
+					evictdb = true;
+				else if (eviction.nrels < MDSHAREDCACHE_MAX_BATCH_RELS)
+				{
+					eviction.reldbs[eviction.nrels] = dbid;
+					eviction.rels[eviction.nrels] = msg->rc.relId;
+					eviction.nrels++;
+				}
+				else
+					evictdb = true;
+				needed = true;
+				break;
+
+			default:
+				break;
+		}
+
+		if (evictdb)
+		{
+			needed = true;
+
+			/* a shared catalog, or a second database: evict everything */
+			if (!OidIsValid(dbid) ||
+				(OidIsValid(eviction.db) && eviction.db != dbid))
+				eviction.all = true;
+			else
+				eviction.db = dbid;
+		}
+	}
+
+	if (needed)
+		MDSharedCacheEvict(&eviction);
+}
@@ -0,0 +1,688 @@
+/*-------------------------------------------------------------------------
+ *
+ * optplancache.c
+ *	  Backend-local cache of plans produced by the optimizer (ORCA).
+ *
+ * ORCA is invoked again every time a statement is planned, even if exactly
+ * the same query was optimized a moment ago, e.g. for each execution of a
+ * prepared statement with a custom plan. For short queries the optimizer
+ * then dominates latency.
+ *
+ * This cache keeps the DXL plans produced by ORCA, keyed on the text form of
+ * the preprocessed query tree with its literals (in which bound parameter
+ * values have already been folded) taken out, the number of segments and the
+ * values of all optimizer_* settings. Each plan remembers the literals of the
+ * query it was optimized for. On a hit, the caller skips optimization, goes
+ * straight to the DXL to PlannedStmt translation, and binds the literals of
+ * the current query into the constants of the plan that came from the cached
+ * literals (see OptPlanCacheBindLiterals). Like a generic plan of a prepared
+ * statement, the plan is then not necessarily the best one for the new
+ * literals. That is only done if each constant of the plan can be traced
+ * back to a single literal of the query: ORCA may fold, merge or drop
+ * predicates depending on their values, e.g. turn a > 2 AND a > 5 into
+ * a > 5, and a plan in which that may have happened is only reused for
+ * exactly the literals it was optimized for.
+ *
+ * Plans are invalidated through the same callbacks as the ORCA metadata
+ * cache: a relcache invalidation, e.g. after ANALYZE, DDL or an index build,
+ * discards the plans that use the relation, and a change to any of the
+ * other catalogs the metadata cache depends on, statistics included,
+ * discards all plans. So does a change in the number of segments. Entries
+ * are evicted in LRU order once the cache exceeds optimizer_plan_cache_size.
+ *
+ * Portions Copyright (c) 2018-Present Pivotal Software, Inc.
+ *
+ * IDENTIFICATION
+ *	    src/backend/utils/cache/optplancache.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include <ctype.h>
+
+#include "access/hash.h"
+#include "catalog/pg_type.h"
+#include "lib/dllist.h"
+#include "lib/stringinfo.h"
+#include "nodes/nodeFuncs.h"
+#include "optimizer/walkers.h"
+#include "utils/datum.h"
+#include "utils/guc_tables.h"
+#include "utils/hsearch.h"
+#include "utils/memutils.h"
+#include "utils/optplancache.h"
+
+/* GUC: size of the plan cache in kB, 0 disables it */
+int			optimizer_plan_cache_size = 0;
+
+#define OPTPLANCACHE_INITIAL_ENTRIES	64
+
+/* settings that are part of the cache key */
+#define OPTPLANCACHE_GUC_PREFIX		"optimizer"
+
+typedef struct OptPlanCacheEntry
+{
+	char	   *key;			/* hash key, must be first */
+	char	   *plan;			/* DXL of the plan */
+	List	   *literals;		/* Consts the plan was optimized for */
+	List	   *relids;			/* OIDs of the relations the plan uses */
+	Size		size;			/* memory charged to this entry */
+	Dlelem		lru;			/* position in the LRU list */
+} OptPlanCacheEntry;
+
+typedef struct OptPlanCacheKeyContext
+{
+	List	   *literals;		/* Consts taken out of the key */
+	List	   *fixed;			/* Consts left in the key */
+	List	   *keep;			/* values of Consts to leave in the key */
+} OptPlanCacheKeyContext;
+
+static MemoryContext OptPlanCacheContext = NULL;
+static HTAB *OptPlanCacheHash = NULL;
+static Dllist OptPlanCacheLRU;
+static Size OptPlanCacheUsed = 0;
+
+/* number of segments the cached plans were made for */
+static int	OptPlanCacheSegments = -1;
+
+static int64 OptPlanCacheHits = 0;
+static int64 OptPlanCacheMisses = 0;
+
+/* optimizer_* settings, collected on first use */
+static struct config_generic **OptPlanCacheGucs = NULL;
+static int	OptPlanCacheNumGucs = 0;
+
+static uint32
+OptPlanCacheHashKey(const void *key, Size keysize)
+{
+	const char *str = *(char *const *) key;
+
+	return DatumGetUInt32(hash_any((const unsigned char *) str, strlen(str)));
+}
+
+static int
+OptPlanCacheMatchKey(const void *key1, const void *key2, Size keysize)
+{
+	return strcmp(*(char *const *) key1, *(char *const *) key2);
+}
+
+static void
+OptPlanCacheInit(void)
+{
+	HASHCTL		info;
+
+	if (OptPlanCacheContext == NULL)
+		OptPlanCacheContext = AllocSetContextCreate(TopMemoryContext,
+													"ORCA plan cache",
+													ALLOCSET_DEFAULT_MINSIZE,
+													ALLOCSET_DEFAULT_INITSIZE,
+													ALLOCSET_DEFAULT_MAXSIZE);
+
+	MemSet(&info, 0, sizeof(info));
+	info.keysize = sizeof(char *);
+	info.entrysize = sizeof(OptPlanCacheEntry);
+	info.hash = OptPlanCacheHashKey;
+	info.match = OptPlanCacheMatchKey;
+	info.hcxt = OptPlanCacheContext;
+
+	OptPlanCacheHash = hash_create("ORCA plan cache",
+								   OPTPLANCACHE_INITIAL_ENTRIES,
+								   &info,
+								   HASH_ELEM | HASH_FUNCTION | HASH_COMPARE | HASH_CONTEXT);
+	DLInitList(&OptPlanCacheLRU);
+	OptPlanCacheUsed = 0;
+}
+
+static void
+OptPlanCacheCollectGucs(void)
+{
+	struct config_generic **gucs = get_guc_variables();
+	int			ngucs = get_num_guc_variables();
+	int			i;
+
+	OptPlanCacheGucs = (struct config_generic **)
+		MemoryContextAlloc(TopMemoryContext, ngucs * sizeof(struct config_generic *));
+
+	/* memory limits, like the size of this cache, don't affect plans */
+	for (i = 0; i < ngucs; i++)
+	{
+		if (strncmp(gucs[i]->name, OPTPLANCACHE_GUC_PREFIX,
+					strlen(OPTPLANCACHE_GUC_PREFIX)) == 0 &&
+			(gucs[i]->flags & GUC_UNIT_MEMORY) == 0)
+			OptPlanCacheGucs[OptPlanCacheNumGucs++] = gucs[i];
+	}
+}
+
+static bool
+OptPlanCacheConstEqual(Const *c1, Const *c2)
+{
+	if (c1->consttype != c2->consttype ||
+		c1->constisnull != c2->constisnull)
+		return false;
+	if (c1->constisnull)
+		return true;
+
+	return datumIsEqual(c1->constvalue, c2->constvalue,
+						c1->constbyval, c1->constlen);
+}
+
+static bool
+OptPlanCacheConstInList(Const *con, List *consts)
+{
+	ListCell   *lc;
+
+	foreach(lc, consts)
+	{
+		if (OptPlanCacheConstEqual(con, (Const *) lfirst(lc)))
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * Replace the literals of a query tree with placeholders, collecting them in
+ * order. The placeholders are Params numbered 0, which no real parameter is.
+ *
+ * Some constants are left in the key, because the plan depends on their
+ * value in ways that binding other values into its constants can't fix, or
+ * because ORCA makes up equal constants of its own: LIMIT and OFFSET counts,
+ * booleans and NULLs. So are the literals that equal any of those in
+ * context->keep, as they can't be told apart from them in the plan.
+ */
+static Node *
+OptPlanCacheNormalizeMutator(Node *node, OptPlanCacheKeyContext *context)
+{
+	if (node == NULL)
+		return NULL;
+
+	if (IsA(node, Const))
+	{
+		Const	   *con = (Const *) node;
+		Param	   *param;
+
+		if (con->constisnull || con->consttype == BOOLOID)
+		{
+			context->fixed = lappend(context->fixed, con);
+			return (Node *) copyObject(con);
+		}
+		if (OptPlanCacheConstInList(con, context->keep))
+			return (Node *) copyObject(con);
+
+		context->literals = lappend(context->literals, copyObject(con));
+
+		param = makeNode(Param);
+		param->paramkind = PARAM_EXTERN;
+		param->paramid = 0;
+		param->paramtype = con->consttype;
+		param->paramtypmod = con->consttypmod;
+
+		return (Node *) param;
+	}
+
+	if (IsA(node, Query))
+	{
+		Query	   *query = (Query *) node;
+		Query	   *newquery = makeNode(Query);
+
+		memcpy(newquery, query, sizeof(Query));
+		newquery->limitOffset = NULL;
+		newquery->limitCount = NULL;
+		query_tree_mutator(newquery, OptPlanCacheNormalizeMutator,
+						   (void *) context, QTW_DONT_COPY_QUERY);
+		newquery->limitOffset = query->limitOffset;
+		newquery->limitCount = query->limitCount;
+
+		if (query->limitOffset != NULL)
+			context->fixed = list_concat(context->fixed,
+										 extract_nodes_expression(query->limitOffset, T_Const, false));
+		if (query->limitCount != NULL)
+			context->fixed = list_concat(context->fixed,
+										 extract_nodes_expression(query->limitCount, T_Const, false));
+
+		return (Node *) newquery;
+	}
+
+	return expression_tree_mutator(node, OptPlanCacheNormalizeMutator,
+								   (void *) context);
+}
+
+/*
+ * Append the text form of a query tree to a key, without the parse
+ * locations, which move with the length of the literals.
+ */
+static void
+OptPlanCacheAppendQuery(StringInfo buf, Query *query)
+{
+	char	   *querystr = nodeToString(query);
+	const char *tag = " :location ";
+	char	   *p = querystr;
+	char	   *loc;
+
+	while ((loc = strstr(p, tag)) != NULL)
+	{
+		loc += strlen(tag);
+		appendBinaryStringInfo(buf, p, loc - p);
+		appendStringInfoChar(buf, '?');
+		if (*loc == '-')
+			loc++;
+		while (isdigit((unsigned char) *loc))
+			loc++;
+		p = loc;
+	}
+	appendStringInfoString(buf, p);
+
+	pfree(querystr);
+}
+
+/*
+ * Build the cache key of a query that is about to be optimized, and collect
+ * the literals that are not part of the key into *literals.
+ *
+ * Plans made for another number of segments are discarded, as the cluster
+ * has been resized since.
+ *
+ * The results are palloc'd in the current memory context.
+ */
+char *
+OptPlanCacheMakeKey(Query *query, int nsegments, List **literals)
+{
+	StringInfoData buf;
+	OptPlanCacheKeyContext context;
+	Query	   *normquery;
+	int			i;
+
+	if (OptPlanCacheGucs == NULL)
+		OptPlanCacheCollectGucs();
+
+	if (nsegments != OptPlanCacheSegments)
+	{
+		OptPlanCacheReset();
+		OptPlanCacheSegments = nsegments;
+	}
+
+	/* find the constants to leave in the key, then the literals */
+	context.literals = NIL;
+	context.fixed = NIL;
+	context.keep = NIL;
+	OptPlanCacheNormalizeMutator((Node *) query, &context);
+
+	context.keep = context.fixed;
+	context.literals = NIL;
+	context.fixed = NIL;
+	normquery = (Query *)
+		OptPlanCacheNormalizeMutator((Node *) query, &context);
+	*literals = context.literals;
+
+	initStringInfo(&buf);
+	appendStringInfo(&buf, "%d", nsegments);
+
+	for (i = 0; i < OptPlanCacheNumGucs; i++)
+	{
+		struct config_generic *conf = OptPlanCacheGucs[i];
+
+		appendStringInfoChar(&buf, ' ');
+
+		switch (conf->vartype)
+		{
+			case PGC_BOOL:
+				appendStringInfoChar(&buf,
+									 *((struct config_bool *) conf)->variable ? 't' : 'f');
+				break;
+
+			case PGC_INT:
+				appendStringInfo(&buf, "%d", *((struct config_int *) conf)->variable);
+				break;
+
+			case PGC_REAL:
+				appendStringInfo(&buf, "%.17g", *((struct config_real *) conf)->variable);
+				break;
+
+			case PGC_STRING:
+				{
+					char	   *val = *((struct config_string *) conf)->variable;
+
+					/* quote, so that the key stays unambiguous */
+					appendStringInfo(&buf, "\"%s\"", val ? val : "");
+					break;
+				}
+
+			case PGC_ENUM:
+				appendStringInfo(&buf, "%d", *((struct config_enum *) conf)->variable);
+				break;
+		}
+	}
+
+	appendStringInfoChar(&buf, ' ');
+	OptPlanCacheAppendQuery(&buf, normquery);
+
+	return buf.data;
+}
+
+/*
+ * Look up the DXL plan of a query.
+ *
+ * The returned string belongs to the cache and is only valid until the next
+ * call to any function of this module, or the next invalidation. The
+ * literals the plan was optimized for are copied into *literals, in the
+ * current memory context.
+ *
+ * A plan that is found only counts as a hit once its literals have been
+ * bound, see OptPlanCacheBindLiterals.
+ */
+const char *
+OptPlanCacheLookup(const char *key, List **literals)
+{
+	OptPlanCacheEntry *entry;
+
+	if (OptPlanCacheHash == NULL)
+		OptPlanCacheInit();
+
+	entry = (OptPlanCacheEntry *) hash_search(OptPlanCacheHash, &key,
+											  HASH_FIND, NULL);
+	if (entry == NULL)
+	{
+		OptPlanCacheMisses++;
+		return NULL;
+	}
+
+	DLMoveToFront(&entry->lru);
+	*literals = (List *) copyObject(entry->literals);
+
+	return entry->plan;
+}
+
+/*
+ * Is there a plan node that was directly dispatched for its constants, or
+ * that scans partitions selected for its constants?
+ */
+static bool
+OptPlanCacheSelectsForConsts(Plan *plan)
+{
+	ListCell   *lc;
+
+	if (plan->directDispatch.isDirectDispatch)
+		return true;
+
+	foreach(lc, extract_nodes_plan(plan, T_Motion, true))
+	{
+		if (((Plan *) lfirst(lc))->directDispatch.isDirectDispatch)
+			return true;
+	}
+
+	foreach(lc, extract_nodes_plan(plan, T_PartitionSelector, true))
+	{
+		if (((PartitionSelector *) lfirst(lc))->staticSelection)
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * Are all of the given literals different from each other?
+ */
+static bool
+OptPlanCacheLiteralsDistinct(List *literals)
+{
+	ListCell   *lc1;
+	ListCell   *lc2;
+
+	foreach(lc1, literals)
+	{
+		for_each_cell(lc2, lnext(lc1))
+		{
+			if (OptPlanCacheConstEqual((Const *) lfirst(lc1), (Const *) lfirst(lc2)))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * Bind the literals of the query being planned into a plan translated from
+ * the cache, which was optimized for the literals planLiterals.
+ *
+ * Every constant of the plan that equals one of planLiterals, in type and
+ * value, gets the value of the corresponding one of queryLiterals. The
+ * values identify the literals, so that fails if two of planLiterals are
+ * equal: a constant of the plan could then have come from either, and
+ * the other may have been merged away, e.g. in a > 2 AND a > 5 AND b = 2.
+ * It also fails if a literal of the plan turns up nowhere in it, e.g.
+ * because ORCA evaluated an expression with it or dropped a redundant
+ * predicate, or if the plan was dispatched or had its partitions selected
+ * for its constants. The caller then optimizes the query instead.
+ *
+ * Returns whether the plan can be used, and counts a hit or a miss.
+ */
+bool
+OptPlanCacheBindLiterals(PlannedStmt *stmt, List *planLiterals,
+						 List *queryLiterals)
+{
+	List	   *plans;
+	List	   *consts = NIL;
+	Const	  **binding;
+	bool	   *used;
+	ListCell   *lc;
+	ListCell   *lcp;
+	ListCell   *lcq;
+	int			nliterals = list_length(planLiterals);
+	int			i;
+	bool		equal = true;
+
+	Assert(list_length(queryLiterals) == nliterals);
+
+	forboth(lcp, planLiterals, lcq, queryLiterals)
+	{
+		if (!OptPlanCacheConstEqual((Const *) lfirst(lcp), (Const *) lfirst(lcq)))
+		{
+			equal = false;
+			break;
+		}
+	}
+
+	/* the plan was made for exactly these literals */
+	if (equal)
+	{
+		OptPlanCacheHits++;
+		return true;
+	}
+
+	if (!OptPlanCacheLiteralsDistinct(planLiterals))
+	{
+		OptPlanCacheMisses++;
+		return false;
+	}
+
+	plans = lcons(stmt->planTree, list_copy(stmt->subplans));
+	foreach(lc, plans)
+	{
+		Plan	   *plan = (Plan *) lfirst(lc);
+
+		if (plan == NULL)
+			continue;
+		if (OptPlanCacheSelectsForConsts(plan))
+		{
+			OptPlanCacheMisses++;
+			return false;
+		}
+		consts = list_concat(consts, extract_nodes_plan(plan, T_Const, true));
+	}
+
+	/* map each constant of the plan to the literal it is to take */
+	binding = (Const **) palloc0(list_length(consts) * sizeof(Const *));
+	used = (bool *) palloc0(nliterals * sizeof(bool));
+	i = 0;
+	foreach(lc, consts)
+	{
+		Const	   *con = (Const *) lfirst(lc);
+		int			j = 0;
+
+		forboth(lcp, planLiterals, lcq, queryLiterals)
+		{
+			if (OptPlanCacheConstEqual(con, (Const *) lfirst(lcp)))
+			{
+				binding[i] = (Const *) lfirst(lcq);
+				used[j] = true;
+				break;
+			}
+			j++;
+		}
+		i++;
+	}
+
+	for (i = 0; i < nliterals; i++)
+	{
+		if (!used[i])
+		{
+			OptPlanCacheMisses++;
+			return false;
+		}
+	}
+
+	i = 0;
+	foreach(lc, consts)
+	{
+		Const	   *con = (Const *) lfirst(lc);
+
+		if (binding[i] != NULL)
+		{
+			con->constvalue = datumCopy(binding[i]->constvalue,
+										binding[i]->constbyval,
+										binding[i]->constlen);
+			con->constisnull = binding[i]->constisnull;
+		}
+		i++;
+	}
+
+	pfree(binding);
+	pfree(used);
+	list_free(consts);
+	list_free(plans);
+
+	OptPlanCacheHits++;
+	return true;
+}
+
+static void
+OptPlanCacheRemove(OptPlanCacheEntry *entry)
+{
+	char	   *key = entry->key;
+
+	DLRemove(&entry->lru);
+	OptPlanCacheUsed -= entry->size;
+	pfree(entry->plan);
+	list_free_deep(entry->literals);
+	list_free(entry->relids);
+
+	hash_search(OptPlanCacheHash, &key, HASH_REMOVE, NULL);
+	pfree(key);
+}
+
+/*
+ * Remember the DXL plan of a query, optimized for the given literals and
+ * using the given relations, evicting the least recently used plans if the
+ * cache grows beyond its size limit. A plan cached before under the same
+ * key is replaced.
+ */
+void
+OptPlanCacheInsert(const char *key, const char *plan, List *literals,
+				   List *relids)
+{
+	OptPlanCacheEntry *entry;
+	MemoryContext oldcxt;
+	char	   *keycopy;
+	Size		size;
+	Size		limit = (Size) optimizer_plan_cache_size * 1024L;
+	bool		found;
+
+	size = strlen(key) + strlen(plan) + 2 + sizeof(OptPlanCacheEntry);
+	if (size > limit)
+		return;
+
+	if (OptPlanCacheHash == NULL)
+		OptPlanCacheInit();
+
+	entry = (OptPlanCacheEntry *) hash_search(OptPlanCacheHash, &key,
+											  HASH_FIND, NULL);
+	if (entry != NULL)
+		OptPlanCacheRemove(entry);
+
+	while (OptPlanCacheUsed + size > limit)
+	{
+		Dlelem	   *victim = DLGetTail(&OptPlanCacheLRU);
+
+		Assert(victim != NULL);
+		OptPlanCacheRemove((OptPlanCacheEntry *) DLE_VAL(victim));
+	}
+
+	keycopy = MemoryContextStrdup(OptPlanCacheContext, key);
+
+	entry = (OptPlanCacheEntry *) hash_search(OptPlanCacheHash, &keycopy,
+											  HASH_ENTER, &found);
+	Assert(!found);
+
+	oldcxt = MemoryContextSwitchTo(OptPlanCacheContext);
+	entry->plan = pstrdup(plan);
+	entry->literals = (List *) copyObject(literals);
+	entry->relids = list_copy(relids);
+	MemoryContextSwitchTo(oldcxt);
+
+	entry->size = size;
+	DLInitElem(&entry->lru, entry);
+	DLAddHead(&OptPlanCacheLRU, &entry->lru);
+
+	OptPlanCacheUsed += size;
+}
+
+/*
+ * Discard the cached plans that use a relation, or all plans if relid is
+ * InvalidOid. Called on relcache invalidations.
+ */
+void
+OptPlanCacheInvalidateRelation(Oid relid)
+{
+	HASH_SEQ_STATUS status;
+	OptPlanCacheEntry *entry;
+
+	if (OptPlanCacheHash == NULL)
+		return;
+
+	if (!OidIsValid(relid))
+	{
+		OptPlanCacheReset();
+		return;
+	}
+
+	hash_seq_init(&status, OptPlanCacheHash);
+	while ((entry = (OptPlanCacheEntry *) hash_seq_search(&status)) != NULL)
+	{
+		if (list_member_oid(entry->relids, relid))
+			OptPlanCacheRemove(entry);
+	}
+}
+
+/*
+ * Discard all cached plans.
+ */
+void
+OptPlanCacheReset(void)
+{
+	if (OptPlanCacheHash == NULL)
+		return;
+
+	MemoryContextReset(OptPlanCacheContext);
+	OptPlanCacheHash = NULL;
+	OptPlanCacheUsed = 0;
+}
+
+void
+OptPlanCacheGetStats(int64 *hits, int64 *misses, int *entries, int64 *size)
+{
+	*hits = OptPlanCacheHits;
+	*misses = OptPlanCacheMisses;
+	*entries = OptPlanCacheHash ? (int) hash_get_num_entries(OptPlanCacheHash) : 0;
+	*size = (int64) OptPlanCacheUsed;
+}
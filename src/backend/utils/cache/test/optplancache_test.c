@@ -0,0 +1,270 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include "cmockery.h"
+
+#include "../optplancache.c"
+
+#include "catalog/pg_operator.h"
+#include "nodes/makefuncs.h"
+#include "optimizer/clauses.h"
+
+static Const *
+int4_const(int32 value)
+{
+	return makeConst(INT4OID, -1, sizeof(int32), Int32GetDatum(value),
+					 false, true);
+}
+
+static Const *
+int8_const(int64 value)
+{
+	return makeConst(INT8OID, -1, sizeof(int64), Int64GetDatum(value),
+					 false, FLOAT8PASSBYVAL);
+}
+
+/*
+ * SELECT ... FROM t WHERE col = value [LIMIT limit]
+ */
+static Query *
+make_query(Const *value, Const *limit)
+{
+	Query	   *query = makeNode(Query);
+	Var		   *var = makeVar(1, 1, value->consttype, -1, 0);
+	Oid			opno = value->consttype == INT8OID ?
+		Int8EqualOperator : Int4EqualOperator;
+
+	query->commandType = CMD_SELECT;
+	query->jointree = makeFromExpr(NIL,
+								   (Node *) make_opclause(opno, BOOLOID, false,
+														  (Expr *) var,
+														  (Expr *) value));
+	query->limitCount = (Node *) limit;
+
+	return query;
+}
+
+/*
+ * A plan that returns col = value for a constant col.
+ */
+static PlannedStmt *
+make_plan(int32 col, int32 value)
+{
+	PlannedStmt *stmt = makeNode(PlannedStmt);
+	Result	   *result = makeNode(Result);
+
+	result->resconstantqual =
+		(Node *) list_make1(make_opclause(Int4EqualOperator, BOOLOID, false,
+										  (Expr *) int4_const(col),
+										  (Expr *) int4_const(value)));
+	stmt->planTree = (Plan *) result;
+
+	return stmt;
+}
+
+static int32
+plan_value(PlannedStmt *stmt)
+{
+	OpExpr	   *op = linitial((List *) ((Result *) stmt->planTree)->resconstantqual);
+
+	return DatumGetInt32(((Const *) lsecond(op->args))->constvalue);
+}
+
+static int
+num_entries(void)
+{
+	int64		hits;
+	int64		misses;
+	int			entries;
+	int64		size;
+
+	OptPlanCacheGetStats(&hits, &misses, &entries, &size);
+	return entries;
+}
+
+void
+test__OptPlanCacheMakeKey__Literals(void **state)
+{
+	List	   *literals5;
+	List	   *literals7;
+	List	   *literals;
+	char	   *key5 = OptPlanCacheMakeKey(make_query(int4_const(5), NULL), 3, &literals5);
+	char	   *key7 = OptPlanCacheMakeKey(make_query(int4_const(7), NULL), 3, &literals7);
+	char	   *key;
+
+	/* queries that differ in their literals share a key */
+	assert_string_equal(key5, key7);
+	assert_int_equal(list_length(literals5), 1);
+	assert_int_equal(DatumGetInt32(((Const *) linitial(literals5))->constvalue), 5);
+	assert_int_equal(DatumGetInt32(((Const *) linitial(literals7))->constvalue), 7);
+
+	/* but not with a query that compares to NULL */
+	key = OptPlanCacheMakeKey(make_query(makeConst(INT4OID, -1, sizeof(int32),
+												   (Datum) 0, true, true),
+										 NULL),
+							  3, &literals);
+	assert_string_not_equal(key, key5);
+	assert_int_equal(list_length(literals), 0);
+
+	/* nor with the same query for another number of segments */
+	key = OptPlanCacheMakeKey(make_query(int4_const(5), NULL), 4, &literals);
+	assert_string_not_equal(key, key5);
+}
+
+void
+test__OptPlanCacheMakeKey__Limit(void **state)
+{
+	List	   *literals;
+	char	   *key5 = OptPlanCacheMakeKey(make_query(int8_const(5), int8_const(5)), 3, &literals);
+	char	   *key7;
+	char	   *key9;
+
+	/* a literal equal to the LIMIT count can't be told apart from it */
+	assert_int_equal(list_length(literals), 0);
+
+	key7 = OptPlanCacheMakeKey(make_query(int8_const(7), int8_const(5)), 3, &literals);
+	assert_int_equal(list_length(literals), 1);
+	assert_string_not_equal(key5, key7);
+
+	key9 = OptPlanCacheMakeKey(make_query(int8_const(9), int8_const(5)), 3, &literals);
+	assert_string_equal(key7, key9);
+
+	/* the LIMIT count is part of the key */
+	key9 = OptPlanCacheMakeKey(make_query(int8_const(9), int8_const(6)), 3, &literals);
+	assert_string_not_equal(key7, key9);
+}
+
+void
+test__OptPlanCacheBindLiterals(void **state)
+{
+	PlannedStmt *stmt;
+	int64		hits;
+	int64		misses;
+	int			entries;
+	int64		size;
+
+	OptPlanCacheHits = OptPlanCacheMisses = 0;
+
+	/* the plan's constant that came from the literal takes the new value */
+	stmt = make_plan(1, 5);
+	assert_true(OptPlanCacheBindLiterals(stmt, list_make1(int4_const(5)),
+										 list_make1(int4_const(7))));
+	assert_int_equal(plan_value(stmt), 7);
+
+	/* a plan in which the literal doesn't turn up can't be used */
+	stmt = make_plan(1, 6);
+	assert_false(OptPlanCacheBindLiterals(stmt, list_make1(int4_const(5)),
+										  list_make1(int4_const(7))));
+
+	/* equal literals can't become different ones */
+	stmt = make_plan(5, 5);
+	assert_false(OptPlanCacheBindLiterals(stmt,
+										  list_make2(int4_const(5), int4_const(5)),
+										  list_make2(int4_const(7), int4_const(8))));
+
+	/*
+	 * Nor can they become equal ones, if the plan came from a > 2 AND a > 5
+	 * AND b = 2 with the first predicate merged into the second: for a > 9
+	 * AND a > 5 AND b = 9, the plan must not become a > 5 AND b = 9.
+	 */
+	stmt = make_plan(5, 2);
+	assert_false(OptPlanCacheBindLiterals(stmt,
+										  list_make3(int4_const(2), int4_const(5), int4_const(2)),
+										  list_make3(int4_const(9), int4_const(5), int4_const(9))));
+	assert_int_equal(plan_value(stmt), 2);
+
+	/* nor can a directly dispatched plan change its literals */
+	stmt = make_plan(1, 5);
+	stmt->planTree->directDispatch.isDirectDispatch = true;
+	assert_false(OptPlanCacheBindLiterals(stmt, list_make1(int4_const(5)),
+										  list_make1(int4_const(7))));
+
+	/* unless they stay the same */
+	assert_true(OptPlanCacheBindLiterals(stmt, list_make1(int4_const(5)),
+										 list_make1(int4_const(5))));
+	assert_int_equal(plan_value(stmt), 5);
+
+	OptPlanCacheGetStats(&hits, &misses, &entries, &size);
+	assert_int_equal(hits, 2);
+	assert_int_equal(misses, 4);
+}
+
+void
+test__OptPlanCacheInsert__Lookup(void **state)
+{
+	List	   *literals;
+	List	   *planLiterals;
+	char	   *key5 = OptPlanCacheMakeKey(make_query(int4_const(5), NULL), 3, &literals);
+
+	optimizer_plan_cache_size = 1024;
+	OptPlanCacheHits = OptPlanCacheMisses = 0;
+
+	assert_true(OptPlanCacheLookup(key5, &planLiterals) == NULL);
+	assert_int_equal(OptPlanCacheMisses, 1);
+
+	OptPlanCacheInsert(key5, "<plan 5/>", literals, list_make1_oid(100));
+	assert_string_equal(OptPlanCacheLookup(key5, &planLiterals), "<plan 5/>");
+	assert_int_equal(list_length(planLiterals), 1);
+	assert_int_equal(DatumGetInt32(((Const *) linitial(planLiterals))->constvalue), 5);
+
+	/* optimizing the query again replaces its plan */
+	OptPlanCacheMakeKey(make_query(int4_const(7), NULL), 3, &literals);
+	OptPlanCacheInsert(key5, "<plan 7/>", literals, list_make1_oid(100));
+	assert_int_equal(num_entries(), 1);
+	assert_string_equal(OptPlanCacheLookup(key5, &planLiterals), "<plan 7/>");
+	assert_int_equal(DatumGetInt32(((Const *) linitial(planLiterals))->constvalue), 7);
+
+	/* plans made for another number of segments are discarded */
+	OptPlanCacheMakeKey(make_query(int4_const(5), NULL), 4, &literals);
+	assert_int_equal(num_entries(), 0);
+
+	optimizer_plan_cache_size = 0;
+}
+
+void
+test__OptPlanCacheInvalidateRelation(void **state)
+{
+	List	   *literals;
+	List	   *planLiterals;
+	char	   *key5 = OptPlanCacheMakeKey(make_query(int4_const(5), NULL), 3, &literals);
+	char	   *key8 = OptPlanCacheMakeKey(make_query(int8_const(5), NULL), 3, &literals);
+
+	optimizer_plan_cache_size = 1024;
+
+	OptPlanCacheInsert(key5, "<plan 1/>", NIL, list_make2_oid(100, 101));
+	OptPlanCacheInsert(key8, "<plan 2/>", NIL, list_make1_oid(200));
+	assert_int_equal(num_entries(), 2);
+
+	/* only the plans that use the relation go */
+	OptPlanCacheInvalidateRelation(101);
+	assert_int_equal(num_entries(), 1);
+	assert_true(OptPlanCacheLookup(key5, &planLiterals) == NULL);
+	assert_string_equal(OptPlanCacheLookup(key8, &planLiterals), "<plan 2/>");
+
+	OptPlanCacheInvalidateRelation(300);
+	assert_int_equal(num_entries(), 1);
+
+	/* InvalidOid stands for all relations */
+	OptPlanCacheInvalidateRelation(InvalidOid);
+	assert_int_equal(num_entries(), 0);
+
+	optimizer_plan_cache_size = 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+	cmockery_parse_arguments(argc, argv);
+
+	const		UnitTest tests[] = {
+		unit_test(test__OptPlanCacheMakeKey__Literals),
+		unit_test(test__OptPlanCacheMakeKey__Limit),
+		unit_test(test__OptPlanCacheBindLiterals),
+		unit_test(test__OptPlanCacheInsert__Lookup),
+		unit_test(test__OptPlanCacheInvalidateRelation)
+	};
+
+	MemoryContextInit();
+
+	return run_tests(tests);
+}
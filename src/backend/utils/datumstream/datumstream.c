@@ -434,6 +434,28 @@ init_datumstream_info(
 				ao_attr->compressLevel = 9;
 				break;
 
+			/*
+			 * zstd decompresses several times faster than zlib for a similar
+			 * ratio, which matters more than the write cost for scans.
+			 */
+			case 5:
+				ao_attr->compress = true;
+				ao_attr->compressType = "zstd";
+				ao_attr->compressLevel = 1;
+				break;
+
+			case 6:
+				ao_attr->compress = true;
+				ao_attr->compressType = "zstd";
+				ao_attr->compressLevel = 5;
+				break;
+
+			case 7:
+				ao_attr->compress = true;
+				ao_attr->compressType = "zstd";
+				ao_attr->compressLevel = 9;
+				break;
+
 			default:
 				ereport(ERROR,
 						(errmsg("Unexpected compresslevel %d",
@@ -488,6 +510,7 @@ DatumStreamWrite *
 create_datumstreamwrite(
 						char *compName,
 						int32 compLevel,
+						bool dictionary,
 						bool checksum,
 						int32 safeFSWriteSize,
 						int32 maxsz,
@@ -616,6 +639,10 @@ create_datumstreamwrite(
 							   acc->datumStreamVersion,
 							   acc->rle_want_compression,
 							   acc->delta_want_compression,
+							   /* dict_want_encoding */
+							   (dictionary &&
+								acc->rle_want_compression &&
+								acc->typeInfo.datumlen == -1),
 							   initialMaxDatumPerBlock,
 							   maxDatumPerBlock,
 							   acc->maxAoBlockSize - acc->maxAoHeaderSize,
@@ -1360,6 +1387,45 @@ datumstreamread_block(DatumStreamRead * acc,
 	return 0;
 }
 
+/*
+ * Position the datum stream so that the next datumstreamread_advance()
+ * returns row rowNum, or the first row after it. Blocks that end before
+ * rowNum are skipped without reading their contents.
+ *
+ * Returns -1 if there are no more blocks, 0 otherwise.
+ */
+int
+datumstreamread_skip_to_row(DatumStreamRead * acc, int64 rowNum)
+{
+	int32		rowNumInBlock;
+
+	Assert(acc);
+
+	if (acc->blockFirstRowNum + acc->blockRowCount <= rowNum)
+	{
+		while (true)
+		{
+			if (!datumstreamread_block_info(acc))
+				return -1;
+
+			Assert(acc->blockFirstRowNum > 0);
+			if (acc->blockFirstRowNum + acc->blockRowCount > rowNum)
+				break;
+
+			AppendOnlyStorageRead_SkipCurrentBlock(&acc->ao_read);
+		}
+
+		datumstreamread_block_content(acc);
+	}
+
+	/* Stop just before the row, the caller advances to it. */
+	rowNumInBlock = (int32) (rowNum - acc->blockFirstRowNum) - 1;
+	if (rowNumInBlock > datumstreamread_nth(acc))
+		datumstreamread_find(acc, rowNumInBlock);
+
+	return 0;
+}
+
 void
 datumstreamread_rewind_block(DatumStreamRead * datumStream)
 {
@@ -13,6 +13,7 @@
  */
 
 #include "postgres.h"
+#include "access/hash.h"
 #include "access/tupmacs.h"
 #include "access/tuptoaster.h"
 #include "utils/datumstreamblock.h"
@@ -402,7 +403,12 @@ void
 DatumStreamBlockRead_Finish(
 							DatumStreamBlockRead * dsr)
 {
-	/* Place holder. */
+	if (dsr->dict_entries != NULL)
+	{
+		pfree(dsr->dict_entries);
+		dsr->dict_entries = NULL;
+		dsr->dict_entries_maxcount = 0;
+	}
 }
 
 /*
@@ -607,6 +613,131 @@ DatumStreamBlockRead_ResetDense(DatumStreamBlockRead * dsr)
 
 	dsr->delta_block_was_compressed = false;
 	dsr->delta_item = false;
+
+	dsr->dict_block_was_encoded = false;
+	dsr->dict_count = 0;
+	dsr->dict_code_size = 0;
+	dsr->dict_codesp = NULL;
+}
+
+/*
+ * Every dictionary read gets a new generation number, so that callers can
+ * tell whether what they derived from the last dictionary still applies.
+ */
+static uint32 DatumStreamBlockRead_DictGeneration = 0;
+
+/*
+ * Set up the entry pointers of a dictionary encoded block.
+ *
+ * The codes are used as array indexes, so they are checked even when the
+ * block integrity checks are minimal.
+ */
+static void
+DatumStreamBlockRead_GetReadyDict(DatumStreamBlockRead * dsr, int32 dictSize)
+{
+	uint8	   *p;
+	uint8	   *entries_afterp;
+	int32		codesOffset;
+	int32		maxCode;
+	int			i;
+
+	if (dsr->typeInfo.datumlen != -1 ||
+		dsr->dict_count <= 0 ||
+		dsr->dict_count > DATUMSTREAM_DICT_MAX_ENTRIES ||
+		dictSize <= 0)
+	{
+		ereport(ERROR,
+				(errmsg("Bad datum stream Dense block dictionary "
+						"(datum length %d, dictionary count %d, dictionary size %d)",
+						dsr->typeInfo.datumlen,
+						dsr->dict_count,
+						dictSize),
+				 errdetail_datumstreamblockread(dsr),
+				 errcontext_datumstreamblockread(dsr)));
+	}
+
+	dsr->dict_code_size = DatumStreamBlock_DictCodeSize(dsr->dict_count);
+	codesOffset = TYPEALIGN(dsr->dict_code_size, dictSize);
+	if (codesOffset + dsr->physical_datum_count * dsr->dict_code_size !=
+		dsr->physical_data_size)
+	{
+		ereport(ERROR,
+				(errmsg("Datum stream Dense block dictionary size does not match physical data size "
+						"(dictionary size %d, physical datum count %d, code size %d, physical data size %d)",
+						dictSize,
+						dsr->physical_datum_count,
+						dsr->dict_code_size,
+						dsr->physical_data_size),
+				 errdetail_datumstreamblockread(dsr),
+				 errcontext_datumstreamblockread(dsr)));
+	}
+
+	/*
+	 * Most dictionaries are small, so size the entry array by the largest
+	 * dictionary seen so far, growing it at least twofold.
+	 */
+	if (dsr->dict_entries_maxcount < dsr->dict_count)
+	{
+		if (dsr->dict_entries != NULL)
+			pfree(dsr->dict_entries);
+		dsr->dict_entries_maxcount = Min(Max(dsr->dict_count,
+											 2 * dsr->dict_entries_maxcount),
+										 DATUMSTREAM_DICT_MAX_ENTRIES);
+		dsr->dict_entries = (Datum *)
+			MemoryContextAlloc(dsr->memctxt,
+							   dsr->dict_entries_maxcount * sizeof(Datum));
+	}
+
+	/*
+	 * The entries are laid out like the datums of a block that is not
+	 * encoded, with zero padding before regular varlena headers.
+	 */
+	p = dsr->datum_beginp;
+	entries_afterp = dsr->datum_beginp + dictSize;
+	for (i = 0; i < dsr->dict_count; i++)
+	{
+		if (i > 0 && p < entries_afterp && *p == 0)
+			p = (uint8 *) att_align_nominal(p, dsr->typeInfo.align);
+
+		if (p >= entries_afterp || p + VARSIZE_ANY(p) > entries_afterp)
+		{
+			ereport(ERROR,
+					(errmsg("Datum stream Dense block dictionary entry %d goes beyond the dictionary "
+							"(dictionary count %d, dictionary size %d)",
+							i,
+							dsr->dict_count,
+							dictSize),
+					 errdetail_datumstreamblockread(dsr),
+					 errcontext_datumstreamblockread(dsr)));
+		}
+
+		dsr->dict_entries[i] = PointerGetDatum(p);
+		p += VARSIZE_ANY(p);
+	}
+
+	dsr->dict_codesp = dsr->datum_beginp + codesOffset;
+	maxCode = 0;
+	if (dsr->dict_code_size == 1)
+	{
+		for (i = 0; i < dsr->physical_datum_count; i++)
+			maxCode = Max(maxCode, dsr->dict_codesp[i]);
+	}
+	else
+	{
+		for (i = 0; i < dsr->physical_datum_count; i++)
+			maxCode = Max(maxCode, ((uint16 *) dsr->dict_codesp)[i]);
+	}
+	if (maxCode >= dsr->dict_count)
+	{
+		ereport(ERROR,
+				(errmsg("Datum stream Dense block dictionary code %d out of range (dictionary count %d)",
+						maxCode,
+						dsr->dict_count),
+				 errdetail_datumstreamblockread(dsr),
+				 errcontext_datumstreamblockread(dsr)));
+	}
+
+	dsr->dict_generation = ++DatumStreamBlockRead_DictGeneration;
 }
 
 void
@@ -628,6 +759,8 @@ DatumStreamBlockRead_GetReadyDense(
 	DatumStreamBlock_Dense *blockDense;
 	DatumStreamBlock_Rle_Extension *rleExtension;
 	DatumStreamBlock_Delta_Extension *deltaExtension;
+	DatumStreamBlock_Dict_Extension *dictExtension;
+	int32		dictSize;
 
 	/*
 	 * PERFORMANCE EXPERIMENT: Only do integrity and trace checking for DEBUG
@@ -716,6 +849,21 @@ DatumStreamBlockRead_GetReadyDense(
 		deltaExtension = NULL;
 	}
 
+	/* Dictionary */
+	dsr->dict_block_was_encoded = ((blockDense->orig_4_bytes.flags & DSB_HAS_DICTIONARY) != 0);
+	if (dsr->dict_block_was_encoded)
+	{
+		dictExtension = (DatumStreamBlock_Dict_Extension *) p;
+		p += sizeof(DatumStreamBlock_Dict_Extension);
+
+		dsr->dict_count = dictExtension->dict_count;
+		dictSize = dictExtension->dict_size;
+	}
+	else
+	{
+		dictSize = 0;
+	}
+
 	/* Set up acc */
 	dsr->nth = -1;				/* put it before first entry.  Caller will
 								 * advance */
@@ -941,6 +1089,9 @@ DatumStreamBlockRead_GetReadyDense(
 		}
 	}
 	dsr->datump = dsr->datum_beginp;
+
+	if (dsr->dict_block_was_encoded)
+		DatumStreamBlockRead_GetReadyDict(dsr, dictSize);
 }
 
 static int
@@ -3761,6 +3912,186 @@ DatumStreamBlockWrite_BlockOrig(
 	return writesz;
 }
 
+/*
+ * Dictionary encode the physical datums of a variable-length block, if that
+ * makes the block smaller.  The code of each physical datum is left in
+ * dict_codes, and the datum_buffer offset of each entry in dict_offsets.
+ *
+ * Returns the size of the encoded datum area, or -1 if the block is better
+ * written as it is.
+ */
+static int32
+DatumStreamBlockWrite_DictEncode(
+								 DatumStreamBlockWrite * dsw,
+								 DatumStreamBlock_Dict_Extension * dict_extension)
+{
+	int32		count = dsw->physical_datum_count;
+	int32		dataSize = dsw->datump - dsw->datum_buffer;
+	int32		hashSize;
+	int32		nentries;
+	int32		entriesSize;
+	int32		codeSize;
+	int32		encodedSize;
+	uint8	   *item;
+	int			i;
+
+	Assert(dsw->typeInfo->datumlen == -1);
+	Assert(!dsw->delta_has_compression);
+
+	if (count < 2)
+		return -1;
+
+	/*
+	 * Open addressing, with the table at most half full.
+	 */
+	hashSize = 16;
+	while (hashSize < 2 * Min(count, DATUMSTREAM_DICT_MAX_ENTRIES))
+		hashSize <<= 1;
+
+	if (dsw->dict_hash_maxsize < hashSize)
+	{
+		if (dsw->dict_hash != NULL)
+			pfree(dsw->dict_hash);
+		dsw->dict_hash = MemoryContextAlloc(dsw->memctxt, hashSize * sizeof(int32));
+		dsw->dict_hash_maxsize = hashSize;
+	}
+	if (dsw->dict_offsets == NULL)
+		dsw->dict_offsets = MemoryContextAlloc(dsw->memctxt,
+										DATUMSTREAM_DICT_MAX_ENTRIES * sizeof(int32));
+	if (dsw->dict_codes_maxcount < count)
+	{
+		if (dsw->dict_codes != NULL)
+			pfree(dsw->dict_codes);
+		dsw->dict_codes = MemoryContextAlloc(dsw->memctxt, count * sizeof(uint16));
+		dsw->dict_codes_maxcount = count;
+	}
+
+	MemSet(dsw->dict_hash, 0, hashSize * sizeof(int32));
+
+	nentries = 0;
+	entriesSize = 0;
+	item = dsw->datum_buffer;
+	for (i = 0; i < count; i++)
+	{
+		int32		len;
+		uint32		h;
+		int32		entry;
+
+		/*
+		 * Skip any possible zero paddings AFTER the previous varlena, like
+		 * the reader does.
+		 */
+		if (i > 0 && *item == 0)
+			item = (uint8 *) att_align_nominal(item, dsw->typeInfo->align);
+
+		len = VARSIZE_ANY(item);
+		h = DatumGetUInt32(hash_any(item, len)) & (hashSize - 1);
+		for (;;)
+		{
+			uint8	   *other;
+
+			entry = dsw->dict_hash[h] - 1;
+			if (entry < 0)
+				break;
+
+			other = dsw->datum_buffer + dsw->dict_offsets[entry];
+			if (VARSIZE_ANY(other) == len && memcmp(other, item, len) == 0)
+				break;
+
+			h = (h + 1) & (hashSize - 1);
+		}
+
+		if (entry < 0)
+		{
+			if (nentries >= DATUMSTREAM_DICT_MAX_ENTRIES)
+				return -1;
+
+			entry = nentries++;
+			dsw->dict_hash[h] = entry + 1;
+			dsw->dict_offsets[entry] = item - dsw->datum_buffer;
+
+			if (!VARATT_IS_SHORT(item))
+				entriesSize = att_align_nominal(entriesSize, dsw->typeInfo->align);
+			entriesSize += len;
+
+			/* Give up as soon as the dictionary alone is too large */
+			if (entriesSize >= dataSize)
+				return -1;
+		}
+
+		dsw->dict_codes[i] = (uint16) entry;
+		item += len;
+	}
+
+	codeSize = DatumStreamBlock_DictCodeSize(nentries);
+	encodedSize = TYPEALIGN(codeSize, entriesSize) + count * codeSize;
+
+	/*
+	 * The extension makes the header up to its size larger.
+	 */
+	if (encodedSize + (int32) sizeof(DatumStreamBlock_Dict_Extension) >= dataSize)
+		return -1;
+
+	dict_extension->dict_count = nentries;
+	dict_extension->dict_size = entriesSize;
+
+	return encodedSize;
+}
+
+/*
+ * Write the dictionary entries and the codes prepared by
+ * DatumStreamBlockWrite_DictEncode.
+ */
+static uint8 *
+DatumStreamBlockWrite_DictPut(
+							  DatumStreamBlockWrite * dsw,
+							  DatumStreamBlock_Dict_Extension * dict_extension,
+							  uint8 * p)
+{
+	uint8	   *beginp = p;
+	int32		codeSize = DatumStreamBlock_DictCodeSize(dict_extension->dict_count);
+	int			i;
+
+	for (i = 0; i < dict_extension->dict_count; i++)
+	{
+		uint8	   *entry = dsw->datum_buffer + dsw->dict_offsets[i];
+		int32		len = VARSIZE_ANY(entry);
+
+		/*
+		 * Align relative to the datum area, like the datums are aligned
+		 * relative to datum_buffer.
+		 */
+		if (!VARATT_IS_SHORT(entry))
+		{
+			uint8	   *alignedp = beginp +
+			att_align_nominal(p - beginp, dsw->typeInfo->align);
+
+			while (p < alignedp)
+				*(p++) = 0;
+		}
+
+		memcpy(p, entry, len);
+		p += len;
+	}
+	Assert(p - beginp == dict_extension->dict_size);
+
+	while ((p - beginp) % codeSize != 0)
+		*(p++) = 0;
+
+	if (codeSize == 1)
+	{
+		for (i = 0; i < dsw->physical_datum_count; i++)
+			*(p++) = (uint8) dsw->dict_codes[i];
+	}
+	else
+	{
+		memcpy(p, dsw->dict_codes, dsw->physical_datum_count * sizeof(uint16));
+		p += dsw->physical_datum_count * sizeof(uint16);
+	}
+
+	return p;
+}
+
 static int64
 DatumStreamBlockWrite_BlockDense(
 								 DatumStreamBlockWrite * dsw,
@@ -3771,6 +4102,8 @@ DatumStreamBlockWrite_BlockDense(
 	DatumStreamBlock_Dense dense;
 	DatumStreamBlock_Rle_Extension rle_extension;
 	DatumStreamBlock_Delta_Extension delta_extension;
+	DatumStreamBlock_Dict_Extension dict_extension;
+	int32		dictDataSize;
 	int32		headerSize;
 	int32		nullSize;
 	int32		rleSize;
@@ -3913,6 +4246,22 @@ DatumStreamBlockWrite_BlockDense(
 		deltaSize = 0;
 	}
 
+	/*
+	 * Replace the datums with a dictionary and codes, if that is smaller.
+	 */
+	if (dsw->dict_want_encoding && dsw->typeInfo->datumlen == -1 &&
+		!dsw->delta_has_compression)
+		dictDataSize = DatumStreamBlockWrite_DictEncode(dsw, &dict_extension);
+	else
+		dictDataSize = -1;
+
+	if (dictDataSize >= 0)
+	{
+		dense.orig_4_bytes.flags |= DSB_HAS_DICTIONARY;
+		dense.physical_data_size = dictDataSize;
+		headerSize += sizeof(DatumStreamBlock_Dict_Extension);
+	}
+
 	/*
 	 * Align headers and meta-data (e.g. NULL bit-maps, etc).
 	 */
@@ -3934,6 +4283,12 @@ DatumStreamBlockWrite_BlockDense(
 		p += sizeof(DatumStreamBlock_Delta_Extension);
 	}
 
+	if (dictDataSize >= 0)
+	{
+		memcpy(p, &dict_extension, sizeof(DatumStreamBlock_Dict_Extension));
+		p += sizeof(DatumStreamBlock_Dict_Extension);
+	}
+
 	if (dsw->has_null)
 	{
 		memcpy(p, dsw->null_bitmap_buffer, DatumStreamBitMapWrite_Size(&dsw->null_bitmap));
@@ -4038,8 +4393,13 @@ DatumStreamBlockWrite_BlockDense(
 				 errcontext_datumstreamblockwrite(dsw)));
 	}
 
-	memcpy(p, dsw->datum_buffer, dense.physical_data_size);
-	p += dense.physical_data_size;
+	if (dictDataSize >= 0)
+		p = DatumStreamBlockWrite_DictPut(dsw, &dict_extension, p);
+	else
+	{
+		memcpy(p, dsw->datum_buffer, dense.physical_data_size);
+		p += dense.physical_data_size;
+	}
 
 	/* Calculate write size. */
 	writesz = p - buffer;
@@ -4157,6 +4517,21 @@ DatumStreamBlockWrite_BlockDense(
 			}
 		}
 
+		if (dictDataSize >= 0)
+		{
+			ereport(LOG,
+					(errmsg("Datum stream write Dense block formatted with a dictionary "
+							"(dictionary count %d, dictionary size %d, physical datum count %d, "
+							"physical data size %d, size before encoding %d)",
+							dict_extension.dict_count,
+							dict_extension.dict_size,
+							dsw->physical_datum_count,
+							dense.physical_data_size,
+							(int32) (dsw->datump - dsw->datum_buffer)),
+					 errdetail_datumstreamblockwrite(dsw),
+					 errcontext_datumstreamblockwrite(dsw)));
+		}
+
 		if (dsw->delta_has_compression)
 		{
 			ereport(LOG,
@@ -4232,6 +4607,7 @@ DatumStreamBlockWrite_Init(
 						   DatumStreamVersion datumStreamVersion,
 						   bool rle_want_compression,
 						   bool delta_want_compression,
+						   bool dict_want_encoding,
 						   int32 initialMaxDatumPerBlock,
 						   int32 maxDatumPerBlock,
 						   int32 maxDataBlockSize,
@@ -4248,6 +4624,7 @@ DatumStreamBlockWrite_Init(
 
 	dsw->rle_want_compression = rle_want_compression;
 	dsw->delta_want_compression = delta_want_compression;
+	dsw->dict_want_encoding = dict_want_encoding;
 
 	dsw->initialMaxDatumPerBlock = initialMaxDatumPerBlock;
 	dsw->maxDatumPerBlock = maxDatumPerBlock;
@@ -4458,6 +4835,15 @@ DatumStreamBlockWrite_Finish(
 	if (dsw->delta_sign != NULL)
 		pfree(dsw->delta_sign);
 
+	if (dsw->dict_hash != NULL)
+		pfree(dsw->dict_hash);
+
+	if (dsw->dict_offsets != NULL)
+		pfree(dsw->dict_offsets);
+
+	if (dsw->dict_codes != NULL)
+		pfree(dsw->dict_codes);
+
 	MemoryContextSwitchTo(oldCtxt);
 }
 
@@ -4666,6 +5052,106 @@ DatumStreamBlock_IntegrityCheckVarlena(
 	return count;
 }
 
+static void
+DatumStreamBlock_IntegrityCheckDict(
+									DatumStreamBlock_Dict_Extension * dictExtension,
+									uint8 * physicalData,
+									int32 physicalDataSize,
+									int32 physicalDatumCount,
+									DatumStreamVersion datumStreamVersion,
+									DatumStreamTypeInfo * typeInfo,
+							   int (*errdetailCallback) (void *errdetailArg),
+									void *errdetailArg,
+							 int (*errcontextCallback) (void *errcontextArg),
+									void *errcontextArg)
+{
+	int32		codeSize;
+	int32		codesOffset;
+	int32		count;
+	uint8	   *codesp;
+	int			i;
+
+	if (typeInfo->datumlen != -1)
+	{
+		ereport(ERROR,
+				(errmsg("Bad datum stream %s dictionary block for a type of length %d",
+						DatumStreamVersion_String(datumStreamVersion),
+						typeInfo->datumlen),
+				 errdetailCallback(errdetailArg),
+				 errcontextCallback(errcontextArg)));
+	}
+
+	if (dictExtension->dict_count <= 0 ||
+		dictExtension->dict_count > DATUMSTREAM_DICT_MAX_ENTRIES ||
+		dictExtension->dict_count > physicalDatumCount)
+	{
+		ereport(ERROR,
+				(errmsg("Bad datum stream %s dictionary count %d (physical datum count %d)",
+						DatumStreamVersion_String(datumStreamVersion),
+						dictExtension->dict_count,
+						physicalDatumCount),
+				 errdetailCallback(errdetailArg),
+				 errcontextCallback(errcontextArg)));
+	}
+
+	codeSize = DatumStreamBlock_DictCodeSize(dictExtension->dict_count);
+	codesOffset = TYPEALIGN(codeSize, dictExtension->dict_size);
+	if (dictExtension->dict_size <= 0 ||
+		codesOffset + physicalDatumCount * codeSize != physicalDataSize)
+	{
+		ereport(ERROR,
+				(errmsg("Bad datum stream %s dictionary size %d (physical datum count %d, code size %d, physical data size %d)",
+						DatumStreamVersion_String(datumStreamVersion),
+						dictExtension->dict_size,
+						physicalDatumCount,
+						codeSize,
+						physicalDataSize),
+				 errdetailCallback(errdetailArg),
+				 errcontextCallback(errcontextArg)));
+	}
+
+	count = DatumStreamBlock_IntegrityCheckVarlena(
+												   physicalData,
+												   dictExtension->dict_size,
+												   datumStreamVersion,
+												   typeInfo,
+												   errdetailCallback,
+												   errdetailArg,
+												   errcontextCallback,
+												   errcontextArg);
+
+	/* The count doesn't include the last item */
+	if (count + 1 != dictExtension->dict_count)
+	{
+		ereport(ERROR,
+				(errmsg("Bad datum stream %s dictionary entry count.  Found %d, expected %d",
+						DatumStreamVersion_String(datumStreamVersion),
+						count + 1,
+						dictExtension->dict_count),
+				 errdetailCallback(errdetailArg),
+				 errcontextCallback(errcontextArg)));
+	}
+
+	codesp = physicalData + codesOffset;
+	for (i = 0; i < physicalDatumCount; i++)
+	{
+		int32		code;
+
+		code = (codeSize == 1) ? codesp[i] : ((uint16 *) codesp)[i];
+		if (code >= dictExtension->dict_count)
+		{
+			ereport(ERROR,
+					(errmsg("Bad datum stream %s dictionary code %d at physical item index #%d (dictionary count %d)",
+							DatumStreamVersion_String(datumStreamVersion),
+							code,
+							i,
+							dictExtension->dict_count),
+					 errdetailCallback(errdetailArg),
+					 errcontextCallback(errcontextArg)));
+		}
+	}
+}
+
 static void
 DatumStreamBlock_IntegrityCheckOrig(
 									uint8 * buffer,
@@ -4896,14 +5382,17 @@ DatumStreamBlock_IntegrityCheckDense(
 	bool		hasNull;
 	bool		hasRleCompression;
 	bool		hasDeltaCompression;
+	bool		hasDictionary;
 
 	int32		alignedHeaderSize;
 	int32		deltaOnCount;
 	DatumStreamBlock_Delta_Extension *deltaExtension;
 	DatumStreamBlock_Rle_Extension *rleExtension;
+	DatumStreamBlock_Dict_Extension *dictExtension;
 
 	deltaExtension = NULL;
 	rleExtension = NULL;
+	dictExtension = NULL;
 
 	alignedHeaderSize = 0;
 
@@ -4942,6 +5431,7 @@ DatumStreamBlock_IntegrityCheckDense(
 	hasNull = ((blockDense->orig_4_bytes.flags & DSB_HAS_NULLBITMAP) != 0);
 	hasRleCompression = ((blockDense->orig_4_bytes.flags & DSB_HAS_RLE_COMPRESSION) != 0);
 	hasDeltaCompression = ((blockDense->orig_4_bytes.flags & DSB_HAS_DELTA_COMPRESSION) != 0);
+	hasDictionary = ((blockDense->orig_4_bytes.flags & DSB_HAS_DICTIONARY) != 0);
 
 	/*
 	 * Verify logical row count.
@@ -5091,6 +5581,24 @@ DatumStreamBlock_IntegrityCheckDense(
 		{
 			deltaOnCount = 0;
 		}
+
+		if (hasDictionary)
+		{
+			headerSize += sizeof(DatumStreamBlock_Dict_Extension);
+
+			if (bufferSize < headerSize)
+			{
+				ereport(ERROR,
+						(errmsg("Bad datum stream dictionary block header extension size. Found %d and expected the size to be at least %d",
+								bufferSize,
+								headerSize),
+						 errdetailCallback(errdetailArg),
+						 errcontextCallback(errcontextArg)));
+			}
+
+			dictExtension = (DatumStreamBlock_Dict_Extension *) p;
+			p += sizeof(DatumStreamBlock_Dict_Extension);
+		}
 		total_datum_count = blockDense->physical_datum_count + deltaOnCount;
 
 		if (!hasNull)
@@ -5266,6 +5774,24 @@ DatumStreamBlock_IntegrityCheckDense(
 			p += sizeof(DatumStreamBlock_Delta_Extension);
 		}
 
+		if (hasDictionary)
+		{
+			headerSize += sizeof(DatumStreamBlock_Dict_Extension);
+
+			if (bufferSize < headerSize)
+			{
+				ereport(ERROR,
+						(errmsg("Bad datum stream RLE_TYPE dictionary block header extension size. Found %d and expected the size to be at least %d",
+								bufferSize,
+								headerSize),
+						 errdetailCallback(errdetailArg),
+						 errcontextCallback(errcontextArg)));
+			}
+
+			dictExtension = (DatumStreamBlock_Dict_Extension *) p;
+			p += sizeof(DatumStreamBlock_Dict_Extension);
+		}
+
 		if (!hasNull)
 		{
 			actualNullOnCount = 0;
@@ -5430,7 +5956,21 @@ DatumStreamBlock_IntegrityCheckDense(
 												  errcontextArg);
 	}
 
-	if (typeInfo->datumlen == -1)
+	if (hasDictionary)
+	{
+		DatumStreamBlock_IntegrityCheckDict(
+											dictExtension,
+											buffer + alignedHeaderSize,
+											blockDense->physical_data_size,
+											blockDense->physical_datum_count,
+											blockDense->orig_4_bytes.version,
+											typeInfo,
+											errdetailCallback,
+											errdetailArg,
+											errcontextCallback,
+											errcontextArg);
+	}
+	else if (typeInfo->datumlen == -1)
 	{
 		/*
 		 * Variable-length items.
@@ -4,6 +4,9 @@
 #include "cmockery.h"
 
 #include "../datumstreamblock.c"
+#include "catalog/pg_type.h"
+#include "utils/builtins.h"
+#include "utils/memutils.h"
 
 /* 
  * Unit test function to test the routines added for
@@ -167,13 +170,153 @@ test__DeltaCompression__Core(void **state)
 	free(dsw);
 }
 
+/*
+ * Write a block of text values with a dictionary, and read it back.
+ */
+void
+test__DictEncoding__RoundTrip(void **state)
+{
+	const char *palette[] = {"red", "green", "blue", "a much longer value than the others"};
+	DatumStreamTypeInfo typeInfo;
+	DatumStreamBlockWrite dsw;
+	DatumStreamBlockRead dsr;
+	Datum		values[1000];
+	bool		nulls[1000];
+	uint8	   *buffer;
+	int64		size;
+	bool		hadToAdjustRowCount;
+	int32		adjustedRowCount;
+	void	   *toFree;
+	int			n = 1000;
+	int			i;
+
+	typeInfo.datumlen = -1;
+	typeInfo.typid = TEXTOID;
+	typeInfo.align = 'i';
+	typeInfo.byval = false;
+
+	MemSet(&dsw, 0, sizeof(dsw));
+	DatumStreamBlockWrite_Init(&dsw, &typeInfo, DatumStreamVersion_Dense_Enhanced,
+							   true, false, true,
+							   n, 2 * n, 32768, NULL, NULL, NULL, NULL);
+	DatumStreamBlockWrite_GetReady(&dsw);
+
+	/* short runs, that RLE alone leaves mostly alone, and a few NULLs */
+	for (i = 0; i < n; i++)
+	{
+		nulls[i] = (i % 97 == 0);
+		values[i] = CStringGetTextDatum(palette[(i / 2 * 7) % lengthof(palette)]);
+		assert_true(DatumStreamBlockWrite_Put(&dsw, values[i], nulls[i], &toFree) >= 0);
+	}
+
+	buffer = palloc(32768);
+	size = DatumStreamBlockWrite_Block(&dsw, buffer);
+	assert_true(size > 0);
+	assert_true(size < 32768 / 4);
+
+	MemSet(&dsr, 0, sizeof(dsr));
+	DatumStreamBlockRead_Init(&dsr, &typeInfo, DatumStreamVersion_Dense_Enhanced,
+							  true, NULL, NULL, NULL, NULL);
+	DatumStreamBlockRead_GetReady(&dsr, buffer, size, 1, n,
+								  &hadToAdjustRowCount, &adjustedRowCount);
+	assert_true(dsr.dict_block_was_encoded);
+	assert_int_equal(dsr.dict_count, lengthof(palette));
+	assert_int_equal(dsr.dict_code_size, 1);
+	assert_int_equal(dsr.dict_entries_maxcount, lengthof(palette));
+
+	for (i = 0; i < n; i++)
+	{
+		Datum		d;
+		bool		isnull;
+
+		assert_int_equal(DatumStreamBlockRead_Advance(&dsr), 1);
+		DatumStreamBlockRead_Get(&dsr, &d, &isnull);
+		assert_int_equal(isnull, nulls[i]);
+		if (!isnull)
+			assert_string_equal(TextDatumGetCString(d), TextDatumGetCString(values[i]));
+	}
+	assert_int_equal(DatumStreamBlockRead_Advance(&dsr), 0);
+}
+
+/*
+ * A dictionary of more than 256 entries uses 2-byte codes.
+ */
+void
+test__DictEncoding__TwoByteCodes(void **state)
+{
+	DatumStreamTypeInfo typeInfo;
+	DatumStreamBlockWrite dsw;
+	DatumStreamBlockRead dsr;
+	Datum		values[3000];
+	uint8	   *buffer;
+	int64		size;
+	bool		hadToAdjustRowCount;
+	int32		adjustedRowCount;
+	void	   *toFree;
+	int			n = 3000;
+	int			ndistinct = 300;
+	int			i;
+
+	typeInfo.datumlen = -1;
+	typeInfo.typid = TEXTOID;
+	typeInfo.align = 'i';
+	typeInfo.byval = false;
+
+	MemSet(&dsw, 0, sizeof(dsw));
+	DatumStreamBlockWrite_Init(&dsw, &typeInfo, DatumStreamVersion_Dense_Enhanced,
+							   true, false, true,
+							   n, 2 * n, 32768, NULL, NULL, NULL, NULL);
+	DatumStreamBlockWrite_GetReady(&dsw);
+
+	/* every value differs from the one before it, so there are no runs */
+	for (i = 0; i < n; i++)
+	{
+		char		str[16];
+
+		snprintf(str, sizeof(str), "v%03d", (i * 7) % ndistinct);
+		values[i] = CStringGetTextDatum(str);
+		assert_true(DatumStreamBlockWrite_Put(&dsw, values[i], false, &toFree) >= 0);
+	}
+
+	buffer = palloc(32768);
+	size = DatumStreamBlockWrite_Block(&dsw, buffer);
+	assert_true(size > 0);
+
+	MemSet(&dsr, 0, sizeof(dsr));
+	DatumStreamBlockRead_Init(&dsr, &typeInfo, DatumStreamVersion_Dense_Enhanced,
+							  true, NULL, NULL, NULL, NULL);
+	DatumStreamBlockRead_GetReady(&dsr, buffer, size, 1, n,
+								  &hadToAdjustRowCount, &adjustedRowCount);
+	assert_true(dsr.dict_block_was_encoded);
+	assert_int_equal(dsr.dict_count, ndistinct);
+	assert_int_equal(dsr.dict_code_size, 2);
+	assert_int_equal(dsr.dict_entries_maxcount, ndistinct);
+
+	for (i = 0; i < n; i++)
+	{
+		Datum		d;
+		bool		isnull;
+
+		assert_int_equal(DatumStreamBlockRead_Advance(&dsr), 1);
+		DatumStreamBlockRead_Get(&dsr, &d, &isnull);
+		assert_false(isnull);
+		assert_string_equal(TextDatumGetCString(d), TextDatumGetCString(values[i]));
+	}
+	assert_int_equal(DatumStreamBlockRead_Advance(&dsr), 0);
+}
+
 int 
 main(int argc, char* argv[]) 
 {
 	cmockery_parse_arguments(argc, argv);
 
 	const UnitTest tests[] = {
-			unit_test(test__DeltaCompression__Core)
+			unit_test(test__DeltaCompression__Core),
+			unit_test(test__DictEncoding__RoundTrip),
+			unit_test(test__DictEncoding__TwoByteCodes)
 	};
+
+	MemoryContextInit();
+
 	return run_tests(tests);
 }
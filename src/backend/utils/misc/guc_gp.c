@@ -22,12 +22,17 @@
 #include "access/transam.h"
 #include "access/url.h"
 #include "access/xlog_internal.h"
+#include "catalog/gp_policy.h"
 #include "cdb/cdbappendonlyam.h"
+#include "cdb/cdbappendonlyblockdirectory.h"
+#include "cdb/cdbbufferedread.h"
 #include "cdb/cdbdisp.h"
 #include "cdb/cdbsreh.h"
+#include "cdb/cdbsrlz.h"
 #include "cdb/cdbvars.h"
 #include "cdb/memquota.h"
 #include "commands/vacuum.h"
+#include "executor/nodeHash.h"
 #include "miscadmin.h"
 #include "libpq/password_hash.h"
 #include "optimizer/cost.h"
@@ -43,6 +48,8 @@
 #include "utils/builtins.h"
 #include "utils/guc_tables.h"
 #include "utils/inval.h"
+#include "utils/mdsharedcache.h"
+#include "utils/optplancache.h"
 #include "utils/resscheduler.h"
 #include "utils/resgroup.h"
 #include "utils/resource_manager.h"
@@ -142,6 +149,8 @@ bool		gp_appendonly_verify_block_checksums = true;
 bool		gp_appendonly_verify_write_block = false;
 bool		gp_appendonly_compaction = true;
 int			gp_appendonly_compaction_threshold = 0;
+int			gp_appendonly_compaction_segfiles = 1;
+int			gp_appendonly_compaction_io_limit = 0;
 bool		gp_heap_require_relhasoids_match = true;
 bool		Debug_appendonly_rezero_quicklz_compress_scratch = false;
 bool		Debug_appendonly_rezero_quicklz_decompress_scratch = false;
@@ -158,6 +167,7 @@ bool		Debug_datumstream_block_write_check_integrity = false;
 bool		Debug_datumstream_read_print_varlena_info = false;
 bool		Debug_datumstream_write_use_small_initial_buffers = false;
 bool		gp_create_table_random_default_distribution = true;
+int			gp_create_table_hash_reduction = POLICY_HASHREDUCE_MODULO;
 bool		gp_allow_non_uniform_partitioning_ddl = true;
 bool		gp_enable_exchange_default_partition = false;
 int			dtx_phase2_retry_count = 0;
@@ -485,6 +495,8 @@ int			writable_external_table_bufsize = 64;
 /* Executor */
 bool		gp_enable_mk_sort = true;
 bool		gp_enable_motion_mk_sort = true;
+int			gp_mk_sort_parallel_workers = 1;
+bool		gp_mk_sort_abbrev_keys = true;
 
 static const struct config_enum_entry gp_log_format_options[] = {
 	{"text", 0},
@@ -565,6 +577,20 @@ static const struct config_enum_entry gp_interconnect_types[] = {
 	{NULL, 0}
 };
 
+static const struct config_enum_entry gp_plan_serialization_codecs[] = {
+	{"zlib", PLAN_CODEC_ZLIB},
+#ifdef HAVE_LIBZSTD
+	{"zstd", PLAN_CODEC_ZSTD},
+#endif
+	{NULL, 0}
+};
+
+static const struct config_enum_entry gp_create_table_hash_reduction_options[] = {
+	{"modulo", POLICY_HASHREDUCE_MODULO},
+	{"jump", POLICY_HASHREDUCE_JUMP},
+	{NULL, 0}
+};
+
 static const struct config_enum_entry gp_log_verbosity[] = {
 	{"terse", GPVARS_VERBOSITY_TERSE},
 	{"off", GPVARS_VERBOSITY_OFF},
@@ -674,6 +700,17 @@ struct config_bool ConfigureNamesBool_gp[] =
 		&gp_enable_hashjoin_size_heuristic,
 		false, NULL, NULL
 	},
+	{
+		{"gp_enable_runtime_filter", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Lets a scan below a hash join drop rows that cannot match the join's inner side."),
+			gettext_noop("The hash join builds a Bloom filter of its inner join "
+						 "keys and hands it to a table scan that directly feeds "
+						 "its outer side."),
+			GUC_GPDB_ADDOPT
+		},
+		&gp_enable_runtime_filter,
+		true, NULL, NULL
+	},
 	{
 		{"gp_enable_fallback_plan", PGC_USERSET, QUERY_TUNING_METHOD,
 			gettext_noop("Plan types which are not enabled may be used when a "
@@ -948,6 +985,17 @@ struct config_bool ConfigureNamesBool_gp[] =
 		true, NULL, NULL
 	},
 
+	{
+		{"gp_mk_sort_abbrev_keys", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Compare abbreviated keys in multi-key sort."),
+			gettext_noop("Keys of numeric, float, integer, date and timestamp types, and of "
+						 "strings in the C locale, are first compared on a 64-bit prefix."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+		},
+		&gp_mk_sort_abbrev_keys,
+		true, NULL, NULL
+	},
+
 
 #ifdef USE_ASSERT_CHECKING
 	{
@@ -1101,6 +1149,41 @@ struct config_bool ConfigureNamesBool_gp[] =
 		true, NULL, NULL
 	},
 
+	{
+		{"gp_appendonly_zonemap", PGC_USERSET, APPENDONLY_TABLES,
+			gettext_noop("Use per-block minimum and maximum values to skip blocks when scanning append-only tables."),
+			gettext_noop("The values are kept in the block directory, so only tables "
+						 "with an index have them."),
+			GUC_GPDB_ADDOPT
+		},
+		&gp_appendonly_zonemap,
+		true, NULL, NULL
+	},
+
+	{
+		{"gp_enable_aocs_batch_scan", PGC_USERSET, APPENDONLY_TABLES,
+			gettext_noop("Evaluate simple quals of column-oriented table scans over batches of rows."),
+			gettext_noop("Comparisons of a column with a constant and null tests are "
+						 "evaluated a column at a time over the rows of a batch."),
+			GUC_GPDB_ADDOPT
+		},
+		&gp_enable_aocs_batch_scan,
+		true, NULL, NULL
+	},
+
+	{
+		{"gp_enable_aocs_late_materialization", PGC_USERSET, APPENDONLY_TABLES,
+			gettext_noop("Read the other columns of a batch scan only for the rows that pass its batch quals."),
+			gettext_noop("The columns that a batch scan of a column-oriented table needs "
+						 "only for its output or its other quals are read for the rows "
+						 "that pass the batch quals. Blocks without such rows are "
+						 "skipped without being read."),
+			GUC_GPDB_ADDOPT
+		},
+		&gp_enable_aocs_late_materialization,
+		true, NULL, NULL
+	},
+
 	{
 		{"gp_heap_require_relhasoids_match", PGC_USERSET, DEVELOPER_OPTIONS,
 			gettext_noop("Issue an error on discovery of a mismatch between relhasoids and a tuple header."),
@@ -1247,6 +1330,16 @@ struct config_bool ConfigureNamesBool_gp[] =
 		true, NULL, NULL
 	},
 
+	{
+		{"gp_interconnect_local_sockets", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Use Unix-domain sockets for TCP interconnect connections between segments on the same host."),
+			gettext_noop("Connections fall back to TCP if the peer's same-host socket cannot be reached."),
+			GUC_GPDB_ADDOPT
+		},
+		&gp_interconnect_local_sockets,
+		false, NULL, NULL
+	},
+
 	{
 		{"resource_scheduler", PGC_POSTMASTER, RESOURCES_MGM,
 			gettext_noop("Enable resource scheduling."),
@@ -3048,6 +3141,37 @@ struct config_int ConfigureNamesInt_gp[] =
 		10, 0, 100, NULL, NULL
 	},
 
+	{
+		{"gp_appendonly_compaction_segfiles", PGC_USERSET, APPENDONLY_TABLES,
+			gettext_noop("Sets the number of segment files compacted together by each compaction transaction of a lazy vacuum."),
+			gettext_noop("Each segment file is moved to its own insert segment file, and the "
+						 "compacted files are all dropped in one drop transaction.")
+		},
+		&gp_appendonly_compaction_segfiles,
+		1, 1, 64, NULL, NULL
+	},
+
+	{
+		{"gp_appendonly_compaction_io_limit", PGC_USERSET, APPENDONLY_TABLES,
+			gettext_noop("Limits the rate at which vacuum reads append-only segment files to compact them."),
+			gettext_noop("The limit is per segment, in kilobytes per second. Zero disables the limit."),
+			GUC_UNIT_KB | GUC_GPDB_ADDOPT
+		},
+		&gp_appendonly_compaction_io_limit,
+		0, 0, INT_MAX, NULL, NULL
+	},
+
+	{
+		{"gp_appendonly_readahead_depth", PGC_USERSET, APPENDONLY_TABLES,
+			gettext_noop("Sets the number of large reads requested ahead of time when scanning append-only segment files."),
+			gettext_noop("Zero disables read-ahead. Each read is as large as the "
+						 "table's block size allows, typically a few megabytes."),
+			GUC_GPDB_ADDOPT
+		},
+		&gp_appendonly_readahead_depth,
+		0, 0, 64, NULL, NULL
+	},
+
 	{
 		{"gp_workfile_max_entries", PGC_POSTMASTER, RESOURCES,
 			gettext_noop("Sets the maximum number of entries that can be stored in the workfile directory"),
@@ -3289,6 +3413,16 @@ struct config_int ConfigureNamesInt_gp[] =
 		10, 1, 4096, NULL, NULL
 	},
 
+	{
+		{"gp_interconnect_io_batch_size", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Sets the maximum number of packets sent or received per system call by the UDP interconnect."),
+			gettext_noop("A value of 1 sends and receives one packet at a time."),
+			GUC_GPDB_ADDOPT
+		},
+		&Gp_interconnect_io_batch_size,
+		16, 1, GP_INTERCONNECT_MAX_IO_BATCH, NULL, NULL
+	},
+
 	{
 		{"gp_udp_bufsize_k", PGC_BACKEND, GP_ARRAY_TUNING,
 			gettext_noop("Sets recv buf size of UDP interconnect, for testing."),
@@ -3600,6 +3734,27 @@ struct config_int ConfigureNamesInt_gp[] =
 		5, 1, 25, NULL, NULL
 	},
 
+	{
+		{"gp_mk_sort_parallel_workers", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Number of threads an in-memory multi-key sort may use."),
+			gettext_noop("Only sorts on pass-by-value keys of built-in types are parallelized. "
+						 "A value of 1 sorts on the backend alone."),
+			GUC_NOT_IN_SAMPLE | GUC_NO_SHOW_ALL | GUC_GPDB_ADDOPT
+		},
+		&gp_mk_sort_parallel_workers,
+		1, 1, 16, NULL, NULL
+	},
+
+	{
+		{"gp_hashagg_probe_batch_size", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Number of input tuples Hashagg reads ahead to prefetch their hash buckets."),
+			gettext_noop("A value of 1 looks up one input tuple at a time."),
+			GUC_NOT_IN_SAMPLE | GUC_NO_SHOW_ALL | GUC_GPDB_ADDOPT
+		},
+		&gp_hashagg_probe_batch_size,
+		16, 1, 256, NULL, NULL
+	},
+
 	{
 		{"gp_hashagg_default_nbatches", PGC_USERSET, QUERY_TUNING_METHOD,
 			gettext_noop("Default number of batches for hashagg's (re-)spilling phases."),
@@ -3820,6 +3975,36 @@ struct config_int ConfigureNamesInt_gp[] =
 		16, 0, WORKFILE_SAFEWRITE_SIZE, NULL, NULL
 	},
 
+	{
+		{"gp_workfile_prefetch_blocks", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Number of blocks to read ahead when reading spill files sequentially."),
+			gettext_noop("A value of 0 disables read-ahead."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+		},
+		&gp_workfile_prefetch_blocks,
+		16, 0, 1024, NULL, NULL
+	},
+
+	{
+		{"gp_workfile_writeback_blocks", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Number of blocks written to spill files after which their writeback to disk is started."),
+			gettext_noop("A value of 0 leaves writeback to the operating system."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+		},
+		&gp_workfile_writeback_blocks,
+		0, 0, 1024, NULL, NULL
+	},
+
+	{
+		{"gp_workfile_compress_zstd_level", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Compression level of work files compressed with zstd."),
+			gettext_noop("Higher levels produce smaller work files at the cost of more CPU."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+		},
+		&gp_workfile_compress_zstd_level,
+		1, 1, 19, NULL, NULL
+	},
+
 	/* for pljava */
 	{
 		{"pljava_statement_cache_size", PGC_SUSET, CUSTOM_OPTIONS,
@@ -3988,6 +4173,26 @@ struct config_int ConfigureNamesInt_gp[] =
 		16384, 0, INT_MAX, NULL, NULL
 	},
 
+	{
+		{"optimizer_shared_mdcache_size", PGC_POSTMASTER, RESOURCES_MEM,
+			gettext_noop("Sets the size of the optimizer metadata cache shared by all sessions."),
+			gettext_noop("Zero disables the shared cache."),
+			GUC_UNIT_KB | GUC_NOT_IN_SAMPLE
+		},
+		&optimizer_shared_mdcache_size,
+		16384, 0, MAX_KILOBYTES, NULL, NULL
+	},
+
+	{
+		{"optimizer_plan_cache_size", PGC_USERSET, RESOURCES_MEM,
+			gettext_noop("Sets the size of the cache of optimizer plans kept by each session."),
+			gettext_noop("Zero disables the plan cache."),
+			GUC_UNIT_KB | GUC_NOT_IN_SAMPLE
+		},
+		&optimizer_plan_cache_size,
+		0, 0, MAX_KILOBYTES, NULL, NULL
+	},
+
 	{
 		{"memory_profiler_dataset_size", PGC_USERSET, DEVELOPER_OPTIONS,
 			gettext_noop("Set the size in GB"),
@@ -4107,6 +4312,16 @@ struct config_real ConfigureNamesReal_gp[] =
 		0, 0, SIZE_MAX / 1024, NULL, NULL,
 	},
 
+	{
+		{"gp_expr_specialize_above_cost", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Specialize the evaluation of function calls on columns and constants "
+						 "in plans that cost more than this."),
+			gettext_noop("-1 disables specialization.")
+		},
+		&gp_expr_specialize_above_cost,
+		100000, -1, DBL_MAX, NULL, NULL
+	},
+
 	{
 		{"gp_motion_cost_per_row", PGC_USERSET, QUERY_TUNING_COST,
 			gettext_noop("Sets the planner's estimate of the cost of "
@@ -4254,7 +4469,7 @@ struct config_string ConfigureNamesString_gp[] =
 	{
 		{"gp_workfile_compress_algorithm", PGC_USERSET, DEVELOPER_OPTIONS,
 			gettext_noop("Specify the compression algorithm that work files in the query executor use."),
-			gettext_noop("Valid values are \"NONE\", \"ZLIB\"."),
+			gettext_noop("Valid values are \"NONE\", \"ZLIB\", \"LZ4\" and \"ZSTD\", if the server was built with support for them."),
 			GUC_GPDB_ADDOPT
 		},
 		&gp_workfile_compress_algorithm_str,
@@ -4705,6 +4920,33 @@ struct config_enum ConfigureNamesEnum_gp[] =
 		INTERCONNECT_TYPE_UDPIFC, gp_interconnect_types, NULL, NULL
 	},
 
+	{
+		{"gp_plan_serialization_codec", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Sets the codec used to compress plans dispatched to segments."),
+			gettext_noop("Valid values are \"zlib\" and, if the server was built with "
+						 "zstd support, \"zstd\". A setting other than zlib is passed to "
+						 "segments when they are connected, so a segment that cannot decode "
+						 "the codec refuses the connection instead of a plan."),
+			GUC_GPDB_ADDOPT
+		},
+		&gp_plan_serialization_codec,
+		PLAN_CODEC_ZLIB, gp_plan_serialization_codecs, NULL, NULL
+	},
+
+	{
+		{"gp_create_table_hash_reduction", PGC_USERSET, CLIENT_CONN_STATEMENT,
+			gettext_noop("Sets how new hash-distributed tables map hash values to segments."),
+			gettext_noop("Valid values are \"modulo\" and \"jump\". With \"jump\", "
+						 "only the rows that belong on new segments change segment when the "
+						 "cluster grows, but the planner treats such tables as randomly "
+						 "distributed, so joins and aggregates on their distribution key "
+						 "need motions."),
+			GUC_NOT_IN_SAMPLE
+		},
+		&gp_create_table_hash_reduction,
+		POLICY_HASHREDUCE_MODULO, gp_create_table_hash_reduction_options, NULL, NULL
+	},
+
 	{
 		{"gp_log_fts", PGC_SIGHUP, LOGGING_WHAT,
 			gettext_noop("Sets the verbosity of logged messages pertaining to fault probing."),
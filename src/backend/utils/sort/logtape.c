@@ -114,6 +114,10 @@ struct LogicalTape
 
 	int64 		firstBlkNum;  /* First block block number */
 	LogicalTapePos   currPos;         /* current postion */
+
+	/* blocks [prefetchStart, prefetchEnd) have been prefetched for reading */
+	int64		prefetchStart;
+	int64		prefetchEnd;
 };
 
 /*
@@ -156,6 +160,7 @@ struct LogicalTapeSet
 
 static void ltsWriteBlock(LogicalTapeSet *lts, int64 blocknum, void *buffer);
 static void ltsReadBlock(LogicalTapeSet *lts, int64 blocknum, void *buffer);
+static void ltsPrefetch(LogicalTapeSet *lts, LogicalTape *lt);
 static long ltsGetFreeBlock(LogicalTapeSet *lts);
 static void ltsReleaseBlock(LogicalTapeSet *lts, int64 blocknum);
 static LogicalTapeSet *LogicalTapeSetCreate_Named(const char *set_prefix, int ntapes, bool del_on_close);
@@ -218,6 +223,8 @@ LoadLogicalTapeSetState(ExecWorkFile *statefile, ExecWorkFile *tapefile)
 
 	lt->currPos.blkNum = lt->firstBlkNum;
 	lt->currPos.offset = 0;
+	lt->prefetchStart = 0;
+	lt->prefetchEnd = 0;
 
 	return lts;
 }
@@ -268,6 +275,42 @@ ltsReadBlock(LogicalTapeSet *lts, int64 blocknum, void *buffer)
 	}
 }
 
+/*
+ * Prefetch the blocks following the current block of a tape being read.
+ *
+ * Only the next block of a tape is known for sure.  But a run is written
+ * while no other tape is written, so its blocks mostly lie one after the
+ * other in the file; prefetch gp_workfile_prefetch_blocks blocks starting at
+ * the next one.  A new request is issued once the tape has consumed half of
+ * the previous one, or has moved outside of it.
+ */
+static void
+ltsPrefetch(LogicalTapeSet *lts, LogicalTape *lt)
+{
+	int64		next = lt->currBlk.next_blk;
+	int64		start;
+	int64		end;
+
+	if (gp_workfile_prefetch_blocks <= 0 || next == -1L)
+		return;
+
+	if (next >= lt->prefetchStart &&
+		next + gp_workfile_prefetch_blocks / 2 < lt->prefetchEnd)
+		return;
+
+	end = Min(next + gp_workfile_prefetch_blocks, lts->nFileBlocks);
+	if (next >= lt->prefetchStart && next < lt->prefetchEnd)
+		start = lt->prefetchEnd;
+	else
+		start = next;
+
+	if (start < end)
+		ExecWorkFile_Prefetch(lts->pfile, start * BLCKSZ, (end - start) * BLCKSZ);
+
+	lt->prefetchStart = next;
+	lt->prefetchEnd = end;
+}
+
 /*
  * qsort comparator for sorting freeBlocks[] into decreasing order.
  */
@@ -363,6 +406,8 @@ LogicalTapeCreate(LogicalTapeSet *lts, LogicalTape *lt)
 	lt->firstBlkNum = -1L;
 	lt->currPos.blkNum = -1L;
 	lt->currPos.offset = 0;
+	lt->prefetchStart = 0;
+	lt->prefetchEnd = 0;
 	return lt;
 }
 
@@ -570,10 +615,17 @@ LogicalTapeRewind(LogicalTapeSet *lts, LogicalTape *lt, bool forWrite)
 			lt->currPos.blkNum = lt->firstBlkNum;
 			lt->currPos.offset = 0;
 		}
+
+		lt->prefetchStart = 0;
+		lt->prefetchEnd = 0;
+		if (lt->firstBlkNum != -1L)
+			ltsPrefetch(lts, lt);
 	}
 	else
 	{
 		lt->firstBlkNum = -1L;
+		lt->prefetchStart = 0;
+		lt->prefetchEnd = 0;
 		lt->currBlk.prev_blk = -1L;
 		lt->currBlk.next_blk = -1L;
 		lt->currBlk.payload_tail = 0;
@@ -620,6 +672,7 @@ LogicalTapeRead(LogicalTapeSet *lts, LogicalTape *lt,
 			lt->currPos.blkNum = lt->currBlk.next_blk;
 			lt->currPos.offset = 0;
 			ltsReadBlock(lts, lt->currBlk.next_blk, &lt->currBlk);
+			ltsPrefetch(lts, lt);
 
 			if(!lt->frozen)
 			{
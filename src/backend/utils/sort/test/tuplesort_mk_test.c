@@ -0,0 +1,132 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+
+#include "cmockery.h"
+
+#include "../tuplesort_mk.c"
+
+/* Datum is signed, the abbreviated keys are compared unsigned */
+#define ABBREV(f, d) ((uint64) f(d))
+
+/*
+ * Check that the abbreviated keys of consecutive values of a sorted array
+ * are ordered.  If exact, they must also be strictly increasing where the
+ * values differ.
+ */
+static void
+check_abbrev_order(MKAbbreviate abbrev, Datum *sorted, int n, bool exact)
+{
+	int			i;
+
+	for (i = 1; i < n; i++)
+	{
+		uint64		prev = ABBREV(abbrev, sorted[i - 1]);
+		uint64		cur = ABBREV(abbrev, sorted[i]);
+
+		if (exact)
+			assert_true(prev < cur);
+		else
+			assert_true(prev <= cur);
+	}
+}
+
+void
+test__tupsort_abbrev__Int(void **state)
+{
+	Datum		i2[] = {Int16GetDatum(PG_INT16_MIN), Int16GetDatum(-1), Int16GetDatum(0),
+		Int16GetDatum(1), Int16GetDatum(PG_INT16_MAX)};
+	Datum		i8[] = {Int64GetDatum(PG_INT64_MIN), Int64GetDatum(-1), Int64GetDatum(0),
+		Int64GetDatum(1), Int64GetDatum(PG_INT64_MAX)};
+	Datum		oid[] = {ObjectIdGetDatum(0), ObjectIdGetDatum(1), ObjectIdGetDatum(0x7FFFFFFF),
+		ObjectIdGetDatum(0xFFFFFFFF)};
+
+	check_abbrev_order(tupsort_abbrev_int2, i2, lengthof(i2), true);
+	check_abbrev_order(tupsort_abbrev_int8, i8, lengthof(i8), true);
+	check_abbrev_order(tupsort_abbrev_oid, oid, lengthof(oid), true);
+}
+
+void
+test__tupsort_abbrev__Float(void **state)
+{
+	Datum		f8[] = {Float8GetDatum(-get_float8_infinity()), Float8GetDatum(-1e300),
+		Float8GetDatum(-1.5), Float8GetDatum(-1e-300), Float8GetDatum(0),
+		Float8GetDatum(1e-300), Float8GetDatum(1.5), Float8GetDatum(1e300),
+		Float8GetDatum(get_float8_infinity()), Float8GetDatum(get_float8_nan())};
+
+	check_abbrev_order(tupsort_abbrev_float8, f8, lengthof(f8), true);
+
+	/* -0 = 0, and all NaNs are equal */
+	assert_true(ABBREV(tupsort_abbrev_float8, Float8GetDatum(-0.0)) ==
+				ABBREV(tupsort_abbrev_float8, Float8GetDatum(0.0)));
+	assert_true(ABBREV(tupsort_abbrev_float8, Float8GetDatum(-get_float8_nan())) ==
+				ABBREV(tupsort_abbrev_float8, Float8GetDatum(get_float8_nan())));
+	assert_true(ABBREV(tupsort_abbrev_float4, Float4GetDatum(-1.5)) <
+				ABBREV(tupsort_abbrev_float4, Float4GetDatum(0.25)));
+}
+
+void
+test__tupsort_abbrev__Text(void **state)
+{
+	Datum		t[] = {CStringGetTextDatum(""), CStringGetTextDatum("a"),
+		CStringGetTextDatum("ab"), CStringGetTextDatum("abcdefgh"),
+		CStringGetTextDatum("abcdefghij"), CStringGetTextDatum("abd"),
+		CStringGetTextDatum("\xff")};
+
+	check_abbrev_order(tupsort_abbrev_text, t, lengthof(t), false);
+
+	/* only the first 8 bytes are used */
+	assert_true(ABBREV(tupsort_abbrev_text, t[3]) == ABBREV(tupsort_abbrev_text, t[4]));
+	assert_true(ABBREV(tupsort_abbrev_text, t[1]) < ABBREV(tupsort_abbrev_text, t[2]));
+
+	/* trailing blanks don't matter for char(n) */
+	assert_true(ABBREV(tupsort_abbrev_bpchar, CStringGetTextDatum("ab  ")) ==
+				ABBREV(tupsort_abbrev_bpchar, CStringGetTextDatum("ab")));
+}
+
+static Datum
+make_numeric(const char *str)
+{
+	return DirectFunctionCall3(numeric_in, CStringGetDatum(str),
+							   ObjectIdGetDatum(InvalidOid), Int32GetDatum(-1));
+}
+
+void
+test__tupsort_abbrev__Numeric(void **state)
+{
+	const char *strs[] = {"-1e100", "-123456789.5", "-123456789", "-1", "-0.0001",
+		"0", "0.0001", "0.5", "1", "1.00000001", "9999", "10000", "123456789",
+		"1e100", "NaN"};
+	Datum		n[lengthof(strs)];
+	int			i;
+
+	for (i = 0; i < lengthof(strs); i++)
+		n[i] = make_numeric(strs[i]);
+
+	check_abbrev_order(numeric_abbrev, n, lengthof(n), false);
+
+	/* zero is zero, whatever its scale */
+	assert_true(ABBREV(numeric_abbrev, make_numeric("0")) ==
+				ABBREV(numeric_abbrev, make_numeric("0.000")));
+
+	/* values that differ in the first digits have different keys */
+	assert_true(ABBREV(numeric_abbrev, n[8]) < ABBREV(numeric_abbrev, n[10]));
+	assert_true(ABBREV(numeric_abbrev, n[2]) < ABBREV(numeric_abbrev, n[3]));
+}
+
+int
+main(int argc, char* argv[])
+{
+	cmockery_parse_arguments(argc, argv);
+
+	const UnitTest tests[] = {
+		unit_test(test__tupsort_abbrev__Int),
+		unit_test(test__tupsort_abbrev__Float),
+		unit_test(test__tupsort_abbrev__Text),
+		unit_test(test__tupsort_abbrev__Numeric)
+	};
+
+	MemoryContextInit();
+
+	return run_tests(tests);
+}
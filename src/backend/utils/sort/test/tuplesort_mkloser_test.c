@@ -0,0 +1,208 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+
+#include "cmockery.h"
+
+#include "../tuplesort_mkloser.c"
+
+#include "utils/builtins.h"
+
+/*
+ * Synthetic sorted streams.  Each row has two int32 sort keys; the first one
+ * has many duplicates across streams, so that the second key and the
+ * stability of the merge are exercised too.
+ */
+typedef struct TestRow
+{
+	int32		k1;
+	int32		k2;
+	int			stream;
+} TestRow;
+
+typedef struct TestStream
+{
+	int			stream;
+	int			nrows;
+	int			pos;
+} TestStream;
+
+static bool
+test_stream_read(void *vpctxt, MKEntry *e)
+{
+	TestStream *s = (TestStream *) vpctxt;
+	TestRow    *row;
+
+	MemSet(e, 0, sizeof(MKEntry));
+
+	if (s->pos >= s->nrows)
+		return false;
+
+	row = (TestRow *) palloc(sizeof(TestRow));
+	row->k1 = s->pos / 4;
+	row->k2 = (s->pos % 4) * 10 + s->stream % 10;
+	row->stream = s->stream;
+	s->pos++;
+
+	e->ptr = row;
+	return true;
+}
+
+static Datum
+test_fetch_datum(MKEntry *e, MKContext *mkctxt, MKLvContext *lvctxt, bool *isNullOut)
+{
+	TestRow    *row = (TestRow *) e->ptr;
+
+	*isNullOut = false;
+	return Int32GetDatum(lvctxt->attno == 1 ? row->k1 : row->k2);
+}
+
+static void
+test_free_tuple(MKEntry *e)
+{
+	pfree(e->ptr);
+	e->ptr = NULL;
+}
+
+static void
+test_init_context(MKContext *mkctxt)
+{
+	int			lv;
+
+	MemSet(mkctxt, 0, sizeof(MKContext));
+	mkctxt->total_lv = 2;
+	mkctxt->lvctxt = (MKLvContext *) palloc0(sizeof(MKLvContext) * 2);
+	mkctxt->fetchForPrep = test_fetch_datum;
+	mkctxt->cpfr = tupsort_cpfr;
+	mkctxt->freeTup = test_free_tuple;
+
+	for (lv = 0; lv < 2; lv++)
+	{
+		MKLvContext *lvctxt = mkctxt->lvctxt + lv;
+
+		lvctxt->typByVal = true;
+		lvctxt->typLen = sizeof(int32);
+		lvctxt->attno = lv + 1;
+		lvctxt->mkctxt = mkctxt;
+		lvctxt->scanKey.sk_func.fn_addr = btint4cmp;
+		lvctxt->scanKey.sk_func.fn_nargs = 2;
+		lvctxt->scanKey.sk_func.fn_strict = true;
+	}
+	mkctxt->lvctxt[0].lvtype = MKLV_TYPE_INT32;
+	mkctxt->lvctxt[1].lvtype = MKLV_TYPE_NONE;
+}
+
+static MKHeapReader *
+test_make_readers(int nreader, int nrows, bool someEmpty)
+{
+	MKHeapReader *readers = (MKHeapReader *) palloc(sizeof(MKHeapReader) * nreader);
+	int			i;
+
+	for (i = 0; i < nreader; i++)
+	{
+		TestStream *s = (TestStream *) palloc(sizeof(TestStream));
+
+		s->stream = i;
+		s->nrows = (someEmpty && i % 3 == 1) ? 0 : nrows + i % 5;
+		s->pos = 0;
+		readers[i].reader = test_stream_read;
+		readers[i].mkhr_ctxt = s;
+	}
+	return readers;
+}
+
+static int
+test_ceil_log2(int n)
+{
+	int			k = 0;
+
+	while ((1 << k) < n)
+		k++;
+	return k;
+}
+
+static void
+test_merge(int nreader, int nrows, bool someEmpty)
+{
+	MKContext	mkctxt;
+	MKHeapReader *readers;
+	MKLoserTree *lt;
+	MKEntry		e;
+	TestRow		prev;
+	int64		expected = 0;
+	int64		count = 0;
+	int			i;
+
+	test_init_context(&mkctxt);
+	readers = test_make_readers(nreader, nrows, someEmpty);
+	for (i = 0; i < nreader; i++)
+		expected += ((TestStream *) readers[i].mkhr_ctxt)->nrows;
+
+	lt = mkloser_from_reader(readers, nreader, &mkctxt);
+
+	/* building the tree plays one match per internal node */
+	assert_true(lt->ncompares <= nreader - 1);
+
+	while (mkloser_get(lt, &e))
+	{
+		TestRow    *row = (TestRow *) e.ptr;
+
+		if (count > 0)
+		{
+			assert_true(prev.k1 <= row->k1);
+			if (prev.k1 == row->k1)
+			{
+				assert_true(prev.k2 <= row->k2);
+				if (prev.k2 == row->k2)
+					assert_true(prev.stream < row->stream);
+			}
+		}
+		prev = *row;
+		pfree(row);
+		count++;
+	}
+
+	assert_true(mke_is_empty(&e));
+	assert_int_equal(count, expected);
+	assert_true(lt->ncompares <= nreader - 1 + count * test_ceil_log2(nreader));
+
+	/* an exhausted tree stays exhausted */
+	assert_false(mkloser_get(lt, &e));
+
+	mkloser_destroy(lt);
+}
+
+void
+test__mkloser_get__MergesInOrder(void **state)
+{
+	test_merge(1, 100, false);
+	test_merge(2, 100, false);
+	test_merge(3, 100, false);
+	test_merge(7, 100, false);
+	test_merge(64, 100, false);
+	test_merge(400, 20, false);
+}
+
+void
+test__mkloser_get__EmptyReaders(void **state)
+{
+	test_merge(2, 100, true);
+	test_merge(7, 100, true);
+	test_merge(400, 20, true);
+	test_merge(5, 0, false);
+}
+
+int
+main(int argc, char* argv[])
+{
+	cmockery_parse_arguments(argc, argv);
+
+	const UnitTest tests[] = {
+		unit_test(test__mkloser_get__MergesInOrder),
+		unit_test(test__mkloser_get__EmptyReaders)
+	};
+
+	MemoryContextInit();
+
+	return run_tests(tests);
+}
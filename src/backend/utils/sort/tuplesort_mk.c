@@ -100,6 +100,8 @@
 
 #include "postgres.h"
 
+#include <math.h>
+
 #include "access/heapam.h"
 #include "access/nbtree.h"
 #include "access/tuptoaster.h"
@@ -115,12 +117,15 @@
 #include "executor/execWorkfile.h"
 #include "utils/logtape.h"
 #include "utils/lsyscache.h"
+#include "utils/numeric.h"
 #include "utils/memutils.h"
 #include "utils/pg_rusage.h"
 #include "utils/syscache.h"
 #include "utils/tuplesort.h"
 #include "utils/pg_locale.h"
 #include "utils/builtins.h"
+#include "utils/date.h"
+#include "utils/timestamp.h"
 #include "utils/tuplesort_mk.h"
 #include "utils/tuplesort_mk_details.h"
 #include "utils/string_wrapper.h"
@@ -418,6 +423,9 @@ is_under_sort_or_exec_ctxt(Tuplesortstate_mk *state)
  *	 not copied -- so for large strings we must resort to datum-based comparison.
  */
 #define STRXFRM_INPUT_LENGTH_LIMIT (512)
+
+/* Fewest entries per range worth sorting on a thread of its own */
+#define MKSORT_PARALLEL_MIN_PART (64 * 1024)
 #define COPYTUP(state,stup,tup) ((*(state)->copytup) (state, stup, tup))
 #define WRITETUP(state,tape,stup)	((*(state)->writetup) (state, tape, stup))
 #define READTUP(state,pos,stup,tape,len) ((*(state)->readtup) (state, pos, stup, tape, len))
@@ -504,9 +512,12 @@ static void readtup_datum(Tuplesortstate_mk *state, TuplesortPos_mk *pos, MKEntr
 			  LogicalTape *lt, uint32 len);
 
 static void tupsort_prepare_char(MKEntry *a, bool isChar);
+static void tupsort_set_abbrev(MKLvContext *lvctxt);
+static inline int bcTruelen(char *p, int len);
 static int	tupsort_compare_char(MKEntry *v1, MKEntry *v2, MKLvContext *lvctxt, MKContext *mkContext);
 
 static Datum tupsort_fetch_datum_mtup(MKEntry *a, MKContext *mkctxt, MKLvContext *lvctxt, bool *isNullOut);
+static bool tuplesort_parallel_sort(Tuplesortstate_mk *state);
 static Datum tupsort_fetch_datum_itup(MKEntry *a, MKContext *mkctxt, MKLvContext *lvctxt, bool *isNullOut);
 
 static int32 estimateMaxPrepareSizeForEntry(MKEntry *a, struct MKContext *mkctxt);
@@ -683,6 +694,7 @@ create_mksort_context(
 	mkctxt->cpfr = tupsort_cpfr;
 	mkctxt->freeTup = freeTupleFn;
 	mkctxt->estimatedExtraForPrep = 0;
+	mkctxt->inParallelSort = false;
 
 	lc_guess_strxfrm_scaling_factor(&mkctxt->strxfrmScaleFactor, &mkctxt->strxfrmConstantFactor);
 
@@ -743,6 +755,8 @@ create_mksort_context(
 				else if (sinfo->scanKey.sk_func.fn_addr == bttextcmp)
 					sinfo->lvtype = MKLV_TYPE_TEXT;
 			}
+			if (sinfo->lvtype == MKLV_TYPE_NONE && gp_mk_sort_abbrev_keys)
+				tupsort_set_abbrev(sinfo);
 		}
 		else
 		{
@@ -1341,10 +1355,10 @@ tuplesort_performsort_mk(Tuplesortstate_mk *state)
 			 * We were able to accumulate all the tuples within the allowed
 			 * amount of memory.  Just qsort 'em and we're done.
 			 */
-			if (!state->mkctxt.bounded)
-				mk_qsort(state->entries, state->entry_count, &state->mkctxt);
-			else
+			if (state->mkctxt.bounded)
 				tuplesort_limit_sort(state);
+			else if (!tuplesort_parallel_sort(state))
+				mk_qsort(state->entries, state->entry_count, &state->mkctxt);
 
 			state->pos.current = 0;
 			state->pos.eof_reached = false;
@@ -3110,6 +3124,32 @@ tupsort_compare_datum(MKEntry *v1, MKEntry *v2, MKLvContext *lvctxt, MKContext *
 
 				return ((lvctxt->scanKey.sk_flags & SK_BT_DESC) != 0) ? -result : result;
 			}
+		case MKLV_TYPE_ABBREV:
+			{
+				uint64		a1 = (uint64) v1->d;
+				uint64		a2 = (uint64) v2->d;
+				int			result;
+				Datum		d1;
+				Datum		d2;
+				bool		isnull;
+
+				if (a1 != a2)
+				{
+					result = (a1 < a2) ? -1 : 1;
+					return ((lvctxt->scanKey.sk_flags & SK_BT_DESC) != 0) ? -result : result;
+				}
+				if (!lvctxt->abbrevLossy)
+					return 0;
+
+				/* equal abbreviated keys, compare the original values */
+				d1 = (context->fetchForPrep) (v1, context, lvctxt, &isnull);
+				Assert(!isnull);
+				d2 = (context->fetchForPrep) (v2, context, lvctxt, &isnull);
+				Assert(!isnull);
+				return inlineApplySortFunction(&lvctxt->scanKey.sk_func, lvctxt->scanKey.sk_flags,
+											   d1, false,
+											   d2, false);
+			}
 		default:
 			return tupsort_compare_char(v1, v2, lvctxt, context);
 	}
@@ -3145,7 +3185,7 @@ tupsort_cpfr(MKEntry *dst, MKEntry *src, MKLvContext *lvctxt)
 		{
 			if (mke_is_refc(src))
 				tupsort_refcnt(DatumGetPointer(dst->d), 1);
-			else if (!lvctxt->typByVal)
+			else if (!lvctxt->typByVal && lvctxt->lvtype != MKLV_TYPE_ABBREV)
 			{
 				Assert(src->d != 0);
 				dst->d = datumCopy(src->d, lvctxt->typByVal, lvctxt->typLen);
@@ -3334,6 +3374,164 @@ tupsort_prepare(MKEntry *a, MKContext *mkctxt, int lv)
 		tupsort_prepare_char(a, true);
 	else if (lvctxt->lvtype == MKLV_TYPE_TEXT)
 		tupsort_prepare_char(a, false);
+	else if (lvctxt->lvtype == MKLV_TYPE_ABBREV && !isnull)
+		a->d = (lvctxt->abbrev) (a->d);
+}
+
+/*
+ * Abbreviated keys.
+ *
+ * For the sort functions below, a level is compared on a 64-bit abbreviated
+ * key computed once when the entry is prepared, instead of calling the sort
+ * function through fmgr for every comparison.  The keys of pass-by-value
+ * types are exact.  Those of numeric and, in the C locale, of strings only
+ * cover a prefix of the value, and ties are broken with the sort function.
+ */
+static Datum
+tupsort_abbrev_int2(Datum d)
+{
+	return (Datum) ((uint64) (int64) DatumGetInt16(d) ^ (UINT64CONST(1) << 63));
+}
+
+static Datum
+tupsort_abbrev_int4(Datum d)
+{
+	return (Datum) ((uint64) (int64) DatumGetInt32(d) ^ (UINT64CONST(1) << 63));
+}
+
+static Datum
+tupsort_abbrev_int8(Datum d)
+{
+	return (Datum) ((uint64) DatumGetInt64(d) ^ (UINT64CONST(1) << 63));
+}
+
+static Datum
+tupsort_abbrev_oid(Datum d)
+{
+	return (Datum) (uint64) DatumGetObjectId(d);
+}
+
+/*
+ * The float comparison functions treat all NaNs as equal and larger than
+ * any other value, and -0 as equal to 0.  Other than that, flipping the sign
+ * bit of positive values and all bits of negative ones gives their order.
+ */
+static Datum
+tupsort_abbrev_float(float8 f)
+{
+	uint64		bits;
+
+	if (isnan(f))
+		return (Datum) PG_UINT64_MAX;
+	if (f == 0)
+		f = 0;
+
+	memcpy(&bits, &f, sizeof(bits));
+	if (bits & (UINT64CONST(1) << 63))
+		bits = ~bits;
+	else
+		bits |= UINT64CONST(1) << 63;
+
+	return (Datum) bits;
+}
+
+static Datum
+tupsort_abbrev_float4(Datum d)
+{
+	return tupsort_abbrev_float((float8) DatumGetFloat4(d));
+}
+
+static Datum
+tupsort_abbrev_float8(Datum d)
+{
+	return tupsort_abbrev_float(DatumGetFloat8(d));
+}
+
+/*
+ * The first 8 bytes of a string, in the C locale.  Shorter strings are
+ * padded with zeroes, so they sort before their extensions.
+ */
+static Datum
+tupsort_abbrev_str(Datum d, bool isCHAR)
+{
+	char	   *p;
+	int			len;
+	void	   *tofree = NULL;
+	uint64		result = 0;
+	int			i;
+
+	varattrib_untoast_ptr_len(d, &p, &len, &tofree);
+
+	if (isCHAR)
+		len = bcTruelen(p, len);
+
+	for (i = 0; i < sizeof(uint64); i++)
+		result = (result << 8) | (i < len ? (unsigned char) p[i] : 0);
+
+	if (tofree)
+		pfree(tofree);
+
+	return (Datum) result;
+}
+
+static Datum
+tupsort_abbrev_text(Datum d)
+{
+	return tupsort_abbrev_str(d, false);
+}
+
+static Datum
+tupsort_abbrev_bpchar(Datum d)
+{
+	return tupsort_abbrev_str(d, true);
+}
+
+typedef struct MKAbbrevFunc
+{
+	PGFunction	sortFunction;
+	MKAbbreviate abbrev;
+	bool		lossy;
+	bool		cLocaleOnly;
+} MKAbbrevFunc;
+
+static const MKAbbrevFunc tupsort_abbrev_funcs[] =
+{
+	{btint2cmp, tupsort_abbrev_int2, false, false},
+	{btint8cmp, tupsort_abbrev_int8, false, false},
+	{btoidcmp, tupsort_abbrev_oid, false, false},
+	{date_cmp, tupsort_abbrev_int4, false, false},
+#ifdef HAVE_INT64_TIMESTAMP
+	{timestamp_cmp, tupsort_abbrev_int8, false, false},
+#endif
+	{btfloat4cmp, tupsort_abbrev_float4, false, false},
+	{btfloat8cmp, tupsort_abbrev_float8, false, false},
+	{numeric_cmp, numeric_abbrev, true, false},
+	{bttextcmp, tupsort_abbrev_text, true, true},
+	{bpcharcmp, tupsort_abbrev_bpchar, true, true},
+};
+
+/*
+ * Use abbreviated keys for a level, if its sort function has them.
+ */
+static void
+tupsort_set_abbrev(MKLvContext *lvctxt)
+{
+	PGFunction	cmp = lvctxt->scanKey.sk_func.fn_addr;
+	int			i;
+
+	for (i = 0; i < lengthof(tupsort_abbrev_funcs); i++)
+	{
+		const MKAbbrevFunc *f = &tupsort_abbrev_funcs[i];
+
+		if (f->sortFunction == cmp &&
+			(!f->cLocaleOnly || lc_collate_is_c()))
+		{
+			lvctxt->lvtype = MKLV_TYPE_ABBREV;
+			lvctxt->abbrev = f->abbrev;
+			lvctxt->abbrevLossy = f->lossy;
+			return;
+		}
+	}
 }
 
 /* "True" length (not counting trailing blanks) of a BpChar */
@@ -3684,6 +3882,82 @@ tuplesort_heap_insert(Tuplesortstate_mk *state, MKEntry *e)
 	}
 }
 
+/*
+ * Can a sort level be prepared and compared by mk_qsort_parallel's threads?
+ * That requires pass-by-value datums, and a comparison that is known not to
+ * allocate memory or raise errors.
+ */
+static bool
+tuplesort_level_is_thread_safe(MKLvContext *lvctxt)
+{
+	PGFunction	cmp = lvctxt->scanKey.sk_func.fn_addr;
+
+	if (!lvctxt->typByVal)
+		return false;
+
+	if (lvctxt->lvtype == MKLV_TYPE_INT32)
+		return true;
+
+	/* the abbreviated keys of pass-by-value types are computed in place */
+	if (lvctxt->lvtype == MKLV_TYPE_ABBREV)
+		return true;
+
+	return lvctxt->lvtype == MKLV_TYPE_NONE &&
+		(cmp == btint2cmp || cmp == btint4cmp || cmp == btint8cmp ||
+		 cmp == btint24cmp || cmp == btint42cmp ||
+		 cmp == btint48cmp || cmp == btint84cmp ||
+		 cmp == btoidcmp || cmp == btfloat4cmp || cmp == btfloat8cmp ||
+		 cmp == date_cmp || cmp == timestamp_cmp);
+}
+
+/*
+ * Sort the in-memory entries on gp_mk_sort_parallel_workers threads, if the
+ * sort is large enough and its keys allow it.  Returns false if the caller
+ * must sort serially instead.
+ *
+ * The merge needs a second entry array.  It is allocated here, in the sort
+ * context, and only if it fits in the sort's memory budget; the threads
+ * themselves never allocate memory.
+ */
+static bool
+tuplesort_parallel_sort(Tuplesortstate_mk *state)
+{
+	MKContext  *mkctxt = &state->mkctxt;
+	MKEntry    *scratch;
+	Size		scratchsize;
+	int			nparts;
+	int			lv;
+
+	nparts = Min(gp_mk_sort_parallel_workers, MKQS_MAX_PARALLEL);
+	nparts = Min(nparts, (int) (state->entry_count / MKSORT_PARALLEL_MIN_PART));
+	if (nparts < 2)
+		return false;
+
+	if (mkctxt->unique || mkctxt->enforceUnique)
+		return false;
+
+	/* index tuple attribute access caches offsets in the shared tupdesc */
+	if (mkctxt->fetchForPrep != NULL &&
+		mkctxt->fetchForPrep != tupsort_fetch_datum_mtup)
+		return false;
+
+	for (lv = 0; lv < mkctxt->total_lv; lv++)
+	{
+		if (!tuplesort_level_is_thread_safe(mkctxt->lvctxt + lv))
+			return false;
+	}
+
+	scratchsize = state->entry_count * sizeof(MKEntry);
+	if (MemoryContextGetCurrentSpace(state->sortcontext) + scratchsize > state->memAllowed)
+		return false;
+
+	scratch = (MKEntry *) palloc(scratchsize);
+	mk_qsort_parallel(state->entries, (int) state->entry_count, mkctxt, nparts, scratch);
+	pfree(scratch);
+
+	return true;
+}
+
 static void
 tuplesort_limit_sort(Tuplesortstate_mk *state)
 {
@@ -0,0 +1,253 @@
+/*-------------------------------------------------------------------------
+ *
+ * tuplesort_mkloser.c
+ *	  Multi level key loser tree, for merging sorted streams.
+ *
+ * Portions Copyright (c) 2018-Present Pivotal Software, Inc.
+ *
+ *
+ * IDENTIFICATION
+ *	    src/backend/utils/sort/tuplesort_mkloser.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+#include "access/nbtree.h"
+#include "utils/tuplesort.h"
+#include "utils/tuplesort_mk.h"
+#include "utils/tuplesort_mk_details.h"
+#include "miscadmin.h"
+
+/*
+ * Loser tree (tournament tree) merge of k sorted streams.
+ *
+ * The current entry of each reader is a leaf of a complete binary tree.
+ * Leaf i is the implicit node k + i, and the internal nodes 1 .. k-1 each
+ * remember the reader that lost the match played at that node.  tree[0]
+ * holds the overall winner.  After the winner is returned, the next entry
+ * of the same reader replays the matches on the path from its leaf to the
+ * root, which takes exactly ceil(log2(k)) comparisons, against about
+ * 2 * log2(k) for sifting down a heap.
+ *
+ * Each entry keeps the first key prepared as in the mk heap, so for int32
+ * keys and for strings in a non-C locale (strxfrm'd once when the entry is
+ * read) most comparisons never look into the tuple.  The later keys are
+ * only fetched when the first keys tie.
+ */
+
+/* Check for interrupts every COMPARES_BETWEEN_INTERRUPT_CHECKS comparisons */
+#define COMPARES_BETWEEN_INTERRUPT_CHECKS 100000
+
+static int32
+mkloser_compare(MKLoserTree *lt, MKEntry *a, MKEntry *b)
+{
+	MKContext  *mkctxt = lt->mkctxt;
+	MKLvContext *lvctxt = mkctxt->lvctxt;
+	int32		ret;
+	int			lv;
+
+	if (lt->ncompares++ % COMPARES_BETWEEN_INTERRUPT_CHECKS == 0)
+		CHECK_FOR_INTERRUPTS();
+
+	/* exhausted readers lose against everything */
+	if (mke_is_empty(a) || mke_is_empty(b))
+		return (int32) mke_is_empty(a) - (int32) mke_is_empty(b);
+
+	/* first key, from the prepared datums */
+	ret = mke_get_nullbits(a) - mke_get_nullbits(b);
+	if (ret != 0)
+		return ret;
+
+	if (!mke_is_null(a))
+	{
+		if (lvctxt->lvtype == MKLV_TYPE_INT32)
+		{
+			int32		i1 = DatumGetInt32(a->d);
+			int32		i2 = DatumGetInt32(b->d);
+
+			ret = (i1 < i2) ? -1 : ((i1 == i2) ? 0 : 1);
+			if ((lvctxt->scanKey.sk_flags & SK_BT_DESC) != 0)
+				ret = -ret;
+		}
+		else
+			ret = tupsort_compare_datum(a, b, lvctxt, mkctxt);
+
+		if (ret != 0)
+			return ret;
+	}
+
+	/* remaining keys, fetched from the tuples */
+	for (lv = 1; lv < mkctxt->total_lv; lv++)
+	{
+		Datum		d1;
+		Datum		d2;
+		bool		isnull1;
+		bool		isnull2;
+
+		lvctxt = mkctxt->lvctxt + lv;
+		d1 = (mkctxt->fetchForPrep) (a, mkctxt, lvctxt, &isnull1);
+		d2 = (mkctxt->fetchForPrep) (b, mkctxt, lvctxt, &isnull2);
+
+		ret = ApplySortFunction(&lvctxt->scanKey.sk_func, lvctxt->scanKey.sk_flags,
+								d1, isnull1, d2, isnull2);
+		if (ret != 0)
+			return ret;
+	}
+
+	return 0;
+}
+
+/*
+ * Does reader i's entry come before reader j's?  Ties go to the lower
+ * reader, so that the merge is stable.
+ */
+static inline bool
+mkloser_before(MKLoserTree *lt, int i, int j)
+{
+	int32		ret = mkloser_compare(lt, lt->entries + i, lt->entries + j);
+
+	return ret < 0 || (ret == 0 && i < j);
+}
+
+/*
+ * Read the next entry of reader i and prepare its first key.
+ */
+static void
+mkloser_read(MKLoserTree *lt, int i)
+{
+	MKEntry    *e = lt->entries + i;
+
+	if (lt->readers[i].reader(lt->readers[i].mkhr_ctxt, e))
+	{
+		mke_blank(e);
+		tupsort_prepare(e, lt->mkctxt, 0);
+		mke_set_lv(e, 0);
+		mke_set_reader(e, i);
+	}
+	else
+		mke_set_empty(e);
+}
+
+/*
+ * Create a loser tree over an array of readers.  Like the mk heap, the tree
+ * does not own the readers.  The first entry of every reader is read here.
+ */
+MKLoserTree *
+mkloser_from_reader(MKHeapReader *readers, int nreader, MKContext *mkctxt)
+{
+	MKLoserTree *lt = (MKLoserTree *) palloc(sizeof(MKLoserTree));
+	int			i;
+
+	Assert(readers && nreader > 0 && nreader <= MKE_MAX_READER);
+	Assert(mkctxt && mkctxt->fetchForPrep);
+
+	lt->mkctxt = mkctxt;
+	lt->readers = readers;
+	lt->nreader = nreader;
+	lt->ncompares = 0;
+	lt->entries = (MKEntry *) palloc0(sizeof(MKEntry) * nreader);
+	lt->tree = (int *) palloc(sizeof(int) * nreader);
+
+	for (i = 0; i < nreader; i++)
+	{
+		mkloser_read(lt, i);
+		lt->tree[i] = -1;
+	}
+
+	/*
+	 * Play the initial tournament bottom up.  The first entry to reach a node
+	 * waits there; the second one plays against it, leaves the loser behind
+	 * and carries on towards the root.  The entry that makes it past the root
+	 * is the winner.
+	 */
+	for (i = 0; i < nreader; i++)
+	{
+		int			winner = i;
+		int			n;
+
+		for (n = (nreader + i) >> 1; n > 0; n >>= 1)
+		{
+			int			waiting = lt->tree[n];
+
+			if (waiting < 0)
+			{
+				lt->tree[n] = winner;
+				winner = -1;
+				break;
+			}
+
+			if (mkloser_before(lt, waiting, winner))
+			{
+				lt->tree[n] = winner;
+				winner = waiting;
+			}
+		}
+
+		if (winner >= 0)
+			lt->tree[0] = winner;
+	}
+
+	return lt;
+}
+
+void
+mkloser_destroy(MKLoserTree *lt)
+{
+	int			i;
+
+	for (i = 0; i < lt->nreader; i++)
+	{
+		MKEntry    *e = lt->entries + i;
+
+		if (!mke_is_empty(e))
+		{
+			if (lt->mkctxt->cpfr)
+				(lt->mkctxt->cpfr) (e, NULL, lt->mkctxt->lvctxt);
+			(lt->mkctxt->freeTup) (e);
+		}
+	}
+
+	pfree(lt->entries);
+	pfree(lt->tree);
+	pfree(lt);
+}
+
+/*
+ * Return the smallest entry in *out, and replace it with the next entry of
+ * the reader it came from.  The caller owns out->ptr; the prepared datum has
+ * already been freed.  Returns false, and sets *out to empty, once all
+ * readers are exhausted.
+ */
+bool
+mkloser_get(MKLoserTree *lt, MKEntry *out)
+{
+	int			winner = lt->tree[0];
+	int			n;
+
+	if (mke_is_empty(lt->entries + winner))
+	{
+		mke_set_empty(out);
+		return false;
+	}
+
+	*out = lt->entries[winner];
+	if (lt->mkctxt->cpfr)
+		(lt->mkctxt->cpfr) (out, NULL, lt->mkctxt->lvctxt);
+
+	mkloser_read(lt, winner);
+
+	/* replay the matches on the path of the new entry */
+	for (n = (lt->nreader + winner) >> 1; n > 0; n >>= 1)
+	{
+		int			loser = lt->tree[n];
+
+		if (mkloser_before(lt, loser, winner))
+		{
+			lt->tree[n] = winner;
+			winner = loser;
+		}
+	}
+	lt->tree[0] = winner;
+
+	return true;
+}
@@ -25,6 +25,7 @@
 #include "utils/tuplesort_mk_details.h"
 
 #include "miscadmin.h"
+#include "cdb/cdbgang.h"
 
 #ifdef MKQSORT_VERIFY 
 extern void mkqsort_verify(MKEntry *a, int l, int r, MKContext *mkctxt);
@@ -265,89 +266,287 @@ void mk_qsort_impl(MKEntry *a, int left, int right, int lv, bool lvdown, MKConte
 {
 	int lastInLow;
 	int firstInHigh;
+#ifdef MKQSORT_VERIFY
+	int origLeft = left;
+	int origRight = right;
+#endif
 
 	Assert(ctxt);
 	Assert(lv < ctxt->total_lv);
 
-	CHECK_FOR_INTERRUPTS();
+	/*
+	 * The chunks below and above the pivot are sorted at the same level.  We
+	 * recurse into the smaller one and loop on the larger one, so that the
+	 * stack depth stays logarithmic in the number of entries at each level.
+	 * mk_qsort_parallel runs this on threads with a small stack.
+	 */
+	for (;;)
+	{
+		/* Worker threads cannot service interrupts; mk_qsort_parallel does */
+		if (!ctxt->inParallelSort)
+			CHECK_FOR_INTERRUPTS();
 
-	if (QueryFinishPending)
-		return;
+		if (QueryFinishPending)
+			return;
 
-	if(right <= left)
-		return;
-	
-	/* Prepare at level lv */
-	if(lvdown)
-        mk_prepare_array(a, left, right, lv, ctxt);
-
-	/* 
-	 * According to Bentley & McIlroy [1] (1993), using insert sort for case 
-	 * n < 7 is a significant saving.  However, according to Sedgewick & 
-	 * Bentley [2] (2002), the wisdom of new millenium is not to special case
-	 * smaller cases.  Here, we do not special case it because we want to save
-	 * memtuple_getattr, and expensive comparisons that has been prepared.
-	 *
-	 * XXX Find out why we have a new wisdom in [2] and impl. & compare.
-	 */
-	mk_qsort_part3(a, left, right, lv, ctxt, &lastInLow, &firstInHigh);
+		if(right <= left)
+			break;
 
-	/* recurse to left chunk */
-	mk_qsort_impl(a, left, lastInLow, lv, false, ctxt, seenNull);
+		/* Prepare at level lv */
+		if(lvdown)
+		{
+			mk_prepare_array(a, left, right, lv, ctxt);
+			lvdown = false;
+		}
 
-	/* recurse to middle (equal) chunk */
-	if(lv < ctxt->total_lv-1)
-	{
-		/*
-		 * [lastInLow+1,firstInHigh-1] defines the pivot region which was all equal at level lv.  So increase the level and compare that region!
+		/* 
+		 * According to Bentley & McIlroy [1] (1993), using insert sort for case 
+		 * n < 7 is a significant saving.  However, according to Sedgewick & 
+		 * Bentley [2] (2002), the wisdom of new millenium is not to special case
+		 * smaller cases.  Here, we do not special case it because we want to save
+		 * memtuple_getattr, and expensive comparisons that has been prepared.
+		 *
+		 * XXX Find out why we have a new wisdom in [2] and impl. & compare.
 		 */
-		mk_qsort_impl(a, lastInLow+1, firstInHigh-1, lv+1, true, ctxt, seenNull || mke_is_null(a+lastInLow+1)); /* a + lastInLow + 1 points to the pivot */
-	}
-	else
-	{
-		/* values are all equal to the deepest level...no need for more compares, but check uniqueness if requested */
-		if(firstInHigh-1 > lastInLow+1 &&
-				!seenNull &&
-				!mke_is_null(a+lastInLow+1)) /* a + lastInLow + 1 points to the pivot */
+		mk_qsort_part3(a, left, right, lv, ctxt, &lastInLow, &firstInHigh);
+
+		/* recurse to middle (equal) chunk */
+		if(lv < ctxt->total_lv-1)
 		{
-			if ( ctxt->enforceUnique )
-			{
-				Datum	values[INDEX_MAX_KEYS];
-				bool	isnull[INDEX_MAX_KEYS];
-		
-				index_deform_tuple((IndexTuple)(a+lastInLow+1)->ptr, ctxt->tupdesc, values, isnull);
-				ereport(ERROR,
-						(errcode(ERRCODE_UNIQUE_VIOLATION),
-						 errmsg("could not create unique index \"%s\"",
-								RelationGetRelationName(ctxt->indexRel)),
-						 errdetail("Key %s is duplicated.",
-								   BuildIndexValueDescription(ctxt->indexRel,
-															  values, isnull))));
-			}
-			else if ( ctxt->unique)
+			/*
+			 * [lastInLow+1,firstInHigh-1] defines the pivot region which was all equal at level lv.  So increase the level and compare that region!
+			 */
+			mk_qsort_impl(a, lastInLow+1, firstInHigh-1, lv+1, true, ctxt, seenNull || mke_is_null(a+lastInLow+1)); /* a + lastInLow + 1 points to the pivot */
+		}
+		else
+		{
+			/* values are all equal to the deepest level...no need for more compares, but check uniqueness if requested */
+			if(firstInHigh-1 > lastInLow+1 &&
+					!seenNull &&
+					!mke_is_null(a+lastInLow+1)) /* a + lastInLow + 1 points to the pivot */
 			{
-				int toFreeIndex;
-				for ( toFreeIndex = lastInLow + 2; toFreeIndex < firstInHigh; toFreeIndex++) /* +2 because we want to keep one around! */
+				if ( ctxt->enforceUnique )
+				{
+					Datum	values[INDEX_MAX_KEYS];
+					bool	isnull[INDEX_MAX_KEYS];
+			
+					index_deform_tuple((IndexTuple)(a+lastInLow+1)->ptr, ctxt->tupdesc, values, isnull);
+					ereport(ERROR,
+							(errcode(ERRCODE_UNIQUE_VIOLATION),
+							 errmsg("could not create unique index \"%s\"",
+									RelationGetRelationName(ctxt->indexRel)),
+							 errdetail("Key %s is duplicated.",
+									   BuildIndexValueDescription(ctxt->indexRel,
+																  values, isnull))));
+				}
+				else if ( ctxt->unique)
 				{
-					MKEntry *toFree = a + toFreeIndex;
-					if ( ctxt->cpfr)
-						ctxt->cpfr(toFree, NULL, ctxt->lvctxt + lv); // todo: verify off-by-one
-					ctxt->freeTup(toFree);
-					mke_set_empty(toFree);
+					int toFreeIndex;
+					for ( toFreeIndex = lastInLow + 2; toFreeIndex < firstInHigh; toFreeIndex++) /* +2 because we want to keep one around! */
+					{
+						MKEntry *toFree = a + toFreeIndex;
+						if ( ctxt->cpfr)
+							ctxt->cpfr(toFree, NULL, ctxt->lvctxt + lv); // todo: verify off-by-one
+						ctxt->freeTup(toFree);
+						mke_set_empty(toFree);
+					}
 				}
 			}
 		}
-	}
 
-	/* recurse to right chunk */
-	mk_qsort_impl(a, firstInHigh, right, lv, false, ctxt, seenNull);
+		/* recurse to the smaller of the left and right chunks, loop on the other */
+		if(lastInLow - left < right - firstInHigh)
+		{
+			mk_qsort_impl(a, left, lastInLow, lv, false, ctxt, seenNull);
+			left = firstInHigh;
+		}
+		else
+		{
+			mk_qsort_impl(a, firstInHigh, right, lv, false, ctxt, seenNull);
+			right = lastInLow;
+		}
+	}
 
 #ifdef MKQSORT_VERIFY 
 	if(lv == 0)
-		mkqsort_verify(a, left, right, ctxt);
+		mkqsort_verify(a, origLeft, origRight, ctxt);
 #endif
 }
 
+/*
+ * Parallel sort.
+ *
+ * The array is cut into equal ranges, each sorted by mk_qsort_impl on its own
+ * thread (the calling backend sorts the first range itself), and the sorted
+ * ranges are then merged by the calling backend.  Nothing but the calling
+ * backend touches palloc, elog or the memory accounting: the scratch array is
+ * supplied by the caller, and the caller only gets here when preparing and
+ * comparing entries is a plain memory operation.
+ */
+typedef struct MKQSortPart
+{
+	MKEntry    *a;
+	int			left;			/* inclusive */
+	int			right;			/* inclusive */
+	MKContext  *ctxt;
+	pthread_t	thread;
+	bool		started;
+} MKQSortPart;
+
+static void *
+mk_qsort_part_thread(void *arg)
+{
+	MKQSortPart *part = (MKQSortPart *) arg;
+
+	gp_set_thread_sigmasks();
+
+	mk_qsort_impl(part->a, part->left, part->right, 0, true, part->ctxt, false);
+
+	return NULL;
+}
+
+/*
+ * Compare two sorted entries on all levels.  Entries coming out of
+ * mk_qsort_impl are prepared at different levels, so fetch the datum of each
+ * level the entry is not prepared at into a copy.
+ */
+static int32
+mk_qsort_comp_all_lv(MKEntry *a, MKEntry *b, MKContext *ctxt)
+{
+	int			lv;
+
+	for (lv = 0; lv < ctxt->total_lv; lv++)
+	{
+		MKLvContext *lvctxt = ctxt->lvctxt + lv;
+		MKEntry		aa = *a;
+		MKEntry		bb = *b;
+		int32		c;
+
+		if (mke_get_lv(a) != lv)
+			tupsort_prepare(&aa, ctxt, lv);
+		if (mke_get_lv(b) != lv)
+			tupsort_prepare(&bb, ctxt, lv);
+
+		c = mke_get_nullbits(&aa) - mke_get_nullbits(&bb);
+		if (c == 0 && !mke_is_null(&aa))
+			c = tupsort_compare_datum(&aa, &bb, lvctxt, ctxt);
+		if (c != 0)
+			return c;
+	}
+
+	return 0;
+}
+
+/* Is the head of part i smaller than the head of part j?  Ties go to the lower part */
+static inline bool
+mk_qsort_part_lt(MKQSortPart *parts, int i, int j, MKContext *ctxt)
+{
+	int32		c = mk_qsort_comp_all_lv(parts[i].a + parts[i].left,
+										 parts[j].a + parts[j].left, ctxt);
+
+	return c < 0 || (c == 0 && i < j);
+}
+
+static void
+mk_qsort_heap_siftdown(int *heap, int nheap, int pos, MKQSortPart *parts, MKContext *ctxt)
+{
+	for (;;)
+	{
+		int			child = 2 * pos + 1;
+		int			tmp;
+
+		if (child >= nheap)
+			break;
+		if (child + 1 < nheap &&
+			mk_qsort_part_lt(parts, heap[child + 1], heap[child], ctxt))
+			child++;
+		if (!mk_qsort_part_lt(parts, heap[child], heap[pos], ctxt))
+			break;
+
+		tmp = heap[pos];
+		heap[pos] = heap[child];
+		heap[child] = tmp;
+		pos = child;
+	}
+}
+
+void
+mk_qsort_parallel(MKEntry *a, int n, MKContext *ctxt, int nparts, MKEntry *scratch)
+{
+	MKQSortPart parts[MKQS_MAX_PARALLEL];
+	int			heap[MKQS_MAX_PARALLEL];
+	int			nheap;
+	int			i;
+	int			out;
+
+	Assert(nparts > 1 && nparts <= MKQS_MAX_PARALLEL);
+	Assert(n >= nparts);
+	Assert(!ctxt->unique && !ctxt->enforceUnique && !ctxt->bounded);
+
+	ctxt->inParallelSort = true;
+
+	for (i = 0; i < nparts; i++)
+	{
+		parts[i].a = a;
+		parts[i].left = (int) (((int64) n * i) / nparts);
+		parts[i].right = (int) (((int64) n * (i + 1)) / nparts) - 1;
+		parts[i].ctxt = ctxt;
+		parts[i].started = false;
+	}
+
+	for (i = 1; i < nparts; i++)
+	{
+		if (gp_pthread_create(&parts[i].thread, mk_qsort_part_thread,
+							  &parts[i], "mk_qsort_parallel") == 0)
+			parts[i].started = true;
+	}
+
+	/* Our own share, plus whatever a thread could not be started for */
+	for (i = 0; i < nparts; i++)
+	{
+		if (!parts[i].started)
+			mk_qsort_impl(a, parts[i].left, parts[i].right, 0, true, ctxt, false);
+	}
+
+	for (i = 1; i < nparts; i++)
+	{
+		if (parts[i].started)
+			pthread_join(parts[i].thread, NULL);
+	}
+
+	ctxt->inParallelSort = false;
+
+	CHECK_FOR_INTERRUPTS();
+
+	if (QueryFinishPending)
+		return;
+
+	/* k-way merge of the sorted ranges into scratch, then copy back */
+	for (i = 0; i < nparts; i++)
+		heap[i] = i;
+	nheap = nparts;
+	for (i = nheap / 2 - 1; i >= 0; i--)
+		mk_qsort_heap_siftdown(heap, nheap, i, parts, ctxt);
+
+	out = 0;
+	while (nheap > 0)
+	{
+		MKQSortPart *top = parts + heap[0];
+
+		scratch[out++] = top->a[top->left++];
+
+		if (top->left > top->right)
+			heap[0] = heap[--nheap];
+		mk_qsort_heap_siftdown(heap, nheap, 0, parts, ctxt);
+
+		if ((out & 0xFFFF) == 0)
+			CHECK_FOR_INTERRUPTS();
+	}
+
+	Assert(out == n);
+	memcpy(a, scratch, n * sizeof(MKEntry));
+}
+
 #ifdef MKQSORT_VERIFY 
 static int mkqsort_comp_entry_all_lv(MKEntry *a, MKEntry *b, MKContext *mkctxt)
 {
@@ -314,6 +314,8 @@ workfile_mgr_populate_set(const void *resource, const void *param)
 	work_set->no_files = 0;
 	work_set->size = 0L;
 	work_set->in_progress_size = 0L;
+	work_set->bytes_uncompressed = 0L;
+	work_set->bytes_compressed = 0L;
 	work_set->node_type = set_info->nodeType;
 	work_set->metadata.type = set_info->file_type;
 	work_set->metadata.bfz_compress_type = gp_workfile_compress_algorithm;
@@ -488,6 +490,21 @@ workfile_set_update_in_progress_size(workfile_set *work_set, int64 size)
 	}
 }
 
+/*
+ * Accounts for data written to the files of a workset, before and after
+ * compression.
+ */
+void
+workfile_set_update_bytes_written(workfile_set *work_set, int64 uncompressed,
+		int64 compressed)
+{
+	if (NULL != work_set)
+	{
+		work_set->bytes_uncompressed += uncompressed;
+		work_set->bytes_compressed += compressed;
+	}
+}
+
 /*
  * Reports corresponding error message when the query or segment size limit is exceeded.
  */
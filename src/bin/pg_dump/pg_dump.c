@@ -149,6 +149,7 @@ static bool gp_partitioning_available = false;
 
 /* flag indicating whether or not this GP database supports column encoding */
 static bool gp_attribute_encoding_available = false;
+static bool gp_hashreduce_available = false;
 
 static void help(const char *progname);
 static void expand_schema_name_patterns(SimpleStringList *patterns,
@@ -238,6 +239,7 @@ static void selectSourceSchema(const char *schemaName);
 static bool testGPbackend(void);
 static bool testPartitioningSupport(void);
 static bool testAttributeEncodingSupport(void);
+static bool testHashReduceSupport(void);
 static char *getFormattedTypeName(Oid oid, OidOptions opts);
 static const char *fmtQualifiedId(const char *schema, const char *id);
 static void getBlobs(Archive *AH);
@@ -256,6 +258,7 @@ static void do_sql_command(PGconn *conn, const char *query);
 /* START MPP ADDITION */
 static char *nextToken(register char **stringp, register const char *delim);
 static void addDistributedBy(PQExpBuffer q, TableInfo *tbinfo, int actual_atts);
+static bool isJumpHashReduced(TableInfo *tbinfo);
 static bool isGPDB4300OrLater(void);
 static bool isGPDB(void);
 static bool isGPDB5000OrLater(void);
@@ -906,6 +909,12 @@ main(int argc, char **argv)
 	 */
 	gp_attribute_encoding_available = testAttributeEncodingSupport();
 
+	/*
+	 * Remember whether or not this GP database records how tables reduce
+	 * hash values to segments.
+	 */
+	gp_hashreduce_available = testHashReduceSupport();
+
 	/* Expand schema selection patterns into OID lists */
 	if (schema_include_patterns.head != NULL)
 	{
@@ -11573,6 +11582,7 @@ dumpTableSchema(Archive *fout, TableInfo *tbinfo)
 	int			j,
 				k;
 	bool		isPartitioned = false;
+	bool		jumpHashReduced = false;
 
 	/* Make sure we are in proper schema */
 	selectSourceSchema(tbinfo->dobj.namespace->dobj.name);
@@ -11665,6 +11675,15 @@ dumpTableSchema(Archive *fout, TableInfo *tbinfo)
 		appendPQExpBuffer(labelq, "%s %s", reltypename,
 						  fmtId(tbinfo->dobj.name));
 
+		/*
+		 * Tables that use jump consistent hashing must be created with it,
+		 * or the restored rows would land on other segments than the ones
+		 * queries look for them on. Partitions follow their parent.
+		 */
+		jumpHashReduced = dumpPolicy && isJumpHashReduced(tbinfo);
+		if (jumpHashReduced)
+			appendPQExpBufferStr(q, "SET gp_create_table_hash_reduction = jump;\n\n");
+
 		appendPQExpBuffer(q, "CREATE TABLE %s",
 						  fmtId(tbinfo->dobj.name));
 		if (tbinfo->reloftype)
@@ -11920,6 +11939,9 @@ dumpTableSchema(Archive *fout, TableInfo *tbinfo)
 
 		appendPQExpBuffer(q, ";\n");
 
+		if (jumpHashReduced)
+			appendPQExpBufferStr(q, "\nRESET gp_create_table_hash_reduction;\n");
+
 		/* Exchange external partition */
 		if (isPartitioned)
 		{
@@ -13758,6 +13780,32 @@ testAttributeEncodingSupport(void)
 	return isSupported;
 }
 
+/*
+ * testHashReduceSupport - tests whether or not the current GP database
+ * records the hash reduction of tables in gp_distribution_policy.
+ */
+static bool
+testHashReduceSupport(void)
+{
+	PQExpBuffer query;
+	PGresult   *res;
+	bool		isSupported;
+
+	query = createPQExpBuffer();
+
+	appendPQExpBuffer(query, "SELECT 1 FROM pg_catalog.pg_attribute "
+					  "WHERE attrelid = 'pg_catalog.gp_distribution_policy'::pg_catalog.regclass "
+					  "AND attname = 'hashreduce';");
+	res = PQexec(g_conn, query->data);
+	check_sql_result(res, g_conn, query->data, PGRES_TUPLES_OK);
+
+	isSupported = (PQntuples(res) == 1);
+
+	PQclear(res);
+	destroyPQExpBuffer(query);
+
+	return isSupported;
+}
 
 bool
 testExtProtocolSupport(void)
@@ -13875,6 +13923,41 @@ addDistributedBy(PQExpBuffer q, TableInfo *tbinfo, int actual_atts)
 	destroyPQExpBuffer(query);
 }
 
+/*
+ *	isJumpHashReduced
+ *
+ *	does the passed in relation map hash values to segments with jump
+ *	consistent hashing? There is no DDL syntax for it, such tables are
+ *	created with gp_create_table_hash_reduction set to jump.
+ */
+static bool
+isJumpHashReduced(TableInfo *tbinfo)
+{
+	PQExpBuffer query;
+	PGresult   *res;
+	bool		isJump;
+
+	if (!gp_hashreduce_available)
+		return false;
+
+	query = createPQExpBuffer();
+
+	appendPQExpBuffer(query,
+					  "SELECT 1 FROM gp_distribution_policy as p "
+					  "WHERE p.localoid = %u AND p.hashreduce = '%c'",
+					  tbinfo->dobj.catId.oid, SYM_HASHREDUCE_JUMP);
+
+	res = PQexec(g_conn, query->data);
+	check_sql_result(res, g_conn, query->data, PGRES_TUPLES_OK);
+
+	isJump = (PQntuples(res) == 1);
+
+	PQclear(res);
+	destroyPQExpBuffer(query);
+
+	return isJump;
+}
+
 /*
  * getFormattedTypeName - retrieve a nicely-formatted type name for the
  * given type name.
@@ -21,6 +21,7 @@ extern void AOCSDrop(Relation aorel,
 extern void AOCSCompact(Relation aorel,
 			List *compaction_segno_list,
 			int insert_segno,
-			bool isFull);
+			bool isFull,
+			int elevel);
 extern void AOCSTruncateToEOF(Relation aorel);
 #endif
@@ -18,15 +18,45 @@
 #include "utils/rel.h"
 #include "access/memtup.h"
 #include "executor/tuptable.h"
+#include "portability/instr_time.h"
 
 #define APPENDONLY_COMPACTION_SEGNO_INVALID (-1)
 
+/*
+ * Progress of the compaction of one segment file. It paces the reads to
+ * gp_appendonly_compaction_io_limit, and reports how far the compaction got.
+ *
+ * The bytes read are estimated from the share of the tuples read, as the
+ * scans don't tell how far into the file they are.
+ */
+typedef struct AppendOnlyCompactionProgress
+{
+	const char *relname;
+	int			segno;
+	int			insert_segno;
+	int			elevel;			/* level of the final message */
+
+	int64		total_tupcount;
+	int64		eof;			/* bytes to read, over all columns */
+
+	int64		tupleCount;		/* tuples read so far */
+	int64		movedTupleCount;
+	int64		droppedTupleCount;
+
+	int64		checkInterval;	/* tuples between two checks */
+	int64		nextCheck;		/* tupleCount of the next check */
+	int			reportedPercent;
+
+	instr_time	startTime;
+} AppendOnlyCompactionProgress;
+
 extern void AppendOnlyDrop(Relation aorel,
 			   List *compaction_segno);
 extern void AppendOnlyCompact(Relation aorel,
 				  List *compaction_segno_list,
 				  int insert_segno,
-				  bool isFull);
+				  bool isFull,
+				  int elevel);
 extern bool AppendOnlyCompaction_ShouldCompact(
 								   Relation aoRelation,
 								   int segno,
@@ -37,4 +67,27 @@ extern void AppendOnlyThrowAwayTuple(Relation rel, MemTuple tuple,
 extern void AppendOnlyTruncateToEOF(Relation aorel);
 extern bool HasLockForSegmentFileDrop(Relation aorel);
 extern bool AppendOnlyCompaction_IsRelationEmpty(Relation aorel);
+extern void AppendOnlyCompaction_BeginProgress(AppendOnlyCompactionProgress *progress,
+								   Relation aorel, int segno, int insert_segno,
+								   int64 total_tupcount, int64 eof, int elevel);
+extern void AppendOnlyCompaction_CheckProgress(AppendOnlyCompactionProgress *progress);
+extern void AppendOnlyCompaction_EndProgress(AppendOnlyCompactionProgress *progress);
+
+/*
+ * Counts a tuple read from the segment file being compacted, moved or
+ * dropped. Every few tuples, waits for the I/O rate limit and reports the
+ * progress.
+ */
+static inline void
+AppendOnlyCompaction_CountTuple(AppendOnlyCompactionProgress *progress, bool moved)
+{
+	if (moved)
+		progress->movedTupleCount++;
+	else
+		progress->droppedTupleCount++;
+
+	if (++progress->tupleCount >= progress->nextCheck)
+		AppendOnlyCompaction_CheckProgress(progress);
+}
+
 #endif
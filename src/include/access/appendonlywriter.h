@@ -214,10 +214,12 @@ extern int	SetSegnoForWrite(Relation rel, int existingsegno);
 extern void RegisterSegnoForCompactionDrop(Oid relid, List *compactedSegmentFileList);
 extern void DeregisterSegnoForCompactionDrop(Oid relid, List *compactedSegmentFileList);
 extern List *SetSegnoForCompaction(Relation rel, List *compactedSegmentFileList,
-					  List *insertedSegmentFileList, bool *isdrop);
+					  List *insertedSegmentFileList, int max_segnos,
+					  bool *isdrop);
 extern int SetSegnoForCompactionInsert(Relation rel, List *compacted_segno,
 							List *compactedSegmentFileList,
-							List *insertedSegmentFileList);
+							List *insertedSegmentFileList,
+							bool missing_ok);
 extern List *assignPerRelSegno(List *all_rels);
 extern void UpdateMasterAosegTotals(Relation parentrel,
 						int segno,
@@ -36,6 +36,7 @@
 #define AO_DEFAULT_COMPRESSTYPE   "zlib"
 #define AO_DEFAULT_CHECKSUM       true
 #define AO_DEFAULT_COLUMNSTORE    false
+#define AO_DEFAULT_DICTIONARY     false
 
 /* types supported by reloptions */
 typedef enum relopt_type
@@ -35,15 +35,17 @@ CATALOG(gp_distribution_policy,5002) BKI_WITHOUT_OIDS
 	Oid			localoid;
 	int2		attrnums[1];
 	char		policytype; /* distribution policy type */
+	char		hashreduce;	/* hash-to-segment reduction method */
 } FormData_gp_policy;
 
 /* GPDB added foreign key definitions for gpcheckcat. */
 FOREIGN_KEY(localoid REFERENCES pg_class(oid));
 
-#define Natts_gp_policy		3
+#define Natts_gp_policy		4
 #define Anum_gp_policy_localoid	1
 #define Anum_gp_policy_attrnums	2
 #define Anum_gp_policy_type	3
+#define Anum_gp_policy_hashreduce	4
 
 /*
  * Symbolic values for Anum_gp_policy_type column
@@ -51,6 +53,12 @@ FOREIGN_KEY(localoid REFERENCES pg_class(oid));
 #define SYM_POLICYTYPE_PARTITIONED 'p'
 #define SYM_POLICYTYPE_REPLICATED 'r'
 
+/*
+ * Symbolic values for Anum_gp_policy_hashreduce column
+ */
+#define SYM_HASHREDUCE_MODULO 'm'
+#define SYM_HASHREDUCE_JUMP 'j'
+
 /*
  * GpPolicyType represents a type of policy under which a relation's
  * tuples may be assigned to a component database.
@@ -62,6 +70,21 @@ typedef enum GpPolicyType
 	POLICYTYPE_REPLICATED		/* Tuples stored a copy on all segment database. */
 } GpPolicyType;
 
+/*
+ * GpPolicyHashReduce represents how the hash of a tuple's distribution key
+ * columns is reduced to a segment number.
+ *
+ * Modulo reduction is the traditional scheme; changing the number of
+ * segments moves almost every row.  Jump consistent hashing (Lamping and
+ * Veach) only moves about (M-N)/M of the rows when growing from N to M
+ * segments, at the cost of a few more cycles per row.
+ */
+typedef enum GpPolicyHashReduce
+{
+	POLICY_HASHREDUCE_MODULO,	/* hash mod number of segments */
+	POLICY_HASHREDUCE_JUMP		/* jump consistent hash */
+} GpPolicyHashReduce;
+
 /*
  * GpPolicy represents a Greenplum DB data distribution policy. The ptype field
  * is always significant.  Other fields may be specific to a particular
@@ -78,6 +101,7 @@ typedef struct GpPolicy
 	/* These fields apply to POLICYTYPE_PARTITIONED. */
 	int			nattrs;
 	AttrNumber	*attrs;		/* pointer to the first of nattrs attribute numbers.  */
+	GpPolicyHashReduce hashreduce;	/* hash reduction, if nattrs > 0 */
 } GpPolicy;
 
 /*
@@ -122,6 +146,7 @@ bool GpPolicyIsHashPartitioned(const GpPolicy *policy);
 bool GpPolicyIsPartitioned(const GpPolicy *policy);
 bool GpPolicyIsReplicated(const GpPolicy *policy);
 bool GpPolicyIsEntry(const GpPolicy *policy);
+bool GpPolicyIsJumpHashed(const GpPolicy *policy);
 
 extern GpPolicy *makeGpPolicy(MemoryContext mcxt, GpPolicyType ptype, int nattrs);
 extern GpPolicy *createReplicatedGpPolicy(MemoryContext mcxt);
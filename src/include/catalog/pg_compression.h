@@ -79,6 +79,8 @@ DATA(insert OID = 3063 ( none gp_dummy_compression_constructor gp_dummy_compress
 
 DATA(insert OID = 3070 ( zstd gp_zstd_constructor gp_zstd_destructor gp_zstd_compress gp_zstd_decompress gp_zstd_validator PGUID ));
 
+DATA(insert OID = 3087 ( lz4 gp_lz4_constructor gp_lz4_destructor gp_lz4_compress gp_lz4_decompress gp_lz4_validator PGUID ));
+
 #define NUM_COMPRESS_FUNCS 5
 
 #define COMPRESSION_CONSTRUCTOR 0
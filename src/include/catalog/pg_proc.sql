@@ -407,6 +407,16 @@
 
  CREATE FUNCTION gp_zstd_validator(internal) RETURNS void LANGUAGE internal IMMUTABLE AS 'zstd_validator' WITH(OID=3075, DESCRIPTION="zstdcompression validator");
 
+ CREATE FUNCTION gp_lz4_constructor(internal, internal, bool) RETURNS internal LANGUAGE internal VOLATILE AS 'lz4_constructor' WITH (OID=3088, DESCRIPTION="lz4 compressor and decompressor constructor");
+
+ CREATE FUNCTION gp_lz4_destructor(internal) RETURNS void LANGUAGE internal VOLATILE AS 'lz4_destructor' WITH(OID=3089, DESCRIPTION="lz4 compressor and decompressor destructor");
+
+ CREATE FUNCTION gp_lz4_compress(internal, int4, internal, int4, internal, internal) RETURNS void LANGUAGE internal IMMUTABLE AS 'lz4_compress' WITH(OID=3090, DESCRIPTION="lz4 compressor");
+
+ CREATE FUNCTION gp_lz4_decompress(internal, int4, internal, int4, internal, internal) RETURNS void LANGUAGE internal IMMUTABLE AS 'lz4_decompress' WITH(OID=3091, DESCRIPTION="lz4 decompressor");
+
+ CREATE FUNCTION gp_lz4_validator(internal) RETURNS void LANGUAGE internal IMMUTABLE AS 'lz4_validator' WITH(OID=3092, DESCRIPTION="lz4 compression validator");
+
  CREATE FUNCTION gp_dummy_compression_constructor(internal, internal, bool) RETURNS internal LANGUAGE internal VOLATILE AS 'dummy_compression_constructor' WITH (OID=3064, DESCRIPTION="Dummy compression destructor");
 
  CREATE FUNCTION gp_dummy_compression_destructor(internal) RETURNS internal LANGUAGE internal VOLATILE AS 'dummy_compression_destructor' WITH (OID=3065, DESCRIPTION="Dummy compression destructor");
@@ -446,6 +456,8 @@
  CREATE FUNCTION enable_xform(text) RETURNS text LANGUAGE internal IMMUTABLE STRICT AS 'enable_xform' WITH (OID=6088, DESCRIPTION="enables transformations in the optimizer");
 
  CREATE FUNCTION gp_opt_version() RETURNS text LANGUAGE internal IMMUTABLE STRICT AS 'gp_opt_version' WITH (OID=6089, DESCRIPTION="Returns the optimizer and gpos library versions");
+
+ CREATE FUNCTION gp_opt_plan_cache_stats(OUT hits int8, OUT misses int8, OUT entries int4, OUT size int8) RETURNS pg_catalog.record LANGUAGE internal VOLATILE AS 'gp_opt_plan_cache_stats' WITH (OID=7097, DESCRIPTION="statistics: optimizer plan cache of the current session");
  
  
   -- functions for the complex data type
@@ -22,7 +22,7 @@
 
    WARNING: DO NOT MODIFY THE FOLLOWING SECTION: 
    Generated by catullus.pl version 8
-   on Thu Mar 15 13:55:44 2018
+   on Fri Oct 16 07:36:36 2026
 
    Please make your changes in pg_proc.sql
 */
@@ -813,6 +813,26 @@ DESCR("zstd decompressor");
 DATA(insert OID = 3075 ( gp_zstd_validator  PGNSP PGUID 12 1 0 0 f f f f f i 1 0 2278 "2281" _null_ _null_ _null_ _null_ zstd_validator _null_ _null_ _null_ n a ));
 DESCR("zstdcompression validator");
 
+/* gp_lz4_constructor(internal, internal, bool) => internal */
+DATA(insert OID = 3088 ( gp_lz4_constructor  PGNSP PGUID 12 1 0 0 f f f f f v 3 0 2281 "2281 2281 16" _null_ _null_ _null_ _null_ lz4_constructor _null_ _null_ _null_ n a ));
+DESCR("lz4 compressor and decompressor constructor");
+
+/* gp_lz4_destructor(internal) => void */
+DATA(insert OID = 3089 ( gp_lz4_destructor  PGNSP PGUID 12 1 0 0 f f f f f v 1 0 2278 "2281" _null_ _null_ _null_ _null_ lz4_destructor _null_ _null_ _null_ n a ));
+DESCR("lz4 compressor and decompressor destructor");
+
+/* gp_lz4_compress(internal, int4, internal, int4, internal, internal) => void */
+DATA(insert OID = 3090 ( gp_lz4_compress  PGNSP PGUID 12 1 0 0 f f f f f i 6 0 2278 "2281 23 2281 23 2281 2281" _null_ _null_ _null_ _null_ lz4_compress _null_ _null_ _null_ n a ));
+DESCR("lz4 compressor");
+
+/* gp_lz4_decompress(internal, int4, internal, int4, internal, internal) => void */
+DATA(insert OID = 3091 ( gp_lz4_decompress  PGNSP PGUID 12 1 0 0 f f f f f i 6 0 2278 "2281 23 2281 23 2281 2281" _null_ _null_ _null_ _null_ lz4_decompress _null_ _null_ _null_ n a ));
+DESCR("lz4 decompressor");
+
+/* gp_lz4_validator(internal) => void */
+DATA(insert OID = 3092 ( gp_lz4_validator  PGNSP PGUID 12 1 0 0 f f f f f i 1 0 2278 "2281" _null_ _null_ _null_ _null_ lz4_validator _null_ _null_ _null_ n a ));
+DESCR("lz4 compression validator");
+
 /* gp_dummy_compression_constructor(internal, internal, bool) => internal */
 DATA(insert OID = 3064 ( gp_dummy_compression_constructor  PGNSP PGUID 12 1 0 0 f f f f f v 3 0 2281 "2281 2281 16" _null_ _null_ _null_ _null_ dummy_compression_constructor _null_ _null_ _null_ n a ));
 DESCR("Dummy compression destructor");
@@ -893,6 +913,10 @@ DESCR("enables transformations in the optimizer");
 DATA(insert OID = 6089 ( gp_opt_version  PGNSP PGUID 12 1 0 0 f f f t f i 0 0 25 "" _null_ _null_ _null_ _null_ gp_opt_version _null_ _null_ _null_ n a ));
 DESCR("Returns the optimizer and gpos library versions");
 
+/* gp_opt_plan_cache_stats(OUT hits int8, OUT misses int8, OUT entries int4, OUT size int8) => pg_catalog.record */
+DATA(insert OID = 7097 ( gp_opt_plan_cache_stats  PGNSP PGUID 12 1 0 0 f f f f f v 0 0 2249 "" "{20,20,23,20}" "{o,o,o,o}" "{hits,misses,entries,size}" _null_ gp_opt_plan_cache_stats _null_ _null_ _null_ n a ));
+DESCR("statistics: optimizer plan cache of the current session");
+
 
   /* functions for the complex data type */
 /* complex_in(cstring) => complex */
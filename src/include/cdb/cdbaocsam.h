@@ -126,6 +126,35 @@ typedef struct AOCSScanDescData
 
 	AppendOnlyVisimap visibilityMap;
 
+	/*
+	 * Zone map scan keys, see aocs_setzonemapkeys(), and the row ranges of
+	 * the current segment file that they rule out.
+	 */
+	int			zonemap_nkeys;
+	ScanKey		zonemap_keys;
+	AppendOnlyBlockSkipRange *skip_ranges;
+	int			nskip_ranges;
+	int			next_skip_range;
+	int64		last_row_num;
+	int64		skipped_ranges;
+
+	/* Run id of the last datum read of each column, see aocs_getnext_batch() */
+	uint32	   *run_ids;
+
+	/*
+	 * Late materialization, see aocs_setlatecolumns(). The projected columns
+	 * are split into early ones, read with each row, and late ones, read by
+	 * aocs_batch_late_values() for the rows the caller still wants. late_seg
+	 * is set if the current segment file is read that way.
+	 */
+	int		   *early_atts;
+	int			num_early_atts;
+	int		   *late_atts;
+	int			num_late_atts;
+	bool		late_seg;
+	int64		rows_read;
+	int64		late_rows_read;
+
 }	AOCSScanDescData;
 
 typedef AOCSScanDescData *AOCSScanDesc;
@@ -209,9 +238,17 @@ extern AOCSScanDesc aocs_beginrangescan(Relation relation, Snapshot snapshot,
 	TupleDesc relationTupleDesc, bool *proj);
 
 extern void aocs_rescan(AOCSScanDesc scan);
+extern void aocs_setzonemapkeys(AOCSScanDesc scan, int nkeys, ScanKey keys);
+extern void aocs_setlatecolumns(AOCSScanDesc scan, bool *late);
 extern void aocs_endscan(AOCSScanDesc scan);
 
 extern void aocs_getnext(AOCSScanDesc scan, ScanDirection direction, TupleTableSlot *slot);
+extern int aocs_getnext_batch(AOCSScanDesc scan, int maxrows, Datum *values,
+				   bool *isnull, uint32 *runs, ItemPointerData *ctids);
+extern int aocs_batch_dictionary(AOCSScanDesc scan, int attno, Datum **entries,
+					  uint32 *generation);
+extern bool aocs_batch_late_values(AOCSScanDesc scan, ItemPointer ctid,
+					   Datum *values, bool *isnull);
 extern AOCSInsertDesc aocs_insert_init(Relation rel, int segno, bool update_mode);
 extern Oid aocs_insert_values(AOCSInsertDesc idesc, Datum *d, bool *null, AOTupleId *aoTupleId);
 static inline Oid aocs_insert(AOCSInsertDesc idesc, TupleTableSlot *slot)
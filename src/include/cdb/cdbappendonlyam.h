@@ -222,6 +222,17 @@ typedef struct AppendOnlyScanDescData
 	 */ 
 	AppendOnlyVisimap visibilityMap;
 
+	/*
+	 * Zone map scan keys, see appendonly_setzonemapkeys(), and the block
+	 * ranges of the current segment file that they rule out.
+	 */
+	int			aos_zonemap_nkeys;
+	ScanKey		aos_zonemap_keys;
+	AppendOnlyBlockSkipRange *aos_skip_ranges;
+	int			aos_nskip_ranges;
+	int			aos_next_skip_range;
+	int64		aos_skipped_blocks;
+
 }	AppendOnlyScanDescData;
 
 typedef AppendOnlyScanDescData *AppendOnlyScanDesc;
@@ -337,6 +348,8 @@ extern AppendOnlyScanDesc appendonly_beginrangescan(Relation relation,
 		int *segfile_no_arr, int segfile_count,
 		int nkeys, ScanKey keys);
 extern void appendonly_rescan(AppendOnlyScanDesc scan, ScanKey key);
+extern void appendonly_setzonemapkeys(AppendOnlyScanDesc scan, int nkeys,
+						  ScanKey keys);
 extern void appendonly_endscan(AppendOnlyScanDesc scan);
 extern MemTuple appendonly_getnext(AppendOnlyScanDesc scan, 
 									ScanDirection direction,
@@ -18,9 +18,11 @@
 #include "access/aocssegfiles.h"
 #include "access/appendonlytid.h"
 #include "access/skey.h"
+#include "fmgr.h"
 
 extern int gp_blockdirectory_entry_min_range;
 extern int gp_blockdirectory_minipage_size;
+extern bool gp_appendonly_zonemap;
 
 typedef struct AppendOnlyBlockDirectoryEntry
 {
@@ -62,6 +64,41 @@ typedef struct Minipage
 	MinipageEntry entry[1];
 } Minipage;
 
+/*
+ * Minipage versions. A zone map minipage is followed by a MinipageZoneHeader
+ * and by nEntry * numColumns MinipageZones, entry-major.
+ */
+#define MINIPAGE_VERSION_PLAIN		0
+#define MINIPAGE_VERSION_ZONEMAP	1
+
+/*
+ * Maximum number of columns summarized in the zone map of one column group.
+ * AOCS column groups always have a single column.
+ */
+#define MAX_ZONEMAP_COLUMNS 4
+
+typedef struct MinipageZoneHeader
+{
+	int32 numColumns;
+	AttrNumber attnum[MAX_ZONEMAP_COLUMNS];
+} MinipageZoneHeader;
+
+/*
+ * The zone map summary of one column over the rows of a minipage entry.
+ * Only pass-by-value types are summarized, so min and max hold Datums.
+ *
+ * A summary with nullCount + valueCount == 0 is not usable. That is the case
+ * for entries built from existing data, e.g. by CREATE INDEX, and for entries
+ * whose rows were not all seen by the writer.
+ */
+typedef struct MinipageZone
+{
+	int64 minValue;
+	int64 maxValue;
+	int32 nullCount;
+	int32 valueCount;
+} MinipageZone;
+
 /*
  * Define the relevant info for a minipage for each
  * column group.
@@ -71,6 +108,16 @@ typedef struct MinipagePerColumnGroup
 	Minipage *minipage;
 	uint32 numMinipageEntries;
 	ItemPointerData tupleTid;
+
+	/*
+	 * Zone map of the columns in zoneAttnums: one summary per minipage entry,
+	 * and the summary of the rows added since the last entry was inserted.
+	 */
+	int numZoneColumns;
+	AttrNumber zoneAttnums[MAX_ZONEMAP_COLUMNS];
+	FmgrInfo *zoneCmpProcs[MAX_ZONEMAP_COLUMNS];
+	MinipageZone *zones;
+	MinipageZone pendingZones[MAX_ZONEMAP_COLUMNS];
 } MinipagePerColumnGroup;
 
 /*
@@ -122,6 +169,18 @@ typedef struct AppendOnlyBlockDirectory
 }	AppendOnlyBlockDirectory;
 
 
+/*
+ * A range of blocks in a segment file that the zone map rules out for a
+ * scan, see AppendOnlyBlockDirectory_GetSkipRanges().
+ */
+typedef struct AppendOnlyBlockSkipRange
+{
+	int64 fileOffset;
+	int64 afterFileOffset;
+	int64 firstRowNum;
+	int64 afterRowNum;
+} AppendOnlyBlockSkipRange;
+
 typedef struct CurrentBlock
 {
 	AppendOnlyBlockDirectoryEntry blockDirectoryEntry;
@@ -199,6 +258,24 @@ extern bool AppendOnlyBlockDirectory_InsertEntry(
 	int64 fileOffset,
 	int64 rowCount,
 	bool addColAction);
+extern void AppendOnlyBlockDirectory_AddZoneValue(
+	AppendOnlyBlockDirectory *blockDirectory,
+	int columnGroupNo,
+	int zoneColumnNo,
+	Datum value,
+	bool isnull);
+extern void AppendOnlyBlockDirectory_InvalidateZoneMap(
+	AppendOnlyBlockDirectory *blockDirectory,
+	int columnGroupNo);
+extern AppendOnlyBlockSkipRange *AppendOnlyBlockDirectory_GetSkipRanges(
+	Relation aoRel,
+	Snapshot appendOnlyMetaDataSnapshot,
+	int segno,
+	int columnGroupNo,
+	int64 eof,
+	int nkeys,
+	ScanKey keys,
+	int *nranges);
 extern bool AppendOnlyBlockDirectory_addCol_InsertEntry(
 	AppendOnlyBlockDirectory *blockDirectory,
 	int columnGroupNo,
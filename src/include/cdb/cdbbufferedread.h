@@ -20,6 +20,9 @@
 
 #include "storage/fd.h"
 
+/* GUC: number of large reads to request ahead of the one being read */
+extern int	gp_appendonly_readahead_depth;
+
 typedef struct BufferedRead
 {
 	/*
@@ -76,6 +79,25 @@ typedef struct BufferedRead
 	bool				haveTemporaryLimitInEffect;
 	int64				temporaryLimitFileLen;
 
+	/*
+	 * Read-ahead support.
+	 */
+	int					readAheadDepth;
+	int64				readAheadPosition;
+							/*
+							 * The number of large reads to keep requested from
+							 * the kernel ahead of the current one, and the end of
+							 * the file range requested so far.
+							 */
+
+	/*
+	 * Statistics, accumulated over all the files read.
+	 */
+	int64				numLargeReads;
+	int64				numReadAheads;
+	int64				bytesRead;
+	double				readWaitMs;
+
 } BufferedRead;
 
 /*
@@ -103,6 +103,19 @@ cdbexplain_recvExecStats(struct PlanState              *planstate,
                          int                            sliceIndex,
                          struct CdbExplain_ShowStatCtx *showstatctx);
 
+/*
+ * cdbexplain_recordDispatchStats
+ *    Called by qDisp after dispatching a plan to the qExecs, to account
+ *    the time spent serializing the plan and sending it out.
+ *
+ * 'nqe' is the number of qExecs the plan was sent to, and 'len' the size
+ *      of the dispatched message.
+ */
+void
+cdbexplain_recordDispatchStats(struct CdbExplain_ShowStatCtx *showstatctx,
+                               int nqe, int len,
+                               double serialize_ms, double send_ms);
+
 /*
  * cdbexplain_showExecStatsBegin
  *    Called by qDisp process to create a CdbExplain_ShowStatCtx structure
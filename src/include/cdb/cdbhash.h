@@ -15,6 +15,8 @@
 #ifndef CDBHASH_H
 #define CDBHASH_H
 
+#include "catalog/gp_policy.h"
+
 /*
  * hashing algorithms.
  */
@@ -30,7 +32,8 @@ typedef enum
 typedef enum
 {
 	REDUCE_LAZYMOD = 1,
-	REDUCE_BITMASK
+	REDUCE_BITMASK,
+	REDUCE_JUMP_CONSISTENT
 } CdbHashReduce;
 
 /*
@@ -55,8 +58,10 @@ extern void hashNullDatum(datumHashFunction hashFn, void *clientData);
 /*
  * Create and initialize a CdbHash in the current memory context.
  * Parameter numsegs - number of segments in Greenplum Database.
+ * Parameter hashreduce - reduction of the distribution policy being hashed
+ *   for (see GpPolicyHashReduce).
  */
-extern CdbHash *makeCdbHash(int numsegs);
+extern CdbHash *makeCdbHash(int numsegs, GpPolicyHashReduce hashreduce);
 
 /*
  * Initialize CdbHash for hashing the next tuple values.
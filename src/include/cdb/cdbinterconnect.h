@@ -285,6 +285,17 @@ struct MotionConn
 	 */
 	int32		 sent_record_typmod;
 
+	/*
+	 * used by the sender.
+	 *
+	 * offset in pBuff of the TC_WHOLE_BATCH chunk that the last tuple was
+	 * packed into, and the message size right after that tuple.  More tuples
+	 * can be packed into the same chunk as long as msgSize still equals
+	 * batchChunkEnd.  batchChunkEnd is 0 if there is no such chunk.
+	 */
+	int32		batchChunkOffset;
+	int32		batchChunkEnd;
+
 	/*
 	 * used by the receiver.
 	 *
@@ -420,6 +431,20 @@ typedef struct MotionNodeEntry
 	 */
 	htup_fifo       ready_tuples;
 
+	/*
+	 * If preserve_order is false, the TC_WHOLE_BATCH chunks of the last
+	 * receive, whose tuples are returned in place, and the remapper of the
+	 * sender.  cur_batch is the chunk that holds the next tuple, at
+	 * batch_offset.  The chunks point into the receive buffer of route
+	 * batch_route, which is only released by the next receive; -1 if no
+	 * buffer is held.
+	 */
+	TupleChunkListData ready_batches;
+	TupleChunkListItem cur_batch;
+	int             batch_offset;
+	int16           batch_route;
+	TupleRemapper  *batch_remapper;
+
 	/*
 	 * Variable that records the total number of senders to this motion node.
 	 * This is expected to always be (number of qExecs).
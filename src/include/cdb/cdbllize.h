@@ -35,7 +35,8 @@ extern Flow *makeFlow(FlowType flotype);
 extern Flow *pull_up_Flow(Plan *plan, Plan *subplan);
 
 extern bool focusPlan(Plan *plan, bool stable, bool rescannable);
-extern bool repartitionPlan(Plan *plan, bool stable, bool rescannable, List *hashExpr);
+extern bool repartitionPlan(Plan *plan, bool stable, bool rescannable, List *hashExpr,
+				GpPolicyHashReduce hashReduce);
 extern bool repartitionPlanForGroupClauses(struct PlannerInfo *root, Plan *plan,
 							   bool stable, bool rescannable,
 							   List *sortclauses, List *targetlist);
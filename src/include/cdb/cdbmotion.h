@@ -48,6 +48,12 @@ struct directTransportBuffer
 {
 	unsigned char		*pri;
 	int					prilen;
+
+	/*
+	 * Header of the TC_WHOLE_BATCH chunk that ends right at pri, if more
+	 * tuples may be packed into it, else NULL.
+	 */
+	unsigned char		*batch;
 };
 
 /* Max message size */
@@ -123,6 +129,10 @@ SendEndOfStream(MotionLayerState       *mlStates,
  * To get an result for unordered receive (we used to provide a separate
  * RecvTuple() function, set the srcRoute to ANY_ROUTE
  *
+ * *shouldFree is set to false if the tuple points into the receive buffer
+ * rather than having been palloc'd; it stays valid until the next call.  Only
+ * unordered receive returns tuples in place.
+ *
  * RETURN: the return code is one of the following:
  *
  *		GOT_TUPLE - A tuple was received, and it data is stored in tup_in.
@@ -135,6 +145,7 @@ extern ReceiveReturnCode RecvTupleFrom(MotionLayerState *mlStates,
 									   ChunkTransportState *transportStates,
 									   int16 motNodeID,
 									   GenericTuple *tup_i,
+									   bool *shouldFree,
 									   int16 srcRoute);
 
 extern void SendStopMessage(MotionLayerState *mlStates,
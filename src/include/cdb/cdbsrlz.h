@@ -20,6 +20,15 @@
 
 #include "nodes/nodes.h"
 
+/* Codecs for compressing serialized plans, see gp_plan_serialization_codec */
+typedef enum PlanCodec
+{
+	PLAN_CODEC_ZLIB = 0,
+	PLAN_CODEC_ZSTD = 1
+} PlanCodec;
+
+extern int	gp_plan_serialization_codec;
+
 extern char *serializeNode(Node *node, int *size, int *uncompressed_size);
 extern Node *deserializeNode(const char *strNode, int size);
 
@@ -427,6 +427,19 @@ extern int	Gp_interconnect_debug_retry_interval;
 /* UDP recv buf size in KB.  For testing */
 extern int 	Gp_udp_bufsize_k;
 
+/*
+ * Parameter Gp_interconnect_io_batch_size
+ *
+ * The run-time parameter Gp_interconnect_io_batch_size controls how many
+ * packets the UDP interconnect tries to move per sendmmsg()/recvmmsg()
+ * system call.  A value of 1 disables batching, which is also what happens
+ * on platforms that lack those calls.
+ *
+ * This guc is specific to the UDP-interconnect.
+ */
+#define GP_INTERCONNECT_MAX_IO_BATCH (64)
+extern int	Gp_interconnect_io_batch_size;
+
 /*
  * Parameter Gp_interconnect_hash_multiplier
  *
@@ -463,6 +476,14 @@ extern bool gp_interconnect_log_stats;
 
 extern bool gp_interconnect_cache_future_packets;
 
+/*
+ * Parameter gp_interconnect_local_sockets
+ *
+ * Let the TCP interconnect use Unix-domain sockets, instead of TCP, between
+ * segments on the same host.  Off by default.
+ */
+extern bool gp_interconnect_local_sockets;
+
 #define UNDEF_SEGMENT -2
 
 extern int	getgpsegmentCount(void);
@@ -614,6 +635,12 @@ extern bool gp_adjust_selectivity_for_outerjoins;
 extern int gp_hashjoin_tuples_per_bucket;
 extern int gp_hashagg_groups_per_bucket;
 
+/*
+ * Number of input tuples HashAgg hashes and prefetches buckets for at a
+ * time; 1 probes one tuple at a time.
+ */
+extern int gp_hashagg_probe_batch_size;
+
 /*
  * Damping of selectivities of clauses which pertain to the same base
  * relation; compensates for undetected correlation
@@ -763,6 +790,8 @@ extern bool gp_enable_sort_distinct;
 /* Greenplum MK Sort */
 extern bool gp_enable_mk_sort;
 extern bool gp_enable_motion_mk_sort;
+extern int	gp_mk_sort_parallel_workers;
+extern bool gp_mk_sort_abbrev_keys;
 
 #ifdef USE_ASSERT_CHECKING
 extern bool gp_mk_sort_check;
@@ -854,7 +883,17 @@ typedef enum
 extern int gpperfmon_log_alert_level;
 
 
+/* Evaluate simple quals of AOCS scans over batches of rows */
+extern bool gp_enable_aocs_batch_scan;
+
+/* Read the columns that batch quals don't need only for qualifying rows */
+extern bool gp_enable_aocs_late_materialization;
+
+/* Specialize function calls on columns and constants above this plan cost */
+extern double gp_expr_specialize_above_cost;
+
 extern int gp_workfile_compress_algorithm;
+extern int gp_workfile_compress_zstd_level;
 extern bool gp_workfile_checksumming;
 extern double gp_workfile_limit_per_segment;
 extern double gp_workfile_limit_per_query;
@@ -862,6 +901,9 @@ extern int gp_workfile_limit_files_per_query;
 extern int gp_workfile_caching_loglevel;
 extern int gp_sessionstate_loglevel;
 extern int gp_workfile_bytes_to_checksum;
+/* Read-ahead and write-behind distance of workfile I/O, in blocks */
+extern int gp_workfile_prefetch_blocks;
+extern int gp_workfile_writeback_blocks;
 /* The type of work files that HashJoin should use */
 extern int gp_workfile_type_hashjoin;
 
@@ -988,6 +1030,9 @@ extern void increment_command_count(void);
 /* default to RANDOM distribution for CREATE TABLE without DISTRIBUTED BY */
 extern bool gp_create_table_random_default_distribution;
 
+/* hash reduction (GpPolicyHashReduce) for new hash-distributed tables */
+extern int gp_create_table_hash_reduction;
+
 /* Functions in guc_gp.c to lookup values in enum GUCs */
 extern GpperfmonLogAlertLevel lookup_loglevel_by_name(const char *name);
 extern const char * lookup_autostats_mode_by_value(GpAutoStatsModeValue val);
@@ -265,11 +265,13 @@ extern void getTransportDirectBuffer(ChunkTransportState *transportStates,
 									 struct directTransportBuffer *b);
 
 /*
- * Advance direct buffer beyond the message we just added.
+ * Advance direct buffer beyond the message we just added. 'batch' is the
+ * header of the TC_WHOLE_BATCH chunk the message was packed into, if any.
  */
 extern void putTransportDirectBuffer(ChunkTransportState *transportStates,
 									 int16 motNodeID,
-									 int16 targetRoute, int serializedLength);
+									 int16 targetRoute, int serializedLength,
+									 unsigned char *batch);
 
 /* doBroadcast() is used to send a TupleChunk to all recipients.
  *
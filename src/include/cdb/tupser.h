@@ -96,4 +96,7 @@ extern HeapTuple DeserializeTuple(SerTupInfo * pSerInfo, StringInfo serialTup);
  */
 extern GenericTuple CvtChunksToTup(TupleChunkList tclist, SerTupInfo * pSerInfo, TupleRemapper *remapper);
 
+/* Extract the next tuple from a TC_WHOLE_BATCH chunk. */
+extern GenericTuple CvtBatchChunkToTup(TupleChunkListItem tcItem, int *offset);
+
 #endif   /* TUPSER_H */
@@ -0,0 +1,96 @@
+/*-------------------------------------------------------------------------
+ *
+ * execBatchQual.h
+ *	  Evaluation of simple scan quals over column vectors.
+ *
+ * Portions Copyright (c) 2018-Present Pivotal Software, Inc.
+ *
+ * src/include/executor/execBatchQual.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef EXECBATCHQUAL_H
+#define EXECBATCHQUAL_H
+
+#include "access/tupdesc.h"
+#include "nodes/pg_list.h"
+
+typedef enum BatchQualOp
+{
+	BQ_LT,
+	BQ_LE,
+	BQ_EQ,
+	BQ_NE,
+	BQ_GE,
+	BQ_GT,
+	BQ_ISNULL,
+	BQ_NOTNULL
+} BatchQualOp;
+
+/* Representation of the column values a clause compares */
+typedef enum BatchQualType
+{
+	BQT_INT16,
+	BQT_INT32,
+	BQT_INT64,
+	BQT_FLOAT4,
+	BQT_FLOAT8,
+	BQT_TEXT					/* only for BQ_EQ */
+} BatchQualType;
+
+/*
+ * A clause "column op constant", or a null test on a column.
+ *
+ * A BQT_TEXT clause is true if the column is equal to any of its constants,
+ * to cover both "column = constant" and "column IN (constants)".
+ */
+typedef struct BatchQualClause
+{
+	int			attno;			/* column number, starting from 0 */
+	BatchQualOp op;
+	BatchQualType type;
+	union
+	{
+		int64		i;
+		double		f;
+	}			constval;
+
+	/* BQT_TEXT constants, detoasted */
+	int			nconsts;
+	text	  **consts;
+
+	/* Result of a BQT_TEXT clause for each code of the last dictionary */
+	bool	   *dict_match;
+	int			dict_match_size;
+	uint32		dict_generation;
+} BatchQualClause;
+
+/*
+ * The clauses of a scan qual that are evaluated over column vectors. They
+ * are implicitly ANDed.
+ */
+typedef struct BatchQual
+{
+	int			nclauses;
+	BatchQualClause *clauses;
+	MemoryContext mcxt;
+} BatchQual;
+
+/*
+ * The dictionary of a column of a batch whose values are dictionary codes.
+ * Code c stands for entries[c], and code ncodes for NULL.
+ */
+typedef struct BatchDict
+{
+	int			ncodes;			/* 0 if the column is not encoded */
+	Datum	   *entries;
+	uint32		generation;		/* changes whenever the dictionary does */
+} BatchDict;
+
+extern BatchQual *ExecInitBatchQual(List *qual, List *qualstate, Index scanrelid,
+				  TupleDesc tupdesc, List **residual);
+extern void ExecEndBatchQual(BatchQual *bq);
+extern int ExecBatchQual(BatchQual *bq, Datum *values, bool *isnull, uint32 *runs,
+			  BatchDict *dicts, int stride, int nrows, int *sel);
+
+#endif   /* EXECBATCHQUAL_H */
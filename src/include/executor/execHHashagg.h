@@ -47,7 +47,16 @@ typedef struct HashAggEntry
 	bool is_primodial; /* indicates if this entry is there before spilling. */
 } HashAggEntry;
 
-typedef HashAggEntry* HashAggBucket;
+/*
+ * A hash bucket: the head of the entry chain, and a one-word Bloom filter
+ * of the hash values in the chain. The two are kept side by side, so that
+ * probing a bucket touches a single cache line.
+ */
+typedef struct HashAggBucket
+{
+	HashAggEntry *entry;
+	uint64 bloom;
+} HashAggBucket;
 
 /* A SpillFile controls access to a temporary file used to hold  
  * transition tuples spilled from the hash table in order to free 
@@ -155,7 +164,6 @@ typedef struct HashAggTable
 
 	unsigned nbuckets;
 	HashAggBucket  *buckets;
-	uint64 *bloom;
 
 	/* hashkey bitshift amount to determine bucket - used when spilling */
 	unsigned pshift;
@@ -207,6 +215,17 @@ typedef struct HashAggTable
 	bool expandable;  /* hash table buckets still have space to grow */
 	struct TupleTableSlot *prev_slot; /* a slot that is read previously. */
 
+	/*
+	 * Input tuples read ahead during the initial pass, with their hash keys,
+	 * so that the buckets of the whole batch can be prefetched before the
+	 * first of them is probed. See agg_hash_next_input().
+	 */
+	struct TupleTableSlot **probe_slots;
+	HashKey *probe_hashkeys;
+	int probe_nslots; /* size of the arrays */
+	int probe_len;   /* # of tuples in the batch */
+	int probe_pos;   /* next tuple of the batch to process */
+
 	/* Statistics used for EXPLAIN ANALYZE */
 	CdbExplain_Agg      chainlength;
 	uint64 total_buckets; /* total of nbuckets across spills and reloads */
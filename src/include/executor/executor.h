@@ -385,6 +385,7 @@ extern TupleTableSlot *AppendOnlyScanNext(ScanState *scanState);
 extern void BeginScanAppendOnlyRelation(ScanState *scanState);
 extern void EndScanAppendOnlyRelation(ScanState *scanState);
 extern void ReScanAppendOnlyRelation(ScanState *scanState);
+extern ScanKey ExecAppendOnlyZoneMapKeys(ScanState *scanState, int *nkeys);
 
 /*
  * prototypes from functions in execAOCSScan.c
@@ -204,6 +204,13 @@ typedef struct HashJoinTableData
     HashJoinTableStats *stats;  /* statistics workarea for EXPLAIN ANALYZE */
     bool		eagerlyReleased; /* Has this hash-table been eagerly released? */
 
+    /*
+     * Bloom filter over the hash values of all inner tuples, for the
+     * runtime join filter. NULL if the join doesn't use one.
+     */
+    uint64     *bloomBits;
+    uint32      bloomMask;      /* number of bits in the filter - 1 */
+
     HashJoinState * hjstate; /* reference to the enclosing HashJoinState */
     bool first_pass; /* Is this the first pass (pre-rescan) */
 } HashJoinTableData;
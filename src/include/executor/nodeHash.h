@@ -20,6 +20,9 @@
 #include "executor/hashjoin.h"  /* for HJTUPLE_OVERHEAD */
 #include "access/memtup.h"
 
+/* GUC */
+extern bool gp_enable_runtime_filter;
+
 extern HashState *ExecInitHash(Hash *node, EState *estate, int eflags);
 extern struct TupleTableSlot *ExecHash(HashState *node);
 extern Node *MultiExecHash(HashState *node);
@@ -51,6 +54,10 @@ extern void ExecChooseHashTableSize(double ntuples, int tupwidth, bool useskew,
 						int *numbatches,
 						int *num_skew_mcvs);
 extern int	ExecHashGetSkewBucket(HashJoinTable hashtable, uint32 hashvalue);
+extern void ExecHashPublishRuntimeFilter(HashJoinTable hashtable,
+							 RuntimeFilterState *filter);
+extern bool ExecHashRuntimeFilterReject(RuntimeFilterState *filter,
+							ExprContext *econtext);
 
 extern void ExecHashTableExplainInit(HashState *hashState, HashJoinState *hjstate,
                                      HashJoinTable  hashtable);
@@ -639,6 +639,30 @@ namespace gpdb {
 	// table has been changed?)
 	bool FMDCacheNeedsReset(void);
 
+	// can the metadata cache shared across backends be used in the current transaction?
+	bool FMDSharedCacheUsable(void);
+
+	// look up a serialized metadata object in the shared metadata cache
+	char *SzMDSharedCacheLookup(const char *szMdid, Size *pulLen, uint64 *pullGeneration);
+
+	// publish a serialized metadata object in the shared metadata cache
+	void MDSharedCacheInsert(const char *szMdid, Oid oidRel, bool fStats, uint64 ullGeneration, const char *pcData, Size ulLen);
+
+	// build the optimizer plan cache key of a query, and collect its literals
+	char *SzOptPlanCacheKey(Query *pquery, int iSegments, List **pplLiterals);
+
+	// look up the DXL plan of a query in the optimizer plan cache
+	const char *SzOptPlanCacheLookup(const char *szKey, List **pplLiterals);
+
+	// bind the literals of a query into a plan from the optimizer plan cache
+	bool FOptPlanCacheBindLiterals(PlannedStmt *pplstmt, List *plPlanLiterals, List *plQueryLiterals);
+
+	// remember the DXL plan of a query in the optimizer plan cache
+	void OptPlanCacheInsert(const char *szKey, const char *szPlan, List *plLiterals, List *plRelids);
+
+	// discard all plans in the optimizer plan cache
+	void OptPlanCacheReset(void);
+
 	// functions for tracking ORCA memory consumption
 	void *OptimizerAlloc(size_t size);
 
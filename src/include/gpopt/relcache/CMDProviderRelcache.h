@@ -20,6 +20,7 @@
 
 #include "gpos/base.h"
 #include "gpos/string/CWStringBase.h"
+#include "gpos/string/CWStringDynamic.h"
 
 #include "naucrates/md/CSystemId.h"
 #include "naucrates/md/IMDId.h"
@@ -52,6 +53,14 @@ namespace gpmd
 			// private copy ctor
 			CMDProviderRelcache(const CMDProviderRelcache&);
 
+			// can the given object be kept in the shared metadata cache, and
+			// which relation, if any, does it depend on
+			static
+			BOOL FSharedCacheable(IMDId *pmdid, OID *poidRel, BOOL *pfStats);
+
+			// translate the requested object and serialize it to DXL
+			CWStringDynamic *PstrTranslate(IMemoryPool *pmp, CMDAccessor *pmda, IMDId *pmdid) const;
+
 		public:
 			// ctor/dtor
 			explicit
@@ -205,6 +205,14 @@ class COptTasks
 		static
 		COptimizerConfig *PoconfCreate(IMemoryPool *pmp, ICostModel *pcm);
 
+		// return the plan cache key and the literals of the query to optimize, or NULL if its plan is not cached
+		static
+		CHAR *SzPlanCacheKey(SOptContext *poctx, List **pplLiterals);
+
+		// translate the plan cached for the query to optimize into a planned statement, if any
+		static
+		BOOL FPlstmtFromPlanCache(IMemoryPool *pmp, SOptContext *poctx, const CHAR *szPlanCacheKey, List *plLiterals);
+
 		// optimize a query to a physical DXL
 		static
 		void* PvOptimizeTask(void *pv);
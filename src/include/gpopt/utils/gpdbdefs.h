@@ -66,6 +66,8 @@ extern "C" {
 #include "parser/parse_coerce.h"
 #include "utils/selfuncs.h"
 #include "utils/faultinjector.h"
+#include "utils/mdsharedcache.h"
+#include "utils/optplancache.h"
 #include "funcapi.h"
 
 extern
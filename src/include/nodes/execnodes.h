@@ -568,6 +568,7 @@ typedef struct EState
 	List	   *es_rowMarks;	/* List of ExecRowMarks */
 
 	uint64		es_processed;	/* # of tuples processed */
+	int			es_num_specialized_exprs;	/* # of specialized function calls */
 	Oid			es_lastoid;		/* last oid processed (by INSERT) */
 
 	int			es_instrument;	/* OR of InstrumentOption flags */
@@ -984,6 +985,12 @@ typedef struct FuncExprState
 	ExprState  *fp_arg[2];
 	Datum		fp_datum[2];
 	bool		fp_null[2];
+
+	/*
+	 * Specialized evaluation of a call whose arguments are all plain columns
+	 * or constants, see ExecInitFuncSpecialization(). NULL if not applicable.
+	 */
+	struct FuncExprSpec *spec;
 } FuncExprState;
 
 /* ----------------
@@ -1634,6 +1641,35 @@ typedef enum
 	TableTypeInvalid,
 } TableType;
 
+/* ----------------
+ *	 RuntimeFilterState information
+ *
+ *		A Bloom filter over the join key hash values of the inner side of
+ *		a hash join.  The Hash node builds it, and a scan that feeds the
+ *		outer side of the join directly uses it to drop rows that cannot
+ *		find a match before projecting them.  See nodeHash.c.
+ *
+ *		hashkeys		   outer hash keys, rewritten to refer to the scan tuple
+ *		scan			   the scan that checks the filter
+ *		hashtable		   the hash table the filter was built for, or NULL
+ *						   if the filter is not in use
+ *		nchecked		   number of rows checked
+ *		nrejected		   number of rows dropped
+ *		nrejected_window   nrejected at the start of the current window of
+ *						   checked rows
+ * ----------------
+ */
+typedef struct RuntimeFilterState
+{
+	List	   *hashkeys;		/* list of ExprState nodes */
+	bool		keep_nulls;
+	struct ScanState *scan;
+	struct HashJoinTableData *hashtable;
+	int64		nchecked;
+	int64		nrejected;
+	int64		nrejected_window;
+} RuntimeFilterState;
+
 /* ----------------
  *	 ScanState information
  *
@@ -1647,6 +1683,7 @@ typedef enum
  *		ScanTupleSlot	   pointer to slot in tuple table holding scan tuple
  *		scan_state		   the stage of scanning
  *		tableType		   the table type of the target relation
+ *		runtimeFilter	   join filter to check before projecting, or NULL
  * ----------------
  */
 typedef struct ScanState
@@ -1659,6 +1696,8 @@ typedef struct ScanState
 
 	/* The type of the table that is being scanned */
 	TableType	tableType;
+
+	RuntimeFilterState *ss_runtimeFilter;
 } ScanState;
 
 /*
@@ -2113,6 +2152,34 @@ typedef struct AOCSScanOpaqueData
 	int			ncol;
 
 	struct AOCSScanDescData *scandesc;
+
+	/*
+	 * Batch mode, used if some clauses of the qual can be evaluated over
+	 * column vectors, see AOCSScanNextBatch(). The other clauses stay in
+	 * ps.qual; origQual is the full list, restored at the end of the scan.
+	 */
+	struct BatchQual *batchQual;
+	List	   *origQual;
+	int			batchSize;		/* maximum number of rows in a batch */
+	int		   *batchAtts;		/* numbers of the projected columns */
+	int			nbatchAtts;
+
+	/*
+	 * With late materialization, the projected columns that batchQual
+	 * doesn't look at are only read for the rows that pass it. They are
+	 * moved from batchAtts to lateAtts; batchLate flags them.
+	 */
+	bool	   *batchLate;
+	int		   *lateAtts;
+	int			nlateAtts;
+	Datum	   *batchValues;	/* ncol column vectors of batchSize rows */
+	bool	   *batchIsnull;
+	uint32	   *batchRuns;		/* RLE run ids, see aocs_getnext_batch() */
+	struct BatchDict *batchDicts;	/* dictionary of each column, if encoded */
+	ItemPointerData *batchCtids;
+	int		   *batchSel;		/* rows of the batch that passed batchQual */
+	int			batchNumSel;
+	int			batchNextSel;
 } AOCSScanOpaqueData;
 
 /* -----------------------------------------------
@@ -2346,6 +2413,9 @@ typedef struct HashJoinState
 	/* set if the operator created workfiles */
 	bool workfiles_created;
 	bool reuse_hashtable; /* Do we need to preserve hash table to support rescan */
+
+	/* Bloom filter handed to the outer side scan, or NULL */
+	RuntimeFilterState *hj_RuntimeFilter;
 } HashJoinState;
 
 
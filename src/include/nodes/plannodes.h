@@ -304,6 +304,7 @@ typedef struct Result
 	Node	   *resconstantqual;
 	bool		hashFilter;
 	List	   *hashList;
+	GpPolicyHashReduce hashReduce;	/* reduction used by the hash filter */
 } Result;
 
 /* ----------------
@@ -1178,6 +1179,7 @@ typedef struct Motion
 	/* For Hash */
 	List		*hashExpr;			/* list of hash expressions */
 	List		*hashDataTypes;	    /* list of hash expr data type oids */
+	GpPolicyHashReduce hashReduce;	/* reduction of hash values to segments */
 
 	/* Output segments */
 	int 	  	numOutputSegs;		/* number of seg indexes in outputSegIdx array, 0 for broadcast */
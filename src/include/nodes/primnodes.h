@@ -23,6 +23,7 @@
 #include "nodes/pg_list.h"
 #include "nodes/params.h"  /* For ParamListInfoData */
 #include "cdb/cdbpathlocus.h" /* For CdbLocusType */
+#include "catalog/gp_policy.h" /* For GpPolicyHashReduce */
 
 
 /* ----------------------------------------------------------------
@@ -1403,6 +1404,11 @@ typedef struct Flow
 	 * otherwise, they are NIL. */
 	List       *hashExpr;			/* list of hash expressions */
 
+	/* If req_move is MOVEMENT_REPARTITION, how the hash motion reduces
+	 * hash values to segments.
+	 */
+	GpPolicyHashReduce hashReduce;
+
 	/* If req_move is MOVEMENT_EXPLICIT, this contains the index of the segid column
 	 * to use in the motion	 */
 	AttrNumber segidColIdx;
@@ -59,12 +59,38 @@ typedef struct bfz
 	int64 numBlocks;
 	int64 blockNo;
 	int64 chosenBlockNo;
+
+	/*
+	 * File offsets up to which read-ahead has been requested while scanning,
+	 * and from which writeback has not been started yet while appending.
+	 */
+	int64 prefetch_end;
+	int64 writeback_start;
 }	bfz_t;
 
+/*
+ * A block compression algorithm. Every buffer passed to write_ex is
+ * compressed on its own and stored as a block with a small header, see
+ * compress_block.c.
+ *
+ * compress returns the compressed size, or 0 if the data could not be
+ * compressed into dstcap bytes. decompress returns the decompressed size,
+ * or -1 if the input is corrupt.
+ */
+typedef struct bfz_block_codec
+{
+	const char *name;
+	int			(*compress) (const char *src, int srclen, char *dst, int dstcap);
+	int			(*decompress) (const char *src, int srclen, char *dst, int dstcap);
+} bfz_block_codec;
+
 /* These functions are internal to bfz. */
 extern void bfz_nothing_init(bfz_t * thiz);
 extern void bfz_zlib_init(bfz_t * thiz);
 extern void bfz_lzop_init(bfz_t * thiz);
+extern void bfz_lz4_init(bfz_t * thiz);
+extern void bfz_zstd_init(bfz_t * thiz);
+extern void bfz_block_init(bfz_t * thiz, const bfz_block_codec *codec);
 extern void bfz_write_ex(bfz_t * thiz, const char *buffer, int size);
 extern int	bfz_read_ex(bfz_t * thiz, char *buffer, int size);
 
@@ -47,6 +47,7 @@ extern int	BufFileSeek(BufFile *file, int fileno, off_t offset, int whence);
 extern void BufFileTell(BufFile *file, int *fileno, off_t *offset);
 extern int	BufFileSeekBlock(BufFile *file, int64 blknum);
 extern void BufFileFlush(BufFile *file);
+extern void BufFilePrefetch(BufFile *file, int64 offset, int64 nbytes);
 extern int64 BufFileGetSize(BufFile *buffile);
 extern void BufFileSetWorkfile(BufFile *buffile);
 
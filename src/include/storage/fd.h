@@ -72,6 +72,7 @@ extern File OpenTemporaryFile(bool interXact, const char *filePrefix);
 
 extern void FileClose(File file);
 extern int	FilePrefetch(File file, off_t offset, int amount);
+extern int	FileWriteback(File file, off_t offset, int amount);
 extern int	FileRead(File file, char *buffer, int amount);
 extern int	FileWrite(File file, char *buffer, int amount);
 extern int	FileSync(File file);
@@ -95,6 +95,7 @@ typedef enum LWLockId
 	FilespaceHashLock,
 	TablespaceHashLock,
 	GpReplicationConfigFileLock,
+	OptMDSharedCacheLock,
 	/* must be last except for MaxDynamicLWLock: */
 	NumFixedLWLocks,
 
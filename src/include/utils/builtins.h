@@ -1244,6 +1244,12 @@ extern Datum zstd_compress(PG_FUNCTION_ARGS);
 extern Datum zstd_decompress(PG_FUNCTION_ARGS);
 extern Datum zstd_validator(PG_FUNCTION_ARGS);
 
+extern Datum lz4_constructor(PG_FUNCTION_ARGS);
+extern Datum lz4_destructor(PG_FUNCTION_ARGS);
+extern Datum lz4_compress(PG_FUNCTION_ARGS);
+extern Datum lz4_decompress(PG_FUNCTION_ARGS);
+extern Datum lz4_validator(PG_FUNCTION_ARGS);
+
 extern Datum delta_constructor(PG_FUNCTION_ARGS);
 extern Datum delta_destructor(PG_FUNCTION_ARGS);
 extern Datum delta_compress(PG_FUNCTION_ARGS);
@@ -1273,6 +1279,7 @@ extern Datum enable_xform(PG_FUNCTION_ARGS);
 
 /* Optimizer's version */
 extern Datum gp_opt_version(PG_FUNCTION_ARGS);
+extern Datum gp_opt_plan_cache_stats(PG_FUNCTION_ARGS);
 
 /* query_metrics.c */
 extern Datum gp_instrument_shmem_summary(PG_FUNCTION_ARGS);
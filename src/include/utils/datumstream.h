@@ -225,6 +225,47 @@ datumstreamread_advance(DatumStreamRead * acc)
 	}
 }
 
+/*
+ * Number of datums that follow the current one in the current block.
+ */
+inline static int
+datumstreamread_block_remaining(DatumStreamRead * acc)
+{
+	if (acc->largeObjectState == DatumStreamLargeObjectState_None)
+		return acc->blockRead.logical_row_count - acc->blockRead.nth - 1;
+	else
+		return (acc->largeObjectState == DatumStreamLargeObjectState_HaveAoContent) ? 1 : 0;
+}
+
+/*
+ * Is the next datum of the current block another copy of the current one,
+ * within an RLE_TYPE run?  Repeated items are never NULL.
+ */
+inline static bool
+datumstreamread_next_repeats(DatumStreamRead * acc)
+{
+	return acc->largeObjectState == DatumStreamLargeObjectState_None &&
+		acc->blockRead.rle_in_repeated_item;
+}
+
+/*
+ * Is the current block dictionary encoded?  Then datumstreamread_dict_code()
+ * is the code of the current datum, if it is not NULL: the index of its
+ * entry in blockRead.dict_entries.
+ */
+inline static bool
+datumstreamread_has_dictionary(DatumStreamRead * acc)
+{
+	return acc->largeObjectState == DatumStreamLargeObjectState_None &&
+		acc->blockRead.dict_block_was_encoded;
+}
+
+inline static int32
+datumstreamread_dict_code(DatumStreamRead * acc)
+{
+	return DatumStreamBlockRead_DictCode(&acc->blockRead);
+}
+
 extern int	datumstreamread_nthlarge(DatumStreamRead * ds);
 inline static int
 datumstreamread_nth(DatumStreamRead * acc)
@@ -255,6 +296,7 @@ extern int	datumstreamwrite_nth(DatumStreamWrite * ds);
 extern DatumStreamWrite *create_datumstreamwrite(
 						char *compName,
 						int32 compLevel,
+						bool dictionary,
 						bool checksum,
 						int32 safeFSWriteSize,
 						int32 maxsz,
@@ -311,6 +353,7 @@ extern int	datumstreamread_block(DatumStreamRead * ds,
 								  int colGroupNo);
 extern void datumstreamread_find(DatumStreamRead * datumStream,
 					 int32 rowNumInBlock);
+extern int	datumstreamread_skip_to_row(DatumStreamRead * acc, int64 rowNum);
 extern void datumstreamread_rewind_block(DatumStreamRead * datumStream);
 extern bool datumstreamread_find_block(DatumStreamRead * datumStream,
 						   DatumStreamFetchDesc datumStreamFetchDesc,
@@ -64,6 +64,9 @@ typedef enum DatumStreamVersion
  * |                       |                   +-------------------+              |
  * |                       |                   | Datum + Alignment |              |
  * +-----------------------+-------------------+-------------------+--------------+
+ *
+ * A Dense_Enhanced block of a variable-length column may also be dictionary
+ * encoded, see DatumStreamBlock_Dict_Extension.
  */
 
 /*
@@ -196,6 +199,37 @@ typedef struct DatumStreamBlock_Delta_Extension
 	 */
 }	DatumStreamBlock_Delta_Extension;
 
+/*
+ * Datum Stream Block extension for dictionary encoding.  It comes after the
+ * RLE_TYPE and Delta extensions, if any.
+ * 8 bytes more.
+ *
+ * A dictionary encoded block stores each distinct physical datum once.  The
+ * datum area begins with the dictionary entries, laid out like the datums of
+ * a block that is not encoded, followed by one code per physical datum, the
+ * index of its entry.  The codes are 1 byte long for up to 256 entries, 2
+ * bytes otherwise, and aligned on their size.  physical_data_size covers the
+ * entries and the codes.
+ */
+typedef struct DatumStreamBlock_Dict_Extension
+{
+	int32		dict_count;
+	/*
+	 * Number of dictionary entries.
+	 */
+
+	int32		dict_size;
+	/*
+	 * Total size of the dictionary entries, including alignment padding
+	 * between them.
+	 */
+}	DatumStreamBlock_Dict_Extension;
+
+/* Most dictionary entries of a block; the codes must fit in 2 bytes. */
+#define DATUMSTREAM_DICT_MAX_ENTRIES 16384
+
+#define DatumStreamBlock_DictCodeSize(dict_count) ((dict_count) <= 256 ? 1 : 2)
+
 
 /* Flags */
 enum
@@ -203,6 +237,7 @@ enum
 	DSB_HAS_NULLBITMAP = 0x1,
 	DSB_HAS_RLE_COMPRESSION = 0x2,
 	DSB_HAS_DELTA_COMPRESSION = 0x4,
+	DSB_HAS_DICTIONARY = 0x8,
 };
 
 typedef struct DatumStreamBitMapWrite
@@ -1008,6 +1043,7 @@ typedef struct DatumStreamBlockWrite
 
 	bool		rle_want_compression;
 	bool		delta_want_compression;
+	bool		dict_want_encoding;
 
 	int32		initialMaxDatumPerBlock;
 	int32		maxDatumPerBlock;
@@ -1082,6 +1118,13 @@ typedef struct DatumStreamBlockWrite
 	bool	   *delta_sign;
 	int32		deltas_maxcount;
 
+	/* Dictionary encoding buffers, allocated on first use */
+	int32	   *dict_hash;		/* entry + 1 for each hash bucket, 0 if free */
+	int32		dict_hash_maxsize;
+	int32	   *dict_offsets;	/* datum_buffer offset of each entry */
+	uint16	   *dict_codes;		/* code of each physical datum */
+	int32		dict_codes_maxcount;
+
 	/* EOF of current file */
 	int64		savings;
 	int64		remember_savings;
@@ -1164,6 +1207,15 @@ typedef struct DatumStreamBlockRead
 	bool		delta_block_was_compressed;
 	DatumStreamBitMapRead delta_bitmap;
 
+	/* Dictionary variables */
+	bool		dict_block_was_encoded;
+	int32		dict_count;
+	int32		dict_code_size;
+	uint8	   *dict_codesp;
+	Datum	   *dict_entries;	/* pointer to each entry */
+	int32		dict_entries_maxcount;
+	uint32		dict_generation;	/* different for every dictionary read */
+
 	/*
 	 * Keep less frequently accessed fields down here for possible better CPU data cache
 	 * performance.
@@ -1718,6 +1770,23 @@ DatumStreamBlockRead_AdvanceDenseDelta(DatumStreamBlockRead * dsr)
 	return DELTA_COMPRESSION_OK;
 }
 
+/*
+ * Dictionary code of the current physical datum of a dictionary encoded
+ * block.
+ */
+inline static int32
+DatumStreamBlockRead_DictCode(DatumStreamBlockRead * dsr)
+{
+	Assert(dsr->dict_block_was_encoded);
+	Assert(dsr->physical_datum_index >= 0 &&
+		   dsr->physical_datum_index < dsr->physical_datum_count);
+
+	if (dsr->dict_code_size == 1)
+		return dsr->dict_codesp[dsr->physical_datum_index];
+	else
+		return ((uint16 *) dsr->dict_codesp)[dsr->physical_datum_index];
+}
+
 inline static int
 DatumStreamBlockRead_AdvanceDense(DatumStreamBlockRead * dsr)
 {
@@ -1924,6 +1993,17 @@ DatumStreamBlockRead_AdvanceDense(DatumStreamBlockRead * dsr)
 	++dsr->physical_datum_index;
 	//Initially, -1.
 
+	if (dsr->dict_block_was_encoded)
+	{
+		/*
+		 * Point at the dictionary entry of the item.  The entries are
+		 * not in item order, so there is nothing to step over.
+		 */
+		dsr->datump = (uint8 *)
+			DatumGetPointer(dsr->dict_entries[DatumStreamBlockRead_DictCode(dsr)]);
+		return 1;
+	}
+
 		if (dsr->physical_datum_index == 0)
 	{
 		/* Pre-positioned by block read to first item. */
@@ -2152,6 +2232,7 @@ extern void DatumStreamBlockWrite_Init(
 						   DatumStreamVersion datumStreamVersion,
 						   bool rle_want_compression,
 						   bool delta_want_compression,
+						   bool dict_want_encoding,
 						   int32 initialMaxDatumPerBlock,
 						   int32 maxDatumPerBlock,
 						   int32 maxDataBlockSize,
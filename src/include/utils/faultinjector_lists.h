@@ -142,6 +142,8 @@ FI_IDENT(CompactionBeforeSegmentFileDropPhase, "compaction_before_segmentfile_dr
 /* inject fault after compaction and drop, but before
  * the cleanup phase for a relation */
 FI_IDENT(CompactionBeforeCleanupPhase, "compaction_before_cleanup_phase")
+/* inject fault when vacuum looks for another segment file to compact into */
+FI_IDENT(CompactionInsertSegnoUnavailable, "compaction_insert_segno_unavailable")
 /* inject fault before an append-only insert */
 FI_IDENT(AppendOnlyInsert, "appendonly_insert")
 /* inject fault before an append-only delete */
@@ -150,6 +152,8 @@ FI_IDENT(AppendOnlyDelete, "appendonly_delete")
 FI_IDENT(AppendOnlyUpdate, "appendonly_update")
 /* inject fault in append-only compression function */
 FI_IDENT(AppendOnlySkipCompression, "appendonly_skip_compression")
+/* inject fault when an append-only scan skips blocks using the zone map */
+FI_IDENT(AppendOnlyZoneMapSkip, "appendonly_zonemap_skip")
 /* inject fault while reindex db is in progress */
 FI_IDENT(ReindexDB, "reindex_db")
 /* inject fault while reindex relation is in progress */
@@ -238,6 +238,13 @@ extern bool gp_appendonly_compaction;
  * 10% of the tuples are hidden.
  */ 
 extern int  gp_appendonly_compaction_threshold;
+/*
+ * Number of segment files each compaction transaction of a lazy vacuum
+ * moves, each one into its own insert segment file.
+ */
+extern int  gp_appendonly_compaction_segfiles;
+/* Read rate limit of compaction, in kB/s per segment. 0 is no limit. */
+extern int  gp_appendonly_compaction_io_limit;
 extern bool gp_heap_require_relhasoids_match;
 extern bool	Debug_appendonly_rezero_quicklz_compress_scratch;
 extern bool	Debug_appendonly_rezero_quicklz_decompress_scratch;
@@ -562,6 +569,7 @@ extern IndexCheckType gp_indexcheck_vacuum;
 #define SOPT_COMPTYPE      "compresstype"
 #define SOPT_COMPLEVEL     "compresslevel"
 #define SOPT_CHECKSUM      "checksum"
+#define SOPT_DICTIONARY    "dictionary"
 #define SOPT_ORIENTATION   "orientation"
 /* Max number of chars needed to hold value of a storage option. */
 #define MAX_SOPT_VALUE_LEN 15
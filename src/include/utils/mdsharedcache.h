@@ -0,0 +1,37 @@
+/*-------------------------------------------------------------------------
+ *
+ * mdsharedcache.h
+ *	  Shared-memory cache of serialized optimizer metadata objects.
+ *
+ * Portions Copyright (c) 2018-Present Pivotal Software, Inc.
+ *
+ * src/include/utils/mdsharedcache.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef MDSHAREDCACHE_H
+#define MDSHAREDCACHE_H
+
+#include "storage/sinval.h"
+
+/*
+ * Longest metadata id string that can be used as a cache key, including
+ * the terminating NUL. Longer ids are simply never cached.
+ */
+#define MDSHAREDCACHE_KEYLEN	64
+
+/* GUC */
+extern int	optimizer_shared_mdcache_size;
+
+extern Size MDSharedCacheShmemSize(void);
+extern void MDSharedCacheShmemInit(void);
+
+extern bool MDSharedCacheIsUsable(void);
+extern char *MDSharedCacheLookup(const char *mdid, Size *len, uint64 *generation);
+extern void MDSharedCacheInsert(const char *mdid, Oid relid, bool isstats,
+					uint64 generation, const char *data, Size len);
+
+extern void MDSharedCacheProcessInvalidations(const SharedInvalidationMessage *msgs,
+								  int n);
+
+#endif   /* MDSHAREDCACHE_H */
@@ -0,0 +1,32 @@
+/*-------------------------------------------------------------------------
+ *
+ * optplancache.h
+ *	  Backend-local cache of plans produced by the optimizer (ORCA).
+ *
+ * Portions Copyright (c) 2018-Present Pivotal Software, Inc.
+ *
+ * src/include/utils/optplancache.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef OPTPLANCACHE_H
+#define OPTPLANCACHE_H
+
+#include "nodes/parsenodes.h"
+#include "nodes/plannodes.h"
+
+/* GUC: size of the plan cache in kB, 0 disables it */
+extern int	optimizer_plan_cache_size;
+
+extern char *OptPlanCacheMakeKey(Query *query, int nsegments, List **literals);
+extern const char *OptPlanCacheLookup(const char *key, List **literals);
+extern bool OptPlanCacheBindLiterals(PlannedStmt *stmt, List *planLiterals,
+						 List *queryLiterals);
+extern void OptPlanCacheInsert(const char *key, const char *plan,
+				   List *literals, List *relids);
+extern void OptPlanCacheInvalidateRelation(Oid relid);
+extern void OptPlanCacheReset(void);
+extern void OptPlanCacheGetStats(int64 *hits, int64 *misses, int *entries,
+					 int64 *size);
+
+#endif   /* OPTPLANCACHE_H */
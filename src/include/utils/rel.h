@@ -263,6 +263,7 @@ typedef struct StdRdOptions
 	bool		checksum;		/* checksum (AO rels only) */
 	bool 		columnstore;	/* columnstore (AO only) */
 	char	   *orientation;	/* orientation (AO only) */
+	bool		dictionary;		/* dictionary encoding (rle_type columns only) */
 } StdRdOptions;
 
 #define HEAP_MIN_FILLFACTOR			10
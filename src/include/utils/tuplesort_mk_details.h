@@ -221,8 +221,15 @@ typedef enum MKLvType
     MKLV_TYPE_INT32, /* this level contains int32 values */
     MKLV_TYPE_CHAR,  /* this level contains char (blank padded) values */
     MKLV_TYPE_TEXT,  /* this level contains text values */
+    MKLV_TYPE_ABBREV, /* this level is compared on abbreviated keys, see abbrev */
 } MKLvType;
 
+/*
+ * Computes an abbreviated key: a uint64, stored in a Datum, whose unsigned
+ * order agrees with the sort function's order of the original values.
+ */
+typedef Datum (*MKAbbreviate) (Datum d);
+
 typedef struct MKLvContext
 {
 	/* Is the type of datums in this level passed by value instead of reference */
@@ -236,6 +243,14 @@ typedef struct MKLvContext
 
 	ScanKeyData	scanKey;
 
+    /*
+     * For MKLV_TYPE_ABBREV, the function computing the abbreviated keys.  If
+     * abbrevLossy, different values can have equal abbreviated keys, and
+     * those are compared again using the sort function.
+     */
+    MKAbbreviate abbrev;
+    bool abbrevLossy;
+
     int16 attno;
 
     /* the mk heap context that this level context belongs to */
@@ -297,6 +312,12 @@ typedef struct MKContext {
 
 	/* Name of the index we're building, if any. Used for error messages. */
 	char	   *indexname;
+
+	/*
+	 * Set while mk_qsort_parallel runs.  The sort then executes outside the
+	 * main backend thread, so it must not check for interrupts.
+	 */
+	bool		inParallelSort;
 } MKContext;
 
 /**
@@ -332,6 +353,17 @@ static inline void mk_qsort(MKEntry* a, int n, MKContext *ctxt)
     mk_qsort_impl(a, 0, n-1, 0, true, ctxt, false);
 }
 
+/* Most ranges mk_qsort_parallel splits the array into */
+#define MKQS_MAX_PARALLEL	16
+
+/*
+ * Sort the array in nparts ranges on separate threads and merge them, using
+ * scratch (n entries) as the merge target.  The caller must make sure that
+ * preparing and comparing the entries neither allocates memory nor raises
+ * errors.
+ */
+extern void mk_qsort_parallel(MKEntry *a, int n, MKContext *ctxt, int nparts, MKEntry *scratch);
+
 /* MK Heap stuff */
 typedef bool (*MKFlagPtrReader) (void *ctxt, MKEntry *e);
 typedef struct MKHeapReader
@@ -432,4 +464,32 @@ static inline int64 mkheap_cnt(MKHeap *mkheap)
     return mkheap->count;
 }
 
+/* MK Loser tree stuff */
+
+/*
+ * A loser tree merging the entries of an array of readers, each of which
+ * returns its entries in sorted order.
+ */
+typedef struct MKLoserTree
+{
+    MKContext *mkctxt;
+
+    /* the readers, not owned by the tree */
+    MKHeapReader *readers;
+    int nreader;
+
+    /* current entry of each reader, empty once the reader is exhausted */
+    MKEntry *entries;
+
+    /* tree[0] is the winning reader, tree[1 .. nreader-1] the losers */
+    int *tree;
+
+    /* number of comparisons so far */
+    uint64 ncompares;
+} MKLoserTree;
+
+extern MKLoserTree *mkloser_from_reader(MKHeapReader *readers, int nreader, MKContext *mkctxt);
+extern void mkloser_destroy(MKLoserTree *lt);
+extern bool mkloser_get(MKLoserTree *lt, MKEntry *out);
+
 #endif  // TUPLESORT_MK_DETAILS_H
@@ -69,6 +69,14 @@ typedef struct workfile_set
 	/* Real-time size of the set as it is being created (for reporting only) */
 	int64 in_progress_size;
 
+	/*
+	 * Bytes written to the files of the set by the operator, and the bytes
+	 * they took on disk after compression (for reporting only). The latter
+	 * is only known for a compressed file once it has been fully written.
+	 */
+	int64 bytes_uncompressed;
+	int64 bytes_compressed;
+
 	/* Prefix of files in the workfile set */
 	char path[MAXPGPATH];
 
@@ -136,6 +144,8 @@ Size workfile_mgr_shmem_size(void);
 void workfile_mgr_cache_init(void);
 Cache *workfile_mgr_get_cache(void);
 void workfile_set_update_in_progress_size(workfile_set *work_set, int64 size);
+void workfile_set_update_bytes_written(workfile_set *work_set, int64 uncompressed,
+		int64 compressed);
 
 /* Workfile File operations */
 ExecWorkFile *workfile_mgr_create_file(workfile_set *work_set);
@@ -0,0 +1,44 @@
+-- Tests for the optimizer metadata cache shared across backends
+-- (optimizer_shared_mdcache_size). A session must not plan with metadata
+-- that another session translated under different settings, or from
+-- catalog state that had already been invalidated.
+
+create table mdcache_t (a int, b int) distributed by (a);
+insert into mdcache_t select i, i from generate_series(1, 100) i;
+create table mdcache_mlp (a int, b int, c int) distributed by (a) partition by range (b) subpartition by list (c) subpartition template (subpartition c1 values (1), subpartition c2 values (2)) (start (1) end (3) every (1));
+insert into mdcache_mlp select i, i % 2 + 1, i % 2 + 1 from generate_series(1, 100) i;
+
+-- Does the plan of a query contain the given text?
+-- (All on one line because of limitations in the isolation2 test language.)
+create or replace function mdcache_plan_has(query text, pattern text) returns bool as $$ declare r record; begin for r in execute 'explain ' || query loop if r."QUERY PLAN" like '%' || pattern || '%' then return true; end if; end loop; return false; end; $$ language plpgsql;
+
+-- A multi-level partitioned table that session 1 could plan with
+-- optimizer_multilevel_partitioning on must still make session 2, which
+-- has it off, fall back to the legacy planner.
+1: set optimizer_multilevel_partitioning = on;
+1: select count(*) from mdcache_mlp;
+2: set optimizer_multilevel_partitioning = off;
+2: select mdcache_plan_has('select * from mdcache_mlp', 'legacy query optimizer');
+2: select count(*) from mdcache_mlp;
+
+-- Session 3 already holds its lock on the table, so planning its next
+-- query does not process invalidations by itself. It must not publish the
+-- table without the index created in the meantime: a new session 4 has to
+-- see the index.
+3: begin;
+3: lock table mdcache_t in access share mode;
+1: create index mdcache_t_b on mdcache_t (b);
+3: select count(*) from mdcache_t where b = 5;
+3: commit;
+4: set enable_seqscan = off;
+4: select mdcache_plan_has('select * from mdcache_t where b = 5', 'Index');
+4: select count(*) from mdcache_t where b = 5;
+
+1q:
+2q:
+3q:
+4q:
+
+drop function mdcache_plan_has(text, text);
+drop table mdcache_mlp;
+drop table mdcache_t;
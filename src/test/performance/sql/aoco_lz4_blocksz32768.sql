@@ -0,0 +1 @@
+INSERT INTO aoco_lz4_blocksz32768 SELECT * FROM base_table;
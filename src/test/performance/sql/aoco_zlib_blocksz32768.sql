@@ -0,0 +1 @@
+INSERT INTO aoco_zlib_blocksz32768 SELECT * FROM base_table;
@@ -0,0 +1 @@
+INSERT INTO aoco_zstd_blocksz32768 SELECT * FROM base_table;
@@ -0,0 +1,11 @@
+-- Report the compression ratio of each compression type, for the same data.
+-- The numbers depend on the size of the dataset, so they are not compared.
+-- start_ignore
+SELECT relname, get_ao_compression_ratio(oid) AS ratio,
+       pg_size_pretty(pg_total_relation_size(oid)) AS size
+FROM pg_class
+WHERE relname IN ('ao_blocksz32768', 'ao_zlib_blocksz32768', 'ao_zstd_blocksz32768',
+                  'ao_lz4_blocksz32768', 'aoco_blocksz32768', 'aoco_zlib_blocksz32768',
+                  'aoco_zstd_blocksz32768', 'aoco_lz4_blocksz32768')
+ORDER BY relname;
+-- end_ignore
@@ -0,0 +1,4 @@
+-- Scan all the columns, to measure decompression throughput
+SELECT count(a) + count(b) + count(c) + count(d) + count(e) + count(f) + count(g) +
+       count(h) + count(i) + count(j) + count(k) + count(l) + count(m) > 0 AS scanned
+FROM aoco_zlib_blocksz32768;
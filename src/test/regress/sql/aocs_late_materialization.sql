@@ -0,0 +1,89 @@
+--
+-- Late materialization of column-oriented table scans
+-- (gp_enable_aocs_late_materialization). The columns that a batch scan only
+-- needs for its output are read for the rows that pass the batch quals.
+-- Every query must return the same rows with it on and off, and the same
+-- rows as the same query on a heap table: over many blocks and several
+-- segment files, with deleted rows, with blocks that the zone map skips, and
+-- with a column added by ALTER TABLE.
+--
+create schema aocs_late_materialization;
+set search_path to aocs_late_materialization;
+
+set gp_enable_aocs_batch_scan = on;
+set enable_indexscan = off;
+set enable_bitmapscan = off;
+
+-- The index gives the table a block directory, and so zone maps on id.
+create table lm_co (id int, k int, p text, n numeric)
+	with (appendonly=true, orientation=column, blocksize=8192) distributed by (id);
+create index lm_co_id on lm_co (id);
+create table lm_heap (id int, k int, p text, n numeric) distributed by (id);
+
+insert into lm_co select i, i % 1000, repeat('p', 20) || i, i * 1.5
+	from generate_series(1, 30000) i;
+insert into lm_heap select * from lm_co;
+
+-- Selective quals, with the late columns in many blocks
+set gp_enable_aocs_late_materialization = on;
+select id, p, n from lm_co where k = 7 and id < 5000 order by id;
+select count(*), sum(n), min(p), max(p) from lm_co where k in (7, 8);
+select count(*) from ((select * from lm_co where k < 3 except all select * from lm_heap where k < 3)
+	union all (select * from lm_heap where k < 3 except all select * from lm_co where k < 3)) d;
+set gp_enable_aocs_late_materialization = off;
+select id, p, n from lm_co where k = 7 and id < 5000 order by id;
+select count(*), sum(n), min(p), max(p) from lm_co where k in (7, 8);
+
+-- Deleted rows
+delete from lm_co where id % 3 = 0;
+delete from lm_heap where id % 3 = 0;
+set gp_enable_aocs_late_materialization = on;
+select id, p, n from lm_co where k = 7 and id < 5000 order by id;
+select count(*), sum(n), min(p), max(p) from lm_co where k in (7, 8);
+select count(*) from ((select * from lm_co where k < 3 except all select * from lm_heap where k < 3)
+	union all (select * from lm_heap where k < 3 except all select * from lm_co where k < 3)) d;
+
+-- VACUUM moves the visible rows to another segment file, the next insert
+-- adds some more
+vacuum lm_co;
+insert into lm_co select i, i % 1000, repeat('p', 20) || i, i * 1.5
+	from generate_series(30001, 40000) i;
+insert into lm_heap select i, i % 1000, repeat('p', 20) || i, i * 1.5
+	from generate_series(30001, 40000) i;
+select id, p, n from lm_co where k = 7 and id > 25000 order by id;
+select count(*), sum(n), min(p), max(p) from lm_co where k in (7, 8);
+select count(*) from ((select * from lm_co where k < 3 except all select * from lm_heap where k < 3)
+	union all (select * from lm_heap where k < 3 except all select * from lm_co where k < 3)) d;
+set gp_enable_aocs_late_materialization = off;
+select id, p, n from lm_co where k = 7 and id > 25000 order by id;
+
+-- Blocks that the zone map on id skips, before and after rows that pass
+set gp_enable_aocs_late_materialization = on;
+select id, k, p from lm_co where id between 20001 and 20010 order by id;
+select id, p, n from lm_co where id > 35000 and k = 5 order by id;
+set gp_appendonly_zonemap = off;
+select id, k, p from lm_co where id between 20001 and 20010 order by id;
+select id, p, n from lm_co where id > 35000 and k = 5 order by id;
+reset gp_appendonly_zonemap;
+
+-- A column added by ALTER TABLE
+alter table lm_co add column c text default 'added';
+alter table lm_heap add column c text default 'added';
+insert into lm_co select i, i % 1000, repeat('p', 20) || i, i * 1.5, 'c' || i
+	from generate_series(40001, 41000) i;
+insert into lm_heap select i, i % 1000, repeat('p', 20) || i, i * 1.5, 'c' || i
+	from generate_series(40001, 41000) i;
+select id, c, n from lm_co where k = 7 and id > 35000 order by id;
+select c, count(*) from lm_co where k < 10 group by c order by c;
+select count(*) from ((select * from lm_co where k < 3 except all select * from lm_heap where k < 3)
+	union all (select * from lm_heap where k < 3 except all select * from lm_co where k < 3)) d;
+set gp_enable_aocs_late_materialization = off;
+select id, c, n from lm_co where k = 7 and id > 35000 order by id;
+
+reset gp_enable_aocs_late_materialization;
+reset gp_enable_aocs_batch_scan;
+reset enable_indexscan;
+reset enable_bitmapscan;
+-- start_ignore
+drop schema aocs_late_materialization cascade;
+-- end_ignore
@@ -0,0 +1,30 @@
+-- Tests for lz4 compression.
+
+CREATE TABLE lz4test (id int4, t text) WITH (appendonly=true, compresstype=lz4, orientation=column);
+
+INSERT INTO lz4test SELECT g, 'foo' || g FROM generate_series(1, 100000) g;
+INSERT INTO lz4test SELECT g, 'bar' || g FROM generate_series(1, 100000) g;
+
+-- Check contents, at the beginning of the table and at the end.
+SELECT * FROM lz4test ORDER BY id, t LIMIT 5;
+SELECT * FROM lz4test ORDER BY id DESC, t LIMIT 5;
+
+
+-- Test the fast and the HC compressor, on a row oriented table.
+CREATE TABLE lz4test_1 (id int4, t text) WITH (appendonly=true, compresstype=lz4, compresslevel=1);
+CREATE TABLE lz4test_9 (id int4, t text) WITH (appendonly=true, compresstype=lz4, compresslevel=9);
+
+INSERT INTO lz4test_1 SELECT g, 'foo' || g FROM generate_series(1, 10000) g;
+INSERT INTO lz4test_1 SELECT g, 'bar' || g FROM generate_series(1, 10000) g;
+SELECT * FROM lz4test_1 ORDER BY id, t LIMIT 5;
+SELECT * FROM lz4test_1 ORDER BY id DESC, t LIMIT 5;
+
+INSERT INTO lz4test_9 SELECT g, 'foo' || g FROM generate_series(1, 10000) g;
+INSERT INTO lz4test_9 SELECT g, 'bar' || g FROM generate_series(1, 10000) g;
+SELECT * FROM lz4test_9 ORDER BY id, t LIMIT 5;
+SELECT * FROM lz4test_9 ORDER BY id DESC, t LIMIT 5;
+
+
+-- Test the bounds of compresslevel. None of these are allowed.
+CREATE TABLE lz4test_invalid (id int4) WITH (appendonly=true, compresstype=lz4, compresslevel=0);
+CREATE TABLE lz4test_invalid (id int4) WITH (appendonly=true, compresstype=lz4, compresslevel=10);
@@ -0,0 +1,99 @@
+--
+-- Dictionary encoding of RLE_TYPE compressed variable-length columns of
+-- column-oriented tables (the "dictionary" column encoding option).  Every
+-- query must return the same rows as the same query on a heap table, with
+-- batch scans on and off, before and after DELETE, UPDATE and VACUUM.
+--
+create schema dict_encoding;
+set search_path to dict_encoding;
+
+-- t has few distinct values (1-byte codes), v has many (2-byte codes).
+create table dict_co (id int,
+	t text encoding (compresstype=rle_type, dictionary=true),
+	v varchar(20) encoding (compresstype=rle_type, dictionary=true))
+	with (appendonly=true, orientation=column) distributed by (id);
+create table dict_heap (id int, t text, v varchar(20)) distributed by (id);
+select attnum, attoptions from pg_attribute_encoding
+	where attrelid = 'dict_co'::regclass and attnum > 1 order by attnum;
+
+-- In the WITH clause the option applies to every column. It is only valid
+-- for rle_type columns of append-only tables.
+create table dict_co_with (id int, t text)
+	with (appendonly=true, orientation=column, compresstype=rle_type, dictionary=true)
+	distributed by (id);
+select attnum, attoptions from pg_attribute_encoding
+	where attrelid = 'dict_co_with'::regclass order by attnum;
+create table dict_bad (id int, t text encoding (compresstype=zlib, dictionary=true))
+	with (appendonly=true, orientation=column) distributed by (id);
+create table dict_bad (id int, t text) with (dictionary=true) distributed by (id);
+
+insert into dict_co select i, 'val' || (i % 50), 'v' || (i % 700)
+	from generate_series(1, 20000) i;
+insert into dict_co select i, null, null from generate_series(20001, 20100) i;
+insert into dict_heap select * from dict_co;
+
+-- Seq scans
+set gp_enable_aocs_batch_scan = off;
+select count(*), count(t), count(distinct t), count(distinct v) from dict_co;
+select count(*) from dict_co where t = 'val7';
+select count(*) from ((select * from dict_co except all select * from dict_heap)
+	union all (select * from dict_heap except all select * from dict_co)) d;
+
+-- Batch scans, which compare the dictionary once instead of every value
+set gp_enable_aocs_batch_scan = on;
+select count(*) from dict_co where t = 'val7';
+select count(*) from dict_co where t in ('val7', 'val8', 'nosuchval');
+select count(*) from dict_co where v = 'v699';
+select count(*) from dict_co where t = 'val7' and v = 'v7';
+select count(*) from dict_co where t is null;
+select count(*) from ((select * from dict_co except all select * from dict_heap)
+	union all (select * from dict_heap except all select * from dict_co)) d;
+
+-- Index scans and fetches
+create index dict_co_t on dict_co (t);
+create index dict_co_id on dict_co (id);
+set enable_seqscan = off;
+select count(*), min(id), max(id) from dict_co where t = 'val7';
+select id, t, v from dict_co where id in (1, 257, 19999, 20050) order by id;
+reset enable_seqscan;
+
+-- DELETE and UPDATE
+delete from dict_co where t = 'val7';
+delete from dict_heap where t = 'val7';
+update dict_co set t = 'updated' where t = 'val8';
+update dict_heap set t = 'updated' where t = 'val8';
+select count(*), count(distinct t) from dict_co;
+select count(*) from dict_co where t = 'updated';
+select count(*) from ((select * from dict_co except all select * from dict_heap)
+	union all (select * from dict_heap except all select * from dict_co)) d;
+
+-- VACUUM rewrites the visible rows into new, again encoded, segment files
+vacuum dict_co;
+set gp_enable_aocs_batch_scan = off;
+select count(*) from ((select * from dict_co except all select * from dict_heap)
+	union all (select * from dict_heap except all select * from dict_co)) d;
+set gp_enable_aocs_batch_scan = on;
+select count(*) from dict_co where t in ('val7', 'updated', 'val9');
+select count(*) from ((select * from dict_co except all select * from dict_heap)
+	union all (select * from dict_heap except all select * from dict_co)) d;
+set enable_seqscan = off;
+select id, t, v from dict_co where id in (7, 8, 257, 258, 19999) order by id;
+reset enable_seqscan;
+
+-- A column added with the option is encoded too
+alter table dict_co add column w text default 'w'
+	encoding (compresstype=rle_type, dictionary=true);
+alter table dict_heap add column w text default 'w';
+insert into dict_co select i, 'val' || (i % 50), 'v' || (i % 700), 'w' || (i % 10)
+	from generate_series(30001, 31000) i;
+insert into dict_heap select i, 'val' || (i % 50), 'v' || (i % 700), 'w' || (i % 10)
+	from generate_series(30001, 31000) i;
+select count(*) from dict_co where w = 'w';
+select count(*) from dict_co where w in ('w3', 'w4');
+select count(*) from ((select * from dict_co except all select * from dict_heap)
+	union all (select * from dict_heap except all select * from dict_co)) d;
+
+reset gp_enable_aocs_batch_scan;
+-- start_ignore
+drop schema dict_encoding cascade;
+-- end_ignore
@@ -225,7 +225,7 @@ show gp_default_storage_options;
 \c dsp3
 
 set gp_default_storage_options=
-	"appendonly=true,orientation=column,compresslevel=5";
+	"appendonly=true,orientation=column,compresslevel=9";
 show gp_default_storage_options;
 -- negative tests - should fail due to invalid combinations of
 -- compresslevel and compresstype.
@@ -234,11 +234,11 @@ create table co6(
 	b float encoding (blocksize=8192))
 	distributed by (a);
 create table co7(a int, b float,
-	default column encoding (compresstype=RLE_TYPE, compresslevel=7))
+	default column encoding (compresstype=RLE_TYPE, compresslevel=8))
 	distributed by (a);
 -- negative tests - session level set
 set gp_default_storage_options="compresstype=zlib,compresslevel=11";
-set gp_default_storage_options="compresslevel=5,compresstype=RLE_TYPE";
+set gp_default_storage_options="compresslevel=9,compresstype=RLE_TYPE";
 set gp_default_storage_options="compresslevel=1,compresstype=rle";
 set gp_default_storage_options="checksum=1234";
 set gp_default_storage_options="blocksize=true";
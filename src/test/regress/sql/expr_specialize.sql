@@ -0,0 +1,72 @@
+--
+-- Specialized evaluation of function calls whose arguments are plain
+-- columns or constants (gp_expr_specialize_above_cost). The results must
+-- be the same as with the general evaluation, and EXPLAIN ANALYZE counts
+-- only the calls that actually switched to the specialized path.
+--
+create schema expr_specialize;
+set search_path to expr_specialize;
+set gp_expr_specialize_above_cost = 0;
+
+create function nonstrict_add(int, int) returns int as $$
+begin
+  return coalesce($1, 0) + coalesce($2, 0);
+end;
+$$ language plpgsql immutable;
+
+create table spec_t (a int, b int) distributed by (a);
+insert into spec_t values (1, 10), (2, null), (3, 30), (4, 40), (5, null);
+create table spec_t2 (a int, b int) distributed by (a);
+insert into spec_t2 values (1, 15), (2, 20), (3, 35), (4, null), (6, 60);
+
+-- Strict and non-strict functions with NULL arguments
+select a, b, a + b as strict_sum, nonstrict_add(a, b) as nonstrict_sum
+from spec_t order by a;
+select a from spec_t where b + 0 > 15 order by a;
+
+-- Arguments from the outer and the inner side of a join
+set enable_mergejoin = off;
+set enable_nestloop = off;
+select t1.a, t1.b, t2.b, t1.b + t2.b as sum
+from spec_t t1 join spec_t2 t2 on t1.a = t2.a
+where t1.b < t2.b order by 1;
+select t1.a, nonstrict_add(t1.b, t2.b) as nonstrict_sum, t1.b + t2.b as strict_sum
+from spec_t t1 left join spec_t2 t2 on t1.a = t2.a order by 1;
+reset enable_mergejoin;
+reset enable_nestloop;
+
+-- Set-returning functions keep the general path
+select a, generate_series(1, a) from spec_t where a <= 2 order by 1, 2;
+
+-- The EXPLAIN ANALYZE counter, on a catalog query that runs on the master
+create function specialized_calls(query text) returns text as $$
+declare
+  r record;
+begin
+  for r in execute 'explain analyze ' || query loop
+    if r."QUERY PLAN" like 'Specialized function calls:%' then
+      return r."QUERY PLAN";
+    end if;
+  end loop;
+  return 'no specialized function calls';
+end;
+$$ language plpgsql;
+
+set enable_indexscan = off;
+set enable_bitmapscan = off;
+select specialized_calls('select relname from pg_class where relname = ''pg_class'' and relnatts + 0 > 0');
+-- generate_series() returns a set, so only the qual switches over
+select specialized_calls('select generate_series(1, relnatts) from pg_class where relname = ''pg_class''');
+-- calls that are tracked in pg_stat_user_functions don't switch over
+set track_functions = 'pl';
+select specialized_calls('select relname from pg_class where relname = ''pg_class'' and nonstrict_add(relnatts, 1) > 0');
+reset track_functions;
+select specialized_calls('select relname from pg_class where relname = ''pg_class'' and nonstrict_add(relnatts, 1) > 0');
+-- nothing switches over below the cost threshold
+set gp_expr_specialize_above_cost = 1e10;
+select specialized_calls('select relname from pg_class where relname = ''pg_class'' and relnatts + 0 > 0');
+reset enable_indexscan;
+reset enable_bitmapscan;
+
+reset gp_expr_specialize_above_cost;
+drop schema expr_specialize cascade;
@@ -0,0 +1,67 @@
+--
+-- Tables created with gp_create_table_hash_reduction = jump map their hash
+-- values to segments with jump consistent hashing instead of modulo.  The
+-- segment ids below are those of the 3-segment demo cluster; they match
+-- the known answers in src/backend/cdb/test/cdbhash_test.c.
+--
+create schema hash_reduction_jump;
+set search_path = hash_reduction_jump;
+
+set gp_create_table_hash_reduction = jump;
+create table jump_tab (a int, b text) distributed by (a);
+create table jump_part (a int, b int) distributed by (a)
+partition by range (b) (start (0) end (2) every (1));
+reset gp_create_table_hash_reduction;
+create table mod_tab (a int, b text) distributed by (a);
+
+select c.relname, p.hashreduce
+from gp_distribution_policy p
+join pg_class c on c.oid = p.localoid
+join pg_namespace n on n.oid = c.relnamespace
+where n.nspname = 'hash_reduction_jump'
+order by 1;
+
+-- INSERT places the rows by the table's reduction
+insert into jump_tab select i, 'row ' || i from generate_series(1, 12) i;
+insert into mod_tab select i, 'row ' || i from generate_series(1, 12) i;
+insert into jump_part select i, i % 2 from generate_series(1, 12) i;
+select a, j.gp_segment_id as jump, m.gp_segment_id as modulo
+from jump_tab j join mod_tab m using (a)
+order by a;
+select a, gp_segment_id from jump_part order by a;
+
+-- and so does COPY
+copy jump_tab from stdin;
+101	copied
+102	copied
+103	copied
+104	copied
+105	copied
+106	copied
+\.
+select a, gp_segment_id from jump_tab where a > 100 order by a;
+
+-- Every row is found on the segment the lookup is dispatched to
+set test_print_direct_dispatch_info = on;
+select * from jump_tab where a = 5;
+select * from jump_tab where a = 104;
+select * from jump_part where a = 7;
+reset test_print_direct_dispatch_info;
+
+-- The reduction survives a dump and restore
+create database hash_reduction_jump_restore;
+\c hash_reduction_jump_restore
+create schema hash_reduction_jump;
+\! pg_dump -t hash_reduction_jump.jump_tab regression | grep gp_create_table_hash_reduction
+\! pg_dump -t hash_reduction_jump.jump_tab regression | psql -q -d hash_reduction_jump_restore > /dev/null 2>&1
+set search_path = hash_reduction_jump;
+select p.hashreduce
+from gp_distribution_policy p
+where p.localoid = 'jump_tab'::regclass;
+select a, gp_segment_id from jump_tab where a <= 12 order by a;
+
+\c regression
+drop database hash_reduction_jump_restore;
+-- start_ignore
+drop schema hash_reduction_jump cascade;
+-- end_ignore
@@ -165,6 +165,24 @@ SELECT SUM(length(long_tval)) AS sum_len_tval
           FROM small_table ORDER BY dkey LIMIT 20) foo
             JOIN (SELECT * FROM small_table ORDER BY dkey LIMIT 100) bar USING(jkey);
 
+-- Receive packets in batches; the rx thread then holds several rx buffers
+-- at once, and each query's teardown must still find them accounted for.
+SET gp_interconnect_io_batch_size TO 64;
+SELECT SUM(length(long_tval)) AS sum_len_tval
+  FROM (SELECT jkey, repeat(tval, 10000) AS long_tval
+          FROM small_table ORDER BY dkey LIMIT 20) foo
+            JOIN (SELECT * FROM small_table ORDER BY dkey LIMIT 100) bar USING(jkey);
+SELECT SUM(length(long_tval)) AS sum_len_tval
+  FROM (SELECT jkey, repeat(tval, 10000) AS long_tval
+          FROM small_table ORDER BY dkey LIMIT 20) foo
+            JOIN (SELECT * FROM small_table ORDER BY dkey LIMIT 100) bar USING(jkey);
+SET gp_interconnect_io_batch_size TO 8;
+SELECT SUM(length(long_tval)) AS sum_len_tval
+  FROM (SELECT jkey, repeat(tval, 10000) AS long_tval
+          FROM small_table ORDER BY dkey LIMIT 20) foo
+            JOIN (SELECT * FROM small_table ORDER BY dkey LIMIT 100) bar USING(jkey);
+RESET gp_interconnect_io_batch_size;
+
 -- MPP-21916
 CREATE TABLE a (i INT, j INT) DISTRIBUTED BY (i);
 INSERT INTO a (SELECT i, i * i FROM generate_series(1, 10) as i);
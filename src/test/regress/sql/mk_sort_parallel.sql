@@ -0,0 +1,60 @@
+--
+-- Multi-key sorts on several threads (gp_mk_sort_parallel_workers). Each
+-- query sorts all rows in one in-memory sort below a window function, and
+-- sums row_number() times a weight that is equal for rows that compare
+-- equal, so the sum only matches if the order is right. Every query runs
+-- serially and on four threads, and must give the same sum both times.
+--
+create schema mk_sort_parallel;
+set search_path to mk_sort_parallel;
+
+create table ps_t (a int, b int, g int, f float8, d date, t text) distributed by (a);
+insert into ps_t
+select i, i % 1000,
+       case when i % 7 = 0 then null else i % 5000 end,
+       case when i % 7 = 0 then null else (i % 5000)::float8 / 3 end,
+       case when i % 13 = 0 then null else date '2000-01-01' + i % 3000 end,
+       case when i % 11 = 0 then null else to_char(i % 100000, 'FM000000') end
+from generate_series(1, 300000) i;
+
+set gp_enable_mk_sort = on;
+set statement_mem = '256MB';
+
+-- Integer key with many duplicates
+set gp_mk_sort_parallel_workers = 1;
+select sum(rn * b) from (select b, row_number() over (order by b) as rn from ps_t) s;
+set gp_mk_sort_parallel_workers = 4;
+select sum(rn * b) from (select b, row_number() over (order by b) as rn from ps_t) s;
+
+-- float8 and integer keys, NULLs first
+set gp_mk_sort_parallel_workers = 1;
+select sum(rn * (coalesce(g, -1) * 1000 + b))
+from (select g, b, row_number() over (order by f nulls first, b desc) as rn from ps_t) s;
+set gp_mk_sort_parallel_workers = 4;
+select sum(rn * (coalesce(g, -1) * 1000 + b))
+from (select g, b, row_number() over (order by f nulls first, b desc) as rn from ps_t) s;
+
+-- Descending float8 key with NULLs last, unique second key
+set gp_mk_sort_parallel_workers = 1;
+select sum(rn * a) from (select a, row_number() over (order by f desc nulls last, a) as rn from ps_t) s;
+set gp_mk_sort_parallel_workers = 4;
+select sum(rn * a) from (select a, row_number() over (order by f desc nulls last, a) as rn from ps_t) s;
+
+-- date key, NULLs last
+set gp_mk_sort_parallel_workers = 1;
+select sum(rn * (coalesce(d - date '2000-01-01', 99999) * 1000 + b))
+from (select d, b, row_number() over (order by d nulls last, b) as rn from ps_t) s;
+set gp_mk_sort_parallel_workers = 4;
+select sum(rn * (coalesce(d - date '2000-01-01', 99999) * 1000 + b))
+from (select d, b, row_number() over (order by d nulls last, b) as rn from ps_t) s;
+
+-- A text key is not eligible, and is sorted serially either way
+set gp_mk_sort_parallel_workers = 1;
+select sum(rn * coalesce(t::int, -1)) from (select t, row_number() over (order by t nulls first) as rn from ps_t) s;
+set gp_mk_sort_parallel_workers = 4;
+select sum(rn * coalesce(t::int, -1)) from (select t, row_number() over (order by t nulls first) as rn from ps_t) s;
+
+reset gp_mk_sort_parallel_workers;
+reset statement_mem;
+reset gp_enable_mk_sort;
+drop schema mk_sort_parallel cascade;
@@ -0,0 +1,109 @@
+--
+-- Plan cache of the optimizer (optimizer_plan_cache_size). Queries that
+-- differ only in their literals share a cached plan; changes to a relation
+-- or to statistics discard the plans that depend on them. Without ORCA,
+-- nothing is cached.
+--
+create schema opt_plan_cache;
+set search_path to opt_plan_cache;
+
+create table pc (a int, b int) distributed by (a);
+create table pc_other (a int, b int) distributed by (a);
+insert into pc select i, i % 10 from generate_series(1, 1000) i;
+analyze pc;
+
+-- The counters since the last call. They are read with the planner, so
+-- that reading them doesn't count.
+create table pc_base (hits int8, misses int8);
+insert into pc_base values (0, 0);
+create function pc_stats(out hits int8, out misses int8, out entries int4)
+as $$
+declare
+	s record;
+	b record;
+begin
+	select * into s from gp_opt_plan_cache_stats();
+	select * into b from pc_base;
+	hits := s.hits - b.hits;
+	misses := s.misses - b.misses;
+	entries := s.entries;
+	update pc_base set hits = s.hits, misses = s.misses;
+end;
+$$ language plpgsql;
+
+set optimizer_plan_cache_size = '1MB';
+set optimizer = off;
+select 1 from pc_stats();
+reset optimizer;
+
+-- The first query misses, the same query with other literals hits
+select count(*) from pc where b = 5;
+select count(*) from pc where b = 7;
+select count(*) from pc where b = 5;
+set optimizer = off;
+select * from pc_stats();
+reset optimizer;
+
+-- Another query misses
+select count(*) from pc where b = 5 and a > 500;
+select count(*) from pc where b = 7 and a > 500;
+set optimizer = off;
+select * from pc_stats();
+reset optimizer;
+
+-- A directly dispatched plan is only reused for the same literals
+select count(*) from pc where a = 5;
+select count(*) from pc where a = 6;
+select count(*) from pc where a = 6;
+set optimizer = off;
+select * from pc_stats();
+reset optimizer;
+
+-- ORCA merges redundant predicates, here into a > 5, so the literal 2 only
+-- survives in b = 2 and can't be told apart from the first one. Such a plan
+-- is only reused for the same literals.
+select count(*) from pc where a > 2 and a > 5 and b = 2;
+select count(*) from pc where a > 9 and a > 5 and b = 9;
+select count(*) from pc where a > 9 and a > 5 and b = 9;
+set optimizer = off;
+select * from pc_stats();
+reset optimizer;
+
+-- Changes to other relations keep the plans
+truncate pc_other;
+select count(*) from pc where b = 3;
+set optimizer = off;
+select * from pc_stats();
+reset optimizer;
+
+-- Changes to the relation discard them
+create index pc_b on pc (b);
+set optimizer = off;
+select * from pc_stats();
+reset optimizer;
+select count(*) from pc where b = 3;
+set optimizer = off;
+select * from pc_stats();
+reset optimizer;
+
+-- So do new statistics
+analyze pc;
+set optimizer = off;
+select * from pc_stats();
+reset optimizer;
+select count(*) from pc where b = 3;
+set optimizer = off;
+select * from pc_stats();
+reset optimizer;
+
+-- Nothing is cached when the cache is off
+set optimizer_plan_cache_size = 0;
+select count(*) from pc where b = 3;
+set optimizer = off;
+select * from pc_stats();
+reset optimizer;
+
+reset optimizer_plan_cache_size;
+-- start_ignore
+drop schema opt_plan_cache cascade;
+-- end_ignore
@@ -0,0 +1,89 @@
+--
+-- rle_type compresslevel 5 to 7 run-length and delta encode the columns,
+-- like the other levels, and compress the blocks with zstd. Every table must
+-- return the same rows as the same table with compresslevel 1, which only
+-- encodes.
+--
+create schema rle_zstd;
+set search_path to rle_zstd;
+
+-- run and t have long runs; seq and ts grow by a small delta
+create table rz1 (
+	id int,
+	run int encoding (compresstype=rle_type, compresslevel=1),
+	seq bigint encoding (compresstype=rle_type, compresslevel=1),
+	ts timestamp encoding (compresstype=rle_type, compresslevel=1),
+	t text encoding (compresstype=rle_type, compresslevel=1))
+	with (appendonly=true, orientation=column) distributed by (id);
+create table rz5 (
+	id int,
+	run int encoding (compresstype=rle_type, compresslevel=5),
+	seq bigint encoding (compresstype=rle_type, compresslevel=5),
+	ts timestamp encoding (compresstype=rle_type, compresslevel=5),
+	t text encoding (compresstype=rle_type, compresslevel=5))
+	with (appendonly=true, orientation=column) distributed by (id);
+create table rz6 (
+	id int,
+	run int encoding (compresstype=rle_type, compresslevel=6),
+	seq bigint encoding (compresstype=rle_type, compresslevel=6),
+	ts timestamp encoding (compresstype=rle_type, compresslevel=6),
+	t text encoding (compresstype=rle_type, compresslevel=6))
+	with (appendonly=true, orientation=column) distributed by (id);
+create table rz7 (
+	id int,
+	run int encoding (compresstype=rle_type, compresslevel=7),
+	seq bigint encoding (compresstype=rle_type, compresslevel=7),
+	ts timestamp encoding (compresstype=rle_type, compresslevel=7),
+	t text encoding (compresstype=rle_type, compresslevel=7))
+	with (appendonly=true, orientation=column) distributed by (id);
+select attrelid::regclass as relname, attnum, attoptions from pg_attribute_encoding
+	where attrelid in ('rz5'::regclass, 'rz7'::regclass) and attnum in (2, 5)
+	order by relname, attnum;
+
+insert into rz1 select i, case when i % 997 = 0 then null else i / 1000 end,
+	1000000000000 + i * 3, timestamp '2020-01-01' + i * interval '1 second',
+	case when i % 7000 < 3500 then 'status_a' else 'status_b' end
+	from generate_series(1, 20000) i;
+insert into rz5 select * from rz1;
+insert into rz6 select * from rz1;
+insert into rz7 select * from rz1;
+
+-- A second insert, into new blocks
+insert into rz1 select i, case when i % 997 = 0 then null else i / 1000 end,
+	1000000000000 + i * 3, timestamp '2020-01-01' + i * interval '1 second',
+	case when i % 7000 < 3500 then 'status_a' else 'status_b' end
+	from generate_series(20001, 30000) i;
+insert into rz5 select * from rz1 where id > 20000;
+insert into rz6 select * from rz1 where id > 20000;
+insert into rz7 select * from rz1 where id > 20000;
+
+select count(*), count(run), sum(run), count(distinct seq), count(distinct ts), count(distinct t) from rz5;
+select count(*), count(run), sum(run), count(distinct seq), count(distinct ts), count(distinct t) from rz6;
+select count(*), count(run), sum(run), count(distinct seq), count(distinct ts), count(distinct t) from rz7;
+
+-- The rows that differ from the table that is only encoded
+select count(*) from ((select * from rz5 except all select * from rz1)
+	union all (select * from rz1 except all select * from rz5)) d;
+select count(*) from ((select * from rz6 except all select * from rz1)
+	union all (select * from rz1 except all select * from rz6)) d;
+select count(*) from ((select * from rz7 except all select * from rz1)
+	union all (select * from rz1 except all select * from rz7)) d;
+
+-- Quals on runs and on delta encoded columns, evaluated per run by the batch
+-- scan
+set gp_enable_aocs_batch_scan = on;
+select run, count(*) from rz5 where run between 3 and 5 group by run order by run;
+select count(*) from rz5 where t = 'status_b' and run = 10;
+select count(*) from rz5 where seq > 1000000000000 + 30000 and ts < timestamp '2020-01-01 04:00:00';
+select run, count(*) from rz6 where run between 3 and 5 group by run order by run;
+select count(*) from rz6 where t = 'status_b' and run = 10;
+select count(*) from rz6 where seq > 1000000000000 + 30000 and ts < timestamp '2020-01-01 04:00:00';
+select run, count(*) from rz7 where run between 3 and 5 group by run order by run;
+select count(*) from rz7 where t = 'status_b' and run = 10;
+select count(*) from rz7 where seq > 1000000000000 + 30000 and ts < timestamp '2020-01-01 04:00:00';
+select count(*) from rz7 where run is null;
+reset gp_enable_aocs_batch_scan;
+
+-- start_ignore
+drop schema rle_zstd cascade;
+-- end_ignore
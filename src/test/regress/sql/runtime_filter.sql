@@ -0,0 +1,100 @@
+--
+-- Runtime join filters: the Hash node builds a Bloom filter of the inner
+-- join keys, and the scan on the outer side of the join drops the rows that
+-- cannot match (gp_enable_runtime_filter).  Every query must return the
+-- same result with and without the filter.
+--
+create schema runtime_filter;
+set search_path to runtime_filter;
+
+-- start_ignore
+create language plpythonu;
+-- end_ignore
+
+-- What EXPLAIN ANALYZE says about the runtime filter of a query.
+create or replace function runtime_filter.filter_use(query text)
+returns text as
+$$
+import re
+rv = plpy.execute('explain analyze ' + query)
+result = 'no filter'
+for i in range(len(rv)):
+    m = re.search('Runtime filter removed (\d+) of (\d+) outer rows', rv[i]['QUERY PLAN'])
+    if m and int(m.group(1)) > 0:
+        result = 'removed rows'
+    elif m and result == 'no filter':
+        result = 'removed no rows'
+return result
+$$
+language plpythonu;
+
+-- Whether a query spilled to workfiles.
+create or replace function runtime_filter.spilled(query text)
+returns bool as
+$$
+rv = plpy.execute('explain analyze ' + query)
+for i in range(len(rv)):
+    if 'spilling' in rv[i]['QUERY PLAN'].lower():
+        return True
+return False
+$$
+language plpythonu;
+
+create table fact (a int, b int) distributed by (a);
+insert into fact select i % 1000, i from generate_series(1, 100000) i;
+insert into fact select null, i from generate_series(1, 1000) i;
+create table dim (a int, c text) distributed by (a);
+insert into dim select i, 'dim ' || i from generate_series(1, 20) i;
+insert into dim values (null, 'dim null');
+create table big_dim (a int) distributed by (a);
+insert into big_dim select i * 7 from generate_series(1, 60000) i;
+analyze fact;
+analyze dim;
+analyze big_dim;
+
+set optimizer = off;
+set enable_nestloop = off;
+set enable_mergejoin = off;
+
+-- Inner join, filter on and off
+set gp_enable_runtime_filter = on;
+select count(*), sum(f.b) from fact f join dim d on f.a = d.a;
+select filter_use('select * from fact f join dim d on f.a = d.a');
+set gp_enable_runtime_filter = off;
+select count(*), sum(f.b) from fact f join dim d on f.a = d.a;
+select filter_use('select * from fact f join dim d on f.a = d.a');
+set gp_enable_runtime_filter = on;
+
+-- Semi join
+select count(*) from fact f where f.a in (select a from dim);
+select count(*) from fact f where exists (select 1 from dim d where d.a = f.a);
+
+-- Outer joins keep the rows without a match, so they have no filter
+select count(*) from fact f left join dim d on f.a = d.a;
+select filter_use('select * from fact f left join dim d on f.a = d.a');
+
+-- NULL join keys never match with =, but do with IS NOT DISTINCT FROM
+select count(*) from fact f join dim d on f.a = d.a where f.a is null;
+select count(*) from fact f join dim d on f.a is not distinct from d.a;
+select count(*) from fact f join dim d on f.a is not distinct from d.a where f.a is null;
+
+-- Rescans of the join, with and without a new hash table
+select d2.a, (select count(*) from fact f join dim d on f.a = d.a where d.a <= d2.a)
+from dim d2 where d2.a <= 3 order by 1;
+select d2.a, (select count(*) from fact f join dim d on f.a = d.a where f.b % 3 = d2.a)
+from dim d2 where d2.a <= 3 order by 1;
+
+-- A join that spills to several batches; the filter covers all of them
+set statement_mem = 1024;
+select count(*), sum(f.b) from fact f join big_dim d on f.a = d.a;
+select spilled('select * from fact f join big_dim d on f.a = d.a');
+select filter_use('select * from fact f join big_dim d on f.a = d.a');
+set gp_enable_runtime_filter = off;
+select count(*), sum(f.b) from fact f join big_dim d on f.a = d.a;
+reset gp_enable_runtime_filter;
+reset statement_mem;
+
+reset enable_mergejoin;
+reset enable_nestloop;
+reset optimizer;
+drop schema runtime_filter cascade;
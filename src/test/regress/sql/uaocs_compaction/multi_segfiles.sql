@@ -0,0 +1,62 @@
+-- @Description Tests lazy vacuum compacting several segment files per
+-- transaction (gp_appendonly_compaction_segfiles > 1).
+--
+-- All rows have b = 1, so that they are all on one segment. Each round of
+-- inserts and vacuums below leaves one more segment file with rows in it.
+CREATE TABLE uaocs_multi (a INT, b INT, c CHAR(128)) WITH (appendonly=true, orientation=column) DISTRIBUTED BY (b);
+CREATE INDEX uaocs_multi_index ON uaocs_multi(a);
+CREATE TABLE uaocs_multi_fallback (a INT, b INT, c CHAR(128)) WITH (appendonly=true, orientation=column) DISTRIBUTED BY (b);
+CREATE INDEX uaocs_multi_fallback_index ON uaocs_multi_fallback(a);
+
+-- Segment file 1 is compacted into 2
+INSERT INTO uaocs_multi SELECT i, 1, 'hello world' FROM generate_series(1, 100) i;
+INSERT INTO uaocs_multi_fallback SELECT i, 1, 'hello world' FROM generate_series(1, 100) i;
+DELETE FROM uaocs_multi WHERE a <= 20;
+DELETE FROM uaocs_multi_fallback WHERE a <= 20;
+VACUUM uaocs_multi;
+VACUUM uaocs_multi_fallback;
+-- Segment file 1 is compacted into 3. Segment file 2 has no dead rows.
+INSERT INTO uaocs_multi SELECT i, 1, 'hello world' FROM generate_series(101, 200) i;
+INSERT INTO uaocs_multi_fallback SELECT i, 1, 'hello world' FROM generate_series(101, 200) i;
+DELETE FROM uaocs_multi WHERE a BETWEEN 101 AND 120;
+DELETE FROM uaocs_multi_fallback WHERE a BETWEEN 101 AND 120;
+VACUUM uaocs_multi;
+VACUUM uaocs_multi_fallback;
+INSERT INTO uaocs_multi SELECT i, 1, 'hello world' FROM generate_series(201, 300) i;
+INSERT INTO uaocs_multi_fallback SELECT i, 1, 'hello world' FROM generate_series(201, 300) i;
+DELETE FROM uaocs_multi WHERE a % 4 = 0;
+DELETE FROM uaocs_multi_fallback WHERE a % 4 = 0;
+SELECT DISTINCT segno, tupcount, state FROM gp_toolkit.__gp_aocsseg_name('uaocs_multi') ORDER BY segno;
+SELECT DISTINCT segno, tupcount, state FROM gp_toolkit.__gp_aocsseg_name('uaocs_multi_fallback') ORDER BY segno;
+
+-- The three dirty segment files are compacted by one transaction, each into
+-- a segment file of its own, and dropped by one drop transaction.
+SET gp_appendonly_compaction_segfiles = 4;
+VACUUM uaocs_multi;
+SELECT DISTINCT segno, tupcount, state FROM gp_toolkit.__gp_aocsseg_name('uaocs_multi') ORDER BY segno;
+SELECT COUNT(*), SUM(a) FROM uaocs_multi;
+
+SET enable_seqscan = off;
+SELECT a FROM uaocs_multi WHERE a IN (5, 24, 25, 121, 124, 150, 201, 204, 300) ORDER BY a;
+SELECT COUNT(*) FROM uaocs_multi WHERE a BETWEEN 101 AND 140;
+RESET enable_seqscan;
+
+-- When no more segment files are available to compact into, the rest of
+-- the segment files are compacted into the last one found.
+-- start_ignore
+CREATE EXTENSION IF NOT EXISTS gp_inject_fault;
+-- end_ignore
+SELECT gp_inject_fault('compaction_insert_segno_unavailable', 'skip', '', '', '', -1, 0, 1);
+VACUUM uaocs_multi_fallback;
+SELECT gp_inject_fault('compaction_insert_segno_unavailable', 'reset', 1);
+SELECT DISTINCT segno, tupcount, state FROM gp_toolkit.__gp_aocsseg_name('uaocs_multi_fallback') ORDER BY segno;
+SELECT COUNT(*), SUM(a) FROM uaocs_multi_fallback;
+
+SET enable_seqscan = off;
+SELECT a FROM uaocs_multi_fallback WHERE a IN (5, 24, 25, 121, 124, 150, 201, 204, 300) ORDER BY a;
+SELECT COUNT(*) FROM uaocs_multi_fallback WHERE a BETWEEN 101 AND 140;
+RESET enable_seqscan;
+RESET gp_appendonly_compaction_segfiles;
+
+DROP TABLE uaocs_multi;
+DROP TABLE uaocs_multi_fallback;
@@ -0,0 +1,79 @@
+--
+-- Spill files compressed with each gp_workfile_compress_algorithm. A hash
+-- join and a hash aggregate that spill must return the same rows whatever
+-- the algorithm, and the rows must survive the round trip through the
+-- compressed files. compress_spill_1.out is the output of a build without
+-- lz4 and zstd, where setting them fails and the queries run with zlib.
+--
+create schema compress_spill;
+set search_path to compress_spill;
+
+-- start_ignore
+create language plpythonu;
+-- end_ignore
+
+-- set workfile is created to true if all segment did it.
+create or replace function compress_spill.is_workfile_created(explain_query text)
+returns setof int as
+$$
+import re
+query = "select count(*) as nsegments from gp_segment_configuration where role='p' and content >= 0;"
+rv = plpy.execute(query)
+nsegments = int(rv[0]['nsegments'])
+rv = plpy.execute(explain_query)
+search_text = 'spilling'
+result = []
+for i in range(len(rv)):
+    cur_line = rv[i]['QUERY PLAN']
+    if search_text.lower() in cur_line.lower():
+        p = re.compile('.+\((segment [\d]+).+ Workfile: \(([\d+]) spilling\)')
+        m = p.match(cur_line)
+        workfile_created = int(m.group(2))
+        cur_row = int(workfile_created == nsegments)
+        result.append(cur_row)
+return result
+$$
+language plpythonu;
+
+create table cs_t (i1 int, i2 int, i3 int, t text) distributed by (i1);
+insert into cs_t select i, i % 1000, i % 10000, repeat('spill', 10) || i from generate_series(1, 150000) i;
+
+set statement_mem = '1MB';
+set gp_resqueue_print_operator_memory_limits = on;
+set gp_workfile_type_hashjoin = bfz;
+set enable_groupagg = off;
+
+set gp_workfile_compress_algorithm = none;
+select count(*), sum(t1.i1), sum(length(t1.t)) from cs_t t1 join cs_t t2 on t1.i1 = t2.i3 + 1;
+select count(*), sum(c), sum(length(m)) from (select i1, count(*) as c, max(t) as m from cs_t group by i1) foo;
+
+set gp_workfile_compress_algorithm = zlib;
+select count(*), sum(t1.i1), sum(length(t1.t)) from cs_t t1 join cs_t t2 on t1.i1 = t2.i3 + 1;
+select count(*), sum(c), sum(length(m)) from (select i1, count(*) as c, max(t) as m from cs_t group by i1) foo;
+
+set gp_workfile_compress_algorithm = lz4;
+select count(*), sum(t1.i1), sum(length(t1.t)) from cs_t t1 join cs_t t2 on t1.i1 = t2.i3 + 1;
+select count(*), sum(c), sum(length(m)) from (select i1, count(*) as c, max(t) as m from cs_t group by i1) foo;
+select * from compress_spill.is_workfile_created('explain (analyze, verbose) select t1.t from cs_t t1 join cs_t t2 on t1.i1 = t2.i3 + 1;');
+select * from compress_spill.is_workfile_created('explain (analyze, verbose) select i1, max(t) from cs_t group by i1;');
+
+set gp_workfile_compress_algorithm = zstd;
+show gp_workfile_compress_zstd_level;
+select count(*), sum(t1.i1), sum(length(t1.t)) from cs_t t1 join cs_t t2 on t1.i1 = t2.i3 + 1;
+select count(*), sum(c), sum(length(m)) from (select i1, count(*) as c, max(t) as m from cs_t group by i1) foo;
+select * from compress_spill.is_workfile_created('explain (analyze, verbose) select t1.t from cs_t t1 join cs_t t2 on t1.i1 = t2.i3 + 1;');
+select * from compress_spill.is_workfile_created('explain (analyze, verbose) select i1, max(t) from cs_t group by i1;');
+
+-- The highest zstd level
+set gp_workfile_compress_zstd_level = 19;
+select count(*), sum(t1.i1), sum(length(t1.t)) from cs_t t1 join cs_t t2 on t1.i1 = t2.i3 + 1;
+select count(*), sum(c), sum(length(m)) from (select i1, count(*) as c, max(t) as m from cs_t group by i1) foo;
+
+reset gp_workfile_compress_zstd_level;
+reset gp_workfile_compress_algorithm;
+reset gp_workfile_type_hashjoin;
+reset enable_groupagg;
+reset statement_mem;
+-- start_ignore
+drop schema compress_spill cascade;
+-- end_ignore
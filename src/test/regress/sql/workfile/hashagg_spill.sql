@@ -93,4 +93,17 @@ select count(*) from (select i, count(*) from aggspill group by i,j,t having cou
 
 select count(*) from (select i, count(*) from aggspill group by i,j,t having count(*) = 3) g;
 
+-- Spill with the input tuples probed in batches, and one at a time
+reset gp_hashagg_default_nbatches;
+set statement_mem = '20MB';
+set gp_hashagg_probe_batch_size = 64;
+select overflows >= 1 from hashagg_spill.num_hashagg_overflows('explain analyze
+select count(*), sum(i) from (select i, count(*) from aggspill group by i,j,t having count(*) = 2) g') overflows;
+select count(*), sum(i) from (select i, count(*) from aggspill group by i,j,t having count(*) = 2) g;
+set gp_hashagg_probe_batch_size = 1;
+select overflows >= 1 from hashagg_spill.num_hashagg_overflows('explain analyze
+select count(*), sum(i) from (select i, count(*) from aggspill group by i,j,t having count(*) = 2) g') overflows;
+select count(*), sum(i) from (select i, count(*) from aggspill group by i,j,t having count(*) = 2) g;
+reset gp_hashagg_probe_batch_size;
+
 drop schema hashagg_spill cascade;
@@ -0,0 +1,81 @@
+--
+-- Read-ahead (gp_workfile_prefetch_blocks) and write-behind
+-- (gp_workfile_writeback_blocks) on spill files must not change what the
+-- spilling operators return. Run the same spilling sort, hash join and
+-- hash aggregate with both off, with both on, and with the smallest
+-- distances, which issue a request for every block.
+--
+create schema prefetch_writeback;
+set search_path to prefetch_writeback;
+
+-- start_ignore
+create language plpythonu;
+-- end_ignore
+
+-- set workfile is created to true if all segment did it.
+create or replace function prefetch_writeback.is_workfile_created(explain_query text)
+returns setof int as
+$$
+import re
+query = "select count(*) as nsegments from gp_segment_configuration where role='p' and content >= 0;"
+rv = plpy.execute(query)
+nsegments = int(rv[0]['nsegments'])
+rv = plpy.execute(explain_query)
+search_text = 'spilling'
+result = []
+for i in range(len(rv)):
+    cur_line = rv[i]['QUERY PLAN']
+    if search_text.lower() in cur_line.lower():
+        p = re.compile('.+\((segment [\d]+).+ Workfile: \(([\d+]) spilling\)')
+        m = p.match(cur_line)
+        workfile_created = int(m.group(2))
+        cur_row = int(workfile_created == nsegments)
+        result.append(cur_row)
+return result
+$$
+language plpythonu;
+
+create table pw_t (i1 int, i2 int, i3 int) distributed by (i1);
+insert into pw_t select i, i % 1000, i % 10000 from generate_series(1, 150000) i;
+
+set statement_mem = '1MB';
+set gp_resqueue_print_operator_memory_limits = on;
+set gp_workfile_type_hashjoin = bfz;
+set gp_workfile_compress_algorithm = none;
+
+-- Both off
+set gp_workfile_prefetch_blocks = 0;
+set gp_workfile_writeback_blocks = 0;
+select sum(rn * i1) from (select i1, row_number() over (order by i2, i1) as rn from pw_t) foo;
+select count(*), sum(t1.i1) from pw_t t1 join pw_t t2 on t1.i1 = t2.i3 + 1;
+select count(*), sum(c) from (select i3, count(*) as c from pw_t group by i3) foo;
+
+-- Read-ahead at its default; write-behind is off by default, so turn it on
+reset gp_workfile_prefetch_blocks;
+reset gp_workfile_writeback_blocks;
+show gp_workfile_prefetch_blocks;
+show gp_workfile_writeback_blocks;
+set gp_workfile_writeback_blocks = 32;
+select sum(rn * i1) from (select i1, row_number() over (order by i2, i1) as rn from pw_t) foo;
+select count(*), sum(t1.i1) from pw_t t1 join pw_t t2 on t1.i1 = t2.i3 + 1;
+select count(*), sum(c) from (select i3, count(*) as c from pw_t group by i3) foo;
+
+-- A request for every block
+set gp_workfile_prefetch_blocks = 1;
+set gp_workfile_writeback_blocks = 1;
+select sum(rn * i1) from (select i1, row_number() over (order by i2, i1) as rn from pw_t) foo;
+select count(*), sum(t1.i1) from pw_t t1 join pw_t t2 on t1.i1 = t2.i3 + 1;
+select count(*), sum(c) from (select i3, count(*) as c from pw_t group by i3) foo;
+select * from prefetch_writeback.is_workfile_created('explain (analyze, verbose) select i1, row_number() over (order by i2, i1) from pw_t;');
+select * from prefetch_writeback.is_workfile_created('explain (analyze, verbose) select t1.i1 from pw_t t1 join pw_t t2 on t1.i1 = t2.i3 + 1;');
+
+-- Compressed bfz files read ahead and write behind, too
+set gp_workfile_compress_algorithm = zlib;
+select count(*), sum(t1.i1) from pw_t t1 join pw_t t2 on t1.i1 = t2.i3 + 1;
+
+reset gp_workfile_compress_algorithm;
+reset gp_workfile_type_hashjoin;
+reset gp_workfile_prefetch_blocks;
+reset gp_workfile_writeback_blocks;
+reset statement_mem;
+drop schema prefetch_writeback cascade;
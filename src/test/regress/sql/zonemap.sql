@@ -0,0 +1,138 @@
+--
+-- Zone maps of append-only tables (gp_appendonly_zonemap). Scans skip the
+-- blocks whose minimum and maximum values show that no row can pass their
+-- quals. Every query must return the same rows with skipping on and off,
+-- and the same rows as on a heap table, after DELETE, UPDATE and VACUUM too.
+--
+create schema zonemap;
+set search_path to zonemap;
+
+set enable_indexscan = off;
+set enable_bitmapscan = off;
+
+-- Only tables with a block directory, i.e. an index, have zone maps, and
+-- only for the rows inserted while they have one.
+create table zm_ao (id int, k int, v int8, t text)
+	with (appendonly=true, blocksize=8192) distributed by (id);
+create index zm_ao_id on zm_ao (id);
+create table zm_co (id int, k int, v int8, t text)
+	with (appendonly=true, orientation=column, blocksize=8192) distributed by (id);
+create index zm_co_id on zm_co (id);
+create table zm_heap (id int, k int, v int8, t text) distributed by (id);
+
+insert into zm_ao select i, i % 100, i * 10, 'row' || i from generate_series(1, 30000) i;
+insert into zm_co select * from zm_ao;
+insert into zm_heap select * from zm_ao;
+
+-- The ranges of id and v are skippable in most blocks, k = 7 and
+-- id is not null in none.
+create view zm_ao_q as
+	select 'range' as q, count(*), sum(v) from zm_ao where id between 1000 and 1010
+	union all select 'low', count(*), sum(v) from zm_ao where id < 50
+	union all select 'high', count(*), sum(v) from zm_ao where id > 29990
+	union all select 'eq', count(*), sum(v) from zm_ao where v = 12340::int8
+	union all select 'updated', count(*), sum(v) from zm_ao where v = 10511::int8
+	union all select 'none', count(*), sum(v) from zm_ao where id > 40000
+	union all select 'null', count(*), sum(v) from zm_ao where id is null
+	union all select 'every', count(*), sum(v) from zm_ao where k = 7
+	union all select 'notnull', count(*), sum(v) from zm_ao where id is not null;
+create view zm_co_q as
+	select 'range' as q, count(*), sum(v) from zm_co where id between 1000 and 1010
+	union all select 'low', count(*), sum(v) from zm_co where id < 50
+	union all select 'high', count(*), sum(v) from zm_co where id > 29990
+	union all select 'eq', count(*), sum(v) from zm_co where v = 12340::int8
+	union all select 'updated', count(*), sum(v) from zm_co where v = 10511::int8
+	union all select 'none', count(*), sum(v) from zm_co where id > 40000
+	union all select 'null', count(*), sum(v) from zm_co where id is null
+	union all select 'every', count(*), sum(v) from zm_co where k = 7
+	union all select 'notnull', count(*), sum(v) from zm_co where id is not null;
+create view zm_heap_q as
+	select 'range' as q, count(*), sum(v) from zm_heap where id between 1000 and 1010
+	union all select 'low', count(*), sum(v) from zm_heap where id < 50
+	union all select 'high', count(*), sum(v) from zm_heap where id > 29990
+	union all select 'eq', count(*), sum(v) from zm_heap where v = 12340::int8
+	union all select 'updated', count(*), sum(v) from zm_heap where v = 10511::int8
+	union all select 'none', count(*), sum(v) from zm_heap where id > 40000
+	union all select 'null', count(*), sum(v) from zm_heap where id is null
+	union all select 'every', count(*), sum(v) from zm_heap where k = 7
+	union all select 'notnull', count(*), sum(v) from zm_heap where id is not null;
+
+-- The rows that differ from the heap table, for each query
+create view zm_diff as
+	select 'ao' as tab, * from ((select * from zm_ao_q except all select * from zm_heap_q)
+		union all (select * from zm_heap_q except all select * from zm_ao_q)) d
+	union all
+	select 'co', * from ((select * from zm_co_q except all select * from zm_heap_q)
+		union all (select * from zm_heap_q except all select * from zm_co_q)) d;
+
+select * from zm_heap_q order by q;
+set gp_appendonly_zonemap = on;
+select * from zm_diff;
+set gp_appendonly_zonemap = off;
+select * from zm_diff;
+
+-- The scans do skip blocks: the appendonly_zonemap_skip fault is hit on
+-- segment 0 with zone maps on, and not with them off.
+create extension if not exists gp_inject_fault;
+select gp_inject_fault('appendonly_zonemap_skip', 'reset', 2);
+select gp_inject_fault('appendonly_zonemap_skip', 'skip', '', '', 'zm_ao', 1, 0, 2);
+set gp_appendonly_zonemap = off;
+select count(*) from zm_ao where id between 1000 and 1010;
+select gp_inject_fault('appendonly_zonemap_skip', 'status', 2);
+set gp_appendonly_zonemap = on;
+select count(*) from zm_ao where id between 1000 and 1010;
+select gp_inject_fault('appendonly_zonemap_skip', 'status', 2);
+select gp_inject_fault('appendonly_zonemap_skip', 'reset', 2);
+select gp_inject_fault('appendonly_zonemap_skip', 'skip', '', '', 'zm_co', 1, 0, 2);
+set gp_appendonly_zonemap = off;
+select count(*) from zm_co where id between 1000 and 1010;
+select gp_inject_fault('appendonly_zonemap_skip', 'status', 2);
+set gp_appendonly_zonemap = on;
+select count(*) from zm_co where id between 1000 and 1010;
+select gp_inject_fault('appendonly_zonemap_skip', 'status', 2);
+select gp_inject_fault('appendonly_zonemap_skip', 'reset', 2);
+
+-- DELETE
+delete from zm_ao where id % 5 = 0;
+delete from zm_co where id % 5 = 0;
+delete from zm_heap where id % 5 = 0;
+select * from zm_heap_q order by q;
+set gp_appendonly_zonemap = on;
+select * from zm_diff;
+set gp_appendonly_zonemap = off;
+select * from zm_diff;
+
+-- UPDATE writes the new versions of the rows at the end of the table
+update zm_ao set v = v + 1 where id between 1000 and 1100;
+update zm_co set v = v + 1 where id between 1000 and 1100;
+update zm_heap set v = v + 1 where id between 1000 and 1100;
+select * from zm_heap_q order by q;
+set gp_appendonly_zonemap = on;
+select * from zm_diff;
+set gp_appendonly_zonemap = off;
+select * from zm_diff;
+
+-- VACUUM rewrites the visible rows, with new zone maps
+vacuum zm_ao;
+vacuum zm_co;
+set gp_appendonly_zonemap = on;
+select * from zm_diff;
+set gp_appendonly_zonemap = off;
+select * from zm_diff;
+
+-- Rows inserted with zone maps off have no summaries, and are never skipped
+set gp_appendonly_zonemap = off;
+insert into zm_ao select i, i % 100, i * 10, 'row' || i from generate_series(30001, 31000) i;
+insert into zm_co select i, i % 100, i * 10, 'row' || i from generate_series(30001, 31000) i;
+insert into zm_heap select i, i % 100, i * 10, 'row' || i from generate_series(30001, 31000) i;
+set gp_appendonly_zonemap = on;
+select * from zm_diff;
+select count(*), sum(v) from zm_co where id > 30990;
+select count(*), sum(v) from zm_ao where id > 30990;
+
+reset gp_appendonly_zonemap;
+reset enable_indexscan;
+reset enable_bitmapscan;
+-- start_ignore
+drop schema zonemap cascade;
+-- end_ignore